@@ -386,7 +386,7 @@ void SimWildMesh::seal_connected_components(
             }
 
             const size_t v_new = split_tag_cache.local().v_new;
-            std::vector<size_t> tids = get_one_ring_tids_for_vertex(v_new);
+            const auto tids = get_one_ring_tids_for_vertex(v_new);
 
             new_vertices.insert(v_new);
 
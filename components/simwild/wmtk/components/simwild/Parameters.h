@@ -84,6 +84,8 @@ struct Parameters : public wmtk::OptimizerParameters
 
         w_amips = json_params["w_amips"];
         smoothing_mode = json_params["smoothing_mode"];
+        smoothing_solver = json_params["smoothing_solver"];
+        smoothing_engine = json_params["smoothing_engine"];
         project_line_search_steps = json_params["project_line_search_steps"];
         project_line_search_nested_steps = json_params["project_line_search_nested_steps"];
         num_smoothing_passes = json_params["num_smoothing_passes"];
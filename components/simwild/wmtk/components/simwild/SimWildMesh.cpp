@@ -386,7 +386,8 @@ size_t SimWildMesh::refine_sizing_around_worst(double)
             return std::cbrt(m_tet_attribute[tid].m_quality) / target; // relative quality
         },
         1.0,
-        m_params.stuck_refine_num_worst);
+        m_params.stuck_refine_num_worst,
+        NUM_THREADS);
 
     if (worst.empty()) {
         return 0;
@@ -140,7 +140,7 @@ public:
         // the note on its copy); there the overrun wrote a double past the end and libc++ let
         // it pass, here it assigns a std::set and segfaults outright.
         const size_t tcap = std::max(n_tet, m_tet_attribute.size());
-        m_tet_attribute.m_attributes = std::vector<TetAttributes>(tcap);
+        m_tet_attribute.m_attributes.assign(tcap, TetAttributes());
         for (size_t i = 0; i < n_tet; i++) m_tet_attribute[i] = _tet_attribute[i];
         for (size_t i = 0; i < n_tet; i++)
             m_tet_attribute[i].m_quality = get_quality(tuple_from_tet(i));
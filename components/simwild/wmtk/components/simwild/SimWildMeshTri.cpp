@@ -62,7 +62,6 @@ void SimWildMeshTri::init_from_image(
     // Only a split can un-round one after this.
     for (int i = 0; i < vert_capacity(); i++) {
         m_vertex_attribute[i].m_posf = V.row(i);
-        m_vertex_attribute[i].m_pos = to_rational(m_vertex_attribute[i].m_posf);
         m_vertex_attribute[i].m_is_rounded = true;
     }
 
@@ -128,19 +127,15 @@ void SimWildMeshTri::init_from_image(
     // A vertex is "direct" when its exact coordinate IS a double -- the round trip through
     // to_double/to_rational returns it unchanged. Those start rounded; the rest are the
     // arrangement's crossing vertices, which generally have no double representation at all.
+    // set_vertex_exact_pos makes that call, and clears m_all_rounded for the indirect ones.
     size_t n_indirect = 0;
     for (int i = 0; i < vert_capacity(); i++) {
-        VertexAttributes& va = m_vertex_attribute[i];
-        va.m_pos = V.row(i);
-        va.m_posf = to_double(va.m_pos);
-        va.m_is_rounded = (to_rational(va.m_posf) == va.m_pos);
-        if (!va.m_is_rounded) {
+        const Vector2r p = V.row(i);
+        set_vertex_exact_pos(i, p);
+        if (!m_vertex_attribute[i].m_is_rounded) {
             ++n_indirect;
         }
     }
-    if (n_indirect > 0) {
-        m_all_rounded.store(false, std::memory_order_relaxed);
-    }
 
     // Orientation is checked in EXACT arithmetic: an un-rounded vertex sends is_inverted down
     // the rational path, which is the whole point of keeping V. Rounding first and checking
@@ -279,14 +274,14 @@ void SimWildMeshTri::init_surfaces_and_boundaries()
         // precisely where rounding decides membership: two vertices that are exactly on the
         // boundary can round off it, or off it can round onto it, and the bbox tag is what
         // keeps the domain from collapsing.
+        const Vector2r p0 = vertex_exact_pos(vids[0]);
+        const Vector2r p1 = vertex_exact_pos(vids[1]);
         for (int k = 0; k < 2; k++) {
-            if (m_vertex_attribute[vids[0]].m_pos[k] == m_sim_params.box_min[k] &&
-                m_vertex_attribute[vids[1]].m_pos[k] == m_sim_params.box_min[k]) {
+            if (p0[k] == m_sim_params.box_min[k] && p1[k] == m_sim_params.box_min[k]) {
                 on_bbox = k * 2;
                 break;
             }
-            if (m_vertex_attribute[vids[0]].m_pos[k] == m_sim_params.box_max[k] &&
-                m_vertex_attribute[vids[1]].m_pos[k] == m_sim_params.box_max[k]) {
+            if (p0[k] == m_sim_params.box_max[k] && p1[k] == m_sim_params.box_max[k]) {
                 on_bbox = k * 2 + 1;
                 break;
             }
@@ -545,7 +540,8 @@ size_t SimWildMeshTri::refine_sizing_around_worst(double)
             return m_face_attribute[fid].m_quality / target_quality(fid); // relative quality
         },
         1.0,
-        m_params.stuck_refine_num_worst);
+        m_params.stuck_refine_num_worst,
+        NUM_THREADS);
 
     if (worst.empty()) {
         return 0;
@@ -915,7 +911,6 @@ bool SimWildMeshTri::split_adjust_position(const size_t v_new, const std::vector
 
     for (int i = 0; i < 20; ++i) {
         p = 0.5 * (p0 + p1);
-        m_vertex_attribute[v_new].m_pos = to_rational(p);
         bool inverted = false;
         for (const Tuple& child : children) {
             if (is_inverted(child)) {
@@ -935,7 +930,6 @@ bool SimWildMeshTri::split_adjust_position(const size_t v_new, const std::vector
         if (!is_inverted(child)) continue;
         logger().warn("Voronoi split inverted a face; reverting to the TriWild midpoint");
         p = 0.5 * (m_vertex_attribute[v1].m_posf + m_vertex_attribute[v2].m_posf);
-        m_vertex_attribute[v_new].m_pos = to_rational(p);
         break;
     }
     return true;
@@ -29,9 +29,11 @@ void SimWildMesh::init_from_image(
 
     auto& VA = m_vertex_attribute;
 
+    // A vertex whose exact coordinate is a double starts rounded; the others keep theirs in
+    // m_exact_pos until the rounding below.
     for (int i = 0; i < vert_capacity(); i++) {
-        VA[i].m_pos = V.row(i);
-        VA[i].m_posf = to_double(VA[i].m_pos);
+        const Vector3r p = V.row(i);
+        set_vertex_exact_pos(i, p);
     }
 
     if (m_params.perform_sanity_checks) {
@@ -75,23 +77,13 @@ void SimWildMesh::init_from_image(
 
     // rounding
     {
+        // set_vertex_exact_pos above already told the direct points apart.
         std::vector<char> is_direct_point(vert_capacity(), 0);
-        // Per-vertex, independent: each i writes only its own m_pos/m_posf/
-        // m_is_rounded/is_direct_point; the rational->double conversion and the
-        // exact comparison read only local data.
-        threading::parallel_for(
-            threading::range(0, vert_capacity()),
-            [&](const threading::range& range) {
-                for (size_t i = range.begin(); i < range.end(); ++i) {
-                    const Vector3r& r = VA[i].m_pos;
-                    const Vector3r r_from_d = to_rational(VA[i].m_posf);
-                    is_direct_point[i] = (r_from_d == r);
-                    VA[i].m_is_rounded = is_direct_point[i];
-                }
-            },
-            NUM_THREADS);
+        for (size_t i = 0; i < is_direct_point.size(); ++i) {
+            is_direct_point[i] = VA[i].m_is_rounded;
+        }
 
-        // Round the indirect vertices in parallel. Rounding snaps m_pos to its double
+        // Round the indirect vertices in parallel. Rounding moves a vertex to its double
         // and may not invert any incident tet, so it is not independent across adjacent
         // vertices and the old code did it serially (round() per vertex, an exact-
         // rational inversion check over each vertex's incident tets). Instead, snap all
@@ -105,8 +97,8 @@ void SimWildMesh::init_from_image(
         // all-rational mesh is valid. Direct points are skipped throughout.
         for_each_vertex([&](const Tuple& v) {
             const size_t i = v.vid(*this);
+            // The m_exact_pos entry stays, in case the vertex has to be reverted.
             if (!VA[i].m_is_rounded) {
-                VA[i].m_pos = to_rational(VA[i].m_posf);
                 VA[i].m_is_rounded = true;
             }
         });
@@ -141,7 +133,6 @@ void SimWildMesh::init_from_image(
                     continue;
                 }
                 if (m_vertex_attribute[vid].m_is_rounded) {
-                    m_vertex_attribute[vid].m_pos = V.row(vid);
                     m_vertex_attribute[vid].m_is_rounded = false;
                     m_all_rounded.store(false, std::memory_order_relaxed);
                 }
@@ -165,9 +156,11 @@ void SimWildMesh::init_from_image(
             round(v);
         }
 
+        // The batch left the exact positions of the vertices it rounded behind.
         size_t cnt_round = 0;
         for (const Tuple& v : vertices) {
             if (VA[v.vid(*this)].m_is_rounded) {
+                m_exact_pos.erase(v.vid(*this));
                 ++cnt_round;
             }
         }
@@ -217,7 +210,6 @@ void SimWildMesh::init_from_image(
 
     for (int i = 0; i < vert_capacity(); i++) {
         m_vertex_attribute[i].m_posf = V.row(i);
-        m_vertex_attribute[i].m_pos = to_rational(m_vertex_attribute[i].m_posf);
         m_vertex_attribute[i].m_is_rounded = true;
     }
 
@@ -359,17 +351,17 @@ void SimWildMesh::init_surfaces_and_boundaries()
     for (size_t i = 0; i < faces.size(); i++) {
         const auto vs = get_face_vertices(faces[i]);
         std::array<size_t, 3> vids = {{vs[0].vid(*this), vs[1].vid(*this), vs[2].vid(*this)}};
+        const std::array<Vector3r, 3> ps = {
+            {vertex_exact_pos(vids[0]), vertex_exact_pos(vids[1]), vertex_exact_pos(vids[2])}};
         int on_bbox = -1;
         for (int k = 0; k < 3; k++) {
-            if (m_vertex_attribute[vids[0]].m_pos[k] == m_sim_params.box_min[k] &&
-                m_vertex_attribute[vids[1]].m_pos[k] == m_sim_params.box_min[k] &&
-                m_vertex_attribute[vids[2]].m_pos[k] == m_sim_params.box_min[k]) {
+            if (ps[0][k] == m_sim_params.box_min[k] && ps[1][k] == m_sim_params.box_min[k] &&
+                ps[2][k] == m_sim_params.box_min[k]) {
                 on_bbox = k * 2;
                 break;
             }
-            if (m_vertex_attribute[vids[0]].m_pos[k] == m_sim_params.box_max[k] &&
-                m_vertex_attribute[vids[1]].m_pos[k] == m_sim_params.box_max[k] &&
-                m_vertex_attribute[vids[2]].m_pos[k] == m_sim_params.box_max[k]) {
+            if (ps[0][k] == m_sim_params.box_max[k] && ps[1][k] == m_sim_params.box_max[k] &&
+                ps[2][k] == m_sim_params.box_max[k]) {
                 on_bbox = k * 2 + 1;
                 break;
             }
@@ -36,7 +36,6 @@ void init_homogeneous_quad(Mesh& mesh)
     for (size_t vid = 0; vid < kQuadVertices.size(); ++vid) {
         auto& attr = mesh.m_vertex_attribute[vid];
         attr.m_posf = kQuadVertices[vid];
-        attr.m_pos = wmtk::to_rational(attr.m_posf);
         attr.m_is_rounded = true;
         attr.m_is_on_surface = false;
         attr.m_sizing_scalar = 1.;
@@ -90,7 +89,7 @@ void check_vertex_positions(const OracleMesh& oracle, const SimMesh& sim)
         CHECK(
             (sim.m_vertex_attribute[vid].m_posf - oracle.m_vertex_attribute[vid].m_posf)
                 .squaredNorm() == 0.);
-        CHECK(bool(sim.m_vertex_attribute[vid].m_pos == oracle.m_vertex_attribute[vid].m_pos));
+        CHECK(bool(sim.vertex_exact_pos(vid) == oracle.vertex_exact_pos(vid)));
     }
 }
 
@@ -134,7 +133,7 @@ TEST_CASE(
         CHECK(
             (sim.m_vertex_attribute[vid].m_posf - tri.m_vertex_attribute[vid].m_posf)
                 .squaredNorm() == 0.);
-        CHECK(bool(sim.m_vertex_attribute[vid].m_pos == tri.m_vertex_attribute[vid].m_pos));
+        CHECK(bool(sim.vertex_exact_pos(vid) == tri.vertex_exact_pos(vid)));
     }
     for (const auto& f : sim.get_faces()) {
         CHECK(sim.m_face_attribute[f.fid(sim)].tags == kHomogeneousTag);
@@ -171,7 +170,7 @@ TEST_CASE(
     CHECK(
         (sim.m_vertex_attribute[sim_mid].m_posf - tri.m_vertex_attribute[tri_mid].m_posf)
             .squaredNorm() == 0.);
-    CHECK(bool(sim.m_vertex_attribute[sim_mid].m_pos == tri.m_vertex_attribute[tri_mid].m_pos));
+    CHECK(bool(sim.vertex_exact_pos(sim_mid) == tri.vertex_exact_pos(tri_mid)));
     for (const auto& f : sim.get_faces()) {
         CHECK(sim.m_face_attribute[f.fid(sim)].tags == kHomogeneousTag);
     }
@@ -216,7 +215,6 @@ void init_homogeneous_tet_ring(Mesh& mesh)
     for (size_t vid = 0; vid < kTetRingVertices.size(); ++vid) {
         auto& attr = mesh.m_vertex_attribute[vid];
         attr.m_posf = kTetRingVertices[vid];
-        attr.m_pos = wmtk::to_rational(attr.m_posf);
         attr.m_is_rounded = true;
         attr.m_is_on_surface = false;
         attr.m_order = 0;
@@ -255,7 +253,6 @@ void init_regular_tet_ring(
     }
     for (size_t vid = 0; vid < size_t(n + 2); ++vid) {
         auto& attr = mesh.m_vertex_attribute[vid];
-        attr.m_pos = wmtk::to_rational(attr.m_posf);
         attr.m_is_rounded = true;
         attr.m_is_on_surface = false;
         attr.m_order = 0;
@@ -283,7 +280,6 @@ void init_two_tet_bipyramid(Mesh& mesh)
     for (size_t vid = 0; vid < vertices.size(); ++vid) {
         auto& attr = mesh.m_vertex_attribute[vid];
         attr.m_posf = vertices[vid];
-        attr.m_pos = wmtk::to_rational(attr.m_posf);
         attr.m_is_rounded = true;
         attr.m_is_on_surface = false;
         attr.m_order = 0;
@@ -421,7 +417,7 @@ TEST_CASE(
         CHECK(
             (sim.m_vertex_attribute[vid].m_posf - tet.m_vertex_attribute[vid].m_posf)
                 .squaredNorm() == 0.);
-        CHECK(bool(sim.m_vertex_attribute[vid].m_pos == tet.m_vertex_attribute[vid].m_pos));
+        CHECK(bool(sim.vertex_exact_pos(vid) == tet.vertex_exact_pos(vid)));
     }
     for (const auto& t : sim.get_tets()) {
         CHECK(sim.m_tet_attribute[t.tid(sim)].tags == kHomogeneousTag);
@@ -517,7 +513,7 @@ TEST_CASE(
         CHECK(
             (sim.m_vertex_attribute[vid].m_posf - tri.m_vertex_attribute[vid].m_posf)
                 .squaredNorm() == 0.);
-        CHECK(bool(sim.m_vertex_attribute[vid].m_pos == tri.m_vertex_attribute[vid].m_pos));
+        CHECK(bool(sim.vertex_exact_pos(vid) == tri.vertex_exact_pos(vid)));
     }
     for (const auto& f : sim.get_faces()) {
         CHECK(sim.m_face_attribute[f.fid(sim)].tags == kHomogeneousTag);
@@ -617,7 +613,7 @@ TEST_CASE(
     CHECK(
         (sim.m_vertex_attribute[sim_mid].m_posf - tet.m_vertex_attribute[tet_mid].m_posf)
             .squaredNorm() == 0.);
-    CHECK(bool(sim.m_vertex_attribute[sim_mid].m_pos == tet.m_vertex_attribute[tet_mid].m_pos));
+    CHECK(bool(sim.vertex_exact_pos(sim_mid) == tet.vertex_exact_pos(tet_mid)));
     // This is the behavior that used to differ: SimWild now takes the exact TetWild edge
     // order for the new vertex instead of assigning its own 1/2 heuristic.
     CHECK(sim.m_vertex_attribute[sim_mid].m_order == tet.m_vertex_attribute[tet_mid].m_order);
@@ -755,7 +751,7 @@ TEST_CASE(
         CHECK(
             (sim.m_vertex_attribute[vid].m_posf - tet.m_vertex_attribute[vid].m_posf)
                 .squaredNorm() == 0.);
-        CHECK(bool(sim.m_vertex_attribute[vid].m_pos == tet.m_vertex_attribute[vid].m_pos));
+        CHECK(bool(sim.vertex_exact_pos(vid) == tet.vertex_exact_pos(vid)));
     }
     for (const auto& t : sim.get_tets()) {
         CHECK(sim.m_tet_attribute[t.tid(sim)].tags == kHomogeneousTag);
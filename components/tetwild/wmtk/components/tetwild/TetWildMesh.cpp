@@ -183,7 +183,7 @@ void TetWildMesh::mesh_improvement_legacy(int max_its)
             const auto& VA = m_vertex_attribute[i];
             const auto& VX = m_vertex_extra[i];
             orig::TetVertex& v = legacy_tetwild.tet_vertices[i];
-            v.pos = VA.m_pos;
+            v.pos = vertex_exact_pos(i);
             v.posf = VA.m_posf;
             v.is_on_bbox = !VA.on_bbox_faces.empty();
             if (v.is_on_bbox) {
@@ -250,13 +250,10 @@ void TetWildMesh::mesh_improvement_legacy(int max_its)
             auto& VA = m_vertex_attribute[i];
             auto& VX = m_vertex_extra[i];
             const orig::TetVertex& v = verts[i];
-            VA.m_is_rounded = v.is_rounded;
             if (v.is_rounded) {
-                VA.m_pos = to_rational(v.posf);
-                VA.m_posf = v.posf;
+                set_vertex_pos(i, v.posf);
             } else {
-                VA.m_pos = v.pos;
-                VA.m_posf = to_double(v.pos);
+                set_vertex_exact_pos(i, v.pos);
             }
             VA.m_sizing_scalar = v.adaptive_scale;
             VA.m_is_on_surface = v.is_on_surface;
@@ -328,7 +325,8 @@ size_t TetWildMesh::refine_sizing_around_worst(double max_energy)
         [this](size_t tid) { return tuple_from_tet(tid).is_valid(*this); },
         [this](size_t tid) { return std::cbrt(m_tet_attribute[tid].m_quality); },
         filter_energy,
-        m_params.stuck_refine_num_worst);
+        m_params.stuck_refine_num_worst,
+        NUM_THREADS);
 
     if (worst.empty()) {
         return 0;
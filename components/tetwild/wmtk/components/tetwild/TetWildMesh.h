@@ -169,7 +169,7 @@ public:
         // libstdc++ then aborts on the corrupted heap a few allocations later, while libc++
         // carries on and the tests pass.
         const size_t tcap = std::max(n_tet, m_tet_attribute.size());
-        m_tet_attribute.m_attributes = std::vector<TetAttributes>(tcap);
+        m_tet_attribute.m_attributes.assign(tcap, TetAttributes());
         for (size_t i = 0; i < n_tet; i++) m_tet_attribute[i] = _tet_attribute[i];
         for (size_t i = 0; i < n_tet; i++)
             m_tet_attribute[i].m_quality = get_quality(tuple_from_tet(i));
@@ -184,22 +184,15 @@ void TetWildMesh::init_from_Volumeremesher(
     // work (and can do it in parallel) for the indirect points.
     std::vector<char> is_direct_point(vert_capacity(), 0);
     {
-        // Per-vertex, independent: each i writes only its own m_pos/m_posf/
-        // m_is_rounded/is_direct_point; the rational->double conversion and the
-        // exact comparison read only local data.
+        // Per-vertex, independent: each i writes only its own attributes and
+        // is_direct_point, and m_exact_pos takes concurrent insertions.
+        // set_vertex_exact_pos is what tells a direct point from an indirect one.
         threading::parallel_for(
             threading::range(0, vert_capacity()),
             [&](const threading::range& range) {
                 for (size_t i = range.begin(); i < range.end(); ++i) {
-                    m_vertex_attribute[i].m_pos = v_rational[i];
-                    m_vertex_attribute[i].m_posf = to_double(v_rational[i]);
-                    const Vector3r& rp = m_vertex_attribute[i].m_pos;
-                    const Vector3d& d = m_vertex_attribute[i].m_posf;
-                    const bool direct = (wmtk::Rational(d[0]) == rp[0]) &&
-                                        (wmtk::Rational(d[1]) == rp[1]) &&
-                                        (wmtk::Rational(d[2]) == rp[2]);
-                    is_direct_point[i] = direct ? 1 : 0;
-                    m_vertex_attribute[i].m_is_rounded = direct;
+                    set_vertex_exact_pos(i, v_rational[i]);
+                    is_direct_point[i] = m_vertex_attribute[i].m_is_rounded ? 1 : 0;
                 }
             },
             NUM_THREADS);
@@ -245,17 +238,19 @@ void TetWildMesh::init_from_Volumeremesher(
                     auto vs = get_face_vertices(faces[i]);
                     std::array<size_t, 3> vids = {
                         {vs[0].vid(*this), vs[1].vid(*this), vs[2].vid(*this)}};
+                    // Straight from v_rational: nothing has moved a vertex yet, and it saves
+                    // the m_exact_pos lookups.
                     int on_bbox = -1;
                     for (int k = 0; k < 3; k++) {
-                        if (m_vertex_attribute[vids[0]].m_pos[k] == m_tet_params.box_min[k] &&
-                            m_vertex_attribute[vids[1]].m_pos[k] == m_tet_params.box_min[k] &&
-                            m_vertex_attribute[vids[2]].m_pos[k] == m_tet_params.box_min[k]) {
+                        if (v_rational[vids[0]][k] == m_tet_params.box_min[k] &&
+                            v_rational[vids[1]][k] == m_tet_params.box_min[k] &&
+                            v_rational[vids[2]][k] == m_tet_params.box_min[k]) {
                             on_bbox = k * 2;
                             break;
                         }
-                        if (m_vertex_attribute[vids[0]].m_pos[k] == m_tet_params.box_max[k] &&
-                            m_vertex_attribute[vids[1]].m_pos[k] == m_tet_params.box_max[k] &&
-                            m_vertex_attribute[vids[2]].m_pos[k] == m_tet_params.box_max[k]) {
+                        if (v_rational[vids[0]][k] == m_tet_params.box_max[k] &&
+                            v_rational[vids[1]][k] == m_tet_params.box_max[k] &&
+                            v_rational[vids[2]][k] == m_tet_params.box_max[k]) {
                             on_bbox = k * 2 + 1;
                             break;
                         }
@@ -291,7 +286,7 @@ void TetWildMesh::init_from_Volumeremesher(
         logger().info("{} vertices with order counts (0,1,2,3): {}", vs.size(), vo);
     }
 
-    // Round the indirect vertices in parallel. Rounding snaps m_pos to its double
+    // Round the indirect vertices in parallel. Rounding moves a vertex to its double
     // and may not invert any incident tet, so it is not independent across adjacent
     // vertices and the old code did it serially (round() per vertex, an exact-
     // rational inversion check over each vertex's incident tets). Instead, snap all
@@ -305,8 +300,8 @@ void TetWildMesh::init_from_Volumeremesher(
     // all-rational mesh is valid. Direct points are skipped throughout.
     for_each_vertex([&](const Tuple& v) {
         const size_t i = v.vid(*this);
+        // The m_exact_pos entry stays, in case the vertex has to be reverted.
         if (!VA[i].m_is_rounded) {
-            VA[i].m_pos = to_rational(VA[i].m_posf);
             VA[i].m_is_rounded = true;
         }
     });
@@ -341,7 +336,6 @@ void TetWildMesh::init_from_Volumeremesher(
                 continue;
             }
             if (m_vertex_attribute[vid].m_is_rounded) {
-                m_vertex_attribute[vid].m_pos = v_rational[vid];
                 m_vertex_attribute[vid].m_is_rounded = false;
                 m_all_rounded.store(false, std::memory_order_relaxed);
             }
@@ -365,9 +359,11 @@ void TetWildMesh::init_from_Volumeremesher(
         round(v);
     }
 
+    // The batch left the exact positions of the vertices it rounded behind.
     size_t cnt_round = 0;
     for (const Tuple& v : vertices) {
         if (VA[v.vid(*this)].m_is_rounded) {
+            m_exact_pos.erase(v.vid(*this));
             ++cnt_round;
         }
     }
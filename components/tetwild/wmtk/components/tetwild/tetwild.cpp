@@ -126,6 +126,8 @@ TetWildMesh::ExportStruct tetwild_with_export(nlohmann::json json_params)
     params.coarsen_max_inner_passes = json_params["coarsen_max_inner_passes"];
     params.w_amips = json_params["w_amips"];
     params.smoothing_mode = json_params["smoothing_mode"];
+    params.smoothing_solver = json_params["smoothing_solver"];
+    params.smoothing_engine = json_params["smoothing_engine"];
     params.project_line_search_steps = json_params["project_line_search_steps"];
     params.project_line_search_nested_steps = json_params["project_line_search_nested_steps"];
 
@@ -150,6 +152,11 @@ TetWildMesh::ExportStruct tetwild_with_export(nlohmann::json json_params)
     // Skip good regions.
     params.skip_good_regions = json_params["skip_good_regions"];
     params.skip_good_regions_margin = json_params["skip_good_regions_margin"];
+    params.work_stealing = json_params["work_stealing"];
+    params.scheduler = json_params["scheduler"];
+    params.scheduler_queue = json_params["scheduler_queue"];
+    params.face_adjacency = json_params["face_adjacency"];
+    params.spatial_reorder = json_params["spatial_reorder"];
 
     std::vector<Eigen::Vector3d> verts;
     std::vector<std::array<size_t, 3>> tris;
@@ -360,6 +367,8 @@ TetWildMesh::ExportStruct tetwild_with_export(nlohmann::json json_params)
         /*simplification_ran=*/!skip_simplify);
 
     auto tet_envelope = std::make_shared<wmtk::SampleEnvelope>(!use_sample_envelope);
+    tet_envelope->use_distance_grid = json_params["envelope_distance_grid"];
+    tet_envelope->distance_grid_threads = NUM_THREADS;
     {
         std::vector<Eigen::Vector3d> env_V;
         std::vector<Eigen::Vector3i> env_F;
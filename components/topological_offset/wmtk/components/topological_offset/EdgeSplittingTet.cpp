@@ -305,7 +305,7 @@ bool TopoOffsetTetMesh::marching_split_edge_after(const Tuple& t)
     const std::vector<Tuple> locs = get_one_ring_tets_for_vertex(t);
 
     /// check inversion & rounding
-    set_vertex_position(
+    set_vertex_pos(
         v_id,
         (m_vertex_attribute[v1_id].m_posf + m_vertex_attribute[v2_id].m_posf) / 2);
 
@@ -317,7 +317,7 @@ bool TopoOffsetTetMesh::marching_split_edge_after(const Tuple& t)
 
     // vertex attribute
     m_vertex_extra[v_id] = cache.new_v_extra;
-    set_vertex_position(v_id, cache.new_v_pos);
+    set_vertex_pos(v_id, cache.new_v_pos);
     m_vertex_extra[v_id].m_is_on_input = cache.is_edge_on_input;
     m_vertex_attribute[v_id].on_bbox_faces = wmtk::set_intersection(
         m_vertex_attribute[v1_id].on_bbox_faces,
@@ -468,7 +468,7 @@ bool TopoOffsetTetMesh::split_face_after(const Tuple& t)
     std::array<size_t, 3> splitf_vids = {{v1_id, v2_id, v3_id}};
 
     // new_vertex
-    set_vertex_position(
+    set_vertex_pos(
         v_id,
         (m_vertex_attribute[v1_id].m_posf + m_vertex_attribute[v2_id].m_posf +
          m_vertex_attribute[v3_id].m_posf) /
@@ -584,7 +584,7 @@ bool TopoOffsetTetMesh::split_tet_after(const Tuple& t)
     size_t v_id = vertex_size() - 1;
 
     // new vertex
-    set_vertex_position(
+    set_vertex_pos(
         v_id,
         (m_vertex_attribute[cache.v_ids[0]].m_posf + m_vertex_attribute[cache.v_ids[1]].m_posf +
          m_vertex_attribute[cache.v_ids[2]].m_posf + m_vertex_attribute[cache.v_ids[3]].m_posf) /
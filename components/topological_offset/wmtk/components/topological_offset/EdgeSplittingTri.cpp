@@ -151,7 +151,7 @@ bool TopoOffsetTriMesh::marching_split_edge_after(const Tuple& t)
     // }
     // size_t v_id = edge_split_get_new_vid(cache.v1_id, cache.v2_id, opp_vids);
     m_vertex_extra[v_id] = cache.new_v_extra;
-    set_vertex_position(v_id, cache.new_v_pos);
+    set_vertex_pos(v_id, cache.new_v_pos);
 
     // split edge attributes
     for (const auto& pair : cache.opp_v_fattr) {
@@ -232,7 +232,7 @@ bool TopoOffsetTriMesh::split_face_after(const Tuple& t)
     auto& cache = face_split_cache.local();
     size_t v_id = get_vertices().size() - 1;
     m_vertex_extra[v_id] = cache.new_v_extra;
-    set_vertex_position(v_id, cache.new_v_pos);
+    set_vertex_pos(v_id, cache.new_v_pos);
 
     // existing edges
     for (const auto& pair : cache.existing_eattr) {
@@ -663,19 +663,19 @@ bool TopoOffsetTriMesh::project_offset_vertex(const Tuple& t)
     // The largest fraction of `step` that is accepted, leaving the vertex at that position.
     // Returns -1 if even the zero step is refused, i.e. p0 itself is illegal.
     const auto search = [&](const Vector2d& step) -> double {
-        set_vertex_position(vid, p0 + step);
+        set_vertex_pos(vid, p0 + step);
         if (!rejected()) return 1.;
         double lo = 0., hi = 1.;
         for (int it = 0; it < 10; ++it) {
             const double mid = 0.5 * (lo + hi);
-            set_vertex_position(vid, p0 + mid * step);
+            set_vertex_pos(vid, p0 + mid * step);
             if (rejected()) {
                 hi = mid;
             } else {
                 lo = mid;
             }
         }
-        set_vertex_position(vid, p0 + lo * step);
+        set_vertex_pos(vid, p0 + lo * step);
         return rejected() ? -1. : lo;
     };
 
@@ -696,7 +696,7 @@ bool TopoOffsetTriMesh::project_offset_vertex(const Tuple& t)
             // Which constraint stopped the search: step just past the accepted fraction and see
             // which of the two predicates fires there.
             const double past = std::min(1.0, frac + (1. - frac) * 0.5 + 1e-9);
-            set_vertex_position(vid, p0 + past * (target - p0));
+            set_vertex_pos(vid, p0 + past * (target - p0));
             bool inv = false;
             for (const Tuple& f : ring) {
                 if (is_inverted(f)) {
@@ -709,7 +709,7 @@ bool TopoOffsetTriMesh::project_offset_vertex(const Tuple& t)
             } else {
                 ++m_smooth_trace.offset_clamp_env;
             }
-            set_vertex_position(vid, p); // restore the accepted position
+            set_vertex_pos(vid, p); // restore the accepted position
         }
     };
 
@@ -754,7 +754,7 @@ bool TopoOffsetTriMesh::project_offset_vertex(const Tuple& t)
 
             minimize_distance_along_tangent(vid, p0, tang, cap, rejected);
             if (dist_err(m_vertex_attribute[vid].m_posf) >= e_scaled) {
-                set_vertex_position(vid, p_scaled); // no better; keep the scaled result
+                set_vertex_pos(vid, p_scaled); // no better; keep the scaled result
             } else {
                 ++m_smooth_trace.offset_slid;
             }
@@ -824,7 +824,7 @@ double TopoOffsetTriMesh::minimize_distance_along_tangent(
 {
     const auto err_at = [&](const double s) {
         const Vector2d p = p0 + s * tang;
-        set_vertex_position(vid, p);
+        set_vertex_pos(vid, p);
         if (rejected()) return std::numeric_limits<double>::infinity();
         const Vector3d n3 = m_input_complex_bvh.nearest_point(VectorXd(p));
         return std::abs((p - Vector2d(n3[0], n3[1])).norm() - m_offset_params.target_distance);
@@ -838,7 +838,7 @@ double TopoOffsetTriMesh::minimize_distance_along_tangent(
         double good = 0., bad = cap;
         bool found_bad = false;
         for (double s = cap / 64.; s <= cap * 1.0000001; s *= 2.) {
-            set_vertex_position(vid, p0 + (sign * s) * tang);
+            set_vertex_pos(vid, p0 + (sign * s) * tang);
             if (rejected()) {
                 bad = s;
                 found_bad = true;
@@ -849,7 +849,7 @@ double TopoOffsetTriMesh::minimize_distance_along_tangent(
         if (!found_bad) return good; // the whole capped range is feasible
         for (int i = 0; i < 12; ++i) {
             const double mid = 0.5 * (good + bad);
-            set_vertex_position(vid, p0 + (sign * mid) * tang);
+            set_vertex_pos(vid, p0 + (sign * mid) * tang);
             if (rejected()) {
                 bad = mid;
             } else {
@@ -861,7 +861,7 @@ double TopoOffsetTriMesh::minimize_distance_along_tangent(
 
     double a = -extent(-1.), b = extent(1.);
     if (b - a < 1e-15) {
-        set_vertex_position(vid, p0);
+        set_vertex_pos(vid, p0);
         return 0.;
     }
 
@@ -888,7 +888,7 @@ double TopoOffsetTriMesh::minimize_distance_along_tangent(
         }
     }
     const double s_best = (fc <= fd) ? c : d;
-    set_vertex_position(vid, p0 + s_best * tang);
+    set_vertex_pos(vid, p0 + s_best * tang);
     return s_best;
 }
 
@@ -137,7 +137,7 @@ bool TopoOffsetTetMesh::smooth_after_offset_surface(const Tuple& t)
     // Move the vertex to `target`; if that inverts an incident tet, binary search along the
     // segment from the known-valid p0 to `target` for the furthest point that does not.
     auto move_to = [&](const Vector3d& target) {
-        set_vertex_position(vid, target);
+        set_vertex_pos(vid, target);
         if (!any_inverted()) return;
 
         double lo = 0.; // m_posf = p0 + lo * (target - p0), always valid
@@ -145,14 +145,14 @@ bool TopoOffsetTetMesh::smooth_after_offset_surface(const Tuple& t)
         constexpr int max_iters = 10;
         for (int iter = 0; iter < max_iters; ++iter) {
             const double mid = 0.5 * (lo + hi);
-            set_vertex_position(vid, p0 + mid * (target - p0));
+            set_vertex_pos(vid, p0 + mid * (target - p0));
             if (any_inverted()) {
                 hi = mid;
             } else {
                 lo = mid;
             }
         }
-        set_vertex_position(vid, p0 + lo * (target - p0));
+        set_vertex_pos(vid, p0 + lo * (target - p0));
     };
 
     // Laplacian smoothing, restricted to neighbors that are also on the offset surface --
@@ -95,7 +95,7 @@ void TopoOffsetTetMesh::init_from_image(
     const auto& verts = get_vertices();
     for (const Tuple& v : verts) {
         size_t v_id = v.vid(*this);
-        set_vertex_position(v_id, V.row(v_id));
+        set_vertex_pos(v_id, V.row(v_id));
     }
 
     init_surfaces_and_boundaries();
@@ -200,27 +200,6 @@ public:
         m_face_extra[fid] = s.extra;
     }
 
-    /**
-     * @brief Place a vertex, keeping its exact and rounded coordinates in step.
-     *
-     * The offset works in doubles throughout -- its construction is driven by a BVH distance
-     * field to the input complex, which has no exact form -- so every vertex it places is
-     * rounded, and its rational position is just the exact value of the double it carries.
-     *
-     * Filling m_pos anyway is not bookkeeping for its own sake. The shared split falls back to
-     * the EXACT midpoint when the double one would invert an incident tet, which is what lets a
-     * degenerate region keep being refined instead of the split being refused; that fallback
-     * reads the endpoints' m_pos, and every quality and orientation test around an un-rounded
-     * vertex reads its neighbours'. A vertex placed here with a stale m_pos would silently feed
-     * those the wrong point.
-     */
-    void set_vertex_position(const size_t vid, const Vector3d& p)
-    {
-        m_vertex_attribute[vid].m_posf = p;
-        m_vertex_attribute[vid].m_pos = to_rational(p);
-        m_vertex_attribute[vid].m_is_rounded = true;
-    }
-
     /**
      * @brief Whether tet `tid` belongs to the closed offset region, read from its TAGS.
      *
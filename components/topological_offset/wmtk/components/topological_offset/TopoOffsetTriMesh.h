@@ -151,20 +151,6 @@ public:
 
     ~TopoOffsetTriMesh() override = default;
 
-    /**
-     * @brief Place a vertex, keeping its exact and rounded coordinates in step.
-     *
-     * As in 3D: the offset works in doubles (its construction is driven by a BVH distance
-     * field), so every vertex it places is rounded, but m_pos must still be filled because the
-     * shared split's exact-midpoint fallback reads it.
-     */
-    void set_vertex_position(const size_t vid, const Vector2d& p)
-    {
-        m_vertex_attribute[vid].m_posf = p;
-        m_vertex_attribute[vid].m_pos = to_rational(p);
-        m_vertex_attribute[vid].m_is_rounded = true;
-    }
-
     /// Whether edge `eid` is on the offset boundary / carries input geometry / bounds some other
     /// tag region.
     bool edge_is_offset(const size_t eid) const
@@ -60,9 +60,9 @@ void TriWildMesh::init_mesh(
     m_edge_attribute.resize(F.rows() * 3);
 
     // Take the arrangement's EXACT positions, and round separately -- the 2D counterpart of
-    // what VolumemesherInsertion does with v_rational. m_pos used to be to_rational(V.row(i)),
-    // i.e. the rounded double converted back, which silently threw the arrangement's
-    // exactness away before anything could use it.
+    // what VolumemesherInsertion does with v_rational. The exact position used to be
+    // to_rational(V.row(i)), i.e. the rounded double converted back, which silently threw
+    // the arrangement's exactness away before anything could use it.
     //
     // A vertex whose coordinates happen to have an exact double representation ("direct")
     // rounds for free: snapping it changes nothing, so it cannot invert a triangle. The rest
@@ -71,21 +71,15 @@ void TriWildMesh::init_mesh(
     assert(V_rational.empty() || V_rational.size() == size_t(V.rows()));
     size_t n_indirect = 0;
     for (int i = 0; i < vert_capacity(); i++) {
-        auto& va = m_vertex_attribute[i];
         if (V_rational.empty()) {
             // No exact input available (a caller that only has doubles, e.g. a unit test).
-            va.m_pos = to_rational(Vector2d(V.row(i)));
-            va.m_posf = V.row(i);
-            va.m_is_rounded = true;
+            set_vertex_pos(i, Vector2d(V.row(i)));
             continue;
         }
-        va.m_pos = V_rational[i];
-        va.m_posf = Vector2d(V_rational[i][0].to_double(), V_rational[i][1].to_double());
-        va.m_is_rounded =
-            (Rational(va.m_posf[0]) == va.m_pos[0]) && (Rational(va.m_posf[1]) == va.m_pos[1]);
-        if (!va.m_is_rounded) {
+        // Tells direct from indirect, and keeps the exact position of the latter.
+        set_vertex_exact_pos(i, V_rational[i]);
+        if (!m_vertex_attribute[i].m_is_rounded) {
             ++n_indirect;
-            m_all_rounded.store(false, std::memory_order_relaxed);
         }
     }
     if (n_indirect > 0) {
@@ -107,7 +101,7 @@ void TriWildMesh::init_mesh(
     // one. Count instead, and say what was found. Same acceptance -- an all-positive mesh
     // passes, anything else throws -- only the message changed.
     //
-    // The orientation is judged in EXACT arithmetic, on m_pos, not on the rounded m_posf.
+    // The orientation is judged in EXACT arithmetic, on vertex_exact_pos, not on m_posf.
     // Judging it on doubles is what used to make about a third of the 20k 2D dataset
     // unusable: two arrangement vertices that are exactly distinct can round to the same
     // double, and any triangle using both then looks exactly degenerate even though the
@@ -119,9 +113,9 @@ void TriWildMesh::init_mesh(
     for (const Tuple& t : get_faces()) {
         const size_t fid = t.fid(*this);
         const auto vs = oriented_tri_vids(fid);
-        const Vector2r& p0 = m_vertex_attribute[vs[0]].m_pos;
-        const Vector2r& p1 = m_vertex_attribute[vs[1]].m_pos;
-        const Vector2r& p2 = m_vertex_attribute[vs[2]].m_pos;
+        const Vector2r p0 = vertex_exact_pos(vs[0]);
+        const Vector2r p1 = vertex_exact_pos(vs[1]);
+        const Vector2r p2 = vertex_exact_pos(vs[2]);
         const Rational d = (p1[0] - p0[0]) * (p2[1] - p0[1]) - (p1[1] - p0[1]) * (p2[0] - p0[0]);
         if (!(d > 0)) {
             if (d == 0) {
@@ -277,15 +271,15 @@ void TriWildMesh::init_mesh(
     const auto edges = get_edges();
     for (size_t i = 0; i < edges.size(); i++) {
         const auto vids = get_edge_vids(edges[i]);
+        const Vector2r p0 = vertex_exact_pos(vids[0]);
+        const Vector2r p1 = vertex_exact_pos(vids[1]);
         int on_bbox = -1;
         for (int k = 0; k < 2; k++) {
-            if (m_vertex_attribute[vids[0]].m_pos[k] == domain_min[k] &&
-                m_vertex_attribute[vids[1]].m_pos[k] == domain_min[k]) {
+            if (p0[k] == domain_min[k] && p1[k] == domain_min[k]) {
                 on_bbox = k * 2;
                 break;
             }
-            if (m_vertex_attribute[vids[0]].m_pos[k] == domain_max[k] &&
-                m_vertex_attribute[vids[1]].m_pos[k] == domain_max[k]) {
+            if (p0[k] == domain_max[k] && p1[k] == domain_max[k]) {
                 on_bbox = k * 2 + 1;
                 break;
             }
@@ -347,7 +341,8 @@ size_t TriWildMesh::refine_sizing_around_worst(double max_energy)
         [this](size_t fid) { return tuple_from_tri(fid).is_valid(*this); },
         [this](size_t fid) { return m_face_attribute[fid].m_quality; },
         filter_energy,
-        m_params.stuck_refine_num_worst);
+        m_params.stuck_refine_num_worst,
+        NUM_THREADS);
 
     if (worst.empty()) {
         return 0;
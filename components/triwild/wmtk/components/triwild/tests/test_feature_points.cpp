@@ -31,7 +31,6 @@ void build_one_tri(TriWildMesh& mesh, const std::array<Vector2d, 3>& p)
     for (int i = 0; i < 3; ++i) {
         auto& va = mesh.m_vertex_attribute[i];
         va.m_posf = p[i];
-        va.m_pos = to_rational(p[i]);
         va.m_is_rounded = true;
     }
 }
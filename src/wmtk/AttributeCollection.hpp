@@ -2,18 +2,32 @@
 
 #include <wmtk/utils/VectorUtils.h>
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/SegmentedVector.hpp>
 
 #include <wmtk/threading/enumerable_thread_specific.hpp>
+#include <wmtk/threading/parallel_for.hpp>
+#include <wmtk/threading/spin_mutex.hpp>
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <unordered_map>
 #include <vector>
 
 namespace wmtk {
+namespace detail {
+inline std::atomic<std::uint64_t>& attribute_collection_uid()
+{
+    static std::atomic<std::uint64_t> counter{1};
+    return counter;
+}
+} // namespace detail
+
 /**
  * @brief serving as buffers for attributes data that can be modified by operations
  *
@@ -23,7 +37,36 @@ class AbstractAttributeContainer
 public:
     virtual ~AbstractAttributeContainer() = default;
     virtual void move(size_t from, size_t to) {};
+    /**
+     * @brief Renumber the elements for consolidate_mesh: afterwards element `k * stride + j`
+     * holds what element `new_to_old[k] * stride + j` held, for every k and j < stride, and
+     * there is room for `capacity * stride` elements.
+     *
+     * `stride` is the number of elements per mesh entity: 1 for vertex and cell attributes,
+     * and e.g. 6 for the edge attributes of a TetMesh, which are stored per tet. The default
+     * goes through move() one element at a time, which is only correct when `new_to_old` is
+     * increasing -- a plain compaction, never a reordering.
+     */
+    virtual void gather(
+        const std::vector<size_t>& new_to_old,
+        size_t stride,
+        size_t capacity,
+        int num_threads)
+    {
+        assert(std::is_sorted(new_to_old.begin(), new_to_old.end()));
+        for (size_t k = 0; k < new_to_old.size(); ++k) {
+            for (size_t j = 0; j < stride; ++j) move(new_to_old[k] * stride + j, k * stride + j);
+        }
+        resize(capacity * stride);
+    }
     virtual void resize(size_t) = 0;
+    /**
+     * @brief Make room for at least `s` elements while operations are running: unlike
+     * resize, this must be safe to call concurrently with itself and with element access.
+     * A container that cannot do that returns false (the default), and the mesh operation
+     * that needed the room fails as if the mesh were out of preallocated slots.
+     */
+    virtual bool grow(size_t s) { return false; }
     virtual void clear() = 0;
     virtual void rollback() = 0;
     virtual void begin_protect() = 0;
@@ -39,22 +82,44 @@ struct AttributeCollection : public AbstractAttributeContainer
         if (from == to) return;
         m_attributes[to] = std::move(m_attributes[from]);
     }
+    // Out of place, so any permutation works and the elements can be moved in parallel.
+    void gather(
+        const std::vector<size_t>& new_to_old,
+        size_t stride,
+        size_t capacity,
+        int num_threads) override
+    {
+        SegmentedVector<T> out(std::max(capacity, new_to_old.size()) * stride);
+        threading::parallel_for(
+            threading::range(0, new_to_old.size(), 1024),
+            [&](const threading::range& r) {
+                for (size_t k = r.begin(); k < r.end(); ++k) {
+                    for (size_t j = 0; j < stride; ++j) {
+                        out[k * stride + j] = std::move(m_attributes[new_to_old[k] * stride + j]);
+                    }
+                }
+            },
+            num_threads);
+        m_attributes.swap(out);
+    }
     // In the preallocated model this sets the storage capacity: it is called
     // (single-threaded) at init / consolidation with the reserved size. It is
     // grow-only so live data below `s` is never dropped. During operations the
-    // storage is never resized -- operations only fail when they run out of the
-    // preallocated slots.
+    // storage only grows through grow(), when a mesh runs out of preallocated slots.
     void resize(size_t s) override
     {
         if (s > m_attributes.size()) m_attributes.resize(s);
     }
+    bool grow(size_t s) override
+    {
+        m_attributes.grow_to_at_least(s);
+        return true;
+    }
     void clear() override { m_attributes.clear(); }
 
     bool assign(size_t to, T&& val) // always use this in OP_after
     {
-        m_attributes[to] = val;
-        if (recording.local()) m_rollback_list.local()[to] = val;
-        // TODO: are locks necessary? not now.
+        (*this)[to] = std::move(val);
         return true;
     }
     /**
@@ -63,8 +128,11 @@ struct AttributeCollection : public AbstractAttributeContainer
      */
     void rollback() override
     {
-        for (auto& [i, v] : m_rollback_list.local()) {
-            m_attributes[i] = std::move(v);
+        UndoLog& log = undo_log();
+        // Newest first, so an element logged twice ends up with the older value.
+        using std::swap;
+        for (size_t k = log.size; k-- > 0;) {
+            swap(m_attributes[log.indices[k]], log.values[k]);
         }
         end_protect();
     }
@@ -74,8 +142,9 @@ struct AttributeCollection : public AbstractAttributeContainer
      */
     void begin_protect() override
     {
-        m_rollback_list.local().clear();
-        recording.local() = true;
+        UndoLog& log = undo_log();
+        log.size = 0;
+        log.recording = true;
     };
     /**
      * @brief clear local buffers and finish recording
@@ -83,8 +152,9 @@ struct AttributeCollection : public AbstractAttributeContainer
      */
     void end_protect() override
     {
-        m_rollback_list.local().clear();
-        recording.local() = false;
+        UndoLog& log = undo_log();
+        log.size = 0;
+        log.recording = false;
     }
 
     const T& at(size_t i) const { return m_attributes[i]; }
@@ -93,18 +163,262 @@ struct AttributeCollection : public AbstractAttributeContainer
 
     T& operator[](size_t i)
     {
-        if (recording.local()) {
-            m_rollback_list.local().emplace(i, m_attributes[i]);
-        }
+        UndoLog& log = undo_log();
+        if (log.recording) log.save(i, m_attributes[i]);
         return m_attributes[i];
     }
 
 
     size_t size() const { return m_attributes.size(); }
-    wmtk::threading::enumerable_thread_specific<std::unordered_map<size_t, T>> m_rollback_list;
-    // Plain preallocated storage: never grows during operations.
-    std::vector<T> m_attributes;
-    wmtk::threading::enumerable_thread_specific<bool> recording{false};
+    // Preallocated, and segmented so that grow() can extend it under running operations
+    // without moving the elements they hold references to.
+    SegmentedVector<T> m_attributes;
+
+private:
+    /**
+     * The values a thread's running operation overwrote, in the order it first touched them.
+     *
+     * Append-only while the operation runs, and emptied by resetting `size`, so committing costs
+     * nothing whatever the operation touched. The entries past `size` are kept rather than
+     * destroyed: the next operation copies into them, and for attributes that own memory
+     * (rationals, vectors) that copy reuses what the previous one allocated.
+     */
+    struct UndoLog
+    {
+        bool recording = false;
+        size_t size = 0;
+        std::vector<size_t> indices;
+        std::vector<T> values;
+
+        void save(size_t i, const T& v)
+        {
+            // Only the first write to an element needs its old value. Operations touch a few
+            // elements, so a scan finds repeats; past that the log takes them as they come,
+            // which rollback's reverse order makes harmless.
+            if (size <= 64) {
+                for (size_t k = 0; k < size; ++k) {
+                    if (indices[k] == i) return;
+                }
+            }
+            if (size == indices.size()) {
+                indices.push_back(i);
+                values.push_back(v);
+            } else {
+                indices[size] = i;
+                values[size] = v;
+            }
+            ++size;
+        }
+    };
+
+    // The calling thread's log. enumerable_thread_specific::local() scans the thread's slots,
+    // so the result is cached per thread: the accesses of one operation all hit the cache,
+    // and only a thread switching between collections of the same type looks it up again.
+    UndoLog& undo_log()
+    {
+        struct Cache
+        {
+            std::uint64_t uid = 0;
+            UndoLog* log = nullptr;
+        };
+        static thread_local Cache cache;
+        if (cache.uid != m_uid) cache = {m_uid, &m_undo.local()};
+        return *cache.log;
+    }
+
+    // Never reused, unlike the address, so a cache entry cannot outlive its collection.
+    const std::uint64_t m_uid = detail::attribute_collection_uid().fetch_add(1);
+    wmtk::threading::enumerable_thread_specific<UndoLog> m_undo;
+};
+
+/**
+ * @brief An attribute only a few elements carry, stored by element id.
+ *
+ * An AttributeCollection pays for its value type on every slot, live or not. For a field that
+ * is absent almost everywhere -- the exact rational position of an un-rounded vertex is the
+ * case this was written for -- that is the wrong trade: the dense column is mostly default
+ * values, which for a rational still cost an allocation each, and it is copied through every
+ * undo log and consolidation. Here an element that has no value costs nothing.
+ *
+ * The entries live in hash maps sharded by id, each behind a spin lock, so operations running
+ * in parallel can insert and erase concurrently; two threads writing the same element must be
+ * kept apart by the caller, as for AttributeCollection (the mesh's vertex locks do). find()
+ * copies the value out under the lock, because an insertion into the same shard may rehash it.
+ *
+ * Rollback works like AttributeCollection's: while protected, every set/erase records the
+ * entry it replaced in a per-thread log, and rollback restores them newest first. resize and
+ * grow have nothing to allocate; gather renumbers the ids and drops the entries of removed
+ * elements.
+ */
+template <typename T>
+class SparseAttributeCollection : public AbstractAttributeContainer
+{
+public:
+    /// The value of element i, if it has one.
+    std::optional<T> find(size_t i) const
+    {
+        const Shard& s = shard(i);
+        std::lock_guard<threading::spin_mutex> lock(s.mutex);
+        const auto it = s.map.find(i);
+        if (it == s.map.end()) return std::nullopt;
+        return it->second;
+    }
+    bool contains(size_t i) const
+    {
+        const Shard& s = shard(i);
+        std::lock_guard<threading::spin_mutex> lock(s.mutex);
+        return s.map.count(i) > 0;
+    }
+
+    void set(size_t i, const T& v)
+    {
+        Shard& s = shard(i);
+        std::lock_guard<threading::spin_mutex> lock(s.mutex);
+        auto it = s.map.find(i);
+        save(i, it == s.map.end() ? nullptr : &it->second);
+        if (it == s.map.end()) {
+            s.map.emplace(i, v);
+        } else {
+            it->second = v;
+        }
+    }
+    void erase(size_t i)
+    {
+        Shard& s = shard(i);
+        std::lock_guard<threading::spin_mutex> lock(s.mutex);
+        auto it = s.map.find(i);
+        if (it == s.map.end()) return;
+        save(i, &it->second);
+        s.map.erase(it);
+    }
+
+    /// The number of elements that have a value. Not synchronised with concurrent writers.
+    size_t size() const
+    {
+        size_t n = 0;
+        for (const Shard& s : m_shards) n += s.map.size();
+        return n;
+    }
+
+    void move(size_t from, size_t to) override
+    {
+        if (from == to) return;
+        std::optional<T> v = find(from);
+        erase(from);
+        if (v) {
+            set(to, *v);
+        } else {
+            erase(to);
+        }
+    }
+    // Only ever registered for vertices or cells, so stride is 1. Serial: the point of the
+    // collection is that it holds few entries.
+    void gather(
+        const std::vector<size_t>& new_to_old,
+        size_t stride,
+        size_t capacity,
+        int num_threads) override
+    {
+        assert(stride == 1);
+        std::unordered_map<size_t, size_t> old_to_new;
+        old_to_new.reserve(size());
+        for (const Shard& s : m_shards) {
+            for (const auto& [i, v] : s.map) old_to_new.emplace(i, size_t(-1));
+        }
+        for (size_t k = 0; k < new_to_old.size(); ++k) {
+            auto it = old_to_new.find(new_to_old[k]);
+            if (it != old_to_new.end()) it->second = k;
+        }
+        std::array<Shard, n_shards> out;
+        for (Shard& s : m_shards) {
+            for (auto& [i, v] : s.map) {
+                const size_t k = old_to_new.at(i);
+                if (k != size_t(-1)) out[k % n_shards].map.emplace(k, std::move(v));
+            }
+            s.map.clear();
+        }
+        for (size_t j = 0; j < n_shards; ++j) m_shards[j].map.swap(out[j].map);
+    }
+    void resize(size_t) override {}
+    bool grow(size_t) override { return true; }
+    void clear() override
+    {
+        for (Shard& s : m_shards) s.map.clear();
+    }
+
+    void rollback() override
+    {
+        UndoLog& log = undo_log();
+        for (size_t k = log.entries.size(); k-- > 0;) {
+            auto& [i, v] = log.entries[k];
+            Shard& s = shard(i);
+            std::lock_guard<threading::spin_mutex> lock(s.mutex);
+            if (v) {
+                s.map[i] = std::move(*v);
+            } else {
+                s.map.erase(i);
+            }
+        }
+        end_protect();
+    }
+    void begin_protect() override
+    {
+        UndoLog& log = undo_log();
+        log.entries.clear();
+        log.recording = true;
+    }
+    void end_protect() override
+    {
+        UndoLog& log = undo_log();
+        log.entries.clear();
+        log.recording = false;
+    }
+
+private:
+    static constexpr size_t n_shards = 64;
+    struct Shard
+    {
+        mutable threading::spin_mutex mutex;
+        std::unordered_map<size_t, T> map;
+    };
+    struct UndoLog
+    {
+        bool recording = false;
+        // The element and what it held before, nullopt if nothing.
+        std::vector<std::pair<size_t, std::optional<T>>> entries;
+    };
+
+    // Cached per thread as in AttributeCollection: begin_protect and end_protect run for every
+    // operation, whether or not it touches this collection.
+    UndoLog& undo_log()
+    {
+        struct Cache
+        {
+            std::uint64_t uid = 0;
+            UndoLog* log = nullptr;
+        };
+        static thread_local Cache cache;
+        if (cache.uid != m_uid) cache = {m_uid, &m_undo.local()};
+        return *cache.log;
+    }
+
+    Shard& shard(size_t i) { return m_shards[i % n_shards]; }
+    const Shard& shard(size_t i) const { return m_shards[i % n_shards]; }
+
+    void save(size_t i, const T* old)
+    {
+        UndoLog& log = undo_log();
+        if (!log.recording) return;
+        if (old) {
+            log.entries.emplace_back(i, *old);
+        } else {
+            log.entries.emplace_back(i, std::nullopt);
+        }
+    }
+
+    std::array<Shard, n_shards> m_shards;
+    const std::uint64_t m_uid = detail::attribute_collection_uid().fetch_add(1);
+    wmtk::threading::enumerable_thread_specific<UndoLog> m_undo;
 };
 
 /**
@@ -137,10 +451,25 @@ public:
     {
         for (auto* c : m_children) c->move(from, to);
     }
+    void gather(
+        const std::vector<size_t>& new_to_old,
+        size_t stride,
+        size_t capacity,
+        int num_threads) override
+    {
+        for (auto* c : m_children) c->gather(new_to_old, stride, capacity, num_threads);
+    }
     void resize(size_t s) override
     {
         for (auto* c : m_children) c->resize(s);
     }
+    bool grow(size_t s) override
+    {
+        for (auto* c : m_children) {
+            if (!c->grow(s)) return false;
+        }
+        return true;
+    }
     void clear() override
     {
         for (auto* c : m_children) c->clear();
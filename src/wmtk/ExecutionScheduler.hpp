@@ -3,7 +3,11 @@
 #include <wmtk/TetMesh.h>
 #include <wmtk/TriMesh.h>
 #include <wmtk/threading/concurrent_priority_queue.hpp>
+#include <wmtk/threading/enumerable_thread_specific.hpp>
+#include <wmtk/threading/parallel_for.hpp>
+#include <wmtk/threading/selectable_heap.hpp>
 #include <wmtk/threading/serial_priority_queue.hpp>
+#include <wmtk/threading/stealable_priority_queue.hpp>
 #include <wmtk/threading/task_group.hpp>
 #include <wmtk/utils/Logger.hpp>
 
@@ -19,20 +23,116 @@
 #include <cassert>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <queue>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace wmtk {
 enum class ExecutionPolicy { kSeq, kUnSeq, kPartition, kColor, kMax };
 
 using Op = std::string;
 
+/**
+ * @brief An operation as ExecutePass::operation() hands it out: an index into that pass's
+ * table of operation names.
+ *
+ * Four bytes, copied and compared as an integer, which is what the `*_by_handle` callbacks
+ * receive and return where the string callbacks traffic in names. Only meaningful to the
+ * ExecutePass that issued it.
+ */
+struct OpHandle
+{
+    static constexpr uint32_t invalid = std::numeric_limits<uint32_t>::max();
+    uint32_t id = invalid;
+
+    bool valid() const { return id != invalid; }
+    friend bool operator==(const OpHandle a, const OpHandle b) { return a.id == b.id; }
+    friend bool operator!=(const OpHandle a, const OpHandle b) { return a.id != b.id; }
+};
+
+/**
+ * @brief What a pass-traits type may provide, detected at compile time. See the traits form of
+ * `ExecutePass::operator()` for what each hook means.
+ */
+namespace pass_traits {
+template <class Void, template <class...> class Hook, class... Args>
+struct detector : std::false_type
+{
+};
+template <template <class...> class Hook, class... Args>
+struct detector<std::void_t<Hook<Args...>>, Hook, Args...> : std::true_type
+{
+};
+/// Whether the traits `T` provide `Hook` for the mesh `M`.
+template <template <class...> class Hook, class T, class M>
+constexpr bool provides = detector<void, Hook, T, M>::value;
+
+template <class M>
+using Tuple = typename M::Tuple;
+
+template <class T, class M>
+using priority_t = decltype(std::declval<T&>().priority(
+    std::declval<const M&>(),
+    OpHandle(),
+    std::declval<const Tuple<M>&>()));
+template <class T, class M>
+using should_renew_t = decltype(std::declval<T&>().should_renew(0.));
+template <class T, class M>
+using renew_neighbor_tuples_t = decltype(std::declval<T&>().renew_neighbor_tuples(
+    std::declval<const M&>(),
+    OpHandle(),
+    std::declval<const std::vector<Tuple<M>>&>(),
+    std::declval<void (&)(OpHandle, const Tuple<M>&)>()));
+template <class T, class M>
+using lock_vertices_t = decltype(std::declval<T&>().lock_vertices(
+    std::declval<M&>(),
+    std::declval<const Tuple<M>&>(),
+    0));
+template <class T, class M>
+using is_weight_up_to_date_t = decltype(std::declval<T&>().is_weight_up_to_date(
+    std::declval<const M&>(),
+    std::declval<const std::tuple<double, OpHandle, Tuple<M>>&>()));
+template <class T, class M>
+using apply_t = decltype(std::declval<T&>().apply(
+    std::declval<M&>(),
+    OpHandle(),
+    std::declval<const Tuple<M>&>()));
+template <class T, class M>
+using on_fail_t = decltype(std::declval<T&>().on_fail(
+    std::declval<const M&>(),
+    OpHandle(),
+    std::declval<const Tuple<M>&>()));
+template <class T, class M>
+using has_operation_t = decltype(std::declval<const T&>().has_operation(OpHandle()));
+template <class T, class M>
+using renew_key_t = decltype(std::declval<T&>().renew_key(
+    std::declval<const M&>(),
+    OpHandle(),
+    std::declval<const Tuple<M>&>()));
+template <class T, class M>
+using dedups_renewals_t = decltype(std::declval<const T&>().dedups_renewals());
+
+/// Traits that provide nothing: every hook comes from the executor's members.
+struct None
+{
+};
+} // namespace pass_traits
+
 template <class AppMesh>
 struct ExecutePass
 {
     using Tuple = typename AppMesh::Tuple;
+    using OperationFn = std::function<std::optional<std::vector<Tuple>>(AppMesh&, const Tuple&)>;
+    using OpTuple = std::pair<OpHandle, Tuple>;
     /**
      * @brief A dictionary that registers names with operations.
      *
@@ -115,6 +215,99 @@ struct ExecutePass
     std::function<void(const AppMesh&, Op, const Tuple& t)> on_fail =
         [](const AppMesh&, Op, const Tuple& t) {};
 
+    /**
+     * @brief The four callbacks above, taking and returning an OpHandle instead of a name.
+     *
+     * The string forms cost a std::string copy per call and, for every tuple renewed, a
+     * string-keyed map lookup to find the operation again -- in a collapse pass that renews a
+     * dozen edges per success, that is most of the scheduler's own time outside the queue.
+     * Handles cost neither. Each one that is set replaces its string counterpart; each one
+     * left empty falls back to it, called with the handle's name, so a driver can move over one
+     * callback at a time and the string API keeps working unchanged on top.
+     *
+     * Get the handles from `operation()` before the pass and capture them; nothing may
+     * register an operation while a pass runs.
+     */
+    std::function<double(const AppMesh&, OpHandle, const Tuple&)> priority_by_handle;
+    std::function<std::vector<OpTuple>(const AppMesh&, OpHandle, const std::vector<Tuple>&)>
+        renew_neighbor_tuples_by_handle;
+    std::function<bool(const AppMesh&, const std::tuple<double, OpHandle, Tuple>&)>
+        is_weight_up_to_date_by_handle;
+    std::function<void(const AppMesh&, OpHandle, const Tuple&)> on_fail_by_handle;
+
+    /**
+     * @brief Identify a renewed operation, so that one operation's renewals are queued once
+     * each. Empty (the default) queues whatever the renewal emits.
+     *
+     * A renewal that walks the new elements and emits their edges emits an edge once per
+     * element it borders -- triwild's split renews the three edges of every new triangle, so
+     * each spoke twice -- and every copy costs a priority evaluation, a queue slot, and later a
+     * pop and a validity check, or a second attempt at an operation that just failed. With a
+     * key, the scheduler drops all but one of the renewals with the same operation and key
+     * before computing any priority.
+     *
+     * Equal keys for the same operation must mean the same operation with the same priority:
+     * an undirected edge's two vertex ids for a split, the directed pair for a collapse. Of
+     * the copies the one kept is the greatest Tuple, the one the queue would have popped first,
+     * so the pass runs what it ran before and only skips the repeats.
+     *
+     * Only duplicates within one operation's renewals are found; an element renewed again by a
+     * later operation is still queued again, which it has to be if its priority changed.
+     * `PassStats::renew_duplicates` says how many were dropped.
+     */
+    std::function<uint64_t(const AppMesh&, OpHandle, const Tuple&)> renew_key_by_handle;
+
+    /**
+     * @brief The handle of the operation named @p name, adding the name to the table on first
+     * use. The same name always gets the same handle.
+     *
+     * A name need not be in `edit_operation_maps` yet, but must be by the time a pass uses it;
+     * an operation that is still missing then is an error, as it always was.
+     */
+    OpHandle operation(const Op& name)
+    {
+        const auto [it, inserted] = m_op_index.emplace(name, uint32_t(m_op_names.size()));
+        if (inserted) {
+            m_op_names.push_back(name);
+        }
+        return OpHandle{it->second};
+    }
+    /// Add (or replace) an operation and return its handle.
+    OpHandle register_operation(const Op& name, OperationFn fn)
+    {
+        edit_operation_maps[name] = std::move(fn);
+        return operation(name);
+    }
+    /// The handle of a name already in the table. Unlike `operation()` this never writes, so it
+    /// may be called from inside a pass; an unknown name throws.
+    OpHandle find_operation(const Op& name) const
+    {
+        const auto it = m_op_index.find(name);
+        if (it == m_op_index.end()) {
+            log_and_throw_error("No operation registered under the name '{}'.", name);
+        }
+        return OpHandle{it->second};
+    }
+    const Op& operation_name(const OpHandle op) const { return m_op_names.at(op.id); }
+
+    /// The string API's operation list in handles. Runs of one name -- the usual shape, since
+    /// drivers collect per operation -- cost one lookup.
+    std::vector<OpTuple> to_handles(const std::vector<std::pair<Op, Tuple>>& operation_tuples)
+    {
+        std::vector<OpTuple> out;
+        out.reserve(operation_tuples.size());
+        const Op* last = nullptr;
+        OpHandle last_handle;
+        for (const auto& [name, t] : operation_tuples) {
+            if (last == nullptr || name != *last) {
+                last_handle = operation(name);
+                last = &name;
+            }
+            out.emplace_back(last_handle, t);
+        }
+        return out;
+    }
+
     ExecutionPolicy policy;
 
     int num_threads = 1;
@@ -164,6 +357,75 @@ struct ExecutePass
      * result is not sharp between 32 and 512; it is sharp against 0.
      */
     size_t deferral_window = 128;
+
+    /**
+     * @brief Let a task whose queue has run dry take work from the other tasks' queues.
+     *
+     * Without it a kPartition pass lasts as long as its slowest partition: the partitions are
+     * cut to equal vertex counts, not equal work, and on an unevenly refined input one of them
+     * routinely holds several times the work of the rest while the other threads sit in
+     * `tg.wait()`. With it an idle task takes up to `steal_batch` of the highest-priority
+     * elements from another task and runs them under its own task id, so the pass tends toward
+     * total work over thread count instead.
+     *
+     * Victims are tried in order of partition-id distance. The partitions are contiguous runs
+     * of a spatial order, so a near id is a nearby region, and the thief's own region -- which
+     * is the other side of that boundary -- is already drained; the ring locks it takes there
+     * collide only with the victim. `PassStats::steals` says how often it happened.
+     *
+     * Off by default: it makes the per-task queues shared, so every access pays an uncontended
+     * lock, and it changes which task runs what, so a pass is no longer reproducible run to run
+     * (it is not reproducible with kPartition anyway, but it is less so). kPartition only.
+     */
+    bool work_stealing = false;
+    /// Upper bound on the elements moved per steal; a steal never takes more than half of the
+    /// victim's queue either. See `work_stealing`.
+    size_t steal_batch = 32;
+    /**
+     * @brief Smallest post-barrier queue that gets a second parallel round. kPartition only.
+     *
+     * The operations that overflowed the first round are, for the most part, the ones on
+     * partition boundaries, and the tasks on both sides lost them to each other. Rather than run
+     * all of them on one thread, they are handed out again on a partition shifted so that each
+     * boundary falls inside one task (see run()), run in parallel once more, and only what
+     * overflows that round is drained serially. Below this size the round costs more in task
+     * start-up than it saves. SIZE_MAX restores the plain serial drain. `PassStats` reports the
+     * size and time of each round.
+     */
+    size_t parallel_tail_min = 256;
+
+    /**
+     * @brief The priority queue the pass's operations wait in.
+     *
+     * kBinaryHeap is std::priority_queue over the whole element, (priority, op, Tuple, retries),
+     * 48 bytes with a TetMesh Tuple, moved once per level of every sift. kDaryHeap pops in
+     * exactly the same order -- the Tuple makes the element order total, so any correct heap
+     * gives one sequence -- but sifts 16-byte (priority, op) keys through a 4-ary heap and leaves
+     * the elements in a side array. kBucketed orders only by the priority rounded to
+     * `bucket_bits` mantissa bits, last-in-first-out within a bucket; it is for passes whose
+     * order is a heuristic, edge-length split and collapse, and changes their output.
+     *
+     * Measured with the hidden "scheduler_queue_performance" test: kSeq passes over the edges
+     * of a tet grid with an operation that does nothing, priority the vertex id, about a million
+     * elements per measurement, best of five, ns per element (run to run noise is about 10%):
+     *
+     *      elements     binary     d-ary     bucketed
+     *        1.9k        195        168         88
+     *       13.4k        300        273         70
+     *      102.0k        367        330         78
+     *
+     * On the queue alone, push then pop with random priorities, the d-ary heap is 25-30% faster
+     * than the binary one up to ~20k elements and 10-15% beyond, where both are bound by cache
+     * misses. The scheduler's other per-element work dilutes that to the ~10% above; the
+     * bucketed queue's cost does not grow with the queue at all. Against an operation that runs
+     * an envelope check or an energy evaluation the queue is a small part of the pass either
+     * way. Left at kBinaryHeap by default; OptimizerParameters::scheduler_queue chooses for the
+     * optimizers.
+     */
+    threading::QueueKind queue_kind = threading::QueueKind::kBinaryHeap;
+    /// Leading mantissa bits kBucketed cuts priorities at: a bucket is 2^-bits wide relative to
+    /// its priority. 4 puts squared edge lengths within 6.25%, lengths within about 3%.
+    int bucket_bits = 4;
     /**
      * @brief Construct a new Execute Pass object. It contains the name-to-operation map and the
      *functions that define the rules for operations
@@ -287,6 +549,9 @@ struct ExecutePass
                          return {};
                  }}};
         }
+        for (const auto& kv : edit_operation_maps) {
+            operation(kv.first);
+        }
     };
 
     ExecutePass(ExecutePass&) = delete;
@@ -323,46 +588,272 @@ public:
      */
     bool operator()(AppMesh& m, const std::vector<std::pair<Op, Tuple>>& operation_tuples)
     {
-        // The queue holds an operation's INDEX rather than its name. edit_operation_maps is a
-        // std::map, so iterating it yields the names in lexicographic order and an index is
-        // exactly a name's rank among them -- comparing indices is therefore identical to
-        // comparing the strings, which is what keeps the queue order, and so the output,
-        // bit-for-bit unchanged. What it buys is that a queue element is now trivially
-        // copyable: a heap sift moves 8 bytes instead of a std::string, and a tie on the
-        // priority is an integer compare instead of a string compare. It also turns the
-        // per-operation dispatch from a string-keyed std::map lookup into an index.
+        return (*this)(m, to_handles(operation_tuples));
+    }
+
+    /// The same, for operations given by handle.
+    bool operator()(AppMesh& m, const std::vector<OpTuple>& operation_tuples)
+    {
+        pass_traits::None none;
+        return (*this)(m, operation_tuples, none);
+    }
+
+    /**
+     * @brief The same, with the per-operation hooks supplied as a type the compiler can see
+     * through.
+     *
+     * The members above are std::functions, so every element the pass pops costs five to seven
+     * indirect calls that cannot be inlined -- the weight check, the operation itself looked up
+     * in `edit_operation_maps`, the lock, the renewal and a priority and should_renew per
+     * renewed tuple. For an operation that fails in its first cheap test, that dispatch is a
+     * visible share of the element. @p traits may instead provide any of
+     *
+     *     double priority(const AppMesh&, OpHandle, const Tuple&);
+     *     bool should_renew(double);
+     *     template <class Emit>
+     *     void renew_neighbor_tuples(const AppMesh&, OpHandle, const std::vector<Tuple>&, Emit&&);
+     *     bool lock_vertices(AppMesh&, const Tuple&, int task_id);
+     *     bool is_weight_up_to_date(const AppMesh&, const std::tuple<double, OpHandle, Tuple>&);
+     *     std::optional<std::vector<Tuple>> apply(AppMesh&, OpHandle, const Tuple&);
+     *     void on_fail(const AppMesh&, OpHandle, const Tuple&);
+     *     bool has_operation(OpHandle) const;
+     *     uint64_t renew_key(const AppMesh&, OpHandle, const Tuple&);
+     *     bool dedups_renewals() const;
+     *
+     * and the pass calls them directly. Each one it does not provide comes from the member of
+     * the same name, exactly as without traits, so a driver moves over the hooks that matter and
+     * leaves the rest. `renew_neighbor_tuples` hands each renewed operation to `emit(op, tuple)`
+     * rather than returning a vector. `apply` runs the operation in place of
+     * `edit_operation_maps`; a traits type that provides it accepts every handle the executor
+     * has issued unless it also says otherwise through `has_operation`. Providing `renew_key`
+     * turns on de-duplication of renewals as `renew_key_by_handle` does; `dedups_renewals` can
+     * turn it back off, for a wrapper that forwards a key it may not have.
+     *
+     * The hooks are called concurrently, from every task, on whatever @p traits refers to; it
+     * is not copied.
+     *
+     * `stopping_criterion` stays a member: it is consulted once a pass has many successes, not
+     * per element.
+     */
+    template <class Traits>
+    bool operator()(AppMesh& m, const std::vector<OpTuple>& operation_tuples, Traits& traits)
+    {
+        Hooks<Traits> h(*this, traits);
+        return run(m, operation_tuples, h);
+    }
+
+    /**
+     * @brief The hooks a pass calls: each from the traits where they provide it, from the
+     * executor's members where they do not.
+     *
+     * Every hook is always there, so wrapping this is how a helper such as
+     * run_localized_to_convergence adds behaviour to a pass without knowing which hooks the
+     * driver provided.
+     */
+    template <class Traits>
+    class Hooks
+    {
+    public:
+        Hooks(ExecutePass& executor, Traits& traits)
+            : m_ex(executor)
+            , m_traits(traits)
+        {}
+
+        double priority(const AppMesh& m, const OpHandle op, const Tuple& t)
+        {
+            if constexpr (pass_traits::provides<pass_traits::priority_t, Traits, AppMesh>) {
+                return m_traits.priority(m, op, t);
+            } else {
+                return m_ex.priority_by_handle ? m_ex.priority_by_handle(m, op, t)
+                                               : m_ex.priority(m, m_ex.m_op_names[op.id], t);
+            }
+        }
+        bool should_renew(const double val)
+        {
+            if constexpr (pass_traits::provides<pass_traits::should_renew_t, Traits, AppMesh>) {
+                return m_traits.should_renew(val);
+            } else {
+                return m_ex.should_renew(val);
+            }
+        }
+        template <class Emit>
+        void renew_neighbor_tuples(
+            const AppMesh& m,
+            const OpHandle op,
+            const std::vector<Tuple>& newts,
+            Emit&& emit)
+        {
+            if constexpr (pass_traits::
+                              provides<pass_traits::renew_neighbor_tuples_t, Traits, AppMesh>) {
+                m_traits.renew_neighbor_tuples(m, op, newts, emit);
+            } else if (m_ex.renew_neighbor_tuples_by_handle) {
+                for (const auto& [o, e] : m_ex.renew_neighbor_tuples_by_handle(m, op, newts)) {
+                    emit(o, e);
+                }
+            } else {
+                const auto renewed = m_ex.renew_neighbor_tuples(m, m_ex.m_op_names[op.id], newts);
+                for (const auto& [o, e] : renewed) {
+                    emit(m_ex.find_operation(o), e);
+                }
+            }
+        }
+        bool lock_vertices(AppMesh& m, const Tuple& t, const int task_id)
+        {
+            if constexpr (pass_traits::provides<pass_traits::lock_vertices_t, Traits, AppMesh>) {
+                return m_traits.lock_vertices(m, t, task_id);
+            } else {
+                return m_ex.lock_vertices(m, t, task_id);
+            }
+        }
+        bool is_weight_up_to_date(const AppMesh& m, const std::tuple<double, OpHandle, Tuple>& ele)
+        {
+            if constexpr (pass_traits::
+                              provides<pass_traits::is_weight_up_to_date_t, Traits, AppMesh>) {
+                return m_traits.is_weight_up_to_date(m, ele);
+            } else if (m_ex.is_weight_up_to_date_by_handle) {
+                return m_ex.is_weight_up_to_date_by_handle(m, ele);
+            } else {
+                const auto& [weight, op, t] = ele;
+                return m_ex.is_weight_up_to_date(
+                    m,
+                    std::tuple<double, Op, Tuple>(weight, m_ex.m_op_names[op.id], t));
+            }
+        }
+        std::optional<std::vector<Tuple>> apply(AppMesh& m, const OpHandle op, const Tuple& t)
+        {
+            if constexpr (pass_traits::provides<pass_traits::apply_t, Traits, AppMesh>) {
+                return m_traits.apply(m, op, t);
+            } else {
+                return (*m_ex.m_op_fn[op.id])(m, t);
+            }
+        }
+        void on_fail(const AppMesh& m, const OpHandle op, const Tuple& t)
+        {
+            if constexpr (pass_traits::provides<pass_traits::on_fail_t, Traits, AppMesh>) {
+                m_traits.on_fail(m, op, t);
+            } else if (m_ex.on_fail_by_handle) {
+                m_ex.on_fail_by_handle(m, op, t);
+            } else {
+                m_ex.on_fail(m, m_ex.m_op_names[op.id], t);
+            }
+        }
+        /// Whether the pass can run @p op: by the traits' say-so, or by its having an entry in
+        /// `edit_operation_maps` when `apply` falls back to that map.
+        bool has_operation(const OpHandle op) const
+        {
+            if constexpr (pass_traits::provides<pass_traits::has_operation_t, Traits, AppMesh>) {
+                return m_traits.has_operation(op);
+            } else if constexpr (pass_traits::provides<pass_traits::apply_t, Traits, AppMesh>) {
+                return op.id < m_ex.m_op_names.size();
+            } else {
+                return op.id < m_ex.m_op_fn.size() && m_ex.m_op_fn[op.id] != nullptr;
+            }
+        }
+        /// Whether renewals go through `renew_key`. See `renew_key_by_handle`.
+        bool dedups_renewals() const
+        {
+            if constexpr (pass_traits::provides<pass_traits::dedups_renewals_t, Traits, AppMesh>) {
+                return m_traits.dedups_renewals();
+            } else if constexpr (pass_traits::provides<pass_traits::renew_key_t, Traits, AppMesh>) {
+                return true;
+            } else {
+                return bool(m_ex.renew_key_by_handle);
+            }
+        }
+        /// Only called when `dedups_renewals()`.
+        uint64_t renew_key(const AppMesh& m, const OpHandle op, const Tuple& t)
+        {
+            if constexpr (pass_traits::provides<pass_traits::renew_key_t, Traits, AppMesh>) {
+                return m_traits.renew_key(m, op, t);
+            } else {
+                return m_ex.renew_key_by_handle(m, op, t);
+            }
+        }
+
+    private:
+        ExecutePass& m_ex;
+        Traits& m_traits;
+    };
+    /// The hooks a pass with @p traits would call. Only valid while both outlive it.
+    template <class Traits>
+    Hooks<Traits> hooks(Traits& traits)
+    {
+        return Hooks<Traits>(*this, traits);
+    }
+
+private:
+    template <class PassHooks>
+    bool run(AppMesh& m, const std::vector<OpTuple>& operation_tuples, PassHooks& hooks)
+    {
+        // The queue holds an operation's RANK among the names in lexicographic order rather
+        // than its name -- comparing ranks is identical to comparing the strings, which is what
+        // keeps the queue order, and so the output, bit-for-bit what it was when the queue held
+        // names. What it buys is that a queue element is trivially copyable: a heap sift moves
+        // 8 bytes instead of a std::string, and a tie on the priority is an integer compare
+        // instead of a string compare. Handles number the names in the order they were first
+        // seen instead, so the two are mapped onto each other once here.
         using OpId = uint32_t;
         using Elem = std::tuple<double, OpId, Tuple, size_t>; // priority, op index, tuple, #retries
         // Each task owns its queue outright -- it is seeded before any thread starts, and the
         // task both pops from it and pushes its renewed operations back into it -- so those need
         // no lock. `final_queue` is the one that genuinely crosses threads: tasks push retry
-        // overflow into it while running, and it is drained after the barrier. Both are
-        // std::priority_queue with the same comparator underneath, so pop order is unchanged.
-        using LocalQueue = wmtk::threading::serial_priority_queue<Elem>;
-        using SharedQueue = wmtk::threading::concurrent_priority_queue<Elem>;
-
-        std::vector<const Op*> op_name;
-        std::vector<std::function<std::optional<std::vector<Tuple>>(AppMesh&, const Tuple&)>*>
-            op_fn;
-        std::map<Op, OpId> op_id;
-        op_name.reserve(edit_operation_maps.size());
-        op_fn.reserve(edit_operation_maps.size());
-        for (auto& kv : edit_operation_maps) {
-            op_id.emplace(kv.first, OpId(op_name.size()));
-            op_name.push_back(&kv.first);
-            op_fn.push_back(&kv.second);
+        // overflow into it while running, and it is drained after the barrier. Both hold the
+        // same heap with the same comparator underneath, a selectable_heap, so that
+        // `queue_kind` picks it per pass; the heap's key is the (priority, op) prefix of Elem.
+        //
+        // With work_stealing on, the per-task queues become shared after all: another task may
+        // take from them. They switch to locking only in that mode -- see
+        // stealable_priority_queue.
+        struct ElemKey
+        {
+            threading::heap_key operator()(const Elem& e) const
+            {
+                return {std::get<0>(e), std::get<1>(e)};
+            }
+        };
+        using Heap = wmtk::threading::selectable_heap<Elem, ElemKey>;
+        using LocalQueue =
+            wmtk::threading::stealable_priority_queue<Elem, std::less<Elem>, Heap>;
+        using SharedQueue =
+            wmtk::threading::concurrent_priority_queue<Elem, std::less<Elem>, Heap>;
+
+        for (const auto& kv : edit_operation_maps) {
+            operation(kv.first); // added to the map directly
+        }
+        const size_t n_ops = m_op_names.size();
+        m_op_fn.assign(n_ops, nullptr);
+        for (size_t h = 0; h < n_ops; ++h) {
+            const auto it = edit_operation_maps.find(m_op_names[h]);
+            if (it != edit_operation_maps.end()) {
+                m_op_fn[h] = &it->second;
+            }
+        }
+        std::vector<uint32_t> handle_of(n_ops); // rank -> handle
+        std::iota(handle_of.begin(), handle_of.end(), 0);
+        std::sort(handle_of.begin(), handle_of.end(), [this](uint32_t a, uint32_t b) {
+            return m_op_names[a] < m_op_names[b];
+        });
+        std::vector<OpId> rank_of(n_ops); // handle -> rank
+        for (size_t r = 0; r < n_ops; ++r) {
+            rank_of[handle_of[r]] = OpId(r);
         }
         // An operation with no entry here was previously default-constructed into the map by
         // operator[] and then called, which throws bad_function_call -- so it cannot occur in
         // any working configuration. Say so plainly rather than ordering it arbitrarily.
-        const auto id_of = [&op_id](const Op& name) {
-            const auto it = op_id.find(name);
-            if (it == op_id.end()) {
-                log_and_throw_error("No operation registered under the name '{}'.", name);
+        const auto id_of = [&](const OpHandle op) {
+            if (op.id >= n_ops || !hooks.has_operation(op)) {
+                log_and_throw_error(
+                    "No operation registered under the name '{}'.",
+                    op.id < n_ops ? m_op_names[op.id] : Op("<invalid handle>"));
             }
-            return it->second;
+            return rank_of[op.id];
         };
 
+        const bool dedup = hooks.dedups_renewals();
+        for (RenewDedup& scratch : m_renew_dedup) {
+            scratch.dropped = 0;
+        }
+
         std::atomic<bool> stop(false);
         cnt_success = 0;
         cnt_fail = 0;
@@ -377,6 +868,12 @@ public:
 
         std::vector<LocalQueue> queues(num_threads);
         SharedQueue final_queue;
+        const bool stealing = work_stealing && policy == ExecutionPolicy::kPartition;
+        for (auto& q : queues) {
+            q.set_shared(stealing);
+            q.heap().configure(queue_kind, bucket_bits);
+        }
+        final_queue.heap().configure(queue_kind, bucket_bits);
 
         // Contention accounting. Everything here is either a per-task local folded in once or a
         // write to the task's own slot, so it adds nothing to the inner loop. It answers the
@@ -385,30 +882,123 @@ public:
         m_stats = PassStats{};
         std::atomic<size_t> lock_failures(0);
         std::atomic<size_t> overflowed(0);
+        std::atomic<size_t> steals(0);
+        std::atomic<size_t> stolen(0);
         std::vector<double> task_seconds(queues.size(), 0.);
 
-        auto run_single_queue = [&](auto& Q, int task_id) {
-            // Per-task tallies folded into the shared counters once, on the way out. The guard
-            // is RAII rather than a line at the bottom because the loop below has early
-            // returns.
-            struct CountFlusher
+        // Per-task tallies folded into the shared counters once, on the way out. The guard is RAII
+        // rather than a line at the bottom because the task loop has early returns.
+        struct CountFlusher
+        {
+            std::atomic_int& success_total;
+            std::atomic_int& fail_total;
+            std::atomic<size_t>& lock_failure_total;
+            std::atomic<size_t>& overflow_total;
+            std::atomic<size_t>& steal_total;
+            std::atomic<size_t>& stolen_total;
+            int success = 0;
+            int fail = 0;
+            size_t lock_failure = 0;
+            size_t overflow = 0;
+            size_t steal = 0;
+            size_t stolen_elements = 0;
+            ~CountFlusher()
             {
-                std::atomic_int& success_total;
-                std::atomic_int& fail_total;
-                std::atomic<size_t>& lock_failure_total;
-                std::atomic<size_t>& overflow_total;
-                int success = 0;
-                int fail = 0;
-                size_t lock_failure = 0;
-                size_t overflow = 0;
-                ~CountFlusher()
-                {
-                    success_total.fetch_add(success, std::memory_order_relaxed);
-                    fail_total.fetch_add(fail, std::memory_order_relaxed);
-                    lock_failure_total.fetch_add(lock_failure, std::memory_order_relaxed);
-                    overflow_total.fetch_add(overflow, std::memory_order_relaxed);
+                success_total.fetch_add(success, std::memory_order_relaxed);
+                fail_total.fetch_add(fail, std::memory_order_relaxed);
+                lock_failure_total.fetch_add(lock_failure, std::memory_order_relaxed);
+                overflow_total.fetch_add(overflow, std::memory_order_relaxed);
+                steal_total.fetch_add(steal, std::memory_order_relaxed);
+                stolen_total.fetch_add(stolen_elements, std::memory_order_relaxed);
+            }
+        };
+
+        // Run the operation in `ele` once it is safe to -- its ring is held, or it is running
+        // in a color class of its own -- and append what it renews to `renewed`. Returns false,
+        // having run nothing, when the weight is out of date. Releases nothing; that is the
+        // caller's `operation_cleanup`.
+        const auto execute = [&](const Elem& ele,
+                                 std::vector<Elem>& renewed,
+                                 CountFlusher& counts) {
+            const auto& [weight, rank, tup, retry] = ele;
+            const OpHandle op{handle_of[rank]};
+            // this can encode, in qslim, recompute(energy) == weight.
+            if (!hooks.is_weight_up_to_date(
+                    m,
+                    std::tuple<double, OpHandle, Tuple>(weight, op, tup))) {
+                return false;
+            }
+            auto newtup = hooks.apply(m, op, tup);
+            if (newtup) {
+                const auto enqueue = [&](const OpHandle o, const Tuple& e) {
+                    const double val = hooks.priority(m, o, e);
+                    if (hooks.should_renew(val)) {
+                        renewed.emplace_back(val, id_of(o), e, 0);
+                    }
+                };
+                if (dedup) {
+                    RenewDedup& scratch = m_renew_dedup.local();
+                    scratch.clear();
+                    hooks.renew_neighbor_tuples(
+                        m,
+                        op,
+                        *newtup,
+                        [&](const OpHandle o, const Tuple& e) {
+                            scratch.add(o, e, hooks.renew_key(m, o, e));
+                        });
+                    scratch.dedup();
+                    for (const auto& [o, e] : scratch.items) {
+                        enqueue(o, e);
+                    }
+                } else {
+                    hooks.renew_neighbor_tuples(m, op, *newtup, enqueue);
+                }
+                counts.success++;
+                if (track_live_success) {
+                    live_success.fetch_add(1, std::memory_order_relaxed);
+                }
+            } else {
+                hooks.on_fail(m, op, tup);
+                counts.fail++;
+            }
+            return true;
+        };
+
+        // Move a batch from another task's queue into this task's, nearest partition id first.
+        // Returns the number of elements moved; 0 means every other queue was (nearly) empty.
+        const auto steal_into = [&queues, this](
+                                    LocalQueue& Q,
+                                    int task_id,
+                                    std::vector<Elem>& loot) {
+            const int n = int(queues.size());
+            for (int d = 1; d < n; ++d) {
+                for (const int victim : {task_id - d, task_id + d}) {
+                    if (victim < 0 || victim >= n) {
+                        continue;
+                    }
+                    loot.clear();
+                    if (queues[victim].try_steal(loot, steal_batch) == 0) {
+                        continue;
+                    }
+                    for (auto& e : loot) {
+                        Q.emplace(std::move(e));
+                    }
+                    return loot.size();
                 }
-            } counts{cnt_success, cnt_fail, lock_failures, overflowed};
+            }
+            return size_t(0);
+        };
+
+        // Drain `Q` as task `task_id`. What keeps losing the race for its ring goes to
+        // `overflow`, to be run after the barrier.
+        auto run_single_queue = [&](auto& Q, int task_id, SharedQueue& overflow) {
+            CountFlusher counts{cnt_success, cnt_fail, lock_failures, overflowed, steals, stolen};
+
+            // Only the per-task queues are stolen from and into; the serial drain after the
+            // last barrier runs alone and has no one to steal from.
+            constexpr bool may_steal =
+                std::is_same_v<std::decay_t<decltype(Q)>, LocalQueue>;
+            std::vector<Elem> loot;
 
             Elem ele_in_queue;
             // Operations that lost a race for their ring wait here rather than going straight
@@ -439,12 +1029,23 @@ public:
                 }
                 if (!Q.try_pop(ele_in_queue)) {
                     if (second_chance.empty()) {
+                        if constexpr (may_steal) {
+                            // Nothing left of our own. Only give up once nobody has anything
+                            // worth taking; a victim that renews work after we leave keeps it.
+                            if (stealing) {
+                                if (const size_t n = steal_into(Q, task_id, loot); n > 0) {
+                                    counts.steal++;
+                                    counts.stolen_elements += n;
+                                    continue;
+                                }
+                            }
+                        }
                         break;
                     }
                     // Queue exhausted: the deferred operations have now had everything else
                     // run ahead of them, so give them another go. `retry` still increments on
-                    // each attempt and still overflows to final_queue at max_retry_limit, so
-                    // this terminates after at most that many rounds.
+                    // each attempt and still overflows at max_retry_limit, so this terminates
+                    // after at most that many rounds.
                     refill();
                     std::this_thread::yield();
                     continue;
@@ -457,7 +1058,7 @@ public:
 
                 std::vector<Elem> renewed_elements;
                 {
-                    auto locked_vid = lock_vertices(
+                    auto locked_vid = hooks.lock_vertices(
                         m,
                         tup,
                         task_id); // Note that returning `Tuples` would be invalid.
@@ -469,36 +1070,13 @@ public:
                         } else {
                             retry = 0;
                             counts.overflow++;
-                            final_queue.emplace(ele_in_queue);
+                            overflow.emplace(ele_in_queue);
                         }
                         continue;
                     }
-                    if (tup.is_valid(m)) {
-                        const Op& op_str = *op_name[op];
-                        if (!is_weight_up_to_date(
-                                m,
-                                std::tuple<double, Op, Tuple>(weight, op_str, tup))) {
-                            operation_cleanup(m);
-                            continue;
-                        } // this can encode, in qslim, recompute(energy) == weight.
-                        auto newtup = (*op_fn[op])(m, tup);
-                        std::vector<std::pair<Op, Tuple>> renewed_tuples;
-                        if (newtup) {
-                            renewed_tuples = renew_neighbor_tuples(m, op_str, newtup.value());
-                            counts.success++;
-                            if (track_live_success) {
-                                live_success.fetch_add(1, std::memory_order_relaxed);
-                            }
-                        } else {
-                            on_fail(m, op_str, tup);
-                            counts.fail++;
-                        }
-                        for (const auto& [o, e] : renewed_tuples) {
-                            auto val = priority(m, o, e);
-                            if (should_renew(val)) {
-                                renewed_elements.emplace_back(val, id_of(o), e, 0);
-                            }
-                        }
+                    if (tup.is_valid(m) && !execute(ele_in_queue, renewed_elements, counts)) {
+                        operation_cleanup(m);
+                        continue;
                     }
                     operation_cleanup(m); // Maybe use RAII
                 }
@@ -524,24 +1102,304 @@ public:
                 if (!e.is_valid(m)) {
                     continue;
                 }
-                final_queue.emplace(priority(m, op, e), id_of(op), e, 0);
+                final_queue.emplace(hooks.priority(m, op, e), id_of(op), e, 0);
             }
-            run_single_queue(final_queue, 0);
+            run_single_queue(final_queue, 0, final_queue);
+        } else if (policy == ExecutionPolicy::kColor) {
+            // Conflict-free batches instead of ring locks. Each round takes the footprint of every
+            // pending operation -- the vertex set `lock_vertices` would claim, taken serially and
+            // released straight away -- colors the operations greedily in priority order so no
+            // two of one color share a vertex, and then runs the color classes one after another,
+            // each fully in parallel and without taking a single lock. What an operation renews
+            // is colored in the next round. Nothing can lose a race, so there is no retry, no
+            // second chance and no serial final_queue.
+            //
+            // It relies on the same contract the locks do -- an operation touches nothing outside
+            // the set its locker claims -- so a pass that is correct under kPartition is correct
+            // here. The one new hazard is that a footprint taken at the start of the round goes
+            // stale once an earlier class has edited the mesh around it. Such an edit can only
+            // reach an operation through a vertex inside the editing operation's footprint, so
+            // those vertices are stamped with the class that dirtied them, and an operation whose
+            // footprint contains one is re-footprinted before its class runs. If the new
+            // footprint collides with a classmate, it waits for the next round.
+            //
+            // An operation whose footprint comes back empty -- `lock_vertices` left at its
+            // default, or failing outright -- has an unknown write set. Those run serially at the
+            // end of the round, and invalidate every footprint taken before them.
+            using clock = std::chrono::steady_clock;
+            const auto t_parallel = clock::now();
+
+            struct Pending
+            {
+                Elem ele;
+                std::vector<size_t> footprint;
+                size_t taken_at = 0; // `step` when `footprint` was taken; 0 = never
+            };
+            std::vector<Pending> pending, next;
+            for (const auto& [op, e] : operation_tuples) {
+                if (!e.is_valid(m)) {
+                    continue;
+                }
+                pending.push_back({Elem(hooks.priority(m, op, e), id_of(op), e, 0), {}, 0});
+            }
+
+            // `step` advances once per executed class. dirty_at[v] is the step that last ran an
+            // operation whose footprint held v; anything taken at or before that step is stale.
+            size_t step = 1;
+            size_t all_dirty_at = 0;
+            std::vector<size_t> dirty_at;
+            // Per-vertex scratch, stamped instead of cleared: the colors already using a vertex
+            // this round, and the class currently claiming it.
+            constexpr int max_colors = 64;
+            std::vector<uint64_t> used_colors;
+            std::vector<size_t> used_round;
+            std::vector<size_t> claimed;
+            size_t claim_stamp = 0;
+            const auto fit = [&](size_t n) {
+                if (dirty_at.size() < n) {
+                    dirty_at.resize(n, 0);
+                    used_colors.resize(n, 0);
+                    used_round.resize(n, 0);
+                    claimed.resize(n, 0);
+                }
+            };
+            const auto is_stale = [&](const Pending& p) {
+                if (p.taken_at <= all_dirty_at) {
+                    return true;
+                }
+                for (const size_t v : p.footprint) {
+                    if (v < dirty_at.size() && dirty_at[v] >= p.taken_at) {
+                        return true;
+                    }
+                }
+                return false;
+            };
+            const auto take_footprint = [&](Pending& p) {
+                p.footprint.clear();
+                if (hooks.lock_vertices(m, std::get<2>(p.ele), 0)) {
+                    const auto& held = m.mutex_release_stack.local();
+                    p.footprint.assign(held.begin(), held.end());
+                }
+                operation_cleanup(m);
+                std::sort(p.footprint.begin(), p.footprint.end());
+                p.footprint.erase(
+                    std::unique(p.footprint.begin(), p.footprint.end()),
+                    p.footprint.end());
+                if (!p.footprint.empty()) {
+                    fit(p.footprint.back() + 1);
+                }
+                p.taken_at = step;
+            };
+            const auto collides = [&](const Pending& p) {
+                for (const size_t v : p.footprint) {
+                    if (claimed[v] == claim_stamp) {
+                        return true;
+                    }
+                }
+                return false;
+            };
+            const auto claim = [&](const Pending& p) {
+                for (const size_t v : p.footprint) {
+                    claimed[v] = claim_stamp;
+                }
+            };
+            const auto mark_dirty = [&](const Pending& p) {
+                for (const size_t v : p.footprint) {
+                    dirty_at[v] = step;
+                }
+            };
+            const auto check_stop = [&] {
+                if (track_live_success && live_success.load(std::memory_order_relaxed) >
+                                              stopping_criterion_checking_frequency) {
+                    if (stopping_criterion(m)) {
+                        stop.store(true);
+                    }
+                }
+                return stop.load();
+            };
+
+            std::vector<std::vector<size_t>> classes(max_colors);
+            std::vector<size_t> unknown, batch;
+            std::vector<char> done;
+            std::mutex merge_mutex;
+            size_t round = 0;
+            while (!pending.empty() && !stop.load()) {
+                ++round;
+                pending.erase(
+                    std::remove_if(
+                        pending.begin(),
+                        pending.end(),
+                        [&](const Pending& p) { return !std::get<2>(p.ele).is_valid(m); }),
+                    pending.end());
+                // Highest priority first, so it gets the lowest color and runs earliest -- the
+                // same order a task would have popped it in.
+                std::sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) {
+                    return a.ele > b.ele;
+                });
+                fit(m.vert_capacity());
+                for (auto& p : pending) {
+                    if (is_stale(p)) {
+                        take_footprint(p);
+                    }
+                }
+
+                // Greedy coloring: the lowest color none of the footprint's vertices carries. An
+                // operation that finds all of them taken sits the round out.
+                for (auto& c : classes) {
+                    c.clear();
+                }
+                unknown.clear();
+                done.assign(pending.size(), 0);
+                for (size_t i = 0; i < pending.size(); ++i) {
+                    const auto& fp = pending[i].footprint;
+                    if (fp.empty()) {
+                        unknown.push_back(i);
+                        continue;
+                    }
+                    uint64_t taken = 0;
+                    for (const size_t v : fp) {
+                        if (used_round[v] == round) {
+                            taken |= used_colors[v];
+                        }
+                    }
+                    if (taken == ~uint64_t(0)) {
+                        continue;
+                    }
+                    int c = 0;
+                    while ((taken >> c) & 1) {
+                        ++c;
+                    }
+                    for (const size_t v : fp) {
+                        if (used_round[v] != round) {
+                            used_round[v] = round;
+                            used_colors[v] = 0;
+                        }
+                        used_colors[v] |= uint64_t(1) << c;
+                    }
+                    classes[c].push_back(i);
+                }
+
+                for (int c = 0; c < max_colors && !classes[c].empty(); ++c) {
+                    // Re-validate against what earlier classes did. Current footprints are
+                    // pairwise disjoint by construction, so claim those first; a refreshed one
+                    // joins only if it still fits around them.
+                    ++claim_stamp;
+                    batch.clear();
+                    for (const size_t i : classes[c]) {
+                        if (!is_stale(pending[i])) {
+                            claim(pending[i]);
+                            batch.push_back(i);
+                        }
+                    }
+                    for (const size_t i : classes[c]) {
+                        auto& p = pending[i];
+                        if (!is_stale(p)) {
+                            continue;
+                        }
+                        if (!std::get<2>(p.ele).is_valid(m)) {
+                            done[i] = 1;
+                            continue;
+                        }
+                        take_footprint(p);
+                        if (p.footprint.empty() || collides(p)) {
+                            ++m_stats.color_conflicts;
+                            continue;
+                        }
+                        claim(p);
+                        batch.push_back(i);
+                    }
+                    if (batch.empty()) {
+                        continue;
+                    }
+
+                    const auto run_batch = [&](const threading::range& r) {
+                        CountFlusher counts{
+                            cnt_success,
+                            cnt_fail,
+                            lock_failures,
+                            overflowed,
+                            steals,
+                            stolen};
+                        std::vector<Elem> renewed;
+                        for (size_t k = r.begin(); k < r.end(); ++k) {
+                            const Elem& ele = pending[batch[k]].ele;
+                            if (std::get<2>(ele).is_valid(m)) {
+                                execute(ele, renewed, counts);
+                            }
+                        }
+                        std::lock_guard<std::mutex> lock(merge_mutex);
+                        for (auto& e : renewed) {
+                            next.push_back({std::move(e), {}, 0});
+                        }
+                    };
+                    if (batch.size() > 1 && num_threads > 1) {
+                        threading::parallel_for(
+                            threading::range(0, batch.size()),
+                            run_batch,
+                            num_threads);
+                    } else {
+                        run_batch(threading::range(0, batch.size()));
+                    }
+                    for (const size_t i : batch) {
+                        done[i] = 1;
+                        mark_dirty(pending[i]);
+                    }
+                    ++step;
+                    ++m_stats.color_classes;
+                    if (check_stop()) {
+                        break;
+                    }
+                }
+
+                for (const size_t i : unknown) {
+                    if (stop.load()) {
+                        break;
+                    }
+                    done[i] = 1;
+                    const Elem& ele = pending[i].ele;
+                    if (!std::get<2>(ele).is_valid(m)) {
+                        continue;
+                    }
+                    CountFlusher
+                        counts{cnt_success, cnt_fail, lock_failures, overflowed, steals, stolen};
+                    std::vector<Elem> renewed;
+                    execute(ele, renewed, counts);
+                    for (auto& e : renewed) {
+                        next.push_back({std::move(e), {}, 0});
+                    }
+                    all_dirty_at = step++;
+                    ++m_stats.unknown_footprint;
+                    check_stop();
+                }
+
+                // Whatever did not run keeps its footprint; is_stale decides next round whether
+                // it is still good.
+                for (size_t i = 0; i < pending.size(); ++i) {
+                    if (!done[i]) {
+                        next.push_back(std::move(pending[i]));
+                    }
+                }
+                pending.swap(next);
+                next.clear();
+            }
+            m_stats.color_rounds = round;
+            m_stats.parallel_seconds =
+                std::chrono::duration<double>(clock::now() - t_parallel).count();
         } else {
             for (const auto& [op, e] : operation_tuples) {
                 if (!e.is_valid(m)) {
                     continue;
                 }
-                queues[get_partition_id(m, e)].emplace(priority(m, op, e), id_of(op), e, 0);
+                queues[get_partition_id(m, e)].emplace(hooks.priority(m, op, e), id_of(op), e, 0);
+                ++m_stats.first_round_size;
             }
-            // Comment out parallel: work on serial first.
             using clock = std::chrono::steady_clock;
             const auto t_parallel = clock::now();
             wmtk::threading::task_group tg;
             for (int task_id = 0; task_id < queues.size(); task_id++) {
-                tg.run([&run_single_queue, &queues, &task_seconds, task_id] {
+                tg.run([&run_single_queue, &queues, &final_queue, &task_seconds, task_id] {
                     const auto t0 = clock::now();
-                    run_single_queue(queues[task_id], task_id);
+                    run_single_queue(queues[task_id], task_id, final_queue);
                     // Each task writes only its own slot.
                     task_seconds[task_id] =
                         std::chrono::duration<double>(clock::now() - t0).count();
@@ -554,14 +1412,57 @@ public:
 
             logger().debug("Parallel Complete, remains element {}", final_queue.size());
 
+            // What overflowed is mostly operations whose ring straddles a partition boundary,
+            // fought over by the tasks on either side. Send each to task (p + q) mod T, p and q
+            // being the partitions of its tuple's two vertices: the partitions are contiguous
+            // runs of a spatial order, so everything straddling the boundary between k and k+1
+            // lands in task 2k+1 mod T and is run by one task, the operations on the neighbouring
+            // boundaries land in other tasks, and operations inside partition k in task 2k mod T.
+            // It is the partition shifted by half a part. Only what loses again -- where three
+            // partitions meet -- is left for the serial drain.
+            SharedQueue tail_queue;
+            tail_queue.heap().configure(queue_kind, bucket_bits);
+            SharedQueue* serial = &final_queue;
+            if (final_queue.size() >= parallel_tail_min && queues.size() > 1 && !stop.load()) {
+                const auto t_round = clock::now();
+                const size_t n_tasks = queues.size();
+                Elem ele;
+                while (final_queue.try_pop(ele)) {
+                    const Tuple& t = std::get<2>(ele);
+                    if (!t.is_valid(m)) {
+                        continue;
+                    }
+                    const size_t p = get_partition_id(m, t);
+                    const size_t q = get_partition_id(m, t.switch_vertex(m));
+                    queues[(p + q) % n_tasks].emplace(std::move(ele));
+                    ++m_stats.tail_round_size;
+                }
+                wmtk::threading::task_group tail_tg;
+                for (int task_id = 0; task_id < queues.size(); task_id++) {
+                    tail_tg.run([&run_single_queue, &queues, &tail_queue, task_id] {
+                        run_single_queue(queues[task_id], task_id, tail_queue);
+                    });
+                }
+                tail_tg.wait();
+                m_stats.tail_round_seconds =
+                    std::chrono::duration<double>(clock::now() - t_round).count();
+                serial = &tail_queue;
+            }
+            m_stats.serial_tail_size = serial->size();
+
             const auto t_tail = clock::now();
-            run_single_queue(final_queue, 0);
+            run_single_queue(*serial, 0, *serial);
             m_stats.serial_tail_seconds =
                 std::chrono::duration<double>(clock::now() - t_tail).count();
         }
 
         m_stats.lock_failures = lock_failures.load(std::memory_order_relaxed);
         m_stats.overflowed = overflowed.load(std::memory_order_relaxed);
+        m_stats.steals = steals.load(std::memory_order_relaxed);
+        m_stats.stolen_elements = stolen.load(std::memory_order_relaxed);
+        for (const RenewDedup& scratch : m_renew_dedup) {
+            m_stats.renew_duplicates += scratch.dropped;
+        }
         if (!task_seconds.empty()) {
             const auto mm = std::minmax_element(task_seconds.begin(), task_seconds.end());
             m_stats.idlest_task_seconds = *mm.first;
@@ -577,6 +1478,7 @@ public:
         return true;
     }
 
+public:
     int get_cnt_success() const { return cnt_success; }
     int get_cnt_fail() const { return cnt_fail; }
 
@@ -591,18 +1493,45 @@ public:
         /// Operations that could not claim their ring and were requeued. Counts *attempts*, so
         /// one stubborn operation can contribute up to max_retry_limit.
         size_t lock_failures = 0;
-        /// Operations that exhausted max_retry_limit and were pushed to the post-barrier queue.
+        /// Operations that exhausted max_retry_limit and were pushed to the post-barrier queue,
+        /// in either parallel round.
         size_t overflowed = 0;
-        /// Size of that queue once every task had finished.
+        /// kPartition only. Operations seeded into the per-task queues, and the size of the
+        /// overflow queue once every task had finished.
+        size_t first_round_size = 0;
         size_t final_queue_size = 0;
-        /// Wall time inside the parallel region, and in the serial drain that follows it. The
-        /// pass is billed as "parallel" in the driver's log line, but it is the sum of these.
+        /// kPartition only. The second parallel round over the overflow, on the shifted
+        /// partition (see `parallel_tail_min`): the operations it was given, still valid, and
+        /// its wall time. Zero when the overflow was drained serially straight away.
+        size_t tail_round_size = 0;
+        double tail_round_seconds = 0.;
+        /// Operations left for the serial drain: the second round's overflow when it ran, the
+        /// first round's otherwise.
+        size_t serial_tail_size = 0;
+        /// Wall time inside the first parallel round, and in the serial drain at the end. The
+        /// pass is billed as "parallel" in the driver's log line, but it is the sum of these and
+        /// `tail_round_seconds`.
         double parallel_seconds = 0.;
         double serial_tail_seconds = 0.;
         /// Busy time of the longest- and shortest-running task. A wide gap means the partition
-        /// split the work unevenly, and since tasks never steal, the tail is one thread.
+        /// split the work unevenly, and unless `work_stealing` is on the tail is one thread.
+        /// With stealing, busy time includes the stolen work, so the gap should close.
         double busiest_task_seconds = 0.;
         double idlest_task_seconds = 0.;
+        /// Successful steals, and the elements they moved. Zero unless `work_stealing` is on.
+        size_t steals = 0;
+        size_t stolen_elements = 0;
+        /// kColor only. Rounds of coloring, and color classes executed over all of them -- the
+        /// latter is the number of barriers the pass paid for.
+        size_t color_rounds = 0;
+        size_t color_classes = 0;
+        /// kColor only. Operations bumped from their class because a re-taken footprint collided
+        /// with a classmate's, and operations run serially because their footprint was unknown.
+        size_t color_conflicts = 0;
+        size_t unknown_footprint = 0;
+        /// Renewed operations dropped as a repeat of another renewed by the same operation.
+        /// Zero unless renewals are keyed; see `renew_key_by_handle`.
+        size_t renew_duplicates = 0;
     };
     const PassStats& stats() const { return m_stats; }
 
@@ -615,7 +1544,21 @@ private:
             return;
         }
         const int executed = (int)cnt_success + (int)cnt_fail;
-        const double total = m_stats.parallel_seconds + m_stats.serial_tail_seconds;
+        if (policy == ExecutionPolicy::kColor) {
+            logger().debug(
+                "  coloring: {} ops in {} classes over {} rounds ({:.1f} ops per barrier); {} "
+                "bumped by a stale footprint, {} run serially with no footprint; {:.4}s",
+                executed,
+                m_stats.color_classes,
+                m_stats.color_rounds,
+                m_stats.color_classes > 0 ? double(executed) / m_stats.color_classes : 0.,
+                m_stats.color_conflicts,
+                m_stats.unknown_footprint,
+                m_stats.parallel_seconds);
+            return;
+        }
+        const double total = m_stats.parallel_seconds + m_stats.tail_round_seconds +
+                             m_stats.serial_tail_seconds;
         logger().debug(
             "  contention: {} ring-acquisition failures over {} executed ops ({:.2f} per op); "
             "{} overflowed to the serial queue ({} queued at the barrier)",
@@ -624,19 +1567,115 @@ private:
             executed > 0 ? double(m_stats.lock_failures) / executed : 0.,
             m_stats.overflowed,
             m_stats.final_queue_size);
+        if (m_stats.tail_round_size > 0) {
+            logger().debug(
+                "  tail: {} operations rerun in parallel on the shifted partition in {:.4}s, {} "
+                "left for the serial tail",
+                m_stats.tail_round_size,
+                m_stats.tail_round_seconds,
+                m_stats.serial_tail_size);
+        }
         logger().debug(
-            "  time: {:.4}s parallel + {:.4}s serial tail ({:.1f}% of the pass); busiest task "
-            "{:.4}s, idlest {:.4}s",
+            "  time: {:.4}s parallel + {:.4}s tail round + {:.4}s serial tail ({:.1f}% of the "
+            "pass serial); busiest task {:.4}s, idlest {:.4}s",
             m_stats.parallel_seconds,
+            m_stats.tail_round_seconds,
             m_stats.serial_tail_seconds,
             total > 0. ? 100. * m_stats.serial_tail_seconds / total : 0.,
             m_stats.busiest_task_seconds,
             m_stats.idlest_task_seconds);
+        if (work_stealing) {
+            logger().debug(
+                "  stealing: {} steals moved {} operations between tasks",
+                m_stats.steals,
+                m_stats.stolen_elements);
+        }
     }
 
     // Totals for the whole pass. Written once per task, at the end -- see CountFlusher.
     std::atomic_int cnt_success = 0;
     std::atomic_int cnt_fail = 0;
     PassStats m_stats;
+
+    /// Operation names by handle, and the reverse. Only ever appended to, and never during a
+    /// pass, so the workers read both without locking.
+    std::vector<Op> m_op_names;
+    std::map<Op, uint32_t> m_op_index;
+    /// The entry of `edit_operation_maps` for each handle, or null. Rebuilt at the start of
+    /// every pass, read-only during it.
+    std::vector<OperationFn*> m_op_fn;
+
+    /**
+     * @brief Per-thread scratch for keeping one of each renewal; see `renew_key_by_handle`.
+     *
+     * The renewals of one operation go to `items`, and `dedup` compacts them through an open
+     * addressing table keyed on (op, key). `stamp[s] == epoch` marks a slot taken by the
+     * current batch, and the epoch is bumped per batch instead of clearing the table, so a
+     * batch costs its own size and not the table's.
+     */
+    struct RenewDedup
+    {
+        std::vector<OpTuple> items;
+        std::vector<uint64_t> keys;
+        std::vector<uint32_t> stamp;
+        std::vector<uint32_t> slot_item; // index into items, valid where stamp == epoch
+        uint32_t epoch = 0;
+        size_t dropped = 0; // this pass
+
+        void clear()
+        {
+            items.clear();
+            keys.clear();
+        }
+        void add(const OpHandle op, const Tuple& t, const uint64_t key)
+        {
+            items.emplace_back(op, t);
+            keys.push_back(key);
+        }
+        /// Keep the first of each (op, key), holding the greatest of its Tuples.
+        void dedup()
+        {
+            const size_t n = items.size();
+            if (n < 2) return;
+            if (stamp.size() < 2 * n) {
+                size_t cap = 64;
+                while (cap < 2 * n) cap *= 2;
+                stamp.assign(cap, 0);
+                slot_item.resize(cap);
+                epoch = 0;
+            }
+            if (++epoch == 0) {
+                std::fill(stamp.begin(), stamp.end(), 0);
+                epoch = 1;
+            }
+            const size_t mask = stamp.size() - 1;
+            size_t kept = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const OpHandle op = items[i].first;
+                const uint64_t h = (keys[i] ^ (uint64_t(op.id) << 56)) * 0x9E3779B97F4A7C15ull;
+                for (size_t s = (h >> 32) & mask;; s = (s + 1) & mask) {
+                    if (stamp[s] != epoch) {
+                        stamp[s] = epoch;
+                        slot_item[s] = uint32_t(kept);
+                        keys[kept] = keys[i];
+                        items[kept] = items[i];
+                        ++kept;
+                        break;
+                    }
+                    OpTuple& other = items[slot_item[s]];
+                    if (keys[slot_item[s]] == keys[i] && other.first == op) {
+                        if (other.second < items[i].second) {
+                            other.second = items[i].second;
+                        }
+                        break;
+                    }
+                }
+            }
+            dropped += n - kept;
+            items.erase(items.begin() + kept, items.end());
+            keys.erase(keys.begin() + kept, keys.end());
+        }
+    };
+    threading::enumerable_thread_specific<RenewDedup> m_renew_dedup;
 };
 } // namespace wmtk
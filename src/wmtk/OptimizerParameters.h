@@ -171,6 +171,21 @@ struct OptimizerParameters
     double w_amips = 1e-4;
     /// "projected" or "exact"; see SmoothVertexOptions::SmoothingMode.
     std::string smoothing_mode = "projected";
+    /// "polysolve" or "newton"; see SmoothVertexOptions::Solver.
+    std::string smoothing_solver = "polysolve";
+    /**
+     * How smooth_all_vertices runs: "pass" or "colored".
+     *
+     * "pass" queues one operation per vertex on the executor, which claims the vertex's
+     * one-ring with spin locks and records every attribute write for rollback. "colored" colors
+     * the vertices once per call so that no two of a color share a cell (utils::color_vertices)
+     * and smooths the classes one after another, each fully in parallel with no locks, no
+     * rollback log and no serial tail. Smoothing never changes connectivity, so one coloring
+     * serves every iteration of the call, and within a class every vertex reads neighbours no
+     * classmate can move -- the moves are independent and the result is the same at any
+     * thread count.
+     */
+    std::string smoothing_engine = "pass";
     /// Bisections tried before the projected search gives up. See SmoothVertexOptions.
     int project_line_search_steps = 12;
     /// Partial-projection bisections tried after it gives up; 0 disables that pass.
@@ -313,6 +328,58 @@ struct OptimizerParameters
      */
     int coarsen_max_inner_passes = 1;
 
+    // ---- Scheduler --------------------------------------------------------
+    /**
+     * Let a pass's idle threads take work from busy ones (ExecutePass::work_stealing).
+     *
+     * Parallel passes only. Off by default: the partition is cut to equal vertex counts rather
+     * than equal work, so on uneven inputs one thread finishes last while the rest wait, and
+     * stealing addresses exactly that -- but it puts a lock on every queue access and makes
+     * the order operations run in depend on timing.
+     */
+    bool work_stealing = false;
+    /**
+     * How a parallel pass keeps concurrent operations apart: "partition" or "color".
+     *
+     * "partition" runs one queue per partition and claims each operation's vertex ring with
+     * spin locks, retrying on conflict and finishing with a serial queue of whatever kept
+     * losing. "color" takes the same rings up front, colors the operations so no two of a color
+     * share a vertex, and runs each color class in parallel with no locks at all -- no lock
+     * failures and no serial tail, at the price of a barrier per class. See
+     * ExecutionPolicy::kColor.
+     */
+    std::string scheduler = "partition";
+    /**
+     * The priority queue the passes keep their operations in: "binary", "dary" or "bucket".
+     *
+     * "binary" and "dary" pop in the same order, so they give the same mesh; the d-ary heap
+     * moves fewer bytes per sift and is ~10% cheaper per queued operation
+     * (ExecutePass::queue_kind). "bucket" additionally lets the edge split and collapse passes,
+     * whose longest-first / shortest-first order is only a heuristic, use a queue ordered to
+     * within a few percent of the edge length, at a fraction of a heap's cost; every other pass
+     * keeps the exact order with the d-ary heap. That changes the output mesh.
+     */
+    std::string scheduler_queue = "binary";
+    /**
+     * Keep a tet-tet face adjacency table (TetMesh::enable_face_adjacency).
+     *
+     * On by default here, unlike in TetMesh: every operation the optimizers run walks across
+     * faces -- canonical edge ids, incident tets, boundary and link checks -- and the table
+     * turns each of those walks from a star search into a lookup, for four indices per tet slot.
+     */
+    bool face_adjacency = true;
+    /**
+     * Renumber vertices and cells along a Morton curve each time the optimizer consolidates
+     * the mesh (TetMesh::consolidate_mesh(const std::vector<uint64_t>&)).
+     *
+     * Splits append their new elements at the end of the arrays, so after a few iterations the
+     * neighbours of a vertex are scattered over the whole mesh and every ring walk is a series
+     * of cache misses. Renumbering puts spatial neighbours back next to each other in memory,
+     * for the price of a sort per iteration. Off by default: it changes the order operations
+     * are queued in, and with it the output, whenever priorities tie.
+     */
+    bool spatial_reorder = false;
+
     bool debug_output = false;
     bool perform_sanity_checks = false;
 
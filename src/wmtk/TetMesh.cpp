@@ -3,26 +3,22 @@
 #include <wmtk/AttributeCollection.hpp>
 #include <wmtk/threading/parallel_for.hpp>
 #include <wmtk/utils/EnableWarnings.hpp>
+#include <wmtk/utils/Reindexing.hpp>
 #include <wmtk/utils/TupleUtils.hpp>
 
 namespace wmtk {
 
-// Atomically reserve `n` contiguous fresh tet slots from the preallocated storage.
-// Returns the first index of the block, or -1 if the reservation would exceed the
-// preallocated capacity -- in that case the caller must abort the operation. On the
-// (rare) failure the counter is left advanced; those unusable slots are reclaimed at
-// the next consolidate_mesh(). This is the only place the tet counter grows during
-// operations, and it never resizes the storage (no more thread-safe growth).
+// Atomically reserve `n` contiguous fresh tet slots. The storage is grown first, if the
+// block would not fit, and the counter advanced after: a slot below current_tet_size is
+// always backed by storage, whichever thread is reading it. Returns -1, without advancing
+// the counter, if the storage cannot grow that far -- the caller must then abort the
+// operation.
 long TetMesh::request_tet_slots(size_t n)
 {
     if (n == 0) return (long)current_tet_size.load();
-    const long cap = (long)m_tet_connectivity.size();
-    // CAS loop: only advance the counter when there is room, so a failed request
-    // never leaks slots (which would push current_tet_size past the storage size
-    // and make later iteration go out of bounds).
     long first = current_tet_size.load(std::memory_order_relaxed);
     do {
-        if (first + (long)n > cap) return -1;
+        if (!grow_tet_storage(first + n)) return -1;
     } while (!current_tet_size.compare_exchange_weak(
         first,
         first + (long)n,
@@ -30,7 +26,7 @@ long TetMesh::request_tet_slots(size_t n)
         std::memory_order_relaxed));
     // Reset the handed-out slots to a clean state. The old tbb::collector
     // shrank on consolidate and regrew fresh slots, so allocations were always
-    // clean; the preallocated std::vector keeps stale data in the spare region, so
+    // clean; the preallocated storage keeps stale data in the spare region, so
     // we must clear it here (matches old behaviour: default tet, hash = -1).
     for (long i = first; i < first + (long)n; ++i) {
         m_tet_connectivity[i] = TetrahedronConnectivity{};
@@ -42,10 +38,9 @@ long TetMesh::request_tet_slots(size_t n)
 long TetMesh::request_vert_slots(size_t n)
 {
     if (n == 0) return (long)current_vert_size.load();
-    const long cap = (long)m_vertex_connectivity.size();
     long first = current_vert_size.load(std::memory_order_relaxed);
     do {
-        if (first + (long)n > cap) return -1;
+        if (!grow_vert_storage(first + n)) return -1;
     } while (!current_vert_size.compare_exchange_weak(
         first,
         first + (long)n,
@@ -58,14 +53,152 @@ long TetMesh::request_vert_slots(size_t n)
     return first;
 }
 
+bool TetMesh::grow_tet_storage(size_t n)
+{
+    if (m_tet_storage_size.load(std::memory_order_acquire) >= n) return true;
+    std::lock_guard<std::mutex> lock(m_storage_mutex);
+    if (m_tet_storage_size.load(std::memory_order_relaxed) >= n) return true;
+    if (n > size_t(std::numeric_limits<index_t>::max())) return false;
+    // The connectivity rounds up to a whole chunk; everything else follows it, so the next
+    // chunk's worth of requests takes the fast path above.
+    m_tet_connectivity.grow_to_at_least(n);
+    const size_t cap = m_tet_connectivity.size();
+    if (m_tet_adjacency_enabled) m_tet_adjacency.grow_to_at_least(cap);
+    if (p_tet_attrs && !p_tet_attrs->grow(cap)) return false;
+    if (p_face_attrs && !p_face_attrs->grow(4 * cap)) return false;
+    if (p_edge_attrs && !p_edge_attrs->grow(6 * cap)) return false;
+    m_tet_storage_size.store(cap, std::memory_order_release);
+    return true;
+}
+
+bool TetMesh::grow_vert_storage(size_t n)
+{
+    if (m_vert_storage_size.load(std::memory_order_acquire) >= n) return true;
+    std::lock_guard<std::mutex> lock(m_storage_mutex);
+    if (m_vert_storage_size.load(std::memory_order_relaxed) >= n) return true;
+    if (n > size_t(std::numeric_limits<index_t>::max())) return false;
+    m_vertex_connectivity.grow_to_at_least(n);
+    const size_t cap = m_vertex_connectivity.size();
+    m_vertex_mutex.grow_to_at_least(cap);
+    if (p_vertex_attrs && !p_vertex_attrs->grow(cap)) return false;
+    m_vert_storage_size.store(cap, std::memory_order_release);
+    return true;
+}
+
 int TetMesh::get_next_empty_slot_t()
 {
-    return (int)request_tet_slots(1);
+    return (int)acquire_tet_slot();
 }
 
 int TetMesh::get_next_empty_slot_v()
 {
-    return (int)request_vert_slots(1);
+    return (int)acquire_vert_slot();
+}
+
+long TetMesh::acquire_tet_slot()
+{
+    auto& cache = m_slot_cache.local();
+    long t;
+    if (!cache.free_tets.empty()) {
+        t = (long)cache.free_tets.back();
+        cache.free_tets.pop_back();
+        // Count on from the last tet's hash rather than restarting from -1 as a fresh slot
+        // does: a Tuple still naming that tet must not become valid again. The slot is
+        // revived in place, removal flag last, so that another worker looking at it sees
+        // either the removed old tet or the new hash -- never a live tet with a default record.
+        TetrahedronConnectivity& slot = m_tet_connectivity[t];
+        assert(slot.m_is_removed);
+        slot.m_indices.fill(0);
+        slot.hash += 1;
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.m_is_removed = false;
+    } else {
+        t = request_tet_slots(1);
+        if (t < 0) return -1;
+    }
+    cache.taken_tets.push_back((size_t)t);
+    return t;
+}
+
+long TetMesh::acquire_vert_slot()
+{
+    auto& cache = m_slot_cache.local();
+    long v;
+    if (!cache.free_verts.empty()) {
+        v = (long)cache.free_verts.back();
+        cache.free_verts.pop_back();
+        m_vertex_connectivity[v] = VertexConnectivity{};
+    } else {
+        v = request_vert_slots(1);
+        if (v < 0) return -1;
+    }
+    cache.taken_verts.push_back((size_t)v);
+    return v;
+}
+
+void TetMesh::release_unused_tet_slots(const std::vector<size_t>& tids)
+{
+    auto& cache = m_slot_cache.local();
+    for (const size_t t : tids) {
+        m_tet_connectivity[t].m_is_removed = true;
+        auto it = std::find(cache.taken_tets.begin(), cache.taken_tets.end(), t);
+        assert(it != cache.taken_tets.end());
+        cache.taken_tets.erase(it);
+        cache.free_tets.push_back(t);
+    }
+}
+
+void TetMesh::release_unused_vert_slots(const std::vector<size_t>& vids)
+{
+    auto& cache = m_slot_cache.local();
+    for (const size_t v : vids) {
+        m_vertex_connectivity[v].m_is_removed = true;
+        auto it = std::find(cache.taken_verts.begin(), cache.taken_verts.end(), v);
+        assert(it != cache.taken_verts.end());
+        cache.taken_verts.erase(it);
+        cache.free_verts.push_back(v);
+    }
+}
+
+void TetMesh::commit_slot_journal()
+{
+    auto& cache = m_slot_cache.local();
+    cache.free_tets.insert(
+        cache.free_tets.end(),
+        cache.retired_tets.begin(),
+        cache.retired_tets.end());
+    cache.free_verts.insert(
+        cache.free_verts.end(),
+        cache.retired_verts.begin(),
+        cache.retired_verts.end());
+    cache.taken_tets.clear();
+    cache.taken_verts.clear();
+    cache.retired_tets.clear();
+    cache.retired_verts.clear();
+}
+
+void TetMesh::rollback_slot_journal()
+{
+    auto& cache = m_slot_cache.local();
+    // The rollback has removed what the operation created; anything still live was never
+    // handed over (an operation that failed before it got that far).
+    for (const size_t t : cache.taken_tets) {
+        if (m_tet_connectivity[t].m_is_removed) cache.free_tets.push_back(t);
+    }
+    for (const size_t v : cache.taken_verts) {
+        if (m_vertex_connectivity[v].m_is_removed) cache.free_verts.push_back(v);
+    }
+    cache.taken_tets.clear();
+    cache.taken_verts.clear();
+    cache.retired_tets.clear();
+    cache.retired_verts.clear();
+}
+
+void TetMesh::clear_free_slots()
+{
+    for (SlotCache& cache : m_slot_cache) {
+        cache = SlotCache{};
+    }
 }
 
 TetMesh::TetMesh()
@@ -87,8 +220,9 @@ void TetMesh::init(size_t n_vertices, const std::vector<std::array<size_t, 4>>&
     m_tet_connectivity.resize(tcap);
     current_vert_size = (long)n_vertices;
     current_tet_size = (long)tets.size();
+    clear_free_slots();
     for (int i = 0; i < tets.size(); i++) {
-        m_tet_connectivity[i].m_indices = tets[i];
+        m_tet_connectivity[i].m_indices = array_cast<index_t>(tets[i]);
         for (int j = 0; j < 4; j++) {
             assert(tets[i][j] < vert_capacity());
             m_vertex_connectivity[tets[i][j]].m_conn_tets.push_back(i);
@@ -111,6 +245,12 @@ void TetMesh::init(size_t n_vertices, const std::vector<std::array<size_t, 4>>&
     if (p_edge_attrs != nullptr) {
         p_edge_attrs->resize(6 * tcap);
     }
+    m_vert_storage_size = vcap;
+    m_tet_storage_size = tcap;
+
+    if (m_tet_adjacency_enabled) {
+        rebuild_face_adjacency();
+    }
 }
 
 void TetMesh::init_with_isolated_vertices(
@@ -125,8 +265,9 @@ void TetMesh::init_with_isolated_vertices(
     m_tet_connectivity.resize(tcap);
     current_vert_size = (long)n_vertices;
     current_tet_size = (long)tets.size();
+    clear_free_slots();
     for (size_t i = 0; i < tets.size(); i++) {
-        m_tet_connectivity[i].m_indices = tets[i];
+        m_tet_connectivity[i].m_indices = array_cast<index_t>(tets[i]);
         for (int j = 0; j < 4; j++) {
             assert(tets[i][j] < vert_capacity());
             m_vertex_connectivity[tets[i][j]].m_conn_tets.push_back(i);
@@ -159,6 +300,12 @@ void TetMesh::init_with_isolated_vertices(
         p_edge_attrs->clear();
         p_edge_attrs->resize(6 * tcap);
     }
+    m_vert_storage_size = vcap;
+    m_tet_storage_size = tcap;
+
+    if (m_tet_adjacency_enabled) {
+        rebuild_face_adjacency();
+    }
 }
 
 void TetMesh::init(const MatrixXi& T)
@@ -255,7 +402,7 @@ std::vector<TetMesh::Tuple> TetMesh::get_faces() const
 
 bool TetMesh::check_mesh_connectivity_validity() const
 {
-    std::vector<std::vector<size_t>> conn_tets(vert_capacity());
+    std::vector<std::vector<index_t>> conn_tets(vert_capacity());
     for (size_t i = 0; i < tet_capacity(); i++) {
         if (m_tet_connectivity[i].m_is_removed) continue;
         for (int j = 0; j < 4; j++) conn_tets[m_tet_connectivity[i][j]].push_back(i);
@@ -429,7 +576,7 @@ size_t TetMesh::lowest_common_tet(const size_t v0_id, const size_t v1_id, const
     // m_conn_tets is sorted, so scanning upward returns the lowest common tet id -- the
     // canonicalisation the global face id depends on, since a face shared by two tets
     // must get the same id from either side.
-    const std::vector<size_t>* fan = &t0;
+    const StarVector* fan = &t0;
     size_t other_a = v1_id;
     size_t other_b = v2_id;
     if (t1.size() < fan->size()) {
@@ -655,9 +802,9 @@ TetMesh::Tuple TetMesh::tuple_from_vids(size_t vid0, size_t vid1, size_t vid2, s
     const auto& vf2 = m_vertex_connectivity[vid2];
     const auto& vf3 = m_vertex_connectivity[vid3];
 
-    const std::vector<size_t> tets01 = set_intersection(vf0.m_conn_tets, vf1.m_conn_tets);
-    const std::vector<size_t> tets012 = set_intersection(tets01, vf2.m_conn_tets);
-    const std::vector<size_t> tets0123 = set_intersection(tets012, vf3.m_conn_tets);
+    const auto tets01 = set_intersection(vf0.m_conn_tets, vf1.m_conn_tets);
+    const auto tets012 = set_intersection(tets01, vf2.m_conn_tets);
+    const auto tets0123 = set_intersection(tets012, vf3.m_conn_tets);
 
     if (tets0123.size() != 1) {
         log_and_throw_error("Cannot find tet with vids ({},{},{},{})", vid0, vid1, vid2, vid3);
@@ -726,7 +873,7 @@ std::array<size_t, 4> TetMesh::oriented_tet_vids(const Tuple& t) const
 
 std::array<size_t, 4> TetMesh::oriented_tet_vids(const size_t tid) const
 {
-    return m_tet_connectivity[tid].m_indices;
+    return array_cast<size_t>(m_tet_connectivity[tid].m_indices);
 }
 
 std::array<TetMesh::Tuple, 3> TetMesh::get_face_vertices(const Tuple& t) const
@@ -760,12 +907,12 @@ std::array<TetMesh::Tuple, 6> TetMesh::tet_edges(const Tuple& t) const
     return es;
 }
 
-const std::vector<size_t>& TetMesh::get_one_ring_tids_for_vertex(const Tuple& t) const
+const TetMesh::StarVector& TetMesh::get_one_ring_tids_for_vertex(const Tuple& t) const
 {
     return get_one_ring_tids_for_vertex(t.m_global_vid);
 }
 
-const std::vector<size_t>& TetMesh::get_one_ring_tids_for_vertex(const size_t vid) const
+const TetMesh::StarVector& TetMesh::get_one_ring_tids_for_vertex(const size_t vid) const
 {
     // The fan IS the stored connectivity, so hand it back rather than copying it. Matches
     // TriMesh::get_one_ring_fids_for_vertex, which has always returned a reference.
@@ -886,10 +1033,9 @@ std::vector<size_t> TetMesh::get_incident_tids_for_edge(const Tuple& t) const
 
 std::vector<size_t> TetMesh::get_incident_tids_for_edge(const size_t vid0, const size_t vid1) const
 {
-    auto tids = set_intersection(
+    return vector_cast<size_t>(set_intersection(
         m_vertex_connectivity[vid0].m_conn_tets,
-        m_vertex_connectivity[vid1].m_conn_tets);
-    return tids;
+        m_vertex_connectivity[vid1].m_conn_tets));
 }
 
 std::vector<TetMesh::Tuple> TetMesh::get_one_ring_tets_for_edge(const Tuple& t) const
@@ -912,87 +1058,152 @@ std::vector<TetMesh::Tuple> TetMesh::get_one_ring_tets_for_edge(const Tuple& t)
 }
 
 
-void TetMesh::consolidate_mesh()
+void TetMesh::enable_face_adjacency(bool enable)
 {
-    auto v_cnt = 0;
-    std::vector<size_t> map_v_ids(vert_capacity(), -1);
-    for (auto i = 0; i < vert_capacity(); i++) {
-        if (m_vertex_connectivity[i].m_is_removed) continue;
-        map_v_ids[i] = v_cnt;
-        v_cnt++;
-    }
-    auto t_cnt = 0;
-    std::vector<size_t> map_t_ids(tet_capacity(), -1);
-    for (auto i = 0; i < tet_capacity(); i++) {
-        if (m_tet_connectivity[i].m_is_removed) continue;
-        map_t_ids[i] = t_cnt;
-        t_cnt++;
+    m_tet_adjacency_enabled = enable;
+    if (enable) {
+        rebuild_face_adjacency();
+    } else {
+        invalidate_face_adjacency();
+        m_tet_adjacency.clear();
     }
+}
 
-    v_cnt = 0;
-    for (auto i = 0; i < vert_capacity(); i++) {
-        if (m_vertex_connectivity[i].m_is_removed) continue;
-        if (v_cnt != i) {
-            assert(v_cnt < i);
-            m_vertex_connectivity[v_cnt] = m_vertex_connectivity[i];
-            if (p_vertex_attrs) {
-                p_vertex_attrs->move(i, v_cnt);
+void TetMesh::rebuild_face_adjacency()
+{
+    invalidate_face_adjacency();
+    m_tet_adjacency.assign(m_tet_connectivity.size(), no_face_neighbors());
+    // Each tet writes only its own row.
+    threading::parallel_for(
+        threading::range(0, tet_capacity(), 1024),
+        [&](const threading::range& r) {
+            for (size_t t = r.begin(); t < r.end(); ++t) {
+                if (m_tet_connectivity[t].m_is_removed) continue;
+                for (int f = 0; f < 4; ++f) {
+                    m_tet_adjacency[t][f] = find_face_neighbor(t, f);
+                }
             }
-        }
-        for (size_t& t_id : m_vertex_connectivity[v_cnt].m_conn_tets) t_id = map_t_ids[t_id];
-        v_cnt++;
+        },
+        NUM_THREADS);
+    m_tet_adjacency_valid.store(true, std::memory_order_relaxed);
+}
+
+void TetMesh::consolidate_mesh()
+{
+    consolidate_mesh({});
+}
+
+void TetMesh::consolidate_mesh(const std::vector<uint64_t>& vertex_keys)
+{
+    const bool reorder = !vertex_keys.empty();
+    assert(!reorder || vertex_keys.size() >= vert_capacity());
+
+    std::vector<size_t> map_v_ids, v_order;
+    compact_ids(
+        vert_capacity(),
+        [&](size_t i) { return !m_vertex_connectivity[i].m_is_removed; },
+        NUM_THREADS,
+        map_v_ids,
+        v_order);
+    std::vector<size_t> map_t_ids, t_order;
+    compact_ids(
+        tet_capacity(),
+        [&](size_t i) { return !m_tet_connectivity[i].m_is_removed; },
+        NUM_THREADS,
+        map_t_ids,
+        t_order);
+    if (reorder) {
+        sort_ids_by_key([&](size_t v) { return vertex_keys[v]; }, NUM_THREADS, map_v_ids, v_order);
+        // A tet goes where its first vertex in the new order is, so the tets of a star end
+        // up next to each other as well as next to the vertex.
+        sort_ids_by_key(
+            [&](size_t t) {
+                const auto& vs = m_tet_connectivity[t].m_indices;
+                return uint64_t(std::min(
+                    std::min(map_v_ids[vs[0]], map_v_ids[vs[1]]),
+                    std::min(map_v_ids[vs[2]], map_v_ids[vs[3]])));
+            },
+            NUM_THREADS,
+            map_t_ids,
+            t_order);
     }
-    t_cnt = 0;
-    for (int i = 0; i < tet_capacity(); i++) {
-        if (m_tet_connectivity[i].m_is_removed) continue;
+    const size_t v_cnt = v_order.size();
+    const size_t t_cnt = t_order.size();
 
-        if (t_cnt != i) {
-            assert(t_cnt < i);
-            m_tet_connectivity[t_cnt] = m_tet_connectivity[i];
-            m_tet_connectivity[t_cnt].hash = 0;
-            if (p_tet_attrs) {
-                p_tet_attrs->move(i, t_cnt);
-            }
+    // Re-establish spare capacity for the next round of operations (only [0,live)
+    // is live; the rest is preallocated headroom that operations consume).
+    const size_t vcap = reserved_capacity(v_cnt);
+    const size_t tcap = reserved_capacity(t_cnt);
 
-            if (p_face_attrs) {
-                for (auto j = 0; j < 4; j++) {
-                    p_face_attrs->move(i * 4 + j, t_cnt * 4 + j);
+    // Everything is gathered into fresh storage rather than compacted in place: that is what
+    // lets each element move independently of the others, in parallel and in any order.
+    {
+        SegmentedVector<VertexConnectivity> vertices(vcap);
+        threading::parallel_for(
+            threading::range(0, v_cnt, 1024),
+            [&](const threading::range& r) {
+                for (size_t k = r.begin(); k < r.end(); ++k) {
+                    vertices[k] = std::move(m_vertex_connectivity[v_order[k]]);
+                    auto& star = vertices[k].m_conn_tets;
+                    for (index_t& t_id : star) t_id = map_t_ids[t_id];
+                    // Only a reordering can take the star out of sorted order.
+                    if (reorder) std::sort(star.begin(), star.end());
                 }
-            }
-            if (p_edge_attrs) {
-                for (auto j = 0; j < 6; j++) {
-                    p_edge_attrs->move(i * 6 + j, t_cnt * 6 + j);
+            },
+            NUM_THREADS);
+        m_vertex_connectivity.swap(vertices);
+    }
+    // A current table moves with its tets and only needs its ids renamed; a stale one is
+    // rebuilt from scratch below.
+    const bool remap_adjacency = has_face_adjacency();
+    {
+        SegmentedVector<TetrahedronConnectivity> tets(tcap);
+        SegmentedVector<std::array<size_t, 4>> adjacency;
+        if (remap_adjacency) adjacency.assign(tcap, no_face_neighbors());
+        threading::parallel_for(
+            threading::range(0, t_cnt, 1024),
+            [&](const threading::range& r) {
+                for (size_t k = r.begin(); k < r.end(); ++k) {
+                    const size_t i = t_order[k];
+                    tets[k] = m_tet_connectivity[i];
+                    tets[k].hash = 0;
+                    for (index_t& v_id : tets[k].m_indices) v_id = map_v_ids[v_id];
+                    if (remap_adjacency) {
+                        for (int f = 0; f < 4; ++f) {
+                            const size_t n = m_tet_adjacency[i][f];
+                            if (n != std::numeric_limits<size_t>::max()) adjacency[k][f] = map_t_ids[n];
+                        }
+                    }
                 }
-            }
-        }
-        for (size_t& v_id : m_tet_connectivity[t_cnt].m_indices) v_id = map_v_ids[v_id];
-        t_cnt++;
+            },
+            NUM_THREADS);
+        m_tet_connectivity.swap(tets);
+        if (remap_adjacency) m_tet_adjacency.swap(adjacency);
     }
 
     current_vert_size = v_cnt;
     current_tet_size = t_cnt;
+    clear_free_slots();
 
-    // Re-establish spare capacity for the next round of operations (only [0,live)
-    // is live; the rest is preallocated headroom that operations consume).
-    const size_t vcap = reserved_capacity(v_cnt);
-    const size_t tcap = reserved_capacity(t_cnt);
-
-    m_vertex_connectivity.resize(vcap);
-    m_tet_connectivity.resize(tcap);
     resize_vertex_mutex(vcap);
+    if (m_tet_adjacency_enabled && !remap_adjacency) {
+        rebuild_face_adjacency();
+    }
 
     if (p_vertex_attrs) {
-        p_vertex_attrs->resize(vcap);
+        p_vertex_attrs->gather(v_order, 1, vcap, NUM_THREADS);
     }
     if (p_edge_attrs) {
-        p_edge_attrs->resize(6 * tcap);
+        p_edge_attrs->gather(t_order, 6, tcap, NUM_THREADS);
     }
     if (p_face_attrs) {
-        p_face_attrs->resize(4 * tcap);
+        p_face_attrs->gather(t_order, 4, tcap, NUM_THREADS);
     }
     if (p_tet_attrs) {
-        p_tet_attrs->resize(tcap);
+        p_tet_attrs->gather(t_order, 1, tcap, NUM_THREADS);
     }
+    m_vert_storage_size = vcap;
+    m_tet_storage_size = tcap;
 
     assert(check_mesh_connectivity_validity());
 }
@@ -1065,6 +1276,8 @@ bool TetMesh::lock_vertex_ball(
     // what makes the BFS expand through them -- the flaw in the hand-written two-ring lockers
     // this replaces was to `continue` past them and never look at their neighbours.
     const auto claim = [&](size_t vid) {
+        // The ball can reach a vertex another thread created after `cap` was read.
+        if (vid >= scr.stamp.size()) scr.stamp.resize(m_vertex_connectivity.size(), 0);
         if (scr.stamp[vid] == epoch) {
             return true;
         }
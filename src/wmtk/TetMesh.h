@@ -8,6 +8,8 @@
 #include <wmtk/threading/enumerable_thread_specific.hpp>
 #include <wmtk/threading/vertex_mutex.hpp>
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/SegmentedVector.hpp>
+#include <wmtk/utils/SmallVector.hpp>
 
 #include <array>
 #include <atomic>
@@ -16,7 +18,9 @@
 #include <cstdint>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <optional>
+#include <tuple>
 #include <vector>
 
 namespace wmtk {
@@ -47,12 +51,13 @@ public:
      */
     class Tuple
     {
-        size_t m_global_vid = std::numeric_limits<size_t>::max();
-        size_t m_local_eid = std::numeric_limits<size_t>::max();
-        size_t m_local_fid = std::numeric_limits<size_t>::max();
-        size_t m_global_tid = std::numeric_limits<size_t>::max();
-
+        // Largest fields first, so the tuple packs to 24 bytes, or 16 with WMTK_COMPACT_INDICES.
+        // Every ExecutePass queue element and every tuple vector carries one.
+        index_t m_global_vid = std::numeric_limits<index_t>::max();
+        index_t m_global_tid = std::numeric_limits<index_t>::max();
         int m_hash = 0;
+        std::uint8_t m_local_eid = std::numeric_limits<std::uint8_t>::max();
+        std::uint8_t m_local_fid = std::numeric_limits<std::uint8_t>::max();
 
     private:
         /**
@@ -238,6 +243,12 @@ public:
         void check_validity() const { return m_tuple.check_validity(m_mesh); }
     };
 
+    /**
+     * The tets around a vertex, sorted. An interior vertex of a tetwild mesh has around 20-25,
+     * so up to 24 are stored inline in the vertex record; see SmallVector.
+     */
+    using StarVector = SmallVector<index_t, 24>;
+
     /**
      * (internal use) Maintains a list of tetra connected to the given vertex, and a flag to
      * mark removal.
@@ -246,10 +257,10 @@ public:
     class VertexConnectivity
     {
     public:
-        std::vector<size_t> m_conn_tets; // todo: always keep it sorted
+        StarVector m_conn_tets; // todo: always keep it sorted
         bool m_is_removed = false;
 
-        size_t& operator[](const size_t index)
+        index_t& operator[](const size_t index)
         {
             assert(index < m_conn_tets.size());
             return m_conn_tets[index];
@@ -277,12 +288,12 @@ public:
     class TetrahedronConnectivity
     {
     public:
-        std::array<size_t, 4> m_indices;
+        std::array<index_t, 4> m_indices;
         bool m_is_removed = false;
 
         int hash = 0;
 
-        size_t& operator[](size_t index)
+        index_t& operator[](size_t index)
         {
             assert(index < 4);
             return m_indices[index];
@@ -591,6 +602,15 @@ public:
      *
      */
     void consolidate_mesh();
+    /**
+     * @brief consolidate_mesh, additionally renumbering the vertices in increasing order of
+     * `vertex_keys` (indexed by current vertex id) and the tets after their lowest new vertex id.
+     *
+     * With the keys of a space-filling curve (wmtk::morton_codes) neighbouring elements get
+     * nearby ids, so the passes that follow walk memory in roughly spatial order. An empty
+     * `vertex_keys` keeps the current order, as consolidate_mesh().
+     */
+    void consolidate_mesh(const std::vector<uint64_t>& vertex_keys);
 
     /**
      * Get all unique undirected edges in the mesh.
@@ -655,9 +675,15 @@ public:
     /**
      * @brief Preallocation factor: init/consolidate reserve capacity =
      * max(floor, ceil(factor * live_count)) so operations can grab fresh slots
-     * without resizing the storage. When a pass exhausts the reserved capacity the
-     * affected operations fail (and are retried later after a consolidate). Tune
-     * per application (e.g. from JSON); values < 1 are clamped to 1.
+     * without growing the storage. A pass that uses up the reserved capacity grows
+     * the storage as it goes (see grow_tet_storage), so the factor only decides how
+     * much is allocated up front. Tune per application (e.g. from JSON); values < 1
+     * are clamped to 1.
+     *
+     * Slots that operations remove are recycled (see SlotCache), so the headroom only has to
+     * cover how far the live count grows between consolidations, not every element an
+     * operation ever creates. Collapses and swaps then need next to none, which is why the
+     * default is low; raise it for passes that refine, to save them the growth.
      */
     void set_preallocation_factor(double factor)
     {
@@ -665,9 +691,32 @@ public:
     }
     double preallocation_factor() const { return m_preallocation_factor; }
 
-    // Atomically reserve `n` contiguous fresh tet/vertex slots. Returns the first
-    // index of the block, or -1 if that would exceed the preallocated capacity (the
-    // caller must then abort the operation before mutating any connectivity).
+    /**
+     * @brief Keep a tet-tet adjacency table, one neighbour per local face, so that
+     * switch_tetrahedron is a lookup instead of a search of a vertex star.
+     *
+     * switch_tetrahedron sits under every canonical edge and face id, incident-tet query,
+     * boundary test and link condition. Without the table it scans the star of the
+     * lowest-valence face vertex; with it, it is a load plus the same local-index fix-up.
+     *
+     * Off by default: the table is four indices per tet slot, and a decimation-only user that
+     * never walks across faces would pay that for nothing. It can be turned on before or after
+     * init. Operations that go through operation_update_connectivity_impl keep it current
+     * (and restore it on rollback); the few that edit connectivity directly -- face and tet
+     * splits, triangle insertion, remove_tets_by_ids -- mark it stale instead, and
+     * switch_tetrahedron then falls back to the search until consolidate_mesh rebuilds it.
+     */
+    void enable_face_adjacency(bool enable);
+    /// Whether switch_tetrahedron is currently answered from the table.
+    bool has_face_adjacency() const
+    {
+        return m_tet_adjacency_valid.load(std::memory_order_relaxed);
+    }
+
+    // Atomically reserve `n` contiguous fresh tet/vertex slots, growing the storage if
+    // the preallocated capacity is used up. Returns the first index of the block, or -1
+    // if the storage cannot grow that far (the caller must then abort the operation
+    // before mutating any connectivity).
     long request_tet_slots(size_t n);
     long request_vert_slots(size_t n);
 
@@ -682,9 +731,11 @@ public:
         if (m_tet_connectivity.size() >= need) return;
         const size_t newcap = std::max(need, m_tet_connectivity.size() * 2 + 1);
         m_tet_connectivity.resize(newcap);
+        if (m_tet_adjacency_enabled) m_tet_adjacency.resize(newcap, no_face_neighbors());
         if (p_tet_attrs) p_tet_attrs->resize(newcap);
         if (p_face_attrs) p_face_attrs->resize(4 * newcap);
         if (p_edge_attrs) p_edge_attrs->resize(6 * newcap);
+        m_tet_storage_size.store(newcap, std::memory_order_release);
     }
     void ensure_free_vert_capacity(size_t extra)
     {
@@ -694,6 +745,7 @@ public:
         m_vertex_connectivity.resize(newcap);
         resize_vertex_mutex(newcap);
         if (p_vertex_attrs) p_vertex_attrs->resize(newcap);
+        m_vert_storage_size.store(newcap, std::memory_order_release);
     }
 
 private:
@@ -707,18 +759,101 @@ private:
         return capacity < floor ? floor : capacity;
     }
 
-    // Stores the connectivity of the mesh
-    vector<VertexConnectivity> m_vertex_connectivity;
-    vector<TetrahedronConnectivity> m_tet_connectivity;
+    // Stores the connectivity of the mesh. Segmented so that request_*_slots can grow it
+    // while other operations are running: an element never moves once it is stored.
+    SegmentedVector<VertexConnectivity> m_vertex_connectivity;
+    SegmentedVector<TetrahedronConnectivity> m_tet_connectivity;
     std::atomic_long current_vert_size;
     std::atomic_long current_tet_size;
-    double m_preallocation_factor = 6.0;
+    double m_preallocation_factor = 1.5;
+
+    /**
+     * Grow everything stored per tet (per vertex) -- connectivity, face adjacency, vertex
+     * mutexes and the registered attributes -- to hold at least @p n of them. Thread-safe: this
+     * is what lets request_*_slots hand out slots past the preallocated capacity while other
+     * operations run. Returns false, leaving the storage size as it was, if @p n does not fit
+     * index_t or an attribute container cannot grow concurrently (see
+     * AbstractAttributeContainer::grow); the operation then fails as it did before the storage
+     * could grow.
+     */
+    bool grow_tet_storage(size_t n);
+    bool grow_vert_storage(size_t n);
+    // How many tets (vertices) all of the above hold. Only published once every container has
+    // grown, so a thread that sees it need not look at the containers themselves.
+    std::atomic<size_t> m_tet_storage_size{0};
+    std::atomic<size_t> m_vert_storage_size{0};
+    std::mutex m_storage_mutex;
+
+    // Face adjacency; see enable_face_adjacency. m_tet_adjacency[t][f] is the tet across
+    // local face f (m_local_faces order) of tet t, or -1 on the boundary. Sized with
+    // m_tet_connectivity while enabled, empty otherwise.
+    bool m_tet_adjacency_enabled = false;
+    std::atomic<bool> m_tet_adjacency_valid{false};
+    SegmentedVector<std::array<size_t, 4>> m_tet_adjacency;
+    // (tet, local face, old neighbour) for every slot the running operation overwrote, for
+    // operation_failure_rollback_imp. Slots rather than rows: a tet outside the operation
+    // shares only one face with it, and its other three slots may be read concurrently.
+    wmtk::threading::enumerable_thread_specific<std::vector<std::tuple<size_t, int, size_t>>>
+        m_tet_adjacency_rollback;
+    static std::array<size_t, 4> no_face_neighbors()
+    {
+        const size_t none = std::numeric_limits<size_t>::max();
+        return {{none, none, none, none}};
+    }
+    /// The tet other than @p tid holding all of @p v0, @p v1, @p v2, by searching a star.
+    size_t find_face_neighbor(size_t tid, size_t v0, size_t v1, size_t v2) const;
+    size_t find_face_neighbor(size_t tid, int local_fid) const;
+    void rebuild_face_adjacency();
+    void invalidate_face_adjacency()
+    {
+        m_tet_adjacency_valid.store(false, std::memory_order_relaxed);
+    }
 
     int m_t_empty_slot = 0;
     int m_v_empty_slot = 0;
     int get_next_empty_slot_t();
     int get_next_empty_slot_v();
 
+    /**
+     * Slot recycling, per thread. A slot removed by a committed operation goes onto the free
+     * list of the thread that ran it, and that thread's later operations take their slots from
+     * there before drawing fresh ones from the preallocated headroom. Per thread, so that
+     * taking a slot needs no synchronisation, and so that a thread keeps reusing slots in the
+     * part of the mesh it works on.
+     *
+     * Each thread journals the slots its running operation takes and removes: removed slots
+     * become free only when the operation commits (release_protect_attributes), since a
+     * rollback restores them; taken slots go back on the free list if it rolls back
+     * (rollback_protected_attributes), since the rollback removes them again.
+     *
+     * A recycled tet slot keeps counting up its hash, so a Tuple that still names the tet
+     * that used to live there stays invalid. The free lists hold ids, which consolidate_mesh
+     * invalidates; it and init empty them.
+     */
+    struct SlotCache
+    {
+        std::vector<size_t> free_tets;
+        std::vector<size_t> free_verts;
+        // The running operation's journal.
+        std::vector<size_t> taken_tets;
+        std::vector<size_t> taken_verts;
+        std::vector<size_t> retired_tets;
+        std::vector<size_t> retired_verts;
+    };
+    wmtk::threading::enumerable_thread_specific<SlotCache> m_slot_cache;
+    /// A free tet or vertex slot, reset to a live, empty element; -1 if there is none left.
+    long acquire_tet_slot();
+    long acquire_vert_slot();
+    /// Give back slots acquire_*_slot handed to the running operation and it did not use.
+    void release_unused_tet_slots(const std::vector<size_t>& tids);
+    void release_unused_vert_slots(const std::vector<size_t>& vids);
+    /// Note that the running operation removed a slot; it becomes free when it commits.
+    void retire_tet_slot(size_t tid) { m_slot_cache.local().retired_tets.push_back(tid); }
+    void retire_vert_slot(size_t vid) { m_slot_cache.local().retired_verts.push_back(vid); }
+    void commit_slot_journal();
+    void rollback_slot_journal();
+    void clear_free_slots();
+
     // TODO: subdivide_tets function should not be in the TetMesh API.
     void subdivide_tets(
         const std::vector<size_t> t_ids,
@@ -1085,10 +1220,10 @@ public:
      * @brief Get the one ring tids for vertex
      *
      * @param t a Tuple that refers to a vertex
-     * @return std::vector<size_t> a vector of vids
+     * @return the sorted tids, as stored in the vertex's star
      */
-    const std::vector<size_t>& get_one_ring_tids_for_vertex(const Tuple& t) const;
-    const std::vector<size_t>& get_one_ring_tids_for_vertex(const size_t vid) const;
+    const StarVector& get_one_ring_tids_for_vertex(const Tuple& t) const;
+    const StarVector& get_one_ring_tids_for_vertex(const size_t vid) const;
 
     /**
      * @brief Get the one ring vertices for a vertex
@@ -1196,6 +1331,7 @@ public:
      */
     void remove_tets_by_ids(const std::vector<size_t>& tids)
     {
+        invalidate_face_adjacency();
         for (size_t tid : tids) {
             m_tet_connectivity[tid].m_is_removed = true;
             for (int j = 0; j < 4; j++)
@@ -1228,7 +1364,7 @@ private:
         std::vector<size_t>& allocate_id,
         bool& ok);
     static std::vector<TetrahedronConnectivity> record_old_tet_connectivity(
-        const TetMesh::vector<TetrahedronConnectivity>& conn,
+        const SegmentedVector<TetrahedronConnectivity>& conn,
         const std::vector<size_t>& tets)
     {
         std::vector<TetrahedronConnectivity> tet_conn;
@@ -1255,8 +1391,11 @@ public:
         }
     }
 
+    // These three bracket every operation's attribute changes, and the last two are also where
+    // it commits or rolls back, which is when the slot journal (SlotCache) is resolved.
     void release_protect_attributes()
     {
+        commit_slot_journal();
         if (p_vertex_attrs) {
             p_vertex_attrs->end_protect();
         }
@@ -1273,6 +1412,7 @@ public:
 
     void rollback_protected_attributes()
     {
+        rollback_slot_journal();
         if (p_vertex_attrs) {
             p_vertex_attrs->rollback();
         }
@@ -1293,7 +1433,7 @@ public:
     using VertexMutex = wmtk::threading::VertexMutex;
 
 private:
-    std::vector<VertexMutex> m_vertex_mutex;
+    SegmentedVector<VertexMutex> m_vertex_mutex;
 
     bool try_set_vertex_mutex(const Tuple& v, int threadid)
     {
@@ -335,7 +335,7 @@ bool TetMesh::link_condition(const Tuple& t)
      */
     auto link = [&intersects, &conn = TC](
                     const auto& verts,
-                    const std::vector<size_t>& tets,
+                    const auto& tets,
                     const std::vector<FaceT>& faces) {
         auto conn_verts = std::set<size_t>();
         auto conn_edges = std::set<EdgeT>();
@@ -367,7 +367,7 @@ bool TetMesh::link_condition(const Tuple& t)
             }
         };
         for (const size_t t : tets) {
-            collect(conn[t].m_indices);
+            collect(array_cast<size_t>(conn[t].m_indices));
         }
         constexpr size_t dummy = std::numeric_limits<size_t>::max();
         logger().trace("in face {}", faces);
@@ -381,8 +381,8 @@ bool TetMesh::link_condition(const Tuple& t)
             conn_edges,
             conn_faces};
     };
-    const std::vector<size_t>& closure0 = VC[v0].m_conn_tets;
-    const std::vector<size_t>& closure1 = VC[v1].m_conn_tets;
+    const auto& closure0 = VC[v0].m_conn_tets;
+    const auto& closure1 = VC[v1].m_conn_tets;
     const std::vector<FaceT> bnd0 = vertex_adjacent_boundary_faces(this->tuple_from_vertex(v0));
     auto bnd1 = vertex_adjacent_boundary_faces(this->tuple_from_vertex(v1));
     auto lk0 = link(std::array<size_t, 1>{{v0}}, closure0, bnd0);
@@ -499,8 +499,8 @@ bool TetMesh::collapse_edge_conn(
     assert(v_C != v_D);
 
     // should be a copy, for the purpose of rollback
-    const auto n1_t_ids =
-        m_vertex_connectivity[v1_id].m_conn_tets; // note: conn_tets for v1 without removed tets
+    const auto n1_t_ids = vector_cast<size_t>(
+        m_vertex_connectivity[v1_id].m_conn_tets); // note: conn_tets for v1 without removed tets
     n1_t_ids_copy = n1_t_ids;
     const auto& n2_t_ids = m_vertex_connectivity[v2_id].m_conn_tets;
 
@@ -525,14 +525,14 @@ bool TetMesh::collapse_edge_conn(
             continue;
         }
         assert(l1 != -1);
-        new_tet_conn.push_back(m_tet_connectivity[t_id].m_indices);
+        new_tet_conn.push_back(array_cast<size_t>(m_tet_connectivity[t_id].m_indices));
         new_tet_conn.back()[l1] = v2_id;
         preserved_tids.push_back(t_id);
     }
     if (m_collapse_check_manifold) {
         std::set<std::array<size_t, 4>> verify_conns; // simplified manifold topology check.
         for (const size_t _t : n2_t_ids) {
-            auto tet = m_tet_connectivity[_t].m_indices;
+            auto tet = array_cast<size_t>(m_tet_connectivity[_t].m_indices);
             std::sort(tet.begin(), tet.end());
             verify_conns.emplace(tet);
         }
@@ -559,6 +559,7 @@ bool TetMesh::collapse_edge_conn(
     //
     m_vertex_connectivity[v1_id].m_is_removed = true;
     m_vertex_connectivity[v1_id].m_conn_tets.clear();
+    retire_vert_slot(v1_id);
 
     // get eid, fid, tid for return
     // Tuple new_loc;
@@ -24,9 +24,9 @@ bool wmtk::TetMesh::split_edge(const Tuple& loc0, std::vector<Tuple>& new_edges)
     size_t v_D = loc0.switch_face(*this).switch_edge(*this).switch_vertex(*this).vid(*this);
 
 
-    auto n12_t_ids = set_intersection(
+    auto n12_t_ids = vector_cast<size_t>(set_intersection(
         m_vertex_connectivity[v1_id].m_conn_tets,
-        m_vertex_connectivity[v2_id].m_conn_tets);
+        m_vertex_connectivity[v2_id].m_conn_tets));
     std::vector<size_t> n12_v_ids;
     for (size_t t_id : n12_t_ids) {
         for (int j = 0; j < 4; j++) n12_v_ids.push_back(m_tet_connectivity[t_id][j]);
@@ -39,7 +39,7 @@ bool wmtk::TetMesh::split_edge(const Tuple& loc0, std::vector<Tuple>& new_edges)
 
     /// update connectivity
     int v_id = get_next_empty_slot_v();
-    if (v_id < 0) return false; // out of preallocated vertex slots: abort before mutating
+    if (v_id < 0) return false; // past the index_t limit: abort before mutating
     std::vector<TetrahedronConnectivity> old_tets_conn;
     std::vector<std::array<size_t, 4>> new_tet_conn;
     auto num = n12_t_ids.size();
@@ -50,12 +50,12 @@ bool wmtk::TetMesh::split_edge(const Tuple& loc0, std::vector<Tuple>& new_edges)
         old_tets_conn.push_back(tet);
         {
             auto l = tet.find(v2_id);
-            new_tet_conn[i] = (tet.m_indices);
+            new_tet_conn[i] = array_cast<size_t>(tet.m_indices);
             new_tet_conn[i][l] = v_id;
         }
         {
             auto l = tet.find(v1_id);
-            new_tet_conn[i + num] = (tet.m_indices);
+            new_tet_conn[i + num] = array_cast<size_t>(tet.m_indices);
             new_tet_conn[i + num][l] = v_id;
         }
     }
@@ -64,8 +64,8 @@ bool wmtk::TetMesh::split_edge(const Tuple& loc0, std::vector<Tuple>& new_edges)
     bool conn_ok = true;
     auto rollback_vert_conn = operation_update_connectivity_impl(new_tet_id, new_tet_conn, conn_ok);
     if (!conn_ok) {
-        // out of preallocated tet slots: free the reserved vertex slot and abort
-        m_vertex_connectivity[v_id].m_is_removed = true;
+        // Only past the index_t limit: nothing was mutated, so give the vertex slot back.
+        release_unused_vert_slots({size_t(v_id)});
         return false;
     }
 
@@ -99,8 +99,7 @@ bool wmtk::TetMesh::split_edge(const Tuple& loc0, std::vector<Tuple>& new_edges)
     }
     release_protect_attributes();
 
-    // new_edges
-    assert(std::is_sorted(new_tet_id.begin(), new_tet_id.end()));
+    // new_edges (new_tet_id is not sorted: recycled slots can precede the ones it reused)
     for (size_t t_id : new_tet_id) {
         for (int j = 0; j < 6; j++) {
             new_edges.push_back(tuple_from_edge(t_id, j));
@@ -57,7 +57,7 @@ bool TetMesh::split_face(const Tuple& t, std::vector<Tuple>& new_tets)
         old_tet_opp = std::make_pair(tid_opp.value(), m_tet_connectivity[tid_opp.value()]);
     }
 
-    const auto conn_tets = [this](size_t i) -> std::vector<size_t>& {
+    const auto conn_tets = [this](size_t i) -> StarVector& {
         return m_vertex_connectivity[i].m_conn_tets;
     };
 
@@ -72,21 +72,28 @@ bool TetMesh::split_face(const Tuple& t, std::vector<Tuple>& new_tets)
         new_tid2_opp = get_next_empty_slot_t();
     }
 
-    // abort before mutating if we ran out of preallocated slots; mark any slots we
-    // did manage to reserve as removed so they don't become live-but-empty phantoms.
+    // abort before mutating if we are past the index_t limit; give back any slots we did
+    // get, so they neither stay live-but-empty nor drop out of the free lists.
     constexpr size_t INVALID_SLOT = static_cast<size_t>(-1);
     if (new_vid == INVALID_SLOT || new_tid1 == INVALID_SLOT || new_tid2 == INVALID_SLOT ||
         (t_opp && (new_tid1_opp.value() == INVALID_SLOT || new_tid2_opp.value() == INVALID_SLOT))) {
-        if (new_vid != INVALID_SLOT) m_vertex_connectivity[new_vid].m_is_removed = true;
-        if (new_tid1 != INVALID_SLOT) m_tet_connectivity[new_tid1].m_is_removed = true;
-        if (new_tid2 != INVALID_SLOT) m_tet_connectivity[new_tid2].m_is_removed = true;
-        if (t_opp && new_tid1_opp.value() != INVALID_SLOT)
-            m_tet_connectivity[new_tid1_opp.value()].m_is_removed = true;
-        if (t_opp && new_tid2_opp.value() != INVALID_SLOT)
-            m_tet_connectivity[new_tid2_opp.value()].m_is_removed = true;
+        if (new_vid != INVALID_SLOT) release_unused_vert_slots({new_vid});
+        std::vector<size_t> taken;
+        for (const size_t slot : {new_tid1, new_tid2}) {
+            if (slot != INVALID_SLOT) taken.push_back(slot);
+        }
+        if (t_opp) {
+            for (const size_t slot : {new_tid1_opp.value(), new_tid2_opp.value()}) {
+                if (slot != INVALID_SLOT) taken.push_back(slot);
+            }
+        }
+        release_unused_tet_slots(taken);
         return false;
     }
 
+    // Edits connectivity directly, not through operation_update_connectivity_impl.
+    invalidate_face_adjacency();
+
     vector_erase(conn_tets(vid[0]), tid);
     conn_tets(vid[0]).emplace_back(new_tid1);
     conn_tets(vid[0]).emplace_back(new_tid2);
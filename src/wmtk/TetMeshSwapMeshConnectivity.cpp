@@ -27,6 +27,13 @@ void TetMesh::operation_failure_rollback_imp(
     for (auto& [v, conn] : rollback_vert_conn) {
         m_vertex_connectivity[v] = std::move(conn);
     }
+    if (has_face_adjacency()) {
+        // Rows of the new tets are left as they are: those tets are removed again above.
+        for (const auto& [t, f, n] : m_tet_adjacency_rollback.local()) {
+            m_tet_adjacency[t][f] = n;
+        }
+    }
+    m_tet_adjacency_rollback.local().clear();
 
     rollback_protected_attributes();
 }
@@ -63,22 +70,54 @@ std::map<size_t, TetMesh::VertexConnectivity> wmtk::TetMesh::operation_update_co
     assert(std::is_sorted(remove_id.begin(), remove_id.end()));
 
     ok = true;
+    m_tet_adjacency_rollback.local().clear();
 
     // Reserve the additional tet slots up-front so that, if the preallocated
     // capacity is exhausted, we abort *before* mutating any connectivity.
-    long reserved_first = -1;
-    size_t add_size = 0;
+    std::vector<size_t> reserved;
     if (allocate_id.empty() && new_tet_conn.size() > remove_id.size()) {
-        add_size = new_tet_conn.size() - remove_id.size();
-        reserved_first = request_tet_slots(add_size);
-        if (reserved_first < 0) {
-            ok = false; // out of preallocated space; nothing mutated yet
-            return {};
+        const size_t add_size = new_tet_conn.size() - remove_id.size();
+        reserved.reserve(add_size);
+        for (size_t i = 0; i < add_size; i++) {
+            const long t = acquire_tet_slot();
+            if (t < 0) {
+                release_unused_tet_slots(reserved);
+                ok = false; // out of preallocated space; nothing mutated yet
+                return {};
+            }
+            reserved.push_back(static_cast<size_t>(t));
         }
     }
 
     auto& tet_conn = this->m_tet_connectivity;
     auto& vert_conn = this->m_vertex_connectivity;
+
+    // Face adjacency: the rows that change are those of the new tets and, for each tet outside
+    // the cavity that faced a removed one, the one slot that faced it. Note both before any
+    // connectivity is touched, and keep the old values for rollback.
+    const bool track_adjacency = has_face_adjacency();
+    std::vector<std::pair<size_t, int>> outside_slots;
+    if (track_adjacency) {
+        auto& rollback_slots = m_tet_adjacency_rollback.local();
+        for (const size_t r : remove_id) {
+            for (int f = 0; f < 4; ++f) {
+                rollback_slots.emplace_back(r, f, m_tet_adjacency[r][f]);
+            }
+            for (const size_t n : m_tet_adjacency[r]) {
+                if (n == std::numeric_limits<size_t>::max() ||
+                    std::binary_search(remove_id.begin(), remove_id.end(), n)) {
+                    continue;
+                }
+                for (int f = 0; f < 4; ++f) {
+                    if (m_tet_adjacency[n][f] == r) {
+                        rollback_slots.emplace_back(n, f, r);
+                        outside_slots.emplace_back(n, f);
+                    }
+                }
+            }
+        }
+    }
+
     auto new_tid = std::vector<size_t>();
     auto affected_vid = std::set<size_t>();
     for (auto i : remove_id) {
@@ -104,21 +143,21 @@ std::map<size_t, TetMesh::VertexConnectivity> wmtk::TetMesh::operation_update_co
         if (new_tet_conn.size() <= allocate_id.size()) { // tet number decrease
             allocate_id.resize(new_tet_conn.size());
         } else {
-            auto hole_size = allocate_id.size();
-
-            allocate_id.resize(new_tet_conn.size(), -1);
-
-            // consume the slots reserved above (contiguous block)
-            for (size_t i = 0; i < add_size; i++) {
-                allocate_id[i + hole_size] = static_cast<size_t>(reserved_first + (long)i);
-            }
+            // consume the slots reserved above
+            allocate_id.insert(allocate_id.end(), reserved.begin(), reserved.end());
         }
     }
     assert(allocate_id.size() == new_tet_conn.size());
+    // Removed slots the new tets did not take are free once the operation commits.
+    for (const size_t r : remove_id) {
+        if (std::find(allocate_id.begin(), allocate_id.end(), r) == allocate_id.end()) {
+            retire_tet_slot(r);
+        }
+    }
 
     for (auto i = 0; i < new_tet_conn.size(); i++) {
         auto id = allocate_id[i];
-        tet_conn[id].m_indices = new_tet_conn[i];
+        tet_conn[id].m_indices = array_cast<index_t>(new_tet_conn[i]);
         tet_conn[id].m_is_removed = false;
         tet_conn[id].hash++;
         for (auto j = 0; j < 4; j++) {
@@ -128,6 +167,18 @@ std::map<size_t, TetMesh::VertexConnectivity> wmtk::TetMesh::operation_update_co
         }
     }
 
+    if (track_adjacency) {
+        // Every slot is now a search of a star that already reflects the operation.
+        for (const size_t id : allocate_id) {
+            for (int f = 0; f < 4; ++f) {
+                m_tet_adjacency[id][f] = find_face_neighbor(id, f);
+            }
+        }
+        for (const auto& [n, f] : outside_slots) {
+            m_tet_adjacency[n][f] = find_face_neighbor(n, f);
+        }
+    }
+
     return rollback_vert_conn;
 }
 
@@ -144,7 +195,8 @@ bool TetMesh::swap_edge(const Tuple& t, std::vector<Tuple>& new_tet_tuples)
     const size_t v2_id = switch_vertex(t).vid(*this);
     auto& nb1 = m_vertex_connectivity[v1_id];
     auto& nb2 = m_vertex_connectivity[v2_id];
-    const auto affected = set_intersection(nb1.m_conn_tets, nb2.m_conn_tets);
+    const auto affected =
+        vector_cast<size_t>(set_intersection(nb1.m_conn_tets, nb2.m_conn_tets));
     assert(!affected.empty());
     if (affected.size() != 3) {
         logger().trace("selected edges need 3 neighbors to swap.");
@@ -197,8 +249,8 @@ bool TetMesh::swap_edge(const Tuple& t, std::vector<Tuple>& new_tet_tuples)
             if (!inter.empty()) return false;
         }
 
-        new_tets[0] = tet_conn[t0_id].m_indices;
-        new_tets[1] = tet_conn[t1_id].m_indices;
+        new_tets[0] = array_cast<size_t>(tet_conn[t0_id].m_indices);
+        new_tets[1] = array_cast<size_t>(tet_conn[t1_id].m_indices);
 
         wmtk::array_replace_inline(new_tets[0], v2_id, (size_t)n0_id);
         wmtk::array_replace_inline(new_tets[1], v1_id, (size_t)n2_id);
@@ -287,7 +339,7 @@ bool TetMesh::swap_face(const Tuple& t, std::vector<Tuple>& new_tet_tuples)
     std::vector<std::array<size_t, 4>> new_tets;
     {
         std::vector<size_t> tri{v0, v1, v_other};
-        new_tets.resize(3, m_tet_connectivity[t1].m_indices);
+        new_tets.resize(3, array_cast<size_t>(m_tet_connectivity[t1].m_indices));
         for (auto i = 0; i < 3; i++) {
             wmtk::array_replace_inline(new_tets[i], tri[i], v3);
         }
@@ -501,7 +553,7 @@ bool TetMesh::swap_edge_44(const Tuple& t, std::vector<Tuple>& new_tet_tuples)
     const size_t v2_id = tt.switch_vertex().vid();
     const auto& nb1 = m_vertex_connectivity[v1_id];
     const auto& nb2 = m_vertex_connectivity[v2_id];
-    auto affected = set_intersection(nb1.m_conn_tets, nb2.m_conn_tets);
+    auto affected = vector_cast<size_t>(set_intersection(nb1.m_conn_tets, nb2.m_conn_tets));
     assert(!affected.empty());
     if (affected.size() != 4) {
         logger().trace("selected edges need 4 neighbors to swap.");
@@ -524,7 +576,7 @@ bool TetMesh::swap_edge_44(const Tuple& t, std::vector<Tuple>& new_tet_tuples)
     std::vector<std::array<size_t, 4>> old_tets_conn;
     old_tets_conn.reserve(old_tets.size());
     for (const auto& ti : old_tets) {
-        old_tets_conn.push_back(ti.m_indices);
+        old_tets_conn.push_back(array_cast<size_t>(ti.m_indices));
     }
 
     std::array<size_t, 2> v0s = {{v_E, v_A}};
@@ -574,9 +626,9 @@ bool TetMesh::swap_edge_44(const Tuple& t, std::vector<Tuple>& new_tet_tuples)
         const auto& vf1 = m_vertex_connectivity[new_edge[1]];
         const auto& vf2 = m_vertex_connectivity[v_other];
         const auto& vf3 = m_vertex_connectivity[v1_id];
-        const std::vector<size_t> tets01 = set_intersection(vf0.m_conn_tets, vf1.m_conn_tets);
-        const std::vector<size_t> tets012 = set_intersection(tets01, vf2.m_conn_tets);
-        const std::vector<size_t> tets0123 = set_intersection(tets012, vf3.m_conn_tets);
+        const auto tets01 = set_intersection(vf0.m_conn_tets, vf1.m_conn_tets);
+        const auto tets012 = set_intersection(tets01, vf2.m_conn_tets);
+        const auto tets0123 = set_intersection(tets012, vf3.m_conn_tets);
         if (tets0123.size() != 1) {
             // The swap can create a tet with the same indices as an already existing tet. That case
             // is prohibited here.
@@ -727,7 +779,7 @@ bool TetMesh::swap_edge_56(const Tuple& t, std::vector<Tuple>& new_tet_tuples)
     const size_t v2_id = tt.switch_vertex().vid();
     const auto& nb1 = m_vertex_connectivity[v1_id];
     const auto& nb2 = m_vertex_connectivity[v2_id];
-    auto affected = set_intersection(nb1.m_conn_tets, nb2.m_conn_tets);
+    auto affected = vector_cast<size_t>(set_intersection(nb1.m_conn_tets, nb2.m_conn_tets));
     assert(!affected.empty());
     if (affected.size() != 5) {
         logger().trace("selected edges need 4 neighbors to swap.");
@@ -748,7 +800,7 @@ bool TetMesh::swap_edge_56(const Tuple& t, std::vector<Tuple>& new_tet_tuples)
     const auto old_tets = record_old_tet_connectivity(m_tet_connectivity, affected);
     auto old_tets_conn = std::vector<std::array<size_t, 4>>();
     for (const auto& ti : old_tets) {
-        old_tets_conn.push_back(ti.m_indices);
+        old_tets_conn.push_back(array_cast<size_t>(ti.m_indices));
     }
 
     std::vector<std::array<size_t, 4>> new_tets;
@@ -797,9 +849,9 @@ bool TetMesh::swap_edge_56(const Tuple& t, std::vector<Tuple>& new_tet_tuples)
         const auto& vf1 = m_vertex_connectivity[new_face[1]];
         const auto& vf2 = m_vertex_connectivity[new_face[2]];
         const auto& vf3 = m_vertex_connectivity[v1_id];
-        const std::vector<size_t> tets01 = set_intersection(vf0.m_conn_tets, vf1.m_conn_tets);
-        const std::vector<size_t> tets012 = set_intersection(tets01, vf2.m_conn_tets);
-        const std::vector<size_t> tets0123 = set_intersection(tets012, vf3.m_conn_tets);
+        const auto tets01 = set_intersection(vf0.m_conn_tets, vf1.m_conn_tets);
+        const auto tets012 = set_intersection(tets01, vf2.m_conn_tets);
+        const auto tets0123 = set_intersection(tets012, vf3.m_conn_tets);
         if (tets0123.size() != 1) {
             // The swap can create a tet with the same indices as an already existing tet. That case
             // is prohibited here.
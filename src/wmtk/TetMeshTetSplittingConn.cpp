@@ -52,7 +52,7 @@ bool TetMesh::split_tet(const Tuple& t, std::vector<Tuple>& new_tets)
     std::pair<size_t, TetrahedronConnectivity> old_tet;
     old_tet = std::make_pair(tid, m_tet_connectivity[tid]);
 
-    const auto conn_tets = [this](size_t i) -> std::vector<size_t>& {
+    const auto conn_tets = [this](size_t i) -> StarVector& {
         return m_vertex_connectivity[i].m_conn_tets;
     };
 
@@ -62,18 +62,23 @@ bool TetMesh::split_tet(const Tuple& t, std::vector<Tuple>& new_tets)
     const size_t new_tid2 = get_next_empty_slot_t();
     const size_t new_tid3 = get_next_empty_slot_t();
 
-    // abort before mutating if we ran out of preallocated slots; mark any slots we
-    // did manage to reserve as removed so they don't become live-but-empty phantoms.
+    // abort before mutating if we are past the index_t limit; give back any slots we did
+    // get, so they neither stay live-but-empty nor drop out of the free lists.
     constexpr size_t INVALID_SLOT = static_cast<size_t>(-1);
     if (new_vid == INVALID_SLOT || new_tid1 == INVALID_SLOT || new_tid2 == INVALID_SLOT ||
         new_tid3 == INVALID_SLOT) {
-        if (new_vid != INVALID_SLOT) m_vertex_connectivity[new_vid].m_is_removed = true;
-        if (new_tid1 != INVALID_SLOT) m_tet_connectivity[new_tid1].m_is_removed = true;
-        if (new_tid2 != INVALID_SLOT) m_tet_connectivity[new_tid2].m_is_removed = true;
-        if (new_tid3 != INVALID_SLOT) m_tet_connectivity[new_tid3].m_is_removed = true;
+        if (new_vid != INVALID_SLOT) release_unused_vert_slots({new_vid});
+        std::vector<size_t> taken;
+        for (const size_t slot : {new_tid1, new_tid2, new_tid3}) {
+            if (slot != INVALID_SLOT) taken.push_back(slot);
+        }
+        release_unused_tet_slots(taken);
         return false;
     }
 
+    // Edits connectivity directly, not through operation_update_connectivity_impl.
+    invalidate_face_adjacency();
+
     vector_erase(conn_tets(vid[0]), tid);
     conn_tets(vid[0]).emplace_back(new_tid1);
     conn_tets(vid[0]).emplace_back(new_tid2);
@@ -16,6 +16,9 @@ void wmtk::TetMesh::triangle_insertion(
     std::vector<std::array<size_t, 4>>& center_split_tets)
 {
     std::vector<size_t> new_tids;
+    // The subdivision rewrites tets in place; switch_tetrahedron searches stars until the next
+    // consolidate_mesh rebuilds the table.
+    invalidate_face_adjacency();
 
     /// get all tets
     std::vector<size_t> intersected_tids;
@@ -37,7 +40,7 @@ void wmtk::TetMesh::triangle_insertion(
         std::array<size_t, 2> e = {{v1_id, v2_id}};
         if (e[0] > e[1]) std::swap(e[0], e[1]);
 
-        std::vector<size_t> tids = set_intersection(
+        const auto tids = set_intersection(
             m_vertex_connectivity[e[0]].m_conn_tets,
             m_vertex_connectivity[e[1]].m_conn_tets);
         surrounding_tids.insert(surrounding_tids.end(), tids.begin(), tids.end());
@@ -208,7 +211,7 @@ void wmtk::TetMesh::subdivide_tets(
         }
 
 
-        std::map<size_t, std::vector<size_t>> new_conn_tets;
+        std::map<size_t, StarVector> new_conn_tets;
         for (size_t vid : vids) {
             new_conn_tets[vid] = {};
         }
@@ -341,7 +344,7 @@ void wmtk::TetMesh::subdivide_a_tet(
                 auto vid = get_next_empty_slot_v();
                 new_center_vids.push_back(vid);
                 all_v_ids.push_back(vid);
-                center_split_tets.push_back(m_tet_connectivity[t_id].m_indices);
+                center_split_tets.push_back(array_cast<size_t>(m_tet_connectivity[t_id].m_indices));
 
                 is_add_centroid = true;
             }
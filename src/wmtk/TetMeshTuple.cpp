@@ -5,10 +5,10 @@ using namespace wmtk;
 
 TetMesh::Tuple::Tuple(const TetMesh& m, size_t vid, size_t local_eid, size_t local_fid, size_t tid)
     : m_global_vid(vid)
-    , m_local_eid(local_eid)
-    , m_local_fid(local_fid)
     , m_global_tid(tid)
     , m_hash(m.m_tet_connectivity[tid].hash)
+    , m_local_eid(local_eid)
+    , m_local_fid(local_fid)
 {
     check_validity(m);
 }
@@ -303,27 +303,50 @@ TetMesh::Tuple TetMesh::Tuple::switch_face(const TetMesh& m) const
 
 std::optional<TetMesh::Tuple> TetMesh::Tuple::switch_tetrahedron(const TetMesh& m) const
 {
-    size_t v0_id = m.m_tet_connectivity[m_global_tid][m_local_faces[m_local_fid][0]];
-    size_t v1_id = m.m_tet_connectivity[m_global_tid][m_local_faces[m_local_fid][1]];
-    size_t v2_id = m.m_tet_connectivity[m_global_tid][m_local_faces[m_local_fid][2]];
+    const auto& tet = m.m_tet_connectivity[m_global_tid];
+    const size_t v0_id = tet[m_local_faces[m_local_fid][0]];
+    const size_t v1_id = tet[m_local_faces[m_local_fid][1]];
+    const size_t v2_id = tet[m_local_faces[m_local_fid][2]];
+
+    const size_t tid = m.has_face_adjacency()
+                           ? m.m_tet_adjacency[m_global_tid][m_local_fid]
+                           : m.find_face_neighbor(m_global_tid, v0_id, v1_id, v2_id);
+    if (tid == std::numeric_limits<size_t>::max()) {
+        // no opposite tet was found
+        return {};
+    }
 
+    // this is the opposite tet
+    Tuple loc = *this;
+    loc.m_global_tid = tid;
+    const auto& opp = m.m_tet_connectivity[tid];
+    loc.m_local_eid = opp.find_local_edge(
+        tet[m_local_edges[m_local_eid][0]],
+        tet[m_local_edges[m_local_eid][1]]);
+    loc.m_local_fid = opp.find_local_face(v0_id, v1_id, v2_id);
+    loc.m_hash = opp.hash;
+    return loc;
+}
+
+size_t TetMesh::find_face_neighbor(size_t tid, size_t v0_id, size_t v1_id, size_t v2_id) const
+{
     // make v0 the one with the fewest incident tets
-    if (m.m_vertex_connectivity[v1_id].m_conn_tets.size() <
-        m.m_vertex_connectivity[v0_id].m_conn_tets.size()) {
+    if (m_vertex_connectivity[v1_id].m_conn_tets.size() <
+        m_vertex_connectivity[v0_id].m_conn_tets.size()) {
         std::swap(v0_id, v1_id);
     }
-    if (m.m_vertex_connectivity[v2_id].m_conn_tets.size() <
-        m.m_vertex_connectivity[v0_id].m_conn_tets.size()) {
+    if (m_vertex_connectivity[v2_id].m_conn_tets.size() <
+        m_vertex_connectivity[v0_id].m_conn_tets.size()) {
         std::swap(v0_id, v2_id);
     }
 
-    for (const size_t tid : m.m_vertex_connectivity[v0_id].m_conn_tets) {
-        if (tid == m_global_tid) {
+    for (const size_t t : m_vertex_connectivity[v0_id].m_conn_tets) {
+        if (t == tid) {
             continue;
         }
         bool v1_found = false;
         bool v2_found = false;
-        for (const size_t vid : m.m_tet_connectivity[tid].m_indices) {
+        for (const size_t vid : m_tet_connectivity[t].m_indices) {
             if (vid == v1_id) {
                 v1_found = true;
                 if (v2_found) {
@@ -338,23 +361,20 @@ std::optional<TetMesh::Tuple> TetMesh::Tuple::switch_tetrahedron(const TetMesh&
             }
         }
         if (v1_found && v2_found) {
-            // this is the opposite tet
-            Tuple loc = *this;
-            loc.m_global_tid = tid;
-
-            loc.m_local_eid = m.m_tet_connectivity[loc.m_global_tid].find_local_edge(
-                m.m_tet_connectivity[m_global_tid][m_local_edges[m_local_eid][0]],
-                m.m_tet_connectivity[m_global_tid][m_local_edges[m_local_eid][1]]);
-            loc.m_local_fid =
-                m.m_tet_connectivity[loc.m_global_tid].find_local_face(v0_id, v1_id, v2_id);
-            loc.m_hash = m.m_tet_connectivity[loc.m_global_tid].hash;
-
-            return loc;
+            return t;
         }
     }
+    return std::numeric_limits<size_t>::max();
+}
 
-    // no opposite tet was found
-    return {};
+size_t TetMesh::find_face_neighbor(size_t tid, int local_fid) const
+{
+    const auto& tet = m_tet_connectivity[tid];
+    return find_face_neighbor(
+        tid,
+        tet[m_local_faces[local_fid][0]],
+        tet[m_local_faces[local_fid][1]],
+        tet[m_local_faces[local_fid][2]]);
 }
 
 std::optional<TetMesh::Tuple> TetMesh::Tuple::switch_tetrahedron_slow(const TetMesh& m) const
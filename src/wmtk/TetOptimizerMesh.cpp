@@ -1,6 +1,7 @@
 #include <wmtk/TetOptimizerMesh.h>
 
 #include <wmtk/utils/AMIPS.h>
+#include <wmtk/utils/AMIPSBatch.h>
 #include <wmtk/utils/GeoUtils.h>
 #include <wmtk/utils/PartitionMesh.h>
 #include <wmtk/envelope/KNN.hpp>
@@ -10,7 +11,9 @@
 #include <wmtk/utils/RunPass.hpp>
 #include <wmtk/utils/SizingField.hpp>
 #include <wmtk/utils/TetraQualityUtils.hpp>
+#include <wmtk/utils/VertexColoring.hpp>
 #include <wmtk/utils/io.hpp>
+#include <wmtk/utils/orient.hpp>
 #include <wmtk/utils/partition_utils.hpp>
 
 // clang-format off
@@ -20,6 +23,7 @@
 #include <wmtk/utils/EnableWarnings.hpp>
 // clang-format on
 
+#include <atomic>
 #include <cstdlib>
 #include <queue>
 
@@ -50,6 +54,7 @@ void TetOptimizerMesh::mesh_improvement(int max_its)
     for (int it = 0; it < max_its; ++it) {
         m_iterations_used = it + 1;
         logger().info("\n========it {}========", it);
+        utils::reset_orient_filter_stats();
 
         double max_metric = 0.;
         double avg_metric = 0.;
@@ -79,7 +84,13 @@ void TetOptimizerMesh::mesh_improvement(int max_its)
         const int cnt_round = n_round.load(std::memory_order_relaxed);
         const int cnt_verts = n_verts.load(std::memory_order_relaxed);
         if (cnt_round < cnt_verts) {
-            logger().info("rounded {}/{}", cnt_round, cnt_verts);
+            const utils::OrientFilterStats filter = utils::orient_filter_stats();
+            logger().info(
+                "rounded {}/{} | exact orientation checks: {} decided by the filter, {} by GMP",
+                cnt_round,
+                cnt_verts,
+                filter.hits,
+                filter.misses);
         } else {
             logger().info("All rounded!");
         }
@@ -92,7 +103,14 @@ void TetOptimizerMesh::mesh_improvement(int max_its)
                 cnt_verts);
         }
 
-        consolidate_mesh();
+        if (m_params.spatial_reorder) {
+            consolidate_mesh(wmtk::morton_codes(
+                vert_capacity(),
+                [this](size_t i) { return m_vertex_attribute[i].m_posf; },
+                NUM_THREADS));
+        } else {
+            consolidate_mesh();
+        }
         logger().info("#V = {}, #T = {}", vert_capacity(), tet_capacity());
 
         if (optimization_stop_at_float() && round_and_check_all_rounded()) {
@@ -214,10 +232,36 @@ std::tuple<double, double> TetOptimizerMesh::local_operations(
     return stats;
 }
 
-TetOptimizerMesh::VertexAttributes::VertexAttributes(const Vector3r& p)
+Vector3r TetOptimizerMesh::vertex_exact_pos(const size_t vid) const
+{
+    const VertexAttributes& va = m_vertex_attribute.at(vid);
+    if (!va.m_is_rounded) {
+        if (const std::optional<Vector3r> p = m_exact_pos.find(vid)) return *p;
+    }
+    return to_rational(va.m_posf);
+}
+
+void TetOptimizerMesh::set_vertex_exact_pos(const size_t vid, const Vector3r& p)
 {
-    m_pos = p;
-    m_posf = to_double(m_pos);
+    VertexAttributes& va = m_vertex_attribute[vid];
+    va.m_posf = to_double(p);
+    va.m_is_rounded = to_rational(va.m_posf) == p;
+    if (va.m_is_rounded) {
+        m_exact_pos.erase(vid);
+    } else {
+        m_exact_pos.set(vid, p);
+        m_all_rounded.store(false, std::memory_order_relaxed);
+    }
+}
+
+void TetOptimizerMesh::set_vertex_pos(const size_t vid, const Vector3d& p)
+{
+    // Called in line searches, once per candidate, so the table is only touched when the
+    // vertex may have an entry.
+    VertexAttributes& va = m_vertex_attribute[vid];
+    if (!va.m_is_rounded) m_exact_pos.erase(vid);
+    va.m_posf = p;
+    va.m_is_rounded = true;
 }
 
 void TetOptimizerMesh::compute_vertex_partition()
@@ -250,12 +294,15 @@ double TetOptimizerMesh::swap_edge_44_energy(
     const std::vector<std::array<size_t, 4>>& tets,
     const int op_case)
 {
-    double max_energy = -1;
     for (const auto& vids : tets) {
         if (is_inverted(vids)) {
             return std::numeric_limits<double>::max();
         }
-        const double e = get_quality(vids);
+    }
+    std::vector<double> q;
+    get_qualities(tets, q);
+    double max_energy = -1;
+    for (const double e : q) {
         max_energy = std::max(max_energy, e);
     }
     return max_energy;
@@ -265,12 +312,15 @@ double TetOptimizerMesh::swap_edge_56_energy(
     const std::vector<std::array<size_t, 4>>& tets,
     const int op_case)
 {
-    double max_energy = -1;
     for (const auto& vids : tets) {
         if (is_inverted(vids)) {
             return std::numeric_limits<double>::max();
         }
-        const double e = get_quality(vids);
+    }
+    std::vector<double> q;
+    get_qualities(tets, q);
+    double max_energy = -1;
+    for (const double e : q) {
         max_energy = std::max(max_energy, e);
     }
     return max_energy;
@@ -308,6 +358,9 @@ bool TetOptimizerMesh::smooth_after(const Tuple& t)
     opts.smoothing_mode = m_params.smoothing_mode == "exact"
                               ? optimization::SmoothVertexOptions::SmoothingMode::Exact
                               : optimization::SmoothVertexOptions::SmoothingMode::Projected;
+    opts.solver = m_params.smoothing_solver == "newton"
+                      ? optimization::SmoothVertexOptions::Solver::FixedNewton
+                      : optimization::SmoothVertexOptions::Solver::Polysolve;
     opts.project_line_search_steps = m_params.project_line_search_steps;
     opts.project_line_search_nested_steps = m_params.project_line_search_nested_steps;
 
@@ -316,6 +369,30 @@ bool TetOptimizerMesh::smooth_after(const Tuple& t)
 
 void TetOptimizerMesh::smooth_all_vertices(const size_t n_iters)
 {
+    const std::string& engine = m_params.smoothing_engine;
+    if (engine != "pass" && engine != "colored") {
+        log_and_throw_error("Unknown smoothing_engine '{}'; expected 'pass' or 'colored'", engine);
+    }
+    const bool colored = engine == "colored";
+
+    // Smoothing changes no connectivity, so one coloring serves every iteration below.
+    std::vector<std::vector<size_t>> classes;
+    if (colored) {
+        igl::Timer timer;
+        timer.start();
+        classes = utils::color_vertices(
+            vert_capacity(),
+            all_vertex_ids(),
+            [this](const size_t v, std::vector<size_t>& out) {
+                out = get_one_ring_vids_for_vertex(v);
+            },
+            NUM_THREADS);
+        logger().info(
+            "vertex coloring: {} colors, time {:.4}s",
+            classes.size(),
+            timer.getElapsedTime());
+    }
+
     for (size_t i = 0; i < n_iters; ++i) {
         // Preserve TetWild's deterministic serial random-seed progression. The current
         // collector does not consume rand(), but keeping the state transition makes the move
@@ -326,6 +403,24 @@ void TetOptimizerMesh::smooth_all_vertices(const size_t n_iters)
         igl::Timer timer;
         timer.start();
         m_smooth_rejects.reset();
+        if (colored) {
+            std::vector<char> active;
+            if (m_params.skip_good_regions) {
+                active.assign(vert_capacity(), 0);
+                for (const size_t v : active_vertices()) {
+                    active[v] = 1;
+                }
+            }
+            logger().info("vertex smoothing prepare time: {:.4}s", timer.getElapsedTime());
+            timer.start();
+            const size_t moved = smooth_color_classes(classes, active);
+            logger().info(
+                "vertex smoothing operation time colored: {:.4}s, {} vertices moved",
+                timer.getElapsedTime(),
+                moved);
+            logger().info("\tsmooth: {}", m_smooth_rejects.to_string());
+            continue;
+        }
         std::vector<std::pair<std::string, Tuple>> collect_all_ops;
         if (m_params.skip_good_regions) {
             for (const size_t v : active_vertices()) {
@@ -347,6 +442,92 @@ void TetOptimizerMesh::smooth_all_vertices(const size_t n_iters)
     }
 }
 
+size_t TetOptimizerMesh::smooth_color_classes(
+    const std::vector<std::vector<size_t>>& classes,
+    const std::vector<char>& active)
+{
+    // What the executor's vertex_smooth does, minus the lock and the undo log. A vertex's
+    // smooth writes its own attributes and the quality of its incident tets, and reads only
+    // its one-ring; classmates share no tet, so within a class all of that is private to one
+    // thread and the neighbours it reads hold still -- each class is a Jacobi step over a
+    // snapshot nobody writes. A smooth that smooth_after or invariants rejects is undone from
+    // a copy of exactly what it wrote, taken after smooth_before as TetMesh::smooth_vertex
+    // takes its protected region: a successful rounding is kept either way.
+    const auto smooth_one = [this](const size_t vid, CoarsenScratch& scr) {
+        const Tuple t = tuple_from_vertex(vid);
+        if (!smooth_before(t)) {
+            return false;
+        }
+        scr.saved_vertex = m_vertex_attribute.at(vid);
+        scr.saved_qualities.clear();
+        for (const size_t tid : get_one_ring_tids_for_vertex(vid)) {
+            scr.saved_qualities.emplace_back(tid, cell_quality(tid));
+        }
+        if (smooth_after(t) && invariants(get_one_ring_tets_for_vertex(t))) {
+            return true;
+        }
+        m_vertex_attribute[vid] = scr.saved_vertex;
+        for (const auto& [tid, quality] : scr.saved_qualities) {
+            set_cell_quality(tid, quality);
+        }
+        return false;
+    };
+
+    std::atomic<size_t> moved(0);
+    std::vector<size_t> batch;
+    for (const std::vector<size_t>& cls : classes) {
+        batch.clear();
+        for (const size_t v : cls) {
+            if ((active.empty() || active[v]) && tuple_from_vertex(v).is_valid(*this)) {
+                batch.push_back(v);
+            }
+        }
+        // Per-vertex cost varies with the solver's iteration count and the one-ring size, so
+        // hand the class out in small chunks.
+        threading::parallel_for(
+            threading::range(0, batch.size(), 64),
+            [&](const threading::range& r) {
+                CoarsenScratch& scr = coarsen_scratch.local();
+                size_t n = 0;
+                for (size_t k = r.begin(); k < r.end(); ++k) {
+                    n += smooth_one(batch[k], scr);
+                }
+                moved.fetch_add(n, std::memory_order_relaxed);
+            },
+            NUM_THREADS);
+    }
+    return moved.load();
+}
+
+bool TetOptimizerMesh::any_surface_triangle_is_outside(
+    const std::array<size_t, 3>* faces,
+    const size_t n) const
+{
+    // One batch per run of faces sharing an envelope -- in practice one batch for all of
+    // them, since only an application that keys envelopes by face ever switches mid-list.
+    static thread_local std::vector<std::array<Vector3d, 3>> tris;
+    const auto& VA = m_vertex_attribute;
+    std::shared_ptr<SampleEnvelope> batch_env;
+    tris.clear();
+    for (size_t i = 0; i <= n; ++i) {
+        std::shared_ptr<SampleEnvelope> env;
+        if (i < n) {
+            env = surface_envelope_for_face(faces[i]);
+        }
+        if (i == n || env != batch_env) {
+            if (batch_env && batch_env->any_outside(tris)) {
+                return true;
+            }
+            batch_env = env;
+            tris.clear();
+        }
+        if (env) {
+            const auto& f = faces[i];
+            tris.push_back({{VA[f[0]].m_posf, VA[f[1]].m_posf, VA[f[2]].m_posf}});
+        }
+    }
+    return false;
+}
 
 std::shared_ptr<SampleEnvelope> TetOptimizerMesh::smoothing_containment_envelope(const size_t) const
 {
@@ -492,15 +673,20 @@ bool TetOptimizerMesh::is_inverted(const std::array<size_t, 4>& vs) const
             return false;
         return true;
     } else {
-        Vector3r n =
-            ((m_vertex_attribute[vs[1]].m_pos) - m_vertex_attribute[vs[0]].m_pos)
-                .cross((m_vertex_attribute[vs[2]].m_pos) - m_vertex_attribute[vs[0]].m_pos);
-        Vector3r d = (m_vertex_attribute[vs[3]].m_pos) - m_vertex_attribute[vs[0]].m_pos;
-        auto res = n.dot(d);
-        if (res > 0) // predicates returns pos value: non-inverted
-            return false;
-        else
-            return true;
+        // m_posf is to_double of the exact position, within an ulp of it, so the interval
+        // filter decides most of these without building a single Rational.
+        const int s = wmtk::utils::orient3d_interval_sign(
+            m_vertex_attribute[vs[0]].m_posf,
+            m_vertex_attribute[vs[1]].m_posf,
+            m_vertex_attribute[vs[2]].m_posf,
+            m_vertex_attribute[vs[3]].m_posf);
+        wmtk::utils::count_orient_filter(s != 0);
+        if (s != 0) return s < 0;
+        return !wmtk::utils::orient3d_exact(
+            vertex_exact_pos(vs[0]),
+            vertex_exact_pos(vs[1]),
+            vertex_exact_pos(vs[2]),
+            vertex_exact_pos(vs[3]));
     }
 }
 
@@ -515,48 +701,98 @@ bool TetOptimizerMesh::round(const Tuple& v)
     size_t i = v.vid(*this);
     if (m_vertex_attribute[i].m_is_rounded) return true;
 
-    auto old_pos = m_vertex_attribute[i].m_pos;
-    m_vertex_attribute[i].m_pos << m_vertex_attribute[i].m_posf[0], m_vertex_attribute[i].m_posf[1],
-        m_vertex_attribute[i].m_posf[2];
+    // Marking the vertex rounded is what makes is_inverted read its double position.
     auto conn_tets = get_one_ring_tets_for_vertex(v);
     m_vertex_attribute[i].m_is_rounded = true;
     for (auto& tet : conn_tets) {
         if (is_inverted(tet)) {
             m_vertex_attribute[i].m_is_rounded = false;
-            m_vertex_attribute[i].m_pos = old_pos;
             return false;
         }
     }
+    m_exact_pos.erase(i);
 
     return true;
 }
 
+namespace {
+/// The clamp every quality goes through: what AMIPS cannot score is MAX_ENERGY.
+double clamp_quality(const double energy)
+{
+    if (std::isinf(energy) || std::isnan(energy) || energy < 27 - 1e-3) {
+        return TetOptimizerMesh::MAX_ENERGY;
+    }
+    return energy;
+}
+
+/// AMIPS_energy_stable_p3 with the double energy already evaluated.
+double stable_p3(const double amips, const std::array<double, 12>& T)
+{
+    if (amips < 1e8 && amips > 2) {
+        return std::pow(amips, 3);
+    }
+    return wmtk::AMIPS_energy_rational_p3<wmtk::Rational>(T);
+}
+} // namespace
+
 double TetOptimizerMesh::get_quality(const std::array<size_t, 4>& its) const
 {
-    std::array<Vector3d, 4> ps;
-    auto use_rational = false;
-    for (auto k = 0; k < 4; k++) {
-        ps[k] = m_vertex_attribute[its[k]].m_posf;
+    for (size_t k = 0; k < 4; k++) {
         if (!m_vertex_attribute[its[k]].m_is_rounded) {
-            use_rational = true;
-            break;
+            std::array<wmtk::Rational, 12> T;
+            for (size_t i = 0; i < 4; i++) {
+                const Vector3r p = vertex_exact_pos(its[i]);
+                for (size_t j = 0; j < 3; j++) T[i * 3 + j] = p[j];
+            }
+            return clamp_quality(wmtk::AMIPS_energy_rational_p3<wmtk::Rational>(T));
         }
     }
-    auto energy = -1.;
-    if (!use_rational) {
-        std::array<double, 12> T;
-        for (auto k = 0; k < 4; k++)
-            for (auto j = 0; j < 3; j++) T[k * 3 + j] = ps[k][j];
 
-        energy = wmtk::AMIPS_energy_stable_p3<wmtk::Rational>(T);
-    } else {
-        std::array<wmtk::Rational, 12> T;
-        for (auto k = 0; k < 4; k++)
-            for (auto j = 0; j < 3; j++) T[k * 3 + j] = m_vertex_attribute[its[k]].m_pos[j];
-        energy = wmtk::AMIPS_energy_rational_p3<wmtk::Rational>(T);
+    // A batch of one, so that a tet scores the same here as in get_qualities.
+    std::array<double, 12> T;
+    for (size_t k = 0; k < 4; k++) {
+        const Vector3d& p = m_vertex_attribute[its[k]].m_posf;
+        for (size_t j = 0; j < 3; j++) T[k * 3 + j] = p[j];
+    }
+    double amips;
+    wmtk::AMIPS_energies(&T, 1, &amips);
+    return clamp_quality(stable_p3(amips, T));
+}
+
+void TetOptimizerMesh::get_qualities(
+    const std::vector<std::array<size_t, 4>>& tets,
+    std::vector<double>& qualities) const
+{
+    qualities.resize(tets.size());
+
+    // Gather the rounded tets for the batch; the rest need their exact positions anyway.
+    std::vector<std::array<double, 12>> T;
+    std::vector<size_t> slot;
+    T.reserve(tets.size());
+    slot.reserve(tets.size());
+    for (size_t i = 0; i < tets.size(); ++i) {
+        const auto& its = tets[i];
+        bool rounded = true;
+        for (size_t k = 0; k < 4 && rounded; ++k) {
+            rounded = m_vertex_attribute[its[k]].m_is_rounded;
+        }
+        if (!rounded) {
+            qualities[i] = get_quality(its);
+            continue;
+        }
+        std::array<double, 12>& t = T.emplace_back();
+        for (size_t k = 0; k < 4; k++) {
+            const Vector3d& p = m_vertex_attribute[its[k]].m_posf;
+            for (size_t j = 0; j < 3; j++) t[k * 3 + j] = p[j];
+        }
+        slot.push_back(i);
+    }
+
+    std::vector<double> amips(T.size());
+    wmtk::AMIPS_energies(T.data(), T.size(), amips.data());
+    for (size_t b = 0; b < T.size(); ++b) {
+        qualities[slot[b]] = clamp_quality(stable_p3(amips[b], T[b]));
     }
-    if (std::isinf(energy) || std::isnan(energy) || energy < 27 - 1e-3) return MAX_ENERGY;
-    return energy;
 }
 
 double TetOptimizerMesh::get_quality(const Tuple& loc) const
@@ -46,12 +46,11 @@ class TetOptimizerMesh : public wmtk::TetMesh, public wmtk::RationalPositions
 public:
     struct VertexAttributes
     {
-        Vector3r m_pos; // exact position in rational
         Vector3d m_posf; // position as double
         /**
          * If a vertex cannot be rounded without inverting a tet, the exact position must be
-         * used. Once the vertex can be rounded to double precision, the rational
-         * representation is obsolete.
+         * used; it is kept in m_exact_pos, see vertex_exact_pos(). Once the vertex can be
+         * rounded to double precision, m_posf is exact and the rational one is dropped.
          */
         bool m_is_rounded = false;
 
@@ -72,7 +71,10 @@ public:
         size_t partition_id = 0;
 
         VertexAttributes() {}
-        VertexAttributes(const Vector3r& p);
+        VertexAttributes(const Vector3d& p)
+            : m_posf(p)
+            , m_is_rounded(true)
+        {}
     };
 
     using FaceAttributes = wmtk::SurfaceTagAttributes;
@@ -91,6 +93,21 @@ public:
      */
     AttributeContainerGroup m_vertex_attr_group;
 
+    /**
+     * @brief The exact positions of the vertices that are not rounded, by vid.
+     *
+     * Nearly every vertex is rounded for nearly all of a run, and a rounded vertex's exact
+     * position is its double one. A Vector3r in every VertexAttributes therefore held three
+     * rationals per slot that nothing read, and copied them through every undo log and
+     * consolidation; this holds only the ones that mean something. Registered in
+     * m_vertex_attr_group, so it is protected, rolled back and renumbered with the rest.
+     *
+     * Read and written through vertex_exact_pos() and set_vertex_exact_pos(), which keep it in
+     * step with m_is_rounded. An entry left behind by code that marks a vertex rounded without
+     * going through them is ignored, and dropped at the next round() or consolidation.
+     */
+    SparseAttributeCollection<Vector3r> m_exact_pos;
+
     /**
      * @brief What p_face_attrs points at, so a derived class can register more.
      *
@@ -128,9 +145,6 @@ public:
     double m_s_amips = 1.;
     double m_s_envelope = -1.;
 
-    double time_env = 0.0;
-    igl::Timer isout_timer;
-
     /// Per-thread Newton solver for smoothing; created on first use.
     wmtk::threading::enumerable_thread_specific<std::unique_ptr<polysolve::nonlinear::Solver>>
         m_solver;
@@ -164,9 +178,11 @@ public:
         , m_envelope(std::move(env))
     {
         m_vertex_attr_group.add(&m_vertex_attribute);
+        m_vertex_attr_group.add(&m_exact_pos);
         p_vertex_attrs = &m_vertex_attr_group;
         m_face_attr_group.add(&m_face_attribute);
         p_face_attrs = &m_face_attr_group;
+        enable_face_adjacency(m_params.face_adjacency);
     }
     ~TetOptimizerMesh() override = default;
 
@@ -213,6 +229,19 @@ public:
 
     double get_length2(const Tuple& l) const;
 
+    /// The exact position of a vertex: its m_exact_pos entry if it is not rounded, m_posf if
+    /// it is -- or if it was left un-rounded without an entry, e.g. by a freshly sized mesh.
+    Vector3r vertex_exact_pos(const size_t vid) const;
+    /**
+     * @brief Move a vertex to an exact position.
+     *
+     * m_posf becomes the nearest double. If that is `p` itself the vertex is rounded and has
+     * no m_exact_pos entry; otherwise `p` is stored there and m_all_rounded is cleared.
+     */
+    void set_vertex_exact_pos(const size_t vid, const Vector3r& p);
+    /// Move a vertex to a double position, which makes it rounded.
+    void set_vertex_pos(const size_t vid, const Vector3d& p);
+
     bool is_inverted(const std::array<size_t, 4>& vs) const;
     bool is_inverted(const Tuple& loc) const;
     /// Inversion check using only the double positions.
@@ -220,6 +249,16 @@ public:
 
     double get_quality(const std::array<size_t, 4>& vs) const;
     double get_quality(const Tuple& loc) const;
+    /**
+     * @brief get_quality of each of `tets`, into `qualities` (resized to match).
+     *
+     * The rounded tets are scored together through AMIPS_energies rather than one call each;
+     * only those whose energy needs the rational fallback, or that have unrounded vertices,
+     * are handled one by one. Same values as calling get_quality per tet.
+     */
+    void get_qualities(
+        const std::vector<std::array<size_t, 4>>& tets,
+        std::vector<double>& qualities) const;
     std::tuple<double, double> get_max_avg_energy();
 
     /**
@@ -309,6 +348,14 @@ public:
         const auto& VA = m_vertex_attribute;
         return env->is_outside({{VA[a].m_posf, VA[b].m_posf, VA[c].m_posf}});
     }
+    /// Whether any of the @p n tracked-surface triangles is outside its containment envelope,
+    /// asked with one SampleEnvelope::first_outside batch per envelope rather than one query
+    /// per triangle.
+    bool any_surface_triangle_is_outside(const std::array<size_t, 3>* faces, size_t n) const;
+    bool any_surface_triangle_is_outside(const std::vector<std::array<size_t, 3>>& faces) const
+    {
+        return any_surface_triangle_is_outside(faces.data(), faces.size());
+    }
 
     bool vertex_is_on_surface(const size_t vid) const override;
     bool face_is_on_surface(const size_t fid) const override;
@@ -568,6 +615,19 @@ private:
     /// One smoothing attempt on @p vid, restoring everything it wrote if it is rejected.
     bool smooth_vertex_reversible(size_t vid, CoarsenScratch& scr);
 
+    /**
+     * @brief One iteration of the "colored" smoothing engine (OptimizerParameters::
+     * smoothing_engine): each class of @p classes smoothed in parallel, one class after another.
+     *
+     * @p classes must come from utils::color_vertices over one-rings, so that classmates share
+     * no cell. @p active, when non-empty, restricts the pass to the vertices it flags.
+     *
+     * @return the number of vertices moved.
+     */
+    size_t smooth_color_classes(
+        const std::vector<std::vector<size_t>>& classes,
+        const std::vector<char>& active);
+
     size_t collapse_all_edges_impl(bool is_limit_length, int lock_ring, size_t max_passes = 0);
 };
 
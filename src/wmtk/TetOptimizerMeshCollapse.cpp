@@ -16,6 +16,63 @@
 
 namespace wmtk {
 
+namespace {
+
+/// The collapse pass's hooks as a type, so that the scheduler calls them directly rather than
+/// through ExecutePass's std::function members. Edges are queued in both directions, shortest
+/// first.
+struct CollapseTraits
+{
+    using Tuple = TetMesh::Tuple;
+
+    double priority(const TetOptimizerMesh& m, OpHandle, const Tuple& t) const
+    {
+        return -m.get_length2(t);
+    }
+    // No renew_key: collapse_edge already returns each new edge once (unique_edge_tuples).
+    template <class Emit>
+    void renew_neighbor_tuples(
+        const TetOptimizerMesh& m,
+        OpHandle op,
+        const std::vector<Tuple>& newts,
+        Emit&& emit) const
+    {
+        for (const Tuple& t : newts) {
+            emit(op, t);
+            emit(op, t.switch_vertex(m));
+        }
+    }
+    bool is_weight_up_to_date(
+        const TetOptimizerMesh& m,
+        const std::tuple<double, OpHandle, Tuple>& ele) const
+    {
+        auto& [weight, op, tup] = ele;
+        auto length = m.get_length2(tup);
+        if (length != -weight) return false;
+        // Length gate, applied to the CANDIDATE LIST -- TetWild's placement. An edge at or
+        // above the collapse target is not offered to this pass at all.
+        if (m.m_collapse_limit_length) {
+            const size_t v1_id = tup.vid(m);
+            const size_t v2_id = tup.switch_vertex(m).vid(m);
+            const double sizing_ratio = (m.m_vertex_attribute[v1_id].m_sizing_scalar +
+                                         m.m_vertex_attribute[v2_id].m_sizing_scalar) /
+                                        2;
+            if (length > m.m_params.collapsing_l2 * sizing_ratio * sizing_ratio) {
+                return false;
+            }
+        }
+        return true;
+    }
+    std::optional<std::vector<Tuple>> apply(TetOptimizerMesh& m, OpHandle, const Tuple& t) const
+    {
+        std::vector<Tuple> ret;
+        if (m.collapse_edge(t, ret)) return ret;
+        return {};
+    }
+};
+
+} // namespace
+
 void TetOptimizerMesh::collapse_all_edges(bool is_limit_length)
 {
     collapse_all_edges_impl(is_limit_length, wmtk::default_ring(wmtk::PassLock::EdgeRing));
@@ -48,37 +105,16 @@ TetOptimizerMesh::collapse_all_edges_impl(bool is_limit_length, int lock_ring, s
         lock_ring,
         "edge collapse operation",
         [&](auto& executor, auto& mesh) {
-            executor.renew_neighbor_tuples = [](const auto& m, auto op, const auto& newts) {
-                std::vector<std::pair<std::string, wmtk::TetMesh::Tuple>> op_tups;
-                for (const Tuple& t : newts) {
-                    op_tups.emplace_back(op, t);
-                    op_tups.emplace_back(op, t.switch_vertex(m));
-                }
-                return op_tups;
-            };
-            executor.priority = [&](auto& m, auto op, auto& t) { return -m.get_length2(t); };
-            executor.is_weight_up_to_date = [&](const auto& m, const auto& ele) {
-                auto& [weight, op, tup] = ele;
-                auto length = m.get_length2(tup);
-                if (length != -weight) return false;
-                // Length gate, applied to the CANDIDATE LIST -- TetWild's placement. An edge
-                // at or above the collapse target is not offered to this pass at all.
-                if (m_collapse_limit_length) {
-                    const size_t v1_id = tup.vid(*this);
-                    const size_t v2_id = tup.switch_vertex(*this).vid(*this);
-                    const double sizing_ratio = (m_vertex_attribute[v1_id].m_sizing_scalar +
-                                                 m_vertex_attribute[v2_id].m_sizing_scalar) /
-                                                2;
-                    if (length > m_params.collapsing_l2 * sizing_ratio * sizing_ratio) {
-                        return false;
-                    }
-                }
-                return true;
-            };
+            wmtk::use_approximate_queue(executor, mesh);
+            CollapseTraits traits;
             // Retry a failed collapse only where the mesh actually changed this round
             // (dirty-epoch localized retry), instead of re-testing every failure every pass.
-            accepted =
-                wmtk::run_localized_to_convergence(mesh, executor, collect_all_ops, max_passes);
+            accepted = wmtk::run_localized_to_convergence(
+                mesh,
+                executor,
+                traits,
+                collect_all_ops,
+                max_passes);
         });
     return accepted;
 }
@@ -158,8 +194,9 @@ bool TetOptimizerMesh::collapse_edge_before(const Tuple& loc) // input is an edg
         }
     }
 
-    // pre-compute after-collapse energies
-    cache.changed_energies.reserve(cache.changed_tids.size());
+    // pre-compute after-collapse energies, all changed tets in one batch
+    std::vector<std::array<size_t, 4>> changed_vs;
+    changed_vs.reserve(cache.changed_tids.size());
     for (const size_t tid : cache.changed_tids) {
         std::array<size_t, 4> vs = oriented_tet_vids(tid);
         for (size_t i = 0; i < 4; ++i) {
@@ -172,15 +209,19 @@ bool TetOptimizerMesh::collapse_edge_before(const Tuple& loc) // input is an edg
         if (is_inverted(vs)) {
             return false;
         }
-        double q = get_quality(vs);
-        // The coarsening pass deliberately skips the quality gate and decides on the region
-        // AFTER re-smoothing instead -- that is the whole point of it. The inversion check
-        // above still applies: an inverted cell is not something smoothing can repair, since
-        // smooth_vertex_3d refuses to start from one.
-        if (!m_coarsen_mode && !collapse_quality_allowed(v1_id, q, cache.max_energy)) {
-            return false;
+        changed_vs.push_back(vs);
+    }
+    get_qualities(changed_vs, cache.changed_energies);
+    // The coarsening pass deliberately skips the quality gate and decides on the region
+    // AFTER re-smoothing instead -- that is the whole point of it. The inversion check
+    // above still applies: an inverted cell is not something smoothing can repair, since
+    // smooth_vertex_3d refuses to start from one.
+    if (!m_coarsen_mode) {
+        for (const double q : cache.changed_energies) {
+            if (!collapse_quality_allowed(v1_id, q, cache.max_energy)) {
+                return false;
+            }
         }
-        cache.changed_energies.emplace_back(q);
     }
     assert(cache.changed_energies.size() == cache.changed_tids.size());
 
@@ -340,12 +381,12 @@ bool TetOptimizerMesh::collapse_edge_after(const Tuple& loc)
     // surface
     // and open boundary
     if (cache.edge_length > 0) {
-        for (auto& vids : cache.surface_faces) {
-            // surface envelope
-            if (surface_triangle_is_outside(vids[0], vids[1], vids[2])) {
-                return false;
-            }
+        // surface envelope, all new faces in one batch
+        if (any_surface_triangle_is_outside(cache.surface_faces)) {
+            return false;
+        }
 
+        // for (auto& vids : cache.surface_faces) {
             // // open boundary envelope
             // // by checking each edge on cached surface
             // if (VA[vids[0]].m_is_on_open_boundary && VA[vids[1]].m_is_on_open_boundary) {
@@ -363,7 +404,7 @@ bool TetOptimizerMesh::collapse_edge_after(const Tuple& loc)
             //             {{VA[vids[2]].m_posf, VA[vids[0]].m_posf, VA[vids[2]].m_posf}}))
             //         return false;
             // }
-        }
+        // }
         // for (const auto& vids : cache.boundary_edges) {
         //     if (!is_open_boundary_edge(vids)) {
         //        // edge was an open boundary before (that is why it got cached) but is not anymore
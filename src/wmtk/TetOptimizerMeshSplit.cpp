@@ -2,7 +2,6 @@
 #include <limits>
 
 #include <igl/Timer.h>
-#include <wmtk/utils/ExecutorUtils.hpp>
 #include <wmtk/utils/LocalizedRetry.hpp>
 #include <wmtk/utils/Logger.hpp>
 #include <wmtk/utils/ParallelCollect.hpp>
@@ -10,6 +9,66 @@
 
 namespace wmtk {
 
+namespace {
+
+/// The split pass's hooks as a type, so that the scheduler calls them directly rather than
+/// through ExecutePass's std::function members. Longest edge first.
+struct SplitTraits
+{
+    using Tuple = TetMesh::Tuple;
+
+    double priority(const TetOptimizerMesh& m, OpHandle, const Tuple& t) const
+    {
+        return m.get_length2(t);
+    }
+    // No renew_key: split_edge already returns each new edge once (unique_edge_tuples).
+    template <class Emit>
+    void renew_neighbor_tuples(
+        const TetOptimizerMesh&,
+        OpHandle op,
+        const std::vector<Tuple>& newts,
+        Emit&& emit) const
+    {
+        for (const Tuple& t : newts) {
+            emit(op, t);
+        }
+    }
+    bool is_weight_up_to_date(
+        const TetOptimizerMesh& m,
+        const std::tuple<double, OpHandle, Tuple>& ele) const
+    {
+        auto [weight, op, tup] = ele;
+        auto length = m.get_length2(tup);
+        if (length != weight) return false;
+        //
+        size_t v1_id = tup.vid(m);
+        size_t v2_id = tup.switch_vertex(m).vid(m);
+        // Force-split: a worst tet's longest edge (queued by refine_sizing_around_worst when
+        // the max energy stalls) is split once regardless of the length gate, to unstick a
+        // sliver without changing the sizing field. The new midpoint is not in
+        // m_force_split_edges, so the two halves are NOT force-split again -- exactly one
+        // split per edge.
+        if (m.is_force_split_edge(v1_id, v2_id)) {
+            return true;
+        }
+        double sizing_ratio = (m.m_vertex_attribute[v1_id].m_sizing_scalar +
+                               m.m_vertex_attribute[v2_id].m_sizing_scalar) /
+                              2;
+        if (length < m.m_params.splitting_l2 * sizing_ratio * sizing_ratio) {
+            return false;
+        }
+        return true;
+    }
+    std::optional<std::vector<Tuple>> apply(TetOptimizerMesh& m, OpHandle, const Tuple& t) const
+    {
+        std::vector<Tuple> ret;
+        if (m.split_edge(t, ret)) return ret;
+        return {};
+    }
+};
+
+} // namespace
+
 void TetOptimizerMesh::split_all_edges()
 {
     igl::Timer timer;
@@ -46,33 +105,9 @@ void TetOptimizerMesh::split_all_edges()
         wmtk::PassLock::EdgeRing,
         "edge split operation",
         [&](auto& executor, auto& mesh) {
-            executor.renew_neighbor_tuples = wmtk::renewal_simple;
-
-            executor.priority = [&](auto& m, auto op, auto& t) { return m.get_length2(t); };
-            executor.is_weight_up_to_date = [&](const auto& m, const auto& ele) {
-                auto [weight, op, tup] = ele;
-                auto length = m.get_length2(tup);
-                if (length != weight) return false;
-                //
-                size_t v1_id = tup.vid(*this);
-                size_t v2_id = tup.switch_vertex(*this).vid(*this);
-                // Force-split: a worst tet's longest edge (queued by
-                // refine_sizing_around_worst when the max energy stalls) is split once
-                // regardless of the length gate, to unstick a sliver without changing the
-                // sizing field. The new midpoint is not in m_force_split_edges, so the
-                // two halves are NOT force-split again -- exactly one split per edge.
-                if (is_force_split_edge(v1_id, v2_id)) {
-                    return true;
-                }
-                double sizing_ratio = (m_vertex_attribute[v1_id].m_sizing_scalar +
-                                       m_vertex_attribute[v2_id].m_sizing_scalar) /
-                                      2;
-                if (length < m_params.splitting_l2 * sizing_ratio * sizing_ratio) {
-                    return false;
-                }
-                return true;
-            };
-            wmtk::run_localized_to_convergence(mesh, executor, collect_all_ops);
+            wmtk::use_approximate_queue(executor, mesh);
+            SplitTraits traits;
+            wmtk::run_localized_to_convergence(mesh, executor, traits, collect_all_ops);
         });
     if (m_force_split_count > 0) {
         wmtk::logger().info(
@@ -196,9 +231,6 @@ bool TetOptimizerMesh::split_edge_after(const Tuple& loc)
         (m_vertex_attribute[v1_id].m_posf + m_vertex_attribute[v2_id].m_posf) / 2;
     m_vertex_attribute[v_id].m_is_rounded = true;
 
-    // this has to be done before the inversion check
-    m_vertex_attribute[v_id].m_pos = to_rational(m_vertex_attribute[v_id].m_posf);
-
     for (const Tuple& loc : locs) {
         if (is_inverted(loc)) {
             m_vertex_attribute[v_id].m_is_rounded = false;
@@ -213,7 +245,8 @@ bool TetOptimizerMesh::split_edge_after(const Tuple& loc)
         // the EXACT rational midpoint of the two endpoints instead. That midpoint lies on the
         // shared edge, so it can never invert a previously-valid incident tet: the split
         // always succeeds and a stuck region can keep being refined. The vertex stays
-        // un-rounded (m_pos exact, m_is_rounded = false) until a later round() reclaims it.
+        // un-rounded (m_is_rounded = false, exact position in m_exact_pos) until a later
+        // round() reclaims it.
         //
         // This used to apply only when an endpoint was already rational, to stop a split
         // between two rounded endpoints from reintroducing exact coordinates into a
@@ -229,15 +262,17 @@ bool TetOptimizerMesh::split_edge_after(const Tuple& loc)
         // split is the only operation that can un-round a vertex (collapse, all four swaps
         // and smoothing never do), the post-optimization pass is collapse-only, and the loop
         // does not stop until every vertex is rounded as well as the energy target being met.
-        m_vertex_attribute[v_id].m_pos =
-            (m_vertex_attribute[v1_id].m_pos + m_vertex_attribute[v2_id].m_pos) / 2;
-        // Keep m_posf in step with the exact position. It was left holding the double
-        // midpoint, which is a different point -- and specifically the one just found to
-        // invert an incident tet. Every un-guarded m_posf read (edge length, the envelope
-        // tests, the smoothing seed) then works from a position the vertex does not have.
-        // When an endpoint is itself un-rounded the gap is not a rounding step but the whole
-        // distance between that endpoint's exact and approximate positions.
-        m_vertex_attribute[v_id].m_posf = to_double(m_vertex_attribute[v_id].m_pos);
+        //
+        // set_vertex_exact_pos also keeps m_posf in step with the exact position. It was left
+        // holding the double midpoint, which is a different point -- and specifically the one
+        // just found to invert an incident tet. Every un-guarded m_posf read (edge length, the
+        // envelope tests, the smoothing seed) would then work from a position the vertex does
+        // not have. When an endpoint is itself un-rounded the gap is not a rounding step but
+        // the whole distance between that endpoint's exact and approximate positions.
+        //
+        // It clears m_all_rounded too, so the sweep does not skip the next pass. If the check
+        // below rolls the split back, that costs the sweep one pass and nothing else.
+        set_vertex_exact_pos(v_id, (vertex_exact_pos(v1_id) + vertex_exact_pos(v2_id)) / 2);
         // Guard against a pre-existing inverted incident tet: re-check in exact
         // arithmetic (un-rounded v_id => is_inverted uses the rational path).
         for (const Tuple& loc : locs) {
@@ -245,9 +280,6 @@ bool TetOptimizerMesh::split_edge_after(const Tuple& loc)
                 return false;
             }
         }
-        // This split keeps an un-rounded vertex, so the sweep must not skip the next
-        // pass. Set after the rollback checks above, which leave the mesh unchanged.
-        m_all_rounded.store(false, std::memory_order_relaxed);
     }
 
     if (!split_adjust_position(v_id, locs)) return false;
@@ -283,6 +315,8 @@ bool TetOptimizerMesh::split_edge_after(const Tuple& loc)
     // The face split is (v1,v2,other) -> (v1,v_id,other) + (v2,v_id,other), which is the same
     // pair of new triangles the attribute update below writes.
     if (cache.is_edge_on_surface) {
+        static thread_local std::vector<std::array<size_t, 3>> new_faces;
+        new_faces.clear();
         for (const auto& info : cache.changed_faces) {
             if (!info.first.m_is_surface_fs) continue;
             const auto& old_vids = info.second;
@@ -296,12 +330,11 @@ bool TetOptimizerMesh::split_edge_after(const Tuple& loc)
                 }
             }
             if (n_shared != 2) continue; // face does not contain the split edge
-            if (surface_triangle_is_outside(v1_id, v_id, other)) {
-                return false;
-            }
-            if (surface_triangle_is_outside(v2_id, v_id, other)) {
-                return false;
-            }
+            new_faces.push_back({{v1_id, v_id, other}});
+            new_faces.push_back({{v2_id, v_id, other}});
+        }
+        if (any_surface_triangle_is_outside(new_faces)) {
+            return false;
         }
     }
 
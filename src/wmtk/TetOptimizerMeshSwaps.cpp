@@ -102,8 +102,10 @@ size_t TetOptimizerMesh::swap_all_edges_32()
         wmtk::PassLock::EdgeRing,
         "edge swap operation",
         [&](auto& executor, auto& mesh) {
-            executor.renew_neighbor_tuples = wmtk::renewal_edges;
-            executor.priority = [&](auto& m, auto op, auto& t) { return m.get_length2(t); };
+            executor.renew_neighbor_tuples_by_handle = wmtk::renewal_edges;
+            executor.priority_by_handle = [&](auto& m, auto op, auto& t) {
+                return m.get_length2(t);
+            };
             total_success = wmtk::run_localized_to_convergence(mesh, executor, collect_all_ops);
         });
     if (check_surface_topology()) {
@@ -322,8 +324,10 @@ bool TetOptimizerMesh::swap_edge_after(const Tuple& t)
     if (cache.is_surface_flip) {
         // The two new surface faces (a,c,d),(b,c,d) must stay within the
         // Hausdorff envelope, exactly like a surface-edge collapse.
-        if (surface_triangle_is_outside(cache.sf_a, cache.sf_c, cache.sf_d)) return false;
-        if (surface_triangle_is_outside(cache.sf_b, cache.sf_c, cache.sf_d)) return false;
+        const std::array<size_t, 3> new_faces[2] = {
+            {{cache.sf_a, cache.sf_c, cache.sf_d}},
+            {{cache.sf_b, cache.sf_c, cache.sf_d}}};
+        if (any_surface_triangle_is_outside(new_faces, 2)) return false;
     }
 
     tracker_assign_after(*this, twotets, cache.changed_faces, m_face_attribute);
@@ -374,8 +378,10 @@ size_t TetOptimizerMesh::swap_all_faces()
         wmtk::PassLock::FaceRing,
         "face swap operation",
         [&](auto& executor, auto& mesh) {
-            executor.renew_neighbor_tuples = wmtk::renewal_faces;
-            executor.priority = [](auto& m, auto op, auto& t) { return m.get_length2(t); };
+            executor.renew_neighbor_tuples_by_handle = wmtk::renewal_faces;
+            executor.priority_by_handle = [](auto& m, auto op, auto& t) {
+                return m.get_length2(t);
+            };
             total_success = wmtk::run_localized_to_convergence(mesh, executor, collect_all_ops);
         });
     return total_success;
@@ -485,9 +491,12 @@ size_t TetOptimizerMesh::swap_all_edges_all()
         "edge swap operation",
         [&](auto& executor, auto& mesh) {
             // executor.renew_neighbor_tuples = wmtk::renewal_edges;
-            executor.renew_neighbor_tuples =
-                [](const TetMesh& m, const std::string& op, const std::vector<Tuple>& newt) {
-                    std::vector<std::pair<std::string, TetMesh::Tuple>> op_tups;
+            const OpHandle swap_32 = executor.operation("edge_swap");
+            const OpHandle swap_44 = executor.operation("edge_swap_44");
+            const OpHandle swap_56 = executor.operation("edge_swap_56");
+            executor.renew_neighbor_tuples_by_handle =
+                [=](const TetMesh& m, OpHandle, const std::vector<Tuple>& newt) {
+                    std::vector<std::pair<OpHandle, TetMesh::Tuple>> op_tups;
                     std::vector<TetMesh::Tuple> new_edges;
                     for (const TetMesh::Tuple& ti : newt) {
                         for (auto j = 0; j < 6; j++) {
@@ -497,13 +506,15 @@ size_t TetOptimizerMesh::swap_all_edges_all()
                     wmtk::unique_edge_tuples(m, new_edges);
                     op_tups.reserve(new_edges.size() * 3);
                     for (const Tuple& loc : new_edges) {
-                        op_tups.emplace_back("edge_swap", loc);
-                        op_tups.emplace_back("edge_swap_44", loc);
-                        op_tups.emplace_back("edge_swap_56", loc);
+                        op_tups.emplace_back(swap_32, loc);
+                        op_tups.emplace_back(swap_44, loc);
+                        op_tups.emplace_back(swap_56, loc);
                     }
                     return op_tups;
                 };
-            executor.priority = [&](auto& m, auto op, auto& t) { return m.get_length2(t); };
+            executor.priority_by_handle = [&](auto& m, auto op, auto& t) {
+                return m.get_length2(t);
+            };
             total_success = wmtk::run_localized_to_convergence(mesh, executor, collect_all_ops);
         });
     if (check_surface_topology()) {
@@ -532,8 +543,10 @@ size_t TetOptimizerMesh::swap_all_edges_44()
         wmtk::PassLock::EdgeRing,
         "edge swap 44 operation",
         [&](auto& executor, auto& mesh) {
-            executor.renew_neighbor_tuples = wmtk::renewal_edges;
-            executor.priority = [&](auto& m, auto op, auto& t) { return m.get_length2(t); };
+            executor.renew_neighbor_tuples_by_handle = wmtk::renewal_edges;
+            executor.priority_by_handle = [&](auto& m, auto op, auto& t) {
+                return m.get_length2(t);
+            };
             total_success = wmtk::run_localized_to_convergence(mesh, executor, collect_all_ops);
         });
     if (check_surface_topology()) warn_if_surface_topology_changed(sig_before, "swap_all_edges_44");
@@ -608,8 +621,10 @@ bool TetOptimizerMesh::swap_edge_44_after(const Tuple& t)
     if (cache.is_surface_flip) {
         // The two new surface faces (a,c,d),(b,c,d) must stay within the Hausdorff envelope,
         // exactly like a surface-edge collapse / the 3->2 surface flip.
-        if (surface_triangle_is_outside(cache.sf_a, cache.sf_c, cache.sf_d)) return false;
-        if (surface_triangle_is_outside(cache.sf_b, cache.sf_c, cache.sf_d)) return false;
+        const std::array<size_t, 3> new_faces[2] = {
+            {{cache.sf_a, cache.sf_c, cache.sf_d}},
+            {{cache.sf_b, cache.sf_c, cache.sf_d}}};
+        if (any_surface_triangle_is_outside(new_faces, 2)) return false;
     }
 
     tracker_assign_after(*this, incident_tets, cache.changed_faces, m_face_attribute);
@@ -654,8 +669,10 @@ size_t TetOptimizerMesh::swap_all_edges_56()
         wmtk::PassLock::EdgeRing,
         "edge swap 56 operation",
         [&](auto& executor, auto& mesh) {
-            executor.renew_neighbor_tuples = wmtk::renewal_edges;
-            executor.priority = [&](auto& m, auto op, auto& t) { return m.get_length2(t); };
+            executor.renew_neighbor_tuples_by_handle = wmtk::renewal_edges;
+            executor.priority_by_handle = [&](auto& m, auto op, auto& t) {
+                return m.get_length2(t);
+            };
             total_success = wmtk::run_localized_to_convergence(mesh, executor, collect_all_ops);
         });
     if (check_surface_topology()) warn_if_surface_topology_changed(sig_before, "swap_all_edges_56");
@@ -730,8 +747,10 @@ bool TetOptimizerMesh::swap_edge_56_after(const Tuple& t)
 
     if (cache.is_surface_flip) {
         // The two new surface faces (a,c,d),(b,c,d) must stay within the Hausdorff envelope.
-        if (surface_triangle_is_outside(cache.sf_a, cache.sf_c, cache.sf_d)) return false;
-        if (surface_triangle_is_outside(cache.sf_b, cache.sf_c, cache.sf_d)) return false;
+        const std::array<size_t, 3> new_faces[2] = {
+            {{cache.sf_a, cache.sf_c, cache.sf_d}},
+            {{cache.sf_b, cache.sf_c, cache.sf_d}}};
+        if (any_surface_triangle_is_outside(new_faces, 2)) return false;
     }
 
     tracker_assign_after(*this, tids, cache.changed_faces, m_face_attribute);
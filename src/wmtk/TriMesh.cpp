@@ -5,6 +5,7 @@
 #include <wmtk/AttributeCollection.hpp>
 #include <wmtk/threading/parallel_for.hpp>
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/Reindexing.hpp>
 #include <wmtk/utils/TupleUtils.hpp>
 
 #include <algorithm>
@@ -44,8 +45,8 @@ struct EdgeFanScan
  * only cares whether a second face exists, and a fan can be large at a pole.
  */
 inline EdgeFanScan scan_edge_fan(
-    const std::vector<size_t>& a,
-    const std::vector<size_t>& b,
+    const TriMesh::StarVector& a,
+    const TriMesh::StarVector& b,
     const size_t after = size_t(-1),
     const size_t stop_at = std::numeric_limits<size_t>::max())
 {
@@ -118,9 +119,9 @@ size_t TriMesh::Tuple::eid(const TriMesh& m) const
     // same set either way, and both fans are sorted, so the first hit is the minimum fid
     // whichever one is scanned. switch_faces() below already picks the smaller fan; this
     // one always took m_vid's, which on a high-valence vertex is the expensive choice.
-    const std::vector<size_t>& v0_fids = m.m_vertex_connectivity[m_vid].m_conn_tris;
-    const std::vector<size_t>& v1_fids = m.m_vertex_connectivity[v_opp].m_conn_tris;
-    const std::vector<size_t>& fids = v0_fids.size() <= v1_fids.size() ? v0_fids : v1_fids;
+    const StarVector& v0_fids = m.m_vertex_connectivity[m_vid].m_conn_tris;
+    const StarVector& v1_fids = m.m_vertex_connectivity[v_opp].m_conn_tris;
+    const StarVector& fids = v0_fids.size() <= v1_fids.size() ? v0_fids : v1_fids;
 
     // find face that contain m_vid and v_opp
     for (const size_t f : fids) {
@@ -256,10 +257,10 @@ std::vector<TriMesh::Tuple> TriMesh::Tuple::switch_faces(const TriMesh& m) const
     size_t loc_v0 = m_vid;
     size_t v1 = this->switch_vertex(m).m_vid;
 
-    const std::vector<size_t>& v0_fids = m.m_vertex_connectivity[loc_v0].m_conn_tris;
-    const std::vector<size_t>& v1_fids = m.m_vertex_connectivity[v1].m_conn_tris;
+    const StarVector& v0_fids = m.m_vertex_connectivity[loc_v0].m_conn_tris;
+    const StarVector& v1_fids = m.m_vertex_connectivity[v1].m_conn_tris;
     // get the smaller vector of the two
-    const std::vector<size_t>& fids = v0_fids.size() <= v1_fids.size() ? v0_fids : v1_fids;
+    const StarVector& fids = v0_fids.size() <= v1_fids.size() ? v0_fids : v1_fids;
 
     // Both fans are sorted, so scanning one of them and keeping the faces that also carry
     // the other endpoint yields the edge's fan in increasing fid order, minus this face.
@@ -340,7 +341,7 @@ void TriMesh::vertex_fan_components(
     component_of.clear();
     representatives.clear();
 
-    const std::vector<size_t>& fan = m_vertex_connectivity[vid].m_conn_tris;
+    const StarVector& fan = m_vertex_connectivity[vid].m_conn_tris;
     if (fan.empty()) {
         return;
     }
@@ -733,7 +734,7 @@ std::optional<TriMesh::Tuple> TriMesh::switch_component(const Tuple& t) const
     // Nowhere to go when the fan is one piece.
     if (representatives.size() <= 1) return {};
 
-    const std::vector<size_t>& fan = m_vertex_connectivity[vid].m_conn_tris;
+    const StarVector& fan = m_vertex_connectivity[vid].m_conn_tris;
     const size_t here = std::lower_bound(fan.begin(), fan.end(), t.fid(*this)) - fan.begin();
     assert(here < fan.size() && fan[here] == t.fid(*this));
 
@@ -751,7 +752,7 @@ std::optional<TriMesh::Tuple> TriMesh::switch_component(const Tuple& t) const
 // a valid mesh can have triangles that are is_removed == true
 bool wmtk::TriMesh::check_mesh_connectivity_validity() const
 {
-    std::vector<std::vector<size_t>> conn_tris(vert_capacity());
+    std::vector<std::vector<index_t>> conn_tris(vert_capacity());
     for (size_t i = 0; i < tri_capacity(); i++) {
         if (m_tri_connectivity[i].m_is_removed) continue;
         for (int j = 0; j < 3; j++) conn_tris[m_tri_connectivity[i][j]].push_back(i);
@@ -1319,7 +1320,7 @@ void TriMesh::collapse_edge_conn(
     const auto n2_fids = m_vertex_connectivity[vid2].m_conn_tris;
 
     // get the fids that will be modified
-    n12_intersect_fids = set_intersection(n1_fids, n2_fids);
+    n12_intersect_fids = vector_cast<size_t>(set_intersection(n1_fids, n2_fids));
 #ifndef NDEBUG
     {
         // check if the triangles intersection is the one adjcent to the edge
@@ -1441,7 +1442,7 @@ void TriMesh::collapse_edge_conn(
         std::vector<size_t> merged_away;
         // m_conn_tris is sorted, so the first face seen for a key is the smallest fid.
         for (const size_t fid : m_vertex_connectivity[vid2].m_conn_tris) {
-            std::array<size_t, 3> key = m_tri_connectivity[fid].m_indices;
+            auto key = array_cast<size_t>(m_tri_connectivity[fid].m_indices);
             std::sort(key.begin(), key.end());
             if (!first_with_key.try_emplace(key, fid).second) {
                 merged_away.push_back(fid);
@@ -1679,7 +1680,7 @@ bool TriMesh::split_face(const Tuple& t, std::vector<Tuple>& new_tris)
     std::pair<size_t, TriangleConnectivity> old_tri;
     old_tri = std::make_pair(fid, m_tri_connectivity[fid]);
 
-    const auto conn_tris = [this, &vid](size_t i) -> std::vector<size_t>& {
+    const auto conn_tris = [this, &vid](size_t i) -> StarVector& {
         return m_vertex_connectivity[vid[i]].m_conn_tris;
     };
 
@@ -1787,67 +1788,88 @@ bool TriMesh::split_face(const Tuple& t, std::vector<Tuple>& new_tris)
 
 void TriMesh::consolidate_mesh()
 {
-    auto v_cnt = 0;
-    std::vector<size_t> map_v_ids(vert_capacity(), -1);
-    for (auto i = 0; i < vert_capacity(); i++) {
-        if (m_vertex_connectivity[i].m_is_removed) continue;
-        map_v_ids[i] = v_cnt;
-        v_cnt++;
-    }
-    auto t_cnt = 0;
-    std::vector<size_t> map_t_ids(tri_capacity(), -1);
-    for (auto i = 0; i < tri_capacity(); i++) {
-        if (m_tri_connectivity[i].m_is_removed) continue;
-        map_t_ids[i] = t_cnt;
-        t_cnt++;
-    }
-    v_cnt = 0;
-    for (auto i = 0; i < vert_capacity(); i++) {
-        if (m_vertex_connectivity[i].m_is_removed) continue;
-        if (v_cnt != i) {
-            assert(v_cnt < i);
-            m_vertex_connectivity[v_cnt] = m_vertex_connectivity[i];
-            if (p_vertex_attrs) p_vertex_attrs->move(i, v_cnt);
-        }
-        for (size_t& t_id : m_vertex_connectivity[v_cnt].m_conn_tris) t_id = map_t_ids[t_id];
-        v_cnt++;
-    }
-    t_cnt = 0;
-    for (int i = 0; i < tri_capacity(); i++) {
-        if (m_tri_connectivity[i].m_is_removed) continue;
+    consolidate_mesh({});
+}
+
+void TriMesh::consolidate_mesh(const std::vector<uint64_t>& vertex_keys)
+{
+    const bool reorder = !vertex_keys.empty();
+    assert(!reorder || vertex_keys.size() >= vert_capacity());
+
+    std::vector<size_t> map_v_ids, v_order;
+    compact_ids(
+        vert_capacity(),
+        [&](size_t i) { return !m_vertex_connectivity[i].m_is_removed; },
+        NUM_THREADS,
+        map_v_ids,
+        v_order);
+    std::vector<size_t> map_t_ids, t_order;
+    compact_ids(
+        tri_capacity(),
+        [&](size_t i) { return !m_tri_connectivity[i].m_is_removed; },
+        NUM_THREADS,
+        map_t_ids,
+        t_order);
+    if (reorder) {
+        sort_ids_by_key([&](size_t v) { return vertex_keys[v]; }, NUM_THREADS, map_v_ids, v_order);
+        sort_ids_by_key(
+            [&](size_t t) {
+                const auto& vs = m_tri_connectivity[t].m_indices;
+                return uint64_t(
+                    std::min(std::min(map_v_ids[vs[0]], map_v_ids[vs[1]]), map_v_ids[vs[2]]));
+            },
+            NUM_THREADS,
+            map_t_ids,
+            t_order);
+    }
+    const size_t v_cnt = v_order.size();
+    const size_t t_cnt = t_order.size();
 
-        if (t_cnt != i) {
-            assert(t_cnt < i);
-            m_tri_connectivity[t_cnt] = m_tri_connectivity[i];
-            m_tri_connectivity[t_cnt].hash = 0;
-            if (p_face_attrs) p_face_attrs->move(i, t_cnt);
+    // Re-establish spare capacity for the next round of operations.
+    const size_t vcap = reserved_capacity(v_cnt);
+    const size_t tcap = reserved_capacity(t_cnt);
 
-            for (auto j = 0; j < 3; j++) {
-                if (p_edge_attrs) p_edge_attrs->move(i * 3 + j, t_cnt * 3 + j);
-            }
-        }
-        for (size_t& v_id : m_tri_connectivity[t_cnt].m_indices) v_id = map_v_ids[v_id];
-        t_cnt++;
+    // Gathered into fresh storage, as in TetMesh::consolidate_mesh, so that every element
+    // moves independently.
+    {
+        vector<VertexConnectivity> vertices(vcap);
+        threading::parallel_for(
+            threading::range(0, v_cnt, 1024),
+            [&](const threading::range& r) {
+                for (size_t k = r.begin(); k < r.end(); ++k) {
+                    vertices[k] = std::move(m_vertex_connectivity[v_order[k]]);
+                    auto& star = vertices[k].m_conn_tris;
+                    for (index_t& t_id : star) t_id = map_t_ids[t_id];
+                    if (reorder) std::sort(star.begin(), star.end());
+                }
+            },
+            NUM_THREADS);
+        m_vertex_connectivity.swap(vertices);
+    }
+    {
+        vector<TriangleConnectivity> tris(tcap);
+        threading::parallel_for(
+            threading::range(0, t_cnt, 1024),
+            [&](const threading::range& r) {
+                for (size_t k = r.begin(); k < r.end(); ++k) {
+                    tris[k] = m_tri_connectivity[t_order[k]];
+                    tris[k].hash = 0;
+                    for (index_t& v_id : tris[k].m_indices) v_id = map_v_ids[v_id];
+                }
+            },
+            NUM_THREADS);
+        m_tri_connectivity.swap(tris);
     }
 
     current_vert_size = v_cnt;
     current_tri_size = t_cnt;
 
-    // Re-establish spare capacity for the next round of operations.
-    const size_t vcap = reserved_capacity(v_cnt);
-    const size_t tcap = reserved_capacity(t_cnt);
-
-    m_vertex_connectivity.resize(vcap);
-    m_vertex_connectivity.shrink_to_fit();
-    m_tri_connectivity.resize(tcap);
-    m_tri_connectivity.shrink_to_fit();
-
     resize_mutex(vcap);
 
-    // Resize user class attributes to the preallocated capacity
-    if (p_vertex_attrs) p_vertex_attrs->resize(vcap);
-    if (p_edge_attrs) p_edge_attrs->resize(tcap * 3);
-    if (p_face_attrs) p_face_attrs->resize(tcap);
+    // Gather user class attributes into the preallocated capacity
+    if (p_vertex_attrs) p_vertex_attrs->gather(v_order, 1, vcap, NUM_THREADS);
+    if (p_edge_attrs) p_edge_attrs->gather(t_order, 3, tcap, NUM_THREADS);
+    if (p_face_attrs) p_face_attrs->gather(t_order, 1, tcap, NUM_THREADS);
 
     // assert(check_edge_manifold());
     assert(check_mesh_connectivity_validity());
@@ -1885,7 +1907,7 @@ std::vector<size_t> TriMesh::get_incident_fids_for_edge(const size_t vid0, const
 {
     const auto& v0 = get_one_ring_fids_for_vertex(vid0);
     const auto& v1 = get_one_ring_fids_for_vertex(vid1);
-    return set_intersection(v0, v1);
+    return vector_cast<size_t>(set_intersection(v0, v1));
 }
 
 std::vector<TriMesh::Tuple> TriMesh::get_one_ring_tris_for_vertex(const TriMesh::Tuple& t) const
@@ -1903,12 +1925,12 @@ std::vector<TriMesh::Tuple> TriMesh::get_one_ring_tris_for_vertex(const TriMesh:
     return one_ring;
 }
 
-const std::vector<size_t>& TriMesh::get_one_ring_fids_for_vertex(const Tuple& t) const
+const TriMesh::StarVector& TriMesh::get_one_ring_fids_for_vertex(const Tuple& t) const
 {
     return get_one_ring_fids_for_vertex(t.vid(*this));
 }
 
-const std::vector<size_t>& TriMesh::get_one_ring_fids_for_vertex(const size_t vid) const
+const TriMesh::StarVector& TriMesh::get_one_ring_fids_for_vertex(const size_t vid) const
 {
     return m_vertex_connectivity[vid].m_conn_tris;
 }
@@ -2044,7 +2066,7 @@ std::tuple<TriMesh::Tuple, size_t> TriMesh::tuple_from_edge(const std::array<siz
 std::optional<std::tuple<TriMesh::Tuple, size_t>> TriMesh::try_tuple_from_edge(
     const std::array<size_t, 2>& vids) const
 {
-    const std::vector<size_t>& fids = m_vertex_connectivity[vids[0]].m_conn_tris;
+    const StarVector& fids = m_vertex_connectivity[vids[0]].m_conn_tris;
 
     // find face that contains both vertices
     size_t local_eid = std::numeric_limits<size_t>::max();
@@ -2093,7 +2115,7 @@ void TriMesh::init(size_t n_vertices, const std::vector<std::array<size_t, 3>>&
     m_tri_connectivity.resize(tcap);
     size_t hash_cnt = 0;
     for (int i = 0; i < tris.size(); i++) {
-        m_tri_connectivity[i].m_indices = tris[i];
+        m_tri_connectivity[i].m_indices = array_cast<index_t>(tris[i]);
 
         m_tri_connectivity[i].hash = hash_cnt;
         for (int j = 0; j < 3; j++) {
@@ -2136,11 +2158,11 @@ std::vector<TriMesh::Tuple> TriMesh::get_vertices() const
     for (size_t i = 0; i < n_vertices; i++) {
         if (m_vertex_connectivity[i].m_is_removed) continue;
 
-        const std::vector<size_t>& v_conn_fids = m_vertex_connectivity[i].m_conn_tris;
-        size_t fid = *min_element(v_conn_fids.begin(), v_conn_fids.end());
+        const StarVector& v_conn_fids = m_vertex_connectivity[i].m_conn_tris;
+        size_t fid = *std::min_element(v_conn_fids.begin(), v_conn_fids.end());
 
         // get the 3 vid
-        const std::array<size_t, 3>& f_conn_verts = m_tri_connectivity[fid].m_indices;
+        const auto& f_conn_verts = m_tri_connectivity[fid].m_indices;
         assert(i == f_conn_verts[0] || i == f_conn_verts[1] || i == f_conn_verts[2]);
 
         // The local edge opposite the vertex's own local index, i.e. (lvid + 2) % 3. The
@@ -2171,7 +2193,7 @@ std::vector<TriMesh::Tuple> TriMesh::get_faces() const
     for (size_t i = 0; i < tri_capacity(); i++) {
         if (m_tri_connectivity[i].m_is_removed) continue;
         // get the 3 vid
-        const std::array<size_t, 3>& f_conn_verts = m_tri_connectivity[i].m_indices;
+        const auto& f_conn_verts = m_tri_connectivity[i].m_indices;
         size_t vid = f_conn_verts[0];
         Tuple f_tuple = Tuple(vid, 2, i, *this);
         assert(f_tuple.is_valid(*this));
@@ -2220,14 +2242,14 @@ TriMesh::Tuple wmtk::TriMesh::tuple_from_vids(size_t vid0, size_t vid1, size_t v
     // pairwise intersection into a heap vector and then intersected that with the third
     // fan, allocating twice to find a single face; the fans are sorted, so a membership
     // test against the other two is enough.
-    const std::vector<size_t>* fans[3] = {&vf0.m_conn_tris, &vf1.m_conn_tris, &vf2.m_conn_tris};
-    const std::vector<size_t>* smallest = fans[0];
+    const StarVector* fans[3] = {&vf0.m_conn_tris, &vf1.m_conn_tris, &vf2.m_conn_tris};
+    const StarVector* smallest = fans[0];
     for (int i = 1; i < 3; ++i) {
         if (fans[i]->size() < smallest->size()) {
             smallest = fans[i];
         }
     }
-    const auto in_fan = [](const std::vector<size_t>& fan, const size_t f) {
+    const auto in_fan = [](const StarVector& fan, const size_t f) {
         return std::binary_search(fan.begin(), fan.end(), f);
     };
 
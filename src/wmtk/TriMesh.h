@@ -8,6 +8,7 @@
 #include <wmtk/threading/enumerable_thread_specific.hpp>
 #include <wmtk/threading/vertex_mutex.hpp>
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/SmallVector.hpp>
 
 #include <algorithm>
 #include <array>
@@ -30,9 +31,10 @@ public:
     class Tuple
     {
     private:
-        size_t m_vid = -1;
-        size_t m_eid = -1;
-        size_t m_fid = -1;
+        // See index_t: 32-bit vertex and face ids with WMTK_COMPACT_INDICES.
+        index_t m_vid = -1;
+        std::uint8_t m_eid = -1;
+        index_t m_fid = -1;
         size_t m_hash = -1;
 
         void update_hash(const TriMesh& m);
@@ -194,6 +196,12 @@ public:
         }
     };
 
+    /**
+     * The triangles around a vertex, sorted. Most vertices of a triangle mesh have six, so up
+     * to eight are stored inline in the vertex record; see SmallVector.
+     */
+    using StarVector = SmallVector<index_t, 8>;
+
     /**
      * (internal use) Maintains a list of triangles connected to the given vertex, and a flag to
      * mark removal.
@@ -206,14 +214,14 @@ public:
          * @brief incident triangles of a given vertex
          *
          */
-        std::vector<size_t> m_conn_tris;
+        StarVector m_conn_tris;
         /**
          * @brief is the vertex removed
          *
          */
         bool m_is_removed = false;
 
-        inline size_t& operator[](const size_t index)
+        inline index_t& operator[](const size_t index)
         {
             assert(index < m_conn_tris.size());
             return m_conn_tris[index];
@@ -237,7 +245,7 @@ public:
          * @brief incident vertices of a given triangle
          *
          */
-        std::array<size_t, 3> m_indices;
+        std::array<index_t, 3> m_indices;
         /**
          * @brief is the triangle removed
          *
@@ -250,7 +258,7 @@ public:
          */
         size_t hash = 0;
 
-        inline size_t& operator[](size_t index)
+        inline index_t& operator[](size_t index)
         {
             assert(index < 3);
             return m_indices[index];
@@ -539,6 +547,12 @@ public:
      * @param bnd_output when turn on will write the boundary vertices to "bdn_table.dmat"
      */
     void consolidate_mesh();
+    /**
+     * @brief consolidate_mesh, additionally renumbering the vertices in increasing order of
+     * `vertex_keys` (indexed by current vertex id) and the triangles after their lowest new
+     * vertex id. See TetMesh::consolidate_mesh(const std::vector<uint64_t>&).
+     */
+    void consolidate_mesh(const std::vector<uint64_t>& vertex_keys);
 
     /**
      * @brief Mark the given triangles, and any vertex left without an incident triangle,
@@ -828,8 +842,8 @@ public:
      * @return a vector of Tuples refering to one-ring tris
      */
     std::vector<Tuple> get_one_ring_tris_for_vertex(const Tuple& t) const;
-    const std::vector<size_t>& get_one_ring_fids_for_vertex(const Tuple& t) const;
-    const std::vector<size_t>& get_one_ring_fids_for_vertex(const size_t vid) const;
+    const StarVector& get_one_ring_fids_for_vertex(const Tuple& t) const;
+    const StarVector& get_one_ring_fids_for_vertex(const size_t vid) const;
     /**
      * @brief Get the vids of the incident one ring tris for a vertex
      *
@@ -1,6 +1,6 @@
 #include <wmtk/TriOptimizerMesh.h>
 
-#include <wmtk/utils/AMIPS2D.h>
+#include <wmtk/utils/AMIPSBatch.h>
 #include <wmtk/utils/PartitionMesh.h>
 #include <wmtk/utils/VectorUtils.h>
 #include <wmtk/utils/ExecutorUtils.hpp>
@@ -10,6 +10,7 @@
 #include <wmtk/utils/RunPass.hpp>
 #include <wmtk/utils/SizingField.hpp>
 #include <wmtk/utils/TupleUtils.hpp>
+#include <wmtk/utils/orient.hpp>
 #include <wmtk/utils/partition_utils.hpp>
 
 #include <igl/Timer.h>
@@ -53,6 +54,7 @@ void TriOptimizerMesh::mesh_improvement(int max_its)
     for (int it = 0; it < max_its; ++it) {
         m_iterations_used = it + 1;
         logger().info("\n========it {}========", it);
+        utils::reset_orient_filter_stats();
 
         double max_metric = 0.;
         double avg_metric = 0.;
@@ -82,7 +84,13 @@ void TriOptimizerMesh::mesh_improvement(int max_its)
         const int cnt_round = n_round.load(std::memory_order_relaxed);
         const int cnt_verts = n_verts.load(std::memory_order_relaxed);
         if (cnt_round < cnt_verts) {
-            logger().info("rounded {}/{}", cnt_round, cnt_verts);
+            const utils::OrientFilterStats filter = utils::orient_filter_stats();
+            logger().info(
+                "rounded {}/{} | exact orientation checks: {} decided by the filter, {} by GMP",
+                cnt_round,
+                cnt_verts,
+                filter.hits,
+                filter.misses);
         } else {
             logger().info("All rounded!");
         }
@@ -95,7 +103,17 @@ void TriOptimizerMesh::mesh_improvement(int max_its)
                 cnt_verts);
         }
 
-        consolidate_mesh();
+        if (m_params.spatial_reorder) {
+            consolidate_mesh(wmtk::morton_codes(
+                vert_capacity(),
+                [this](size_t i) {
+                    const Vector2d& p = m_vertex_attribute[i].m_posf;
+                    return Eigen::Vector3d(p[0], p[1], 0);
+                },
+                NUM_THREADS));
+        } else {
+            consolidate_mesh();
+        }
         logger().info("#V = {}, #F = {}", vert_capacity(), tri_capacity());
 
         if (optimization_stop_at_float() && round_and_check_all_rounded()) {
@@ -217,7 +235,7 @@ auto renew_swap_neighbors = [](const TriOptimizerMesh& m, auto op, auto& tris) {
     }
     unique_edge_tuples(m, edges);
 
-    std::vector<std::pair<std::string, Tuple>> optup;
+    std::vector<std::pair<decltype(op), Tuple>> optup;
     optup.reserve(edges.size());
     for (const Tuple& e : edges) {
         optup.emplace_back(op, e);
@@ -240,12 +258,12 @@ size_t TriOptimizerMesh::swap_all_edges()
 
     size_t total_success = 0;
     run_pass(*this, PassLock::EdgeRing, "", [&](auto& executor, auto& mesh) {
-        executor.renew_neighbor_tuples = renew_swap_neighbors;
-        executor.priority = [](const TriOptimizerMesh& m, std::string, const Tuple& e) {
+        executor.renew_neighbor_tuples_by_handle = renew_swap_neighbors;
+        executor.priority_by_handle = [](const TriOptimizerMesh& m, OpHandle, const Tuple& e) {
             return m.swap_weight(e);
         };
         executor.should_renew = [](auto val) { return val > 0; };
-        executor.is_weight_up_to_date = [](const TriOptimizerMesh& m, auto& ele) {
+        executor.is_weight_up_to_date_by_handle = [](const TriOptimizerMesh& m, auto& ele) {
             auto& [val, _, e] = ele;
             const double w = m.swap_weight(e);
             return (w > 1e-5) && ((w - val) * (w - val) < 1e-8);
@@ -424,6 +442,38 @@ bool TriOptimizerMesh::is_inverted_f(const size_t fid) const
     return true;
 }
 
+Vector2r TriOptimizerMesh::vertex_exact_pos(const size_t vid) const
+{
+    const VertexAttributes& va = m_vertex_attribute.at(vid);
+    if (!va.m_is_rounded) {
+        if (const std::optional<Vector2r> p = m_exact_pos.find(vid)) return *p;
+    }
+    return to_rational(va.m_posf);
+}
+
+void TriOptimizerMesh::set_vertex_exact_pos(const size_t vid, const Vector2r& p)
+{
+    VertexAttributes& va = m_vertex_attribute[vid];
+    va.m_posf = to_double(p);
+    va.m_is_rounded = to_rational(va.m_posf) == p;
+    if (va.m_is_rounded) {
+        m_exact_pos.erase(vid);
+    } else {
+        m_exact_pos.set(vid, p);
+        m_all_rounded.store(false, std::memory_order_relaxed);
+    }
+}
+
+void TriOptimizerMesh::set_vertex_pos(const size_t vid, const Vector2d& p)
+{
+    // Called in line searches, once per candidate, so the table is only touched when the
+    // vertex may have an entry.
+    VertexAttributes& va = m_vertex_attribute[vid];
+    if (!va.m_is_rounded) m_exact_pos.erase(vid);
+    va.m_posf = p;
+    va.m_is_rounded = true;
+}
+
 bool TriOptimizerMesh::is_inverted(const std::array<size_t, 3>& vs) const
 {
     if (m_vertex_attribute[vs[0]].m_is_rounded && m_vertex_attribute[vs[1]].m_is_rounded &&
@@ -438,17 +488,18 @@ bool TriOptimizerMesh::is_inverted(const std::array<size_t, 3>& vs) const
         }
         return true;
     } else {
-        const Vector2r& v0 = m_vertex_attribute[vs[0]].m_pos;
-        const Vector2r& v1 = m_vertex_attribute[vs[1]].m_pos;
-        const Vector2r& v2 = m_vertex_attribute[vs[2]].m_pos;
-        const Vector2r a = v1 - v0;
-        const Vector2r b = v2 - v0;
-        Rational res = a.x() * b.y() - a.y() * b.x();
-        if (res > 0) {
-            return false;
-        } else {
-            return true;
-        }
+        // m_posf is to_double of the exact position, within an ulp of it, so the interval
+        // filter decides most of these without building a single Rational.
+        const int s = wmtk::utils::orient2d_interval_sign(
+            m_vertex_attribute[vs[0]].m_posf,
+            m_vertex_attribute[vs[1]].m_posf,
+            m_vertex_attribute[vs[2]].m_posf);
+        wmtk::utils::count_orient_filter(s != 0);
+        if (s != 0) return s < 0;
+        return !wmtk::utils::orient2d_exact(
+            vertex_exact_pos(vs[0]),
+            vertex_exact_pos(vs[1]),
+            vertex_exact_pos(vs[2]));
     }
 }
 
@@ -482,8 +533,6 @@ bool TriOptimizerMesh::round(const Tuple& v)
         return true;
     }
 
-    auto old_pos = m_vertex_attribute[i].m_pos;
-    m_vertex_attribute[i].m_pos << m_vertex_attribute[i].m_posf[0], m_vertex_attribute[i].m_posf[1];
     auto conn_tets = get_one_ring_tris_for_vertex(v);
     // Set before the loop so is_inverted takes the float path: the question being asked is
     // exactly whether the ROUNDED position keeps every incident face valid.
@@ -491,33 +540,54 @@ bool TriOptimizerMesh::round(const Tuple& v)
     for (const Tuple& tet : conn_tets) {
         if (is_inverted(tet)) {
             m_vertex_attribute[i].m_is_rounded = false;
-            m_vertex_attribute[i].m_pos = old_pos;
             return false;
         }
     }
+    m_exact_pos.erase(i);
 
     return true;
 }
 
 double TriOptimizerMesh::get_quality(const std::array<size_t, 3>& vs) const
 {
-    std::array<Vector2d, 3> ps;
-    for (size_t k = 0; k < 3; k++) {
-        ps[k] = m_vertex_attribute[vs[k]].m_posf;
-    }
-    double energy = -1.;
-    {
-        std::array<double, 6> T;
-        for (size_t k = 0; k < 3; k++)
-            for (size_t j = 0; j < 2; j++) {
-                T[k * 2 + j] = ps[k][j];
+    // A batch of one, so that a face scores the same here as in get_qualities.
+    double q;
+    get_qualities_impl(&vs, 1, &q);
+    return q;
+}
+
+void TriOptimizerMesh::get_qualities(
+    const std::vector<std::array<size_t, 3>>& faces,
+    std::vector<double>& qualities) const
+{
+    qualities.resize(faces.size());
+    get_qualities_impl(faces.data(), faces.size(), qualities.data());
+}
+
+void TriOptimizerMesh::get_qualities_impl(
+    const std::array<size_t, 3>* faces,
+    const size_t n,
+    double* qualities) const
+{
+    constexpr size_t kChunk = 64; // keeps the gathered coordinates on the stack
+    std::array<std::array<double, 6>, kChunk> T;
+    for (size_t begin = 0; begin < n; begin += kChunk) {
+        const size_t m = std::min(kChunk, n - begin);
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t k = 0; k < 3; k++) {
+                const Vector2d& p = m_vertex_attribute[faces[begin + i][k]].m_posf;
+                T[i][k * 2] = p[0];
+                T[i][k * 2 + 1] = p[1];
             }
-        energy = AMIPS2D_energy(T);
+        }
+        AMIPS2D_energies(T.data(), m, qualities + begin);
     }
-    if (std::isinf(energy) || std::isnan(energy) || energy < 2 - 1e-3) {
-        return MAX_ENERGY;
+    for (size_t i = 0; i < n; ++i) {
+        const double energy = qualities[i];
+        if (std::isinf(energy) || std::isnan(energy) || energy < 2 - 1e-3) {
+            qualities[i] = MAX_ENERGY;
+        }
     }
-    return energy;
 }
 
 double TriOptimizerMesh::get_quality(const Tuple& loc) const
@@ -40,11 +40,10 @@ public:
     struct VertexAttributes
     {
         Vector2d m_posf; // position as double
-        Vector2r m_pos; // exact position in rational
         /**
          * If a vertex cannot be rounded without inverting an incident face, the exact position
-         * must be used. Once the vertex can be rounded to double precision, the rational
-         * representation is obsolete.
+         * must be used; it is kept in m_exact_pos, see vertex_exact_pos(). Once the vertex can
+         * be rounded to double precision, m_posf is exact and the rational one is dropped.
          */
         bool m_is_rounded = false;
 
@@ -58,13 +57,8 @@ public:
         VertexAttributes() {}
         VertexAttributes(const Vector2d& p)
             : m_posf(p)
-            , m_pos(to_rational(p))
             , m_is_rounded(true)
         {}
-        VertexAttributes(const Vector2r& p)
-            : m_posf(to_double(p))
-            , m_pos(p)
-        {}
     };
 
     using EdgeAttributes = wmtk::SurfaceTagAttributes;
@@ -94,6 +88,15 @@ public:
      */
     AttributeContainerGroup m_vertex_attr_group;
 
+    /**
+     * @brief The exact positions of the vertices that are not rounded, by vid.
+     *
+     * The 2D counterpart of wmtk::TetOptimizerMesh::m_exact_pos: only un-rounded vertices have
+     * an entry, it is registered in m_vertex_attr_group, and vertex_exact_pos() and
+     * set_vertex_exact_pos() keep it in step with m_is_rounded.
+     */
+    SparseAttributeCollection<Vector2r> m_exact_pos;
+
     /**
      * @brief What p_edge_attrs points at, so a derived class can register more.
      *
@@ -159,6 +162,7 @@ public:
         : m_params(params)
     {
         m_vertex_attr_group.add(&m_vertex_attribute);
+        m_vertex_attr_group.add(&m_exact_pos);
         p_vertex_attrs = &m_vertex_attr_group;
         m_edge_attr_group.add(&m_edge_attribute);
         p_edge_attrs = &m_edge_attr_group;
@@ -183,6 +187,19 @@ public:
 
     double get_length2(const Tuple& l) const;
 
+    /// The exact position of a vertex: its m_exact_pos entry if it is not rounded, m_posf if
+    /// it is -- or if it was left un-rounded without an entry, e.g. by a freshly sized mesh.
+    Vector2r vertex_exact_pos(const size_t vid) const;
+    /**
+     * @brief Move a vertex to an exact position.
+     *
+     * m_posf becomes the nearest double. If that is `p` itself the vertex is rounded and has
+     * no m_exact_pos entry; otherwise `p` is stored there and m_all_rounded is cleared.
+     */
+    void set_vertex_exact_pos(const size_t vid, const Vector2r& p);
+    /// Move a vertex to a double position, which makes it rounded.
+    void set_vertex_pos(const size_t vid, const Vector2d& p);
+
     /**
      * @brief Orientation check, exact for the coordinates the vertices actually carry.
      *
@@ -201,6 +218,11 @@ public:
     double get_quality(const std::array<size_t, 3>& vs) const;
     double get_quality(const Tuple& loc) const;
     double get_quality(const size_t fid) const;
+    /// get_quality of each of `faces`, into `qualities` (resized to match), scored as one
+    /// batch through AMIPS2D_energies. Same values as calling get_quality per face.
+    void get_qualities(
+        const std::vector<std::array<size_t, 3>>& faces,
+        std::vector<double>& qualities) const;
 
     std::tuple<double, double> get_max_avg_energy();
 
@@ -459,6 +481,9 @@ protected:
     bool m_coarsen_mode = false;
 
 private:
+    void get_qualities_impl(const std::array<size_t, 3>* faces, size_t n, double* qualities)
+        const;
+
     struct SwapInfoCache
     {
         double max_energy;
@@ -499,6 +524,19 @@ private:
     /// One smoothing attempt on @p vid, restoring everything it wrote if it is rejected.
     bool smooth_vertex_reversible(size_t vid, CoarsenScratch& scr);
 
+    /**
+     * @brief One iteration of the "colored" smoothing engine (OptimizerParameters::
+     * smoothing_engine): each class of @p classes smoothed in parallel, one class after another.
+     *
+     * @p classes must come from utils::color_vertices over one-rings, so that classmates share
+     * no face. @p active, when non-empty, restricts the pass to the vertices it flags.
+     *
+     * @return the number of vertices moved.
+     */
+    size_t smooth_color_classes(
+        const std::vector<std::vector<size_t>>& classes,
+        const std::vector<char>& active);
+
     size_t collapse_all_edges_impl(bool is_limit_length, int lock_ring, size_t max_passes = 0);
 };
 
@@ -15,6 +15,73 @@
 
 namespace wmtk {
 
+namespace {
+
+/// The collapse pass's hooks as a type, so that the scheduler calls them directly rather than
+/// through ExecutePass's std::function members. Edges are queued in both directions, shortest
+/// first.
+struct CollapseTraits
+{
+    using Tuple = TriMesh::Tuple;
+
+    double priority(const TriOptimizerMesh& m, OpHandle, const Tuple& t) const
+    {
+        return -m.get_length2(t);
+    }
+    template <class Emit>
+    void renew_neighbor_tuples(
+        const TriOptimizerMesh& m,
+        OpHandle op,
+        const std::vector<Tuple>& newts,
+        Emit&& emit) const
+    {
+        for (const Tuple& t : newts) {
+            emit(op, t);
+            emit(op, t.switch_vertex(m));
+        }
+    }
+    /// The new triangles share their spokes, so each directed spoke comes out twice above. A
+    /// collapse is of a DIRECTED edge -- the two directions keep different vertices -- so the
+    /// key keeps the order.
+    uint64_t renew_key(const TriOptimizerMesh& m, OpHandle, const Tuple& t) const
+    {
+        return (uint64_t(t.vid(m)) << 32) | t.switch_vertex(m).vid(m);
+    }
+    bool is_weight_up_to_date(
+        const TriOptimizerMesh& m,
+        const std::tuple<double, OpHandle, Tuple>& ele) const
+    {
+        const auto& VA = m.m_vertex_attribute;
+        auto& [weight, op, tup] = ele;
+        const double length = m.get_length2(tup);
+        if (length != -weight) {
+            return false;
+        }
+        // Length gate, applied to the CANDIDATE LIST -- TriWild's placement. An edge at or
+        // above the collapse target is not offered to this pass at all.
+        if (m.m_collapse_limit_length) {
+            const size_t v1_id = tup.vid(m);
+            const size_t v2_id = tup.switch_vertex(m).vid(m);
+            const double sizing_ratio =
+                (VA[v1_id].m_sizing_scalar + VA[v2_id].m_sizing_scalar) / 2;
+            if (length > m.m_params.collapsing_l2 * sizing_ratio * sizing_ratio) {
+                return false;
+            }
+        }
+        return true;
+    }
+    std::optional<std::vector<Tuple>> apply(TriOptimizerMesh& m, OpHandle, const Tuple& t) const
+    {
+        std::vector<Tuple> ret;
+        if (m.collapse_edge(t, ret)) {
+            return ret;
+        }
+        return {};
+    }
+};
+
+} // namespace
+
 void TriOptimizerMesh::collapse_all_edges(bool is_limit_length)
 {
     collapse_all_edges_impl(is_limit_length, wmtk::default_ring(wmtk::PassLock::EdgeRing));
@@ -47,47 +114,14 @@ TriOptimizerMesh::collapse_all_edges_impl(bool is_limit_length, int lock_ring, s
         lock_ring,
         "edge collapse",
         [&](auto& executor, auto& mesh) {
-            executor.renew_neighbor_tuples =
-                [](const wmtk::TriOptimizerMesh& m, Op op, const auto& newts) {
-                    std::vector<std::pair<std::string, TriMesh::Tuple>> op_tups;
-                    op_tups.reserve(2 * newts.size());
-                    for (const Tuple& t : newts) {
-                        op_tups.emplace_back(op, t);
-                        op_tups.emplace_back(op, t.switch_vertex(m));
-                    }
-                    return op_tups;
-                };
-            executor.priority = [](const wmtk::TriOptimizerMesh& m, Op op, const Tuple& t) {
-                return -m.get_length2(t);
-            };
-            executor.is_weight_up_to_date = [&](const wmtk::TriOptimizerMesh& m,
-                                                const std::tuple<double, Op, Tuple>& ele) {
-                const auto& VA = m_vertex_attribute;
-                auto& [weight, op, tup] = ele;
-                const double length = m.get_length2(tup);
-                if (length != -weight) {
-                    return false;
-                }
-                // Length gate, applied to the CANDIDATE LIST -- TriWild's placement. An edge
-                // at or above the collapse target is not offered to this pass at all.
-                if (m_collapse_limit_length) {
-                    const size_t v1_id = tup.vid(m);
-                    const size_t v2_id = tup.switch_vertex(m).vid(m);
-                    const double sizing_ratio =
-                        (VA[v1_id].m_sizing_scalar + VA[v2_id].m_sizing_scalar) / 2;
-                    if (length > m_params.collapsing_l2 * sizing_ratio * sizing_ratio) {
-                        return false;
-                    }
-                }
-                return true;
-            };
-
+            wmtk::use_approximate_queue(executor, mesh);
+            CollapseTraits traits;
             // Retry a failed collapse only where the mesh actually changed this round
             // (dirty-epoch localized retry). This replaces the loop that rebuilt the whole op
             // list from get_edges() after every pass and re-ran the expensive geometric
             // pre-checks on every failure, even where nothing could have changed.
             const size_t total_success =
-                wmtk::run_localized_to_convergence(mesh, executor, all_ops, max_passes);
+                wmtk::run_localized_to_convergence(mesh, executor, traits, all_ops, max_passes);
             logger().info("collapse success: {}", total_success);
             collapse_pass_end(total_success);
             accepted = total_success;
@@ -182,8 +216,9 @@ bool TriOptimizerMesh::collapse_edge_before(const Tuple& loc) // input is an edg
         }
     }
 
-    // pre-compute after-collapse energies
-    cache.changed_energies.reserve(cache.changed_fids.size());
+    // pre-compute after-collapse energies, all changed faces in one batch
+    std::vector<std::array<size_t, 3>> changed_vs;
+    changed_vs.reserve(cache.changed_fids.size());
     for (const size_t tid : cache.changed_fids) {
         std::array<size_t, 3> vs = oriented_tri_vids(tid);
         for (size_t i = 0; i < 3; ++i) {
@@ -196,15 +231,20 @@ bool TriOptimizerMesh::collapse_edge_before(const Tuple& loc) // input is an edg
         if (is_inverted(vs)) {
             return false;
         }
-        double q = get_quality(vs);
-        // The coarsening pass deliberately skips the quality gate and decides on the region
-        // AFTER re-smoothing instead -- that is the whole point of it. The inversion check
-        // above still applies: an inverted face is not something smoothing can repair, since
-        // smooth_vertex_2d refuses to start from one.
-        if (!m_coarsen_mode && !collapse_quality_allowed(v1_id, tid, q, cache.max_energy)) {
-            return false;
+        changed_vs.push_back(vs);
+    }
+    get_qualities(changed_vs, cache.changed_energies);
+    // The coarsening pass deliberately skips the quality gate and decides on the region
+    // AFTER re-smoothing instead -- that is the whole point of it. The inversion check
+    // above still applies: an inverted face is not something smoothing can repair, since
+    // smooth_vertex_2d refuses to start from one.
+    if (!m_coarsen_mode) {
+        for (size_t i = 0; i < cache.changed_fids.size(); ++i) {
+            const double q = cache.changed_energies[i];
+            if (!collapse_quality_allowed(v1_id, cache.changed_fids[i], q, cache.max_energy)) {
+                return false;
+            }
         }
-        cache.changed_energies.emplace_back(q);
     }
     assert(cache.changed_energies.size() == cache.changed_fids.size());
 
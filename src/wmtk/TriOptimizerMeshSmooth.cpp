@@ -1,12 +1,16 @@
 #include <wmtk/TriOptimizerMesh.h>
 
+#include <wmtk/threading/parallel_for.hpp>
 #include <wmtk/utils/Logger.hpp>
 #include <wmtk/utils/RunPass.hpp>
 #include <wmtk/utils/SizingField.hpp>
+#include <wmtk/utils/VertexColoring.hpp>
 
 #include <igl/Timer.h>
 #include <spdlog/fmt/bundled/format.h>
 
+#include <atomic>
+
 namespace wmtk {
 
 bool TriOptimizerMesh::smooth_before(const Tuple& t)
@@ -40,6 +44,9 @@ bool TriOptimizerMesh::smooth_after(const Tuple& t)
     opts.smoothing_mode = m_params.smoothing_mode == "exact"
                               ? optimization::SmoothVertexOptions::SmoothingMode::Exact
                               : optimization::SmoothVertexOptions::SmoothingMode::Projected;
+    opts.solver = m_params.smoothing_solver == "newton"
+                      ? optimization::SmoothVertexOptions::Solver::FixedNewton
+                      : optimization::SmoothVertexOptions::Solver::Polysolve;
     opts.project_line_search_steps = m_params.project_line_search_steps;
     opts.project_line_search_nested_steps = m_params.project_line_search_nested_steps;
 
@@ -55,34 +62,77 @@ Vector2d TriOptimizerMesh::smoothing_position(const size_t vid) const
 
 void TriOptimizerMesh::set_smoothing_position(const size_t vid, const Vector2d& p)
 {
+    // smooth_before only admits rounded vertices, so there is no exact position to update.
     m_vertex_attribute[vid].m_posf = p;
-    m_vertex_attribute[vid].m_pos = to_rational(p);
 }
 
 void TriOptimizerMesh::smooth_all_vertices(const size_t n_iters)
 {
+    const std::string& engine = m_params.smoothing_engine;
+    if (engine != "pass" && engine != "colored") {
+        log_and_throw_error("Unknown smoothing_engine '{}'; expected 'pass' or 'colored'", engine);
+    }
+    const bool colored = engine == "colored";
+
+    // Smoothing changes no connectivity, so one coloring serves every iteration below.
+    std::vector<std::vector<size_t>> classes;
+    if (colored) {
+        igl::Timer timer;
+        timer.start();
+        classes = utils::color_vertices(
+            vert_capacity(),
+            all_vertex_ids(),
+            [this](const size_t v, std::vector<size_t>& out) {
+                get_one_ring_vids_for_vertex_duplicate(v, out);
+            },
+            NUM_THREADS);
+        logger().info(
+            "vertex coloring: {} colors, time {:.4}s",
+            classes.size(),
+            timer.getElapsedTimeInSec());
+    }
+
     for (size_t i = 0; i < n_iters; ++i) {
         logger().info("==smoothing {}==", i);
         igl::Timer timer;
         timer.start();
         m_smooth_rejects.reset();
 
-        std::vector<std::pair<std::string, Tuple>> collect_all_ops;
-        if (m_params.skip_good_regions) {
-            for (const size_t vid : active_vertices()) {
-                collect_all_ops.emplace_back("vertex_smooth", tuple_from_vertex(vid));
+        if (colored) {
+            std::vector<char> active;
+            if (m_params.skip_good_regions) {
+                active.assign(vert_capacity(), 0);
+                for (const size_t vid : active_vertices()) {
+                    active[vid] = 1;
+                }
             }
+            logger().info("vertex smoothing prepare time: {:.4}s", timer.getElapsedTimeInSec());
+            timer.start();
+            const size_t moved = smooth_color_classes(classes, active);
+            logger().info(
+                "vertex smoothing time colored: {:.4}s, {} vertices moved",
+                timer.getElapsedTimeInSec(),
+                moved);
         } else {
-            for (const Tuple& t : get_vertices()) {
-                collect_all_ops.emplace_back("vertex_smooth", t);
+            std::vector<std::pair<std::string, Tuple>> collect_all_ops;
+            if (m_params.skip_good_regions) {
+                for (const size_t vid : active_vertices()) {
+                    collect_all_ops.emplace_back("vertex_smooth", tuple_from_vertex(vid));
+                }
+            } else {
+                for (const Tuple& t : get_vertices()) {
+                    collect_all_ops.emplace_back("vertex_smooth", t);
+                }
             }
-        }
 
-        logger().info("vertex smoothing prepare time: {:.4}s", timer.getElapsedTimeInSec());
-        logger().info("#V = {}", collect_all_ops.size());
-        run_pass(*this, PassLock::VertexRing, "vertex smoothing", [&](auto& executor, auto& mesh) {
-            executor(mesh, collect_all_ops);
-        });
+            logger().info("vertex smoothing prepare time: {:.4}s", timer.getElapsedTimeInSec());
+            logger().info("#V = {}", collect_all_ops.size());
+            run_pass(
+                *this,
+                PassLock::VertexRing,
+                "vertex smoothing",
+                [&](auto& executor, auto& mesh) { executor(mesh, collect_all_ops); });
+        }
         logger().info("\tsmooth: {}", m_smooth_rejects.to_string());
 
         if (m_params.debug_output) {
@@ -91,6 +141,61 @@ void TriOptimizerMesh::smooth_all_vertices(const size_t n_iters)
     }
 }
 
+size_t TriOptimizerMesh::smooth_color_classes(
+    const std::vector<std::vector<size_t>>& classes,
+    const std::vector<char>& active)
+{
+    // What the executor's vertex_smooth does, minus the lock and the undo log. A vertex's
+    // smooth writes its own attributes and the quality of its incident faces, and reads only
+    // its one-ring; classmates share no face, so within a class all of that is private to one
+    // thread and the neighbours it reads hold still. A smooth that smooth_after or invariants
+    // rejects is undone from a copy of exactly what it wrote, taken after smooth_before as
+    // TriMesh::smooth_vertex takes its protected region: a successful rounding is kept either
+    // way.
+    const auto smooth_one = [this](const size_t vid, CoarsenScratch& scr) {
+        const Tuple t = tuple_from_vertex(vid);
+        if (!smooth_before(t)) {
+            return false;
+        }
+        scr.saved_vertex = m_vertex_attribute.at(vid);
+        scr.saved_qualities.clear();
+        for (const size_t fid : get_one_ring_fids_for_vertex(vid)) {
+            scr.saved_qualities.emplace_back(fid, m_face_attribute.at(fid).m_quality);
+        }
+        if (smooth_after(t) && invariants(get_one_ring_tris_for_vertex(t))) {
+            return true;
+        }
+        m_vertex_attribute[vid] = scr.saved_vertex;
+        for (const auto& [fid, quality] : scr.saved_qualities) {
+            m_face_attribute[fid].m_quality = quality;
+        }
+        return false;
+    };
+
+    std::atomic<size_t> moved(0);
+    std::vector<size_t> batch;
+    for (const std::vector<size_t>& cls : classes) {
+        batch.clear();
+        for (const size_t v : cls) {
+            if ((active.empty() || active[v]) && tuple_from_vertex(v).is_valid(*this)) {
+                batch.push_back(v);
+            }
+        }
+        threading::parallel_for(
+            threading::range(0, batch.size(), 64),
+            [&](const threading::range& r) {
+                CoarsenScratch& scr = coarsen_scratch.local();
+                size_t n = 0;
+                for (size_t k = r.begin(); k < r.end(); ++k) {
+                    n += smooth_one(batch[k], scr);
+                }
+                moved.fetch_add(n, std::memory_order_relaxed);
+            },
+            NUM_THREADS);
+    }
+    return moved.load();
+}
+
 std::vector<size_t> TriOptimizerMesh::active_vertices() const
 {
     return utils::active_vertices(
@@ -10,6 +10,78 @@
 
 namespace wmtk {
 
+namespace {
+
+/// The split pass's hooks as a type, so that the scheduler calls them directly rather than
+/// through ExecutePass's std::function members. Longest edge first.
+struct SplitTraits
+{
+    using Tuple = TriMesh::Tuple;
+
+    double priority(const TriOptimizerMesh& m, OpHandle, const Tuple& t) const
+    {
+        return m.get_length2(t);
+    }
+    template <class Emit>
+    void renew_neighbor_tuples(
+        const TriOptimizerMesh& m,
+        OpHandle op,
+        const std::vector<Tuple>& newts,
+        Emit&& emit) const
+    {
+        for (const Tuple& t : newts) {
+            emit(op, t);
+            emit(op, t.switch_edge(m));
+            emit(op, t.switch_vertex(m).switch_edge(m));
+        }
+    }
+    /// The renewal above emits every spoke of the new vertex twice, once per triangle on
+    /// either side; the undirected edge is what a split is of, so one copy is queued.
+    uint64_t renew_key(const TriOptimizerMesh& m, OpHandle, const Tuple& t) const
+    {
+        const uint64_t a = t.vid(m);
+        const uint64_t b = t.switch_vertex(m).vid(m);
+        return a < b ? (a << 32) | b : (b << 32) | a;
+    }
+    bool is_weight_up_to_date(
+        const TriOptimizerMesh& m,
+        const std::tuple<double, OpHandle, Tuple>& ele) const
+    {
+        auto [weight, op, tup] = ele;
+        auto length = m.get_length2(tup);
+        if (length != weight) {
+            return false;
+        }
+        //
+        size_t v1_id = tup.vid(m);
+        size_t v2_id = tup.switch_vertex(m).vid(m);
+        // Force-split: a worst triangle's longest edge (queued by refine_sizing_around_worst
+        // when the max energy stalls) is split once regardless of the length gate, to unstick a
+        // sliver without changing the sizing field. The new midpoint is not in
+        // m_force_split_edges, so the two halves are NOT force-split again -- exactly one split
+        // per edge.
+        if (m.is_force_split_edge(v1_id, v2_id)) {
+            return true;
+        }
+        const auto& VA = m.m_vertex_attribute;
+        double sizing_ratio = 0.5 * (VA[v1_id].m_sizing_scalar + VA[v2_id].m_sizing_scalar);
+        if (length < m.m_params.splitting_l2 * sizing_ratio * sizing_ratio) {
+            return false;
+        }
+        return true;
+    }
+    std::optional<std::vector<Tuple>> apply(TriOptimizerMesh& m, OpHandle, const Tuple& t) const
+    {
+        std::vector<Tuple> ret;
+        if (m.split_edge(t, ret)) {
+            return ret;
+        }
+        return {};
+    }
+};
+
+} // namespace
+
 void TriOptimizerMesh::split_all_edges()
 {
     igl::Timer timer;
@@ -40,47 +112,11 @@ void TriOptimizerMesh::split_all_edges()
         wmtk::PassLock::EdgeRing,
         "edge split operation",
         [&](auto& executor, auto& mesh) {
-            executor.renew_neighbor_tuples =
-                [](const wmtk::TriOptimizerMesh& m, std::string op, const auto& newts) {
-                    std::vector<std::pair<std::string, TriMesh::Tuple>> op_tups;
-                    for (const auto& t : newts) {
-                        op_tups.emplace_back(op, t);
-                        op_tups.emplace_back(op, t.switch_edge(m));
-                        op_tups.emplace_back(op, t.switch_vertex(m).switch_edge(m));
-                    }
-                    return op_tups;
-                };
-
-            executor.priority = [&](const wmtk::TriOptimizerMesh& m,
-                                    std::string op,
-                                    const Tuple& t) { return m.get_length2(t); };
-            executor.is_weight_up_to_date = [&](const wmtk::TriOptimizerMesh& m, const auto& ele) {
-                auto [weight, op, tup] = ele;
-                auto length = m.get_length2(tup);
-                if (length != weight) {
-                    return false;
-                }
-                //
-                size_t v1_id = tup.vid(*this);
-                size_t v2_id = tup.switch_vertex(*this).vid(*this);
-                // Force-split: a worst triangle's longest edge (queued by
-                // refine_sizing_around_worst when the max energy stalls) is split once
-                // regardless of the length gate, to unstick a sliver without changing the
-                // sizing field. The new midpoint is not in m_force_split_edges, so the two
-                // halves are NOT force-split again -- exactly one split per edge.
-                if (is_force_split_edge(v1_id, v2_id)) {
-                    return true;
-                }
-                const auto& VA = m_vertex_attribute;
-                double sizing_ratio = 0.5 * (VA[v1_id].m_sizing_scalar + VA[v2_id].m_sizing_scalar);
-                if (length < m_params.splitting_l2 * sizing_ratio * sizing_ratio) {
-                    return false;
-                }
-                return true;
-            };
+            wmtk::use_approximate_queue(executor, mesh);
+            SplitTraits traits;
             // Retry a failed split only where the mesh actually changed this round
             // (dirty-epoch localized retry), instead of re-testing every failure every pass.
-            wmtk::run_localized_to_convergence(mesh, executor, collect_all_ops);
+            wmtk::run_localized_to_convergence(mesh, executor, traits, collect_all_ops);
         });
     if (m_force_split_count > 0) {
         wmtk::logger().info(
@@ -187,9 +223,6 @@ bool TriOptimizerMesh::split_edge_after(const Tuple& loc)
     p = (m_vertex_attribute[v1_id].m_posf + m_vertex_attribute[v2_id].m_posf) / 2;
     m_vertex_attribute[v_id].m_is_rounded = true;
 
-    // this has to be done before the inversion check
-    m_vertex_attribute[v_id].m_pos = to_rational(p);
-
     for (auto& loc : locs) {
         if (is_inverted(loc)) {
             m_vertex_attribute[v_id].m_is_rounded = false;
@@ -204,7 +237,8 @@ bool TriOptimizerMesh::split_edge_after(const Tuple& loc)
         // at the EXACT rational midpoint of the two endpoints instead. That midpoint lies on
         // the shared edge, so it can never invert a previously-valid incident triangle: the
         // split always succeeds and a stuck region can keep being refined. The vertex stays
-        // un-rounded (m_pos exact, m_is_rounded = false) until a later round() reclaims it.
+        // un-rounded (m_is_rounded = false, exact position in m_exact_pos) until a later
+        // round() reclaims it.
         //
         // This used to apply only when an endpoint was already rational, to stop a split
         // between two rounded endpoints from reintroducing exact coordinates into a
@@ -220,12 +254,13 @@ bool TriOptimizerMesh::split_edge_after(const Tuple& loc)
         // smoothing never do), the post-optimization pass is collapse-only, and
         // mesh_improvement does not stop until every vertex is rounded as well as the energy
         // target being met.
-        m_vertex_attribute[v_id].m_pos =
-            (m_vertex_attribute[v1_id].m_pos + m_vertex_attribute[v2_id].m_pos) / 2;
-        // Unlike tetwild, keep m_posf in step with the exact position: when an endpoint is
-        // itself un-rounded, the rounded midpoint of the two *approximations* is a worse
-        // approximation of the exact midpoint than rounding the exact midpoint once.
-        p = to_double(m_vertex_attribute[v_id].m_pos);
+        //
+        // set_vertex_exact_pos also keeps m_posf in step with the exact position: when an
+        // endpoint is itself un-rounded, the rounded midpoint of the two *approximations* is a
+        // worse approximation of the exact midpoint than rounding the exact midpoint once. It
+        // clears m_all_rounded too, so the sweep does not skip the next pass; if the check
+        // below rolls the split back, that costs the sweep one pass and nothing else.
+        set_vertex_exact_pos(v_id, (vertex_exact_pos(v1_id) + vertex_exact_pos(v2_id)) / 2);
         // Guard against a pre-existing inverted incident triangle: re-check in exact
         // arithmetic (un-rounded v_id => is_inverted uses the rational path). This check
         // was missing, so a split could leave an inverted triangle behind.
@@ -234,9 +269,6 @@ bool TriOptimizerMesh::split_edge_after(const Tuple& loc)
                 return false;
             }
         }
-        // This split keeps an un-rounded vertex, so the sweep must not skip the next pass.
-        // Set after the rollback checks above, which leave the mesh unchanged.
-        m_all_rounded.store(false, std::memory_order_relaxed);
     }
 
     if (!split_adjust_position(v_id, locs)) return false;
@@ -6,8 +6,26 @@
 #include <wmtk/utils/Rational.hpp>
 #include <wmtk/utils/predicates.hpp>
 
+#include <cstddef>
+#include <cstdint>
+
 namespace wmtk {
 
+/**
+ * The type TetMesh and TriMesh store vertex and cell ids in: tuples, cell-vertex tables and
+ * vertex stars.
+ *
+ * size_t by default. Configuring with WMTK_COMPACT_INDICES makes it 32 bits, which halves the
+ * cell-vertex tables and vertex stars and shrinks a TetMesh::Tuple from 24 to 16 bytes, for
+ * meshes with fewer than 2^32 - 1 vertices and cells (the last value is the invalid id). The
+ * mesh APIs take and return size_t either way; only storage changes.
+ */
+#ifdef WMTK_COMPACT_INDICES
+using index_t = std::uint32_t;
+#else
+using index_t = std::size_t;
+#endif
+
 template <typename T>
 using MatrixX = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
 
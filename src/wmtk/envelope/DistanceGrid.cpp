@@ -0,0 +1,176 @@
+#include "DistanceGrid.hpp"
+
+#include <wmtk/threading/parallel_for.hpp>
+#include <wmtk/utils/Logger.hpp>
+
+#include <igl/Timer.h>
+
+#include <algorithm>
+
+namespace wmtk {
+
+void DistanceGrid::clear()
+{
+    m_keys = std::vector<uint64_t>();
+    m_bounds = std::vector<float>();
+    m_mask = 0;
+    m_shift = 64;
+    m_size = 0;
+}
+
+void DistanceGrid::reset_table(const size_t n)
+{
+    size_t capacity = 16;
+    int log2 = 4;
+    while (capacity < 2 * n) {
+        capacity *= 2;
+        ++log2;
+    }
+    // Fresh vectors rather than assign(): the candidate table is larger than the final one
+    // and its capacity should not outlive the build.
+    m_keys = std::vector<uint64_t>(capacity, kEmpty);
+    m_bounds = std::vector<float>(capacity, 0.f);
+    m_mask = capacity - 1;
+    m_shift = 64 - log2;
+    m_size = 0;
+}
+
+bool DistanceGrid::insert(const uint64_t key, const float bound)
+{
+    if (2 * (m_size + 1) > m_keys.size()) {
+        std::vector<uint64_t> keys;
+        std::vector<float> bounds;
+        keys.swap(m_keys);
+        bounds.swap(m_bounds);
+        reset_table(keys.size());
+        for (size_t s = 0; s < keys.size(); ++s) {
+            if (keys[s] != kEmpty) insert(keys[s], bounds[s]);
+        }
+    }
+    size_t slot = hash(key);
+    for (; m_keys[slot] != kEmpty; slot = (slot + 1) & m_mask) {
+        if (m_keys[slot] == key) return false;
+    }
+    m_keys[slot] = key;
+    m_bounds[slot] = bound;
+    ++m_size;
+    return true;
+}
+
+bool DistanceGrid::build(
+    const Eigen::Vector3d& lo,
+    const Eigen::Vector3d& hi,
+    double cell,
+    const double max_radius,
+    const std::function<void(double, std::vector<Eigen::Vector3d>&)>& seeds,
+    const std::function<double(const Eigen::Vector3d&)>& sq_distance,
+    const size_t max_cells,
+    const int num_threads)
+{
+    igl::Timer timer;
+    timer.start();
+    clear();
+    const double half_diagonal = std::sqrt(3.) / 2;
+    const uint64_t axis_mask = (uint64_t(1) << kBits) - 1;
+    std::vector<Eigen::Vector3d> pts;
+
+    for (; cell > 0 && cell * half_diagonal < max_radius; cell *= 2) {
+        // A frame with room for a whole band around the box, so that every candidate has
+        // non-negative coordinates.
+        const double pad = max_radius + cell;
+        m_origin = lo.array() - pad;
+        m_cell = cell;
+        m_inv_cell = 1 / cell;
+        bool fits = true;
+        for (int d = 0; d < 3; ++d) {
+            m_dims[d] = std::floor((hi[d] - lo[d] + 2 * pad) * m_inv_cell) + 1;
+            fits = fits && m_dims[d] < double(axis_mask);
+        }
+        if (!fits) continue;
+
+        // Candidates: the cells whose centre is within reach of a seed. Seeds `cell` apart
+        // leave every input point within cell/sqrt(3) of one, and a cell worth keeping has its
+        // centre within max_radius of the input, so a reach of max_radius + cell misses none.
+        pts.clear();
+        seeds(cell, pts);
+        const double reach = max_radius + cell;
+        const int k = int(std::ceil(reach * m_inv_cell));
+        reset_table(std::min(max_cells, pts.size() * 8));
+        for (const Eigen::Vector3d& p : pts) {
+            if (!p.allFinite()) continue; // a degenerate input face can sample to NaN
+            int64_t c[3];
+            for (int d = 0; d < 3; ++d) {
+                c[d] = int64_t(std::floor((p[d] - m_origin[d]) * m_inv_cell));
+            }
+            for (int64_t i = std::max<int64_t>(0, c[0] - k); i <= c[0] + k; ++i) {
+                for (int64_t j = std::max<int64_t>(0, c[1] - k); j <= c[1] + k; ++j) {
+                    for (int64_t l = std::max<int64_t>(0, c[2] - k); l <= c[2] + k; ++l) {
+                        if (i >= m_dims[0] || j >= m_dims[1] || l >= m_dims[2]) continue;
+                        const Eigen::Vector3d centre =
+                            m_origin + cell * Eigen::Vector3d(i + 0.5, j + 0.5, l + 0.5);
+                        if ((centre - p).squaredNorm() > reach * reach) continue;
+                        insert(pack(i, j, l), 0.f);
+                    }
+                }
+            }
+            if (m_size > max_cells) break;
+        }
+        if (m_size > max_cells) {
+            logger().debug(
+                "distance grid: cell {:.3g} needs more than {} cells, trying {:.3g}",
+                cell,
+                max_cells,
+                2 * cell);
+            continue;
+        }
+
+        std::vector<uint64_t> keys;
+        keys.reserve(m_size);
+        for (const uint64_t key : m_keys) {
+            if (key != kEmpty) keys.push_back(key);
+        }
+        // The margin covers rounding twice over: in the BVH's distance, and in bound()
+        // assigning a point right on a cell face to its neighbour.
+        const double slack = cell * half_diagonal + 1e-9 * cell + 1e-12 * max_radius;
+        std::vector<float> bounds(keys.size());
+        threading::parallel_for(
+            threading::range(0, keys.size(), 256),
+            [&](const threading::range& r) {
+                for (size_t s = r.begin(); s < r.end(); ++s) {
+                    const uint64_t key = keys[s];
+                    const Eigen::Vector3d centre =
+                        m_origin + cell * Eigen::Vector3d(
+                                              double((key >> (2 * kBits)) & axis_mask) + 0.5,
+                                              double((key >> kBits) & axis_mask) + 0.5,
+                                              double(key & axis_mask) + 0.5);
+                    const double b = std::sqrt(sq_distance(centre)) + slack;
+                    float f = float(b);
+                    if (double(f) < b) f = std::nextafter(f, std::numeric_limits<float>::max());
+                    bounds[s] = f;
+                }
+            },
+            num_threads);
+
+        size_t n_kept = 0;
+        for (const float b : bounds) n_kept += b <= max_radius;
+        reset_table(n_kept);
+        for (size_t s = 0; s < keys.size(); ++s) {
+            if (bounds[s] <= max_radius) insert(keys[s], bounds[s]);
+        }
+        logger().info(
+            "distance grid: {} of {} candidate cells of size {:.3g} kept, {:.1f} MiB, {:.3f}s",
+            m_size,
+            keys.size(),
+            cell,
+            memory_bytes() / (1024. * 1024.),
+            timer.getElapsedTimeInSec());
+        if (m_size == 0) clear();
+        return m_size > 0;
+    }
+
+    logger().info("distance grid: no cell size fits the budget, grid left empty");
+    clear();
+    return false;
+}
+
+} // namespace wmtk
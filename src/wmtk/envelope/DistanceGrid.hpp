@@ -0,0 +1,121 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace wmtk {
+
+/**
+ * @brief A sparse uniform grid of distance upper bounds around a piecewise-linear input.
+ *
+ * Every stored cell carries a bound U on the distance from ANY point of the cell to the input:
+ * the distance of the cell centre, plus the centre-to-corner half diagonal (distance to a set
+ * is 1-Lipschitz), plus a margin for rounding, rounded up to float. A point whose cell is
+ * stored with U <= r is therefore within r of the input, and r - U is a lower bound on its
+ * clearance -- without a BVH search. Only cells with U <= max_radius are kept, which is a band
+ * around the input a few cells thick, hashed by cell coordinates. Everything else, including
+ * the rim of the band where the answer depends on where in the cell the point is, is
+ * "unknown": bound() returns infinity and the caller searches as before. The grid can only
+ * ever say "inside", so putting it in front of a conservative test keeps the test
+ * conservative.
+ *
+ * Built once, read-only afterwards, so any number of threads may query it.
+ */
+class DistanceGrid
+{
+public:
+    /**
+     * @brief Fill the grid, replacing whatever it held.
+     *
+     * Candidate cells are those around points on the input, `seeds(spacing, out)` appending
+     * points no more than `spacing` apart; each candidate's centre then costs one
+     * `sq_distance` call, in parallel. Missing a candidate only costs a hit, never
+     * correctness, so the seeding need not be exact.
+     *
+     * A band of cells of size h holds about area / h^2 * (2 max_radius / h) of them, so halving
+     * the cell multiplies the memory by eight. When the candidates would exceed @p max_cells
+     * the cell size is doubled and the build retried, for as long as a cell can still be
+     * accepted at all, i.e. its half diagonal stays below max_radius. Past that the grid is
+     * left empty.
+     *
+     * @param lo, hi a box containing the input
+     * @param cell the cell edge length to try first
+     * @param max_radius the largest acceptance radius the grid will be asked about
+     * @return whether a non-empty grid was built
+     */
+    bool build(
+        const Eigen::Vector3d& lo,
+        const Eigen::Vector3d& hi,
+        double cell,
+        double max_radius,
+        const std::function<void(double, std::vector<Eigen::Vector3d>&)>& seeds,
+        const std::function<double(const Eigen::Vector3d&)>& sq_distance,
+        size_t max_cells,
+        int num_threads = -1);
+
+    void clear();
+
+    /// The distance bound stored for the cell containing @p p, or infinity.
+    double bound(const Eigen::Vector3d& p) const
+    {
+        if (m_keys.empty()) return std::numeric_limits<double>::infinity();
+        uint64_t c[3];
+        for (int d = 0; d < 3; ++d) {
+            const double x = (p[d] - m_origin[d]) * m_inv_cell;
+            // Also false for NaN.
+            if (!(x >= 0 && x < m_dims[d])) return std::numeric_limits<double>::infinity();
+            c[d] = uint64_t(x);
+        }
+        const uint64_t key = pack(c[0], c[1], c[2]);
+        for (size_t slot = hash(key);; slot = (slot + 1) & m_mask) {
+            if (m_keys[slot] == key) return m_bounds[slot];
+            if (m_keys[slot] == kEmpty) return std::numeric_limits<double>::infinity();
+        }
+    }
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    double cell_size() const { return m_cell; }
+    size_t memory_bytes() const
+    {
+        return m_keys.capacity() * sizeof(uint64_t) + m_bounds.capacity() * sizeof(float);
+    }
+
+private:
+    /// 21 bits per axis, and a top bit that keeps every key distinct from kEmpty.
+    static constexpr int kBits = 21;
+    static constexpr uint64_t kEmpty = 0;
+
+    static uint64_t pack(const uint64_t i, const uint64_t j, const uint64_t k)
+    {
+        return (uint64_t(1) << 63) | (i << (2 * kBits)) | (j << kBits) | k;
+    }
+    size_t hash(const uint64_t key) const
+    {
+        return size_t((key * 0x9E3779B97F4A7C15ull) >> m_shift) & m_mask;
+    }
+    /// Empty the table and size it for @p n entries.
+    void reset_table(size_t n);
+    /// Insert unless present; whether it was inserted. Grows the table as needed.
+    bool insert(uint64_t key, float bound);
+
+    Eigen::Vector3d m_origin = Eigen::Vector3d::Zero();
+    double m_dims[3] = {0, 0, 0};
+    double m_cell = 0;
+    double m_inv_cell = 0;
+
+    // Open addressing with linear probing, at most half full.
+    std::vector<uint64_t> m_keys;
+    std::vector<float> m_bounds;
+    size_t m_mask = 0;
+    int m_shift = 64;
+    size_t m_size = 0;
+};
+
+} // namespace wmtk
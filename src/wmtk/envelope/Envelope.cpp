@@ -1,5 +1,6 @@
 #include "Envelope.hpp"
 
+#include <algorithm>
 #include <limits>
 
 #include <wmtk/Types.hpp>
@@ -92,6 +93,123 @@ void sampleTriangle(
     }
 }
 
+namespace {
+
+/**
+ * The last few input facets a thread's triangle samples were found near, for
+ * SampleEnvelope::first_outside.
+ *
+ * Stored as structure-of-arrays with everything the distance needs precomputed, so that
+ * `covers` is one loop over the lanes with no branches in it -- selects, not jumps -- which
+ * the compiler turns into vector code. Unused lanes hold a point facet at the far end of the
+ * double range, whose distance overflows to infinity.
+ */
+struct FacetCache
+{
+    static constexpr int K = 8;
+
+    const SampleEnvelope* owner = nullptr;
+    uint64_t generation = 0;
+    int ids[K];
+    int next = 0; // round-robin replacement
+
+    // Vertex a, edges ab, bc, ca, normal n = ab x ac; 1/|n|^2 and 1/|e|^2 (0 when degenerate).
+    double a[3][K], ab[3][K], bc[3][K], ca[3][K], n[3][K];
+    double inv_nn[K], inv_ab[K], inv_bc[K], inv_ca[K];
+
+    void reset(const SampleEnvelope* env, const uint64_t gen)
+    {
+        owner = env;
+        generation = gen;
+        next = 0;
+        for (int l = 0; l < K; ++l) {
+            ids[l] = -1;
+            for (int c = 0; c < 3; ++c) {
+                a[c][l] = std::numeric_limits<double>::max(); // far, yet no inf * 0
+                ab[c][l] = bc[c][l] = ca[c][l] = n[c][l] = 0;
+            }
+            inv_nn[l] = inv_ab[l] = inv_bc[l] = inv_ca[l] = 0;
+        }
+    }
+
+    void insert(const int id, const Vector3d& A, const Vector3d& B, const Vector3d& C)
+    {
+        for (int l = 0; l < K; ++l) {
+            if (ids[l] == id) return;
+        }
+        const int l = next;
+        next = (next + 1) % K;
+        ids[l] = id;
+        const Vector3d e0 = B - A, e1 = C - B, e2 = A - C;
+        const Vector3d nn = e0.cross(C - A);
+        for (int c = 0; c < 3; ++c) {
+            a[c][l] = A[c];
+            ab[c][l] = e0[c];
+            bc[c][l] = e1[c];
+            ca[c][l] = e2[c];
+            n[c][l] = nn[c];
+        }
+        const auto inv = [](const double x) { return x > 0 ? 1 / x : 0.; };
+        inv_nn[l] = inv(nn.squaredNorm());
+        inv_ab[l] = inv(e0.squaredNorm());
+        inv_bc[l] = inv(e1.squaredNorm());
+        inv_ca[l] = inv(e2.squaredNorm());
+    }
+
+    /// Whether some cached facet is within sqrt(eps2) of p.
+    bool covers(const Vector3d& p, const double eps2) const
+    {
+        double d[K];
+        for (int l = 0; l < K; ++l) {
+            // p relative to each corner: a, b = a + ab, c = b + bc.
+            const double px = p[0] - a[0][l], py = p[1] - a[1][l], pz = p[2] - a[2][l];
+            const double qx = px - ab[0][l], qy = py - ab[1][l], qz = pz - ab[2][l];
+            const double rx = qx - bc[0][l], ry = qy - bc[1][l], rz = qz - bc[2][l];
+            const double nx = n[0][l], ny = n[1][l], nz = n[2][l];
+            // Each edge's side of p, measured along n: the projection is inside the triangle
+            // iff it is on the inner side of all three.
+            const auto side = [&](const double ex,
+                                  const double ey,
+                                  const double ez,
+                                  const double vx,
+                                  const double vy,
+                                  const double vz) {
+                return (ey * vz - ez * vy) * nx + (ez * vx - ex * vz) * ny +
+                       (ex * vy - ey * vx) * nz;
+            };
+            const double s0 = side(ab[0][l], ab[1][l], ab[2][l], px, py, pz);
+            const double s1 = side(bc[0][l], bc[1][l], bc[2][l], qx, qy, qz);
+            const double s2 = side(ca[0][l], ca[1][l], ca[2][l], rx, ry, rz);
+            const bool inside = inv_nn[l] > 0 && s0 >= 0 && s1 >= 0 && s2 >= 0;
+            const double h = px * nx + py * ny + pz * nz;
+            const double plane = h * h * inv_nn[l];
+            // Otherwise the nearest point is on the boundary: the nearest of the three edges.
+            const auto seg = [](const double ex,
+                                const double ey,
+                                const double ez,
+                                const double inv_ee,
+                                const double vx,
+                                const double vy,
+                                const double vz) {
+                const double t = std::clamp((vx * ex + vy * ey + vz * ez) * inv_ee, 0., 1.);
+                const double dx = vx - t * ex, dy = vy - t * ey, dz = vz - t * ez;
+                return dx * dx + dy * dy + dz * dz;
+            };
+            const double d0 = seg(ab[0][l], ab[1][l], ab[2][l], inv_ab[l], px, py, pz);
+            const double d1 = seg(bc[0][l], bc[1][l], bc[2][l], inv_bc[l], qx, qy, qz);
+            const double d2 = seg(ca[0][l], ca[1][l], ca[2][l], inv_ca[l], rx, ry, rz);
+            d[l] = inside ? plane : std::min(d0, std::min(d1, d2));
+        }
+        double best = d[0];
+        for (int l = 1; l < K; ++l) {
+            best = std::min(best, d[l]);
+        }
+        return best <= eps2;
+    }
+};
+
+} // namespace
+
 /**
  * Build the exact edge envelope, when there is one to build and anything will ask for it.
  *
@@ -141,6 +259,7 @@ void SampleEnvelope::init(
         logger().info("Using sample envelope.");
     }
     m_kind = Kind::Triangles3d;
+    new_generation();
     m_v3 = V;
     m_f3 = F;
     exact_envelope.init(V, F, _eps);
@@ -185,6 +304,7 @@ void SampleEnvelope::init(
 
     m_bvh = std::make_shared<SimpleBVH::BVH>();
     m_bvh->init(VV, FF, 0);
+    build_distance_grid();
 }
 
 void SampleEnvelope::init(
@@ -193,6 +313,7 @@ void SampleEnvelope::init(
     const double _eps)
 {
     m_kind = Kind::Edges3d;
+    new_generation();
     m_v3 = V;
     m_e3 = F;
     // The raw _eps, not the shrunk one below: the shrink pays for the sampling lattice and
@@ -221,6 +342,7 @@ void SampleEnvelope::init(
 
     m_bvh = std::make_shared<SimpleBVH::BVH>();
     m_bvh->init(VV, FF, 0);
+    build_distance_grid();
 }
 void SampleEnvelope::init(
     const std::vector<Eigen::Vector2d>& V,
@@ -228,6 +350,7 @@ void SampleEnvelope::init(
     const double _eps)
 {
     m_kind = Kind::Edges2d;
+    new_generation();
     m_v2 = V;
     m_e2 = F;
     // Raw _eps again; see the 3D edge overload. In 2D the conservative shape is a rectangle
@@ -256,6 +379,7 @@ void SampleEnvelope::init(
 
     m_bvh = std::make_shared<SimpleBVH::BVH>();
     m_bvh->init(VV, FF, 0);
+    build_distance_grid();
 }
 
 /**
@@ -314,7 +438,16 @@ bool SampleEnvelope::is_outside(const Eigen::Vector3d& pts) const
         require_exact_3d("3D point");
         return exact_envelope.is_outside(pts);
     }
+    QueryStats counts;
+    counts.points = counts.samples = 1;
+    if (grid_covers(pts, eps2)) {
+        counts.grid_hits = 1;
+        m_counters.add(counts);
+        return false;
+    }
     double dist2 = squared_distance(pts);
+    counts.bvh_queries = 1;
+    m_counters.add(counts);
 
     return (dist2 > eps2);
 }
@@ -333,60 +466,102 @@ bool SampleEnvelope::is_outside(const Eigen::Vector2d& pts) const
 
 bool SampleEnvelope::is_outside(const std::array<Eigen::Vector3d, 3>& tri) const
 {
-    if (disabled) return false;
+    return first_outside(&tri, 1) < 1;
+}
+
+size_t SampleEnvelope::first_outside(const std::array<Eigen::Vector3d, 3>* tris, const size_t n)
+    const
+{
+    if (disabled) return n;
     if (use_exact) {
         require_exact_kind(Kind::Triangles3d, "triangle");
-        return exact_envelope.is_outside(tri);
+        for (size_t t = 0; t < n; ++t) {
+            if (exact_envelope.is_outside(tris[t])) return t;
+        }
+        return n;
     }
-    std::array<Vector3d, 3> vs = {
-        {Vector3d(tri[0][0], tri[0][1], tri[0][2]),
-         Vector3d(tri[1][0], tri[1][1], tri[1][2]),
-         Vector3d(tri[2][0], tri[2][1], tri[2][2])}};
-    static thread_local std::vector<Vector3d> ps;
-    ps.clear();
 
+    static thread_local FacetCache cache;
+    const bool use_cache = m_kind == Kind::Triangles3d;
+    if (use_cache && (cache.owner != this || cache.generation != m_generation)) {
+        cache.reset(this, m_generation);
+    }
+    static thread_local std::vector<Vector3d> ps;
+    static thread_local std::vector<unsigned int> candidates;
+    int last_cached = -1; // the BVH's id of the facet cached last
 
-    sampleTriangle(vs, ps, sampling_dist);
-
-    size_t num_queries = 0;
-    size_t num_samples = ps.size();
-
+    QueryStats counts;
     double bvh_sq_dist = std::numeric_limits<double>::max();
     Vector3d bvh_nearest_point;
     int bvh_prev_facet = -1;
 
-    size_t cnt = 0;
-    const size_t ps_size = ps.size();
-    for (size_t i = ps_size / 2; i < ps.size(); i = (i + 1) % ps_size) { // check from the middle
-
-        const Vector3d& bvh_p = ps[i];
-        if (bvh_prev_facet != -1) {
-            m_bvh->point_facet_distance(bvh_p, bvh_prev_facet, bvh_nearest_point, bvh_sq_dist);
-        }
-        if (bvh_sq_dist > eps2) {
-            m_bvh->facet_in_envelope_with_hint(
-                bvh_p,
-                eps2,
-                bvh_prev_facet,
-                bvh_nearest_point,
-                bvh_sq_dist);
-        }
-
-        ++num_queries;
+    size_t result = n;
+    for (size_t t = 0; t < n && result == n; ++t) {
+        ps.clear();
+        sampleTriangle(tris[t], ps, sampling_dist);
+        ++counts.triangles;
+
+        const size_t ps_size = ps.size();
+        size_t i = ps_size / 2; // check from the middle
+        for (size_t cnt = 0; cnt < ps_size; ++cnt, i = (i + 1) % ps_size) {
+            const Vector3d& bvh_p = ps[i];
+            ++counts.samples;
+            // Cheapest first: the distance grid, the facet the previous sample was found near,
+            // then the cache, then the BVH.
+            if (grid_covers(bvh_p, eps2)) {
+                ++counts.grid_hits;
+                continue;
+            }
+            if (bvh_prev_facet != -1) {
+                m_bvh->point_facet_distance(bvh_p, bvh_prev_facet, bvh_nearest_point, bvh_sq_dist);
+            }
+            if (bvh_sq_dist > eps2 && use_cache && cache.covers(bvh_p, eps2)) {
+                ++counts.cache_hits;
+                continue;
+            }
+            bool searched = false;
+            if (bvh_sq_dist > eps2) {
+                m_bvh->facet_in_envelope_with_hint(
+                    bvh_p,
+                    eps2,
+                    bvh_prev_facet,
+                    bvh_nearest_point,
+                    bvh_sq_dist);
+                ++counts.bvh_queries;
+                searched = true;
+            }
 
-        if (bvh_sq_dist > eps2) {
-            wmtk::logger().trace("num_queries {} / {}", num_queries, num_samples);
-            return true;
-        }
-        cnt++;
-        if (cnt >= ps_size) {
-            break;
+            if (bvh_sq_dist > eps2) {
+                result = t;
+                break;
+            }
+            if (use_cache && searched && bvh_prev_facet != last_cached) {
+                // The BVH numbers facets its own way (see nearest_point_feature), so the facet
+                // it found is looked up again in input ids by a box query around the foot.
+                // Everything touching the foot goes in: for a foot on an input edge or vertex
+                // those are the neighbours the next samples are likely to land near.
+                last_cached = bvh_prev_facet;
+                const double pad = 1e-9 + 1e-9 * std::sqrt(bvh_sq_dist);
+                const Eigen::Vector3d lo = bvh_nearest_point.array() - pad;
+                const Eigen::Vector3d hi = bvh_nearest_point.array() + pad;
+                candidates.clear();
+                m_bvh->intersect_box(lo, hi, candidates);
+                for (const unsigned int fid : candidates) {
+                    const Eigen::Vector3i& f = m_f3[fid];
+                    cache.insert(int(fid), m_v3[f[0]], m_v3[f[1]], m_v3[f[2]]);
+                }
+            }
         }
     }
 
-
-    wmtk::logger().trace("num_queries {} / {}", num_queries, num_samples);
-    return false;
+    wmtk::logger().trace(
+        "{} / {} triangles, {} samples, {} BVH queries",
+        std::min(result + 1, n),
+        n,
+        counts.samples,
+        counts.bvh_queries);
+    m_counters.add(counts);
+    return result;
 }
 
 bool SampleEnvelope::is_outside(const std::array<Vector3d, 2>& edge) const
@@ -414,16 +589,26 @@ bool SampleEnvelope::is_outside(const std::array<Vector3d, 2>& edge) const
         pts.push_back(tmp);
     }
 
+    QueryStats counts;
+    counts.segments = 1;
     double sq_dist;
     Vector3d nearest_point;
     for (size_t i = 0; i < pts.size(); ++i) {
+        ++counts.samples;
+        if (grid_covers(pts[i], eps2_edge)) {
+            ++counts.grid_hits;
+            continue;
+        }
         m_bvh->nearest_facet(pts[i], nearest_point, sq_dist);
+        ++counts.bvh_queries;
         if (sq_dist > eps2_edge) {
             wmtk::logger().trace("fail envelope check 5");
+            m_counters.add(counts);
             return true;
         }
     }
 
+    m_counters.add(counts);
     return false;
 }
 
@@ -676,6 +861,137 @@ double SampleEnvelope::squared_distance(const Eigen::Vector2d& p) const
 }
 
 
+void SampleEnvelope::new_generation()
+{
+    static std::atomic<uint64_t> counter(0);
+    m_generation = ++counter;
+    reset_query_stats();
+}
+
+void SampleEnvelope::build_distance_grid()
+{
+    // Exact queries never look at the grid, so an exact envelope does not pay for one.
+    if (!use_distance_grid || use_exact) {
+        m_grid.clear();
+        return;
+    }
+
+    // Everything in 3D; a 2D input lies in z = 0, where its queries are lifted to as well.
+    std::vector<Vector3d> V;
+    if (m_kind == Kind::Edges2d) {
+        V.reserve(m_v2.size());
+        for (const Vector2d& v : m_v2) V.emplace_back(v[0], v[1], 0);
+    } else {
+        V = m_v3;
+    }
+    const std::vector<Eigen::Vector2i>& E = m_kind == Kind::Edges2d ? m_e2 : m_e3;
+    if (V.empty()) {
+        m_grid.clear();
+        return;
+    }
+    Vector3d lo = V[0], hi = V[0];
+    for (const Vector3d& v : V) {
+        lo = lo.cwiseMin(v);
+        hi = hi.cwiseMax(v);
+    }
+
+    const auto seeds = [&](const double spacing, std::vector<Vector3d>& out) {
+        if (m_kind == Kind::Triangles3d) {
+            for (const Eigen::Vector3i& f : m_f3) {
+                sampleTriangle({{V[f[0]], V[f[1]], V[f[2]]}}, out, spacing);
+            }
+            return;
+        }
+        for (const Eigen::Vector2i& e : E) {
+            const int N = (V[e[0]] - V[e[1]]).norm() / spacing + 1;
+            for (int n = 0; n <= N; ++n) {
+                out.push_back(V[e[0]] * (double(n) / N) + V[e[1]] * (double(N - n) / N));
+            }
+        }
+    };
+    const auto sq_distance = [this](const Vector3d& p) { return squared_distance(p); };
+
+    // Point and triangle queries accept at sqrt(eps2), segment queries at sqrt(eps2_edge);
+    // the cells are sized for the smaller and kept up to the larger.
+    const double r_min = std::sqrt(std::min(eps2, eps2_edge));
+    const double r_max = std::sqrt(std::max(eps2, eps2_edge));
+    m_grid.build(
+        lo,
+        hi,
+        distance_grid_cell_ratio * r_min,
+        r_max,
+        seeds,
+        sq_distance,
+        distance_grid_max_cells,
+        distance_grid_threads);
+}
+
+void SampleEnvelope::QueryCounters::add(const QueryStats& s)
+{
+    // Only what the query touched: a point query costs three adds, not six.
+    const auto bump = [](std::atomic<size_t>& c, const size_t v) {
+        if (v > 0) c.fetch_add(v, std::memory_order_relaxed);
+    };
+    bump(triangles, s.triangles);
+    bump(segments, s.segments);
+    bump(points, s.points);
+    bump(samples, s.samples);
+    bump(grid_hits, s.grid_hits);
+    bump(cache_hits, s.cache_hits);
+    bump(bvh_queries, s.bvh_queries);
+}
+
+SampleEnvelope::QueryStats SampleEnvelope::query_stats() const
+{
+    QueryStats s;
+    s.triangles = m_counters.triangles.load();
+    s.segments = m_counters.segments.load();
+    s.points = m_counters.points.load();
+    s.samples = m_counters.samples.load();
+    s.grid_hits = m_counters.grid_hits.load();
+    s.cache_hits = m_counters.cache_hits.load();
+    s.bvh_queries = m_counters.bvh_queries.load();
+    return s;
+}
+
+void SampleEnvelope::reset_query_stats()
+{
+    m_counters.triangles = 0;
+    m_counters.segments = 0;
+    m_counters.points = 0;
+    m_counters.samples = 0;
+    m_counters.grid_hits = 0;
+    m_counters.cache_hits = 0;
+    m_counters.bvh_queries = 0;
+}
+
+SampleEnvelope::QueryStats SampleEnvelope::QueryStats::operator-(const QueryStats& o) const
+{
+    QueryStats d;
+    d.triangles = triangles - o.triangles;
+    d.segments = segments - o.segments;
+    d.points = points - o.points;
+    d.samples = samples - o.samples;
+    d.grid_hits = grid_hits - o.grid_hits;
+    d.cache_hits = cache_hits - o.cache_hits;
+    d.bvh_queries = bvh_queries - o.bvh_queries;
+    return d;
+}
+
+std::string SampleEnvelope::QueryStats::to_string() const
+{
+    return fmt::format(
+        "{} triangles, {} segments, {} points; {} samples, {} from the distance grid, {} from "
+        "the facet cache, {} BVH queries",
+        triangles,
+        segments,
+        points,
+        samples,
+        grid_hits,
+        cache_hits,
+        bvh_queries);
+}
+
 void SampleEnvelope::init(const Eigen::MatrixXd& V, const Eigen::MatrixXi& F, const double eps)
 {
     if (V.cols() == 3 && F.cols() == 3) {
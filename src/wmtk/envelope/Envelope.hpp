@@ -1,7 +1,11 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 // clang-format off
 #include <wmtk/utils/DisableWarnings.hpp>
@@ -11,6 +15,8 @@
 #include <wmtk/utils/EnableWarnings.hpp>
 // clang-format on
 
+#include "DistanceGrid.hpp"
+
 namespace wmtk {
 class Envelope
 {
@@ -48,6 +54,13 @@ public:
 };
 
 
+/// The points SampleEnvelope tests a triangle at: a triangular lattice of spacing
+/// `sampling_dist` over `vs`, appended to `ps`. From TetWild.
+void sampleTriangle(
+    const std::array<Eigen::Vector3d, 3>& vs,
+    std::vector<Eigen::Vector3d>& ps,
+    const double sampling_dist);
+
 class SampleEnvelope : public wmtk::Envelope
 {
 public:
@@ -111,6 +124,28 @@ public:
      * optimizer cannot move at all".
      */
     bool disabled = false;
+
+    /**
+     * Opt-in, read by init(): also build a DistanceGrid over the input, so that a sampled
+     * query whose sample falls in a cell known to lie deep inside the envelope is answered
+     * without a BVH search. Only the samples near the envelope's boundary, and those away from
+     * the input altogether, still go to the BVH. The grid only ever proves a sample inside with
+     * the same radius the search would use, so the answers do not change -- only their cost.
+     *
+     * The build costs one BVH query per cell of the band and its memory grows with the input's
+     * area over the cell size squared; see the two knobs below. Clearing the flag after init()
+     * switches the grid off again for this envelope. Exact queries never use it.
+     */
+    bool use_distance_grid = false;
+    /// Cell edge over the smaller acceptance radius. Smaller cells accept closer to the
+    /// boundary, at eight times the memory per halving.
+    double distance_grid_cell_ratio = 0.5;
+    /// Cap on the grid's candidate cells, 24 to 48 bytes each in a table kept at most half
+    /// full; above it the cell size is doubled until the grid fits, or it is given up on.
+    size_t distance_grid_max_cells = size_t(1) << 22;
+    /// Threads for the grid's build, as threading::parallel_for takes them.
+    int distance_grid_threads = -1;
+
     void init(
         const std::vector<Eigen::Vector3d>& m_ver,
         const std::vector<Eigen::Vector3i>& m_faces,
@@ -136,6 +171,32 @@ public:
      */
     void init(const Eigen::MatrixXd& V, const Eigen::MatrixXi& F, const double eps);
     bool is_outside(const std::array<Eigen::Vector3d, 3>& tris) const;
+
+    /**
+     * @brief Batched triangle query: the index of the first of the @p n triangles found
+     * outside, or @p n if all of them are inside.
+     *
+     * Operations ask about several triangles at once -- the surface faces around a collapsed
+     * edge or a smoothed vertex, the pair a swap or a split creates -- and those triangles share
+     * vertices, so their samples land near the same few input facets. The sampled path uses
+     * that twice. The facet the previous sample was found near is the BVH hint for the next one
+     * across triangles, not only within one. And the facets the BVH found for recent samples
+     * are kept in a small per-thread cache: a sample the hint does not cover is tested against
+     * all of them in one branch-free point-triangle distance loop, which the compiler
+     * vectorizes, and only a sample none of them covers goes to the BVH. A facet within the
+     * radius proves a sample inside exactly as the BVH search would, so the answer is the one
+     * triangle-by-triangle queries give, in the same order, stopping at the first sample found
+     * outside.
+     *
+     * The cache needs the facets' geometry and so only serves an envelope built from
+     * triangles. The exact path checks the triangles one by one.
+     */
+    size_t first_outside(const std::array<Eigen::Vector3d, 3>* tris, size_t n) const;
+    bool any_outside(const std::vector<std::array<Eigen::Vector3d, 3>>& tris) const
+    {
+        return first_outside(tris.data(), tris.size()) < tris.size();
+    }
+
     bool is_outside(const std::array<Eigen::Vector3d, 2>& edge) const;
     bool is_outside(const std::array<Eigen::Vector2d, 2>& edge) const;
     bool is_outside(const Eigen::Vector3d& pts) const;
@@ -180,7 +241,70 @@ public:
     double squared_distance(const Eigen::Vector3d& p) const;
     double squared_distance(const Eigen::Vector2d& p) const;
 
+    /**
+     * @brief What the sampled containment queries have cost, summed over all threads since
+     * init() or the last reset_query_stats().
+     *
+     * Counted once per query, not per sample, so the counters stay off the hot loop. Take a
+     * snapshot before a pass and subtract it afterwards for that pass's share; run_pass logs
+     * exactly that for the mesh's surface envelope. Exact queries are not counted.
+     */
+    struct QueryStats
+    {
+        size_t triangles = 0;
+        size_t segments = 0;
+        size_t points = 0;
+        /// Sample points tested for the triangles and segments, plus one per point query.
+        size_t samples = 0;
+        /// Samples the distance grid answered, without a BVH search.
+        size_t grid_hits = 0;
+        /// Samples a cached facet answered, without a BVH search.
+        size_t cache_hits = 0;
+        size_t bvh_queries = 0;
+
+        QueryStats operator-(const QueryStats& o) const;
+        std::string to_string() const;
+    };
+    QueryStats query_stats() const;
+    void reset_query_stats();
+
+    /// Empty unless use_distance_grid was set at init() and a grid fit the budget.
+    const DistanceGrid& distance_grid() const { return m_grid; }
+
 private:
+    /// Atomic counters behind query_stats(). A copied envelope starts its own count.
+    struct QueryCounters
+    {
+        std::atomic<size_t> triangles{0};
+        std::atomic<size_t> segments{0};
+        std::atomic<size_t> points{0};
+        std::atomic<size_t> samples{0};
+        std::atomic<size_t> grid_hits{0};
+        std::atomic<size_t> cache_hits{0};
+        std::atomic<size_t> bvh_queries{0};
+
+        QueryCounters() = default;
+        QueryCounters(const QueryCounters&) {}
+        QueryCounters& operator=(const QueryCounters&) { return *this; }
+        void add(const QueryStats& s);
+    };
+    mutable QueryCounters m_counters;
+    /// Distinguishes one init() from another, so a per-thread facet cache filled against a
+    /// previous build (possibly of another envelope at the same address) is never consulted.
+    uint64_t m_generation = 0;
+    void new_generation();
+
+    DistanceGrid m_grid;
+    /// The last step of every init(): (re)build m_grid, or clear it.
+    void build_distance_grid();
+    /// Whether the grid proves @p p within sqrt(@p r2) of the input.
+    bool grid_covers(const Eigen::Vector3d& p, const double r2) const
+    {
+        if (!use_distance_grid) return false;
+        const double b = m_grid.bound(p);
+        return b * b <= r2;
+    }
+
     void require_exact_kind(Kind expected, const char* query) const;
     void require_exact_3d(const char* query) const;
     void require_exact_built(const char* query) const;
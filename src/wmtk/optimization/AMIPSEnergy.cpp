@@ -1,7 +1,6 @@
 #include "AMIPSEnergy.hpp"
 
-#include <wmtk/utils/AMIPS.h>
-#include <wmtk/utils/AMIPS2D.h>
+#include <wmtk/utils/AMIPSBatch.h>
 #include <wmtk/utils/orient.hpp>
 
 namespace wmtk::optimization {
@@ -20,51 +19,24 @@ AMIPSEnergy2D::TVector AMIPSEnergy2D::initial_position() const
 double AMIPSEnergy2D::value(const TVector& x)
 {
     assert(x.size() == 2);
-
-    double res = 0;
-    for (size_t i = 0; i < m_cells.size(); ++i) {
-        auto c = m_cells[i];
-        c[0] = x[0];
-        c[1] = x[1];
-        res += wmtk::AMIPS2D_energy(c);
-    }
-    return m_weight * res;
+    return m_weight * wmtk::AMIPS2D_one_ring(m_cells, Vector2d(x));
 }
 
 void AMIPSEnergy2D::gradient(const TVector& x, TVector& gradv)
 {
     assert(x.size() == 2);
-    gradv.resize(2);
-    gradv.setZero();
-
-    Vector2d tmp;
-    for (size_t i = 0; i < m_cells.size(); ++i) {
-        auto c = m_cells[i];
-        c[0] = x[0];
-        c[1] = x[1];
-        wmtk::AMIPS2D_jacobian(c, tmp);
-        gradv += tmp;
-    }
-
-    gradv *= m_weight;
+    Vector2d g;
+    wmtk::AMIPS2D_one_ring(m_cells, Vector2d(x), &g);
+    gradv = m_weight * g;
 }
 
 void AMIPSEnergy2D::hessian(const TVector& x, MatrixXd& hessian)
 {
     assert(x.size() == 2);
-    hessian.resize(2, 2);
-    hessian.setZero();
-
-    Matrix2d tmp;
-    for (size_t i = 0; i < m_cells.size(); ++i) {
-        auto c = m_cells[i];
-        c[0] = x[0];
-        c[1] = x[1];
-        wmtk::AMIPS2D_hessian(c, tmp);
-        hessian += tmp;
-    }
-
-    hessian *= m_weight;
+    Vector2d g;
+    Matrix2d h;
+    wmtk::AMIPS2D_one_ring(m_cells, Vector2d(x), &g, &h);
+    hessian = m_weight * h;
 }
 
 void AMIPSEnergy2D::solution_changed(const TVector& new_x) {}
@@ -97,54 +69,24 @@ AMIPSEnergy3D::TVector AMIPSEnergy3D::initial_position() const
 double AMIPSEnergy3D::value(const TVector& x)
 {
     assert(x.size() == 3);
-
-    double res = 0;
-    for (size_t i = 0; i < m_cells.size(); ++i) {
-        auto c = m_cells[i];
-        c[0] = x[0];
-        c[1] = x[1];
-        c[2] = x[2];
-        res += wmtk::AMIPS_energy(c);
-    }
-    return m_weight * res;
+    return m_weight * wmtk::AMIPS_one_ring(m_cells, Vector3d(x));
 }
 
 void AMIPSEnergy3D::gradient(const TVector& x, TVector& gradv)
 {
     assert(x.size() == 3);
-    gradv.resize(3);
-    gradv.setZero();
-
-    Vector3d tmp;
-    for (size_t i = 0; i < m_cells.size(); ++i) {
-        auto c = m_cells[i];
-        c[0] = x[0];
-        c[1] = x[1];
-        c[2] = x[2];
-        wmtk::AMIPS_jacobian(c, tmp);
-        gradv += tmp;
-    }
-
-    gradv *= m_weight;
+    Vector3d g;
+    wmtk::AMIPS_one_ring(m_cells, Vector3d(x), &g);
+    gradv = m_weight * g;
 }
 
 void AMIPSEnergy3D::hessian(const TVector& x, MatrixXd& hessian)
 {
     assert(x.size() == 3);
-    hessian.resize(3, 3);
-    hessian.setZero();
-
-    Matrix3d tmp;
-    for (size_t i = 0; i < m_cells.size(); ++i) {
-        auto c = m_cells[i];
-        c[0] = x[0];
-        c[1] = x[1];
-        c[2] = x[2];
-        wmtk::AMIPS_hessian(c, tmp);
-        hessian += tmp;
-    }
-
-    hessian *= m_weight;
+    Vector3d g;
+    Matrix3d h;
+    wmtk::AMIPS_one_ring(m_cells, Vector3d(x), &g, &h);
+    hessian = m_weight * h;
 }
 
 void AMIPSEnergy3D::solution_changed(const TVector& new_x) {}
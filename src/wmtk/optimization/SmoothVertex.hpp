@@ -3,6 +3,7 @@
 #include <wmtk/optimization/AMIPSEnergy.hpp>
 #include <wmtk/optimization/EnergySum.hpp>
 #include <wmtk/optimization/EnvelopeEnergy.hpp>
+#include <wmtk/optimization/VertexNewton.hpp>
 #include <wmtk/optimization/solver.hpp>
 
 #include <wmtk/Types.hpp>
@@ -143,6 +144,20 @@ struct SmoothVertexOptions
      * case.
      */
     int project_line_search_nested_steps = 0;
+
+    /**
+     * What minimizes the objective.
+     *
+     * Polysolve: polysolve's DenseNewton on the AMIPSEnergy / ExactDistanceEnergy / EnergySum
+     * problem objects, the reference.
+     *
+     * FixedNewton: fixed_newton_minimize on a VertexObjective -- the same energy, Newton
+     * step and line search on Matrix2d/Matrix3d, with no problem objects, no dynamic vectors
+     * and no solver to create. For a 2- or 3-variable problem that machinery is most of the
+     * cost of the solve; the positions agree with Polysolve to solver tolerance.
+     */
+    enum class Solver { Polysolve, FixedNewton };
+    Solver solver = Solver::Polysolve;
 };
 
 /**
@@ -159,7 +174,7 @@ struct SmoothVertexOptions
  * which test whole incident faces rather than the vertex point anyway.
  *
  * `Mesh` must provide, on top of what wmtk::TetMesh already gives:
- *   - m_vertex_attribute[vid].{m_pos, m_posf, m_is_on_surface}
+ *   - m_vertex_attribute[vid].{m_posf, m_is_on_surface}
  *   - cell_quality(tid) / set_cell_quality(tid, quality)
  *   - is_inverted_f(Tuple), is_inverted(Tuple), get_quality(Tuple)
  *   - std::shared_ptr<SampleEnvelope> smoothing_envelope(size_t vid) const
@@ -206,15 +221,41 @@ bool smooth_vertex_3d(
         }
     }
 
-    if (!solver) {
-        solver = create_basic_solver();
-    }
+    const std::shared_ptr<SampleEnvelope> pull_env =
+        VA[vid].m_is_on_surface ? m.smoothing_energy_envelope(vid) : nullptr;
 
+    // Minimize wa * AMIPS + we * envelope from the current position. The weights multiply
+    // the option weights, so (1, 0) is plain AMIPS and (1, 1) the weighted objective.
     const double amips_w = opts.w_amips > 0 ? opts.s_amips * opts.w_amips : 1.0;
-    auto amips_energy = std::make_shared<AMIPSEnergy3D>(assembles, amips_w);
-    std::shared_ptr<polysolve::nonlinear::Problem> total_energy = amips_energy;
+    const double envelope_w = opts.s_envelope * opts.w_envelope;
+    std::shared_ptr<AMIPSEnergy3D> amips_energy;
+    std::shared_ptr<ExactDistanceEnergy3D> envelope_energy;
+    auto solve = [&](const double wa, const double we) {
+        if (opts.solver == SmoothVertexOptions::Solver::FixedNewton) {
+            const VertexObjective<3> obj(assembles, wa * amips_w, pull_env.get(), we * envelope_w);
+            Vector3d x = VA[vid].m_posf;
+            fixed_newton_minimize(obj, x);
+            VA[vid].m_posf = x;
+            return;
+        }
+
+        if (!solver) {
+            solver = create_basic_solver();
+        }
+        if (!amips_energy) {
+            amips_energy = std::make_shared<AMIPSEnergy3D>(assembles, amips_w);
+        }
+        std::shared_ptr<polysolve::nonlinear::Problem> total_energy = amips_energy;
+        if (we > 0 || wa != 1) {
+            if (!envelope_energy) {
+                envelope_energy = std::make_shared<ExactDistanceEnergy3D>(pull_env, envelope_w);
+            }
+            auto sum = std::make_shared<EnergySum>();
+            if (wa > 0) sum->add_energy(amips_energy, wa);
+            if (we > 0) sum->add_energy(envelope_energy, we);
+            total_energy = sum;
+        }
 
-    auto solve = [&]() {
         VectorXd x = VA[vid].m_posf;
         try {
             solver->minimize(*total_energy, x);
@@ -225,21 +266,17 @@ bool smooth_vertex_3d(
         VA[vid].m_posf = x;
     };
 
-    const std::shared_ptr<SampleEnvelope> pull_env =
-        VA[vid].m_is_on_surface ? m.smoothing_energy_envelope(vid) : nullptr;
-
     if (pull_env && opts.smoothing_mode == SmoothVertexOptions::SmoothingMode::Projected) {
         // Smooth as if the vertex were interior, then walk back onto the input.
         const Vector3d x_orig = VA[vid].m_posf;
-        total_energy = amips_energy;
-        solve();
+        solve(1, 0);
         const Vector3d x_new = VA[vid].m_posf;
 
         // Place a candidate and report the worst incident quality, or infinity if it
-        // inverts. is_inverted is exact, so the rational position tracks every candidate.
+        // inverts. Only rounded vertices are smoothed, so the double position is the exact
+        // one is_inverted reads.
         const auto worst_at = [&](const Vector3d& p) {
             VA[vid].m_posf = p;
-            VA[vid].m_pos = to_rational(p);
             double mq = 0.;
             for (const Tuple& loc : locs) {
                 if (m.is_inverted(loc)) {
@@ -299,29 +336,18 @@ bool smooth_vertex_3d(
         }
         if (!accepted) {
             VA[vid].m_posf = x_orig;
-            VA[vid].m_pos = to_rational(x_orig);
             if (counters) ++counters->quality;
             return false;
         }
     } else if (pull_env) {
-        auto envelope_energy =
-            std::make_shared<ExactDistanceEnergy3D>(pull_env, opts.s_envelope * opts.w_envelope);
-
         if (opts.two_stage) {
-            auto warmup = std::make_shared<EnergySum>();
-            if (opts.w_amips > 0) warmup->add_energy(amips_energy, 1. / opts.w_amips);
-            if (opts.w_envelope > 0) warmup->add_energy(envelope_energy, 1. / opts.w_envelope);
-            total_energy = warmup;
-            solve();
+            solve(
+                opts.w_amips > 0 ? 1. / opts.w_amips : 0.,
+                opts.w_envelope > 0 ? 1. / opts.w_envelope : 0.);
         }
-
-        auto weighted = std::make_shared<EnergySum>();
-        if (opts.w_amips > 0) weighted->add_energy(amips_energy);
-        if (opts.w_envelope > 0) weighted->add_energy(envelope_energy);
-        total_energy = weighted;
-        solve();
+        solve(opts.w_amips > 0 ? 1. : 0., opts.w_envelope > 0 ? 1. : 0.);
     } else {
-        solve();
+        solve(1, 0);
     }
 
     // Containment: every surface triangle at this vertex must still be inside. Checked
@@ -329,22 +355,22 @@ bool smooth_vertex_3d(
     const std::shared_ptr<SampleEnvelope> check_env =
         VA[vid].m_is_on_surface ? m.smoothing_containment_envelope(vid) : nullptr;
     if (check_env) {
+        // One batch, so that the samples of neighbouring faces share the envelope's facet cache.
+        static thread_local std::vector<std::array<Eigen::Vector3d, 3>> faces;
+        faces.clear();
         const simplex::SimplexCollection surf = m.get_surface_faces_for_vertex(vid);
         for (const simplex::Face& f : surf.faces()) {
-            const std::array<Eigen::Vector3d, 3> face = {
-                {VA[f.vertices()[0]].m_posf,
-                 VA[f.vertices()[1]].m_posf,
-                 VA[f.vertices()[2]].m_posf}};
-            if (check_env->is_outside(face)) {
-                if (counters) ++counters->envelope;
-                return false;
-            }
+            faces.push_back(
+                {{VA[f.vertices()[0]].m_posf,
+                  VA[f.vertices()[1]].m_posf,
+                  VA[f.vertices()[2]].m_posf}});
+        }
+        if (check_env->any_outside(faces)) {
+            if (counters) ++counters->envelope;
+            return false;
         }
     }
 
-    // The rational position must be current before the exact inversion test.
-    VA[vid].m_pos = to_rational(VA[vid].m_posf);
-
     double max_after_quality = 0.;
     for (const Tuple& loc : locs) {
         if (m.is_inverted(loc)) {
@@ -383,7 +409,7 @@ bool smooth_vertex_3d(
  *   - is_inverted_f(size_t fid), is_inverted(size_t fid), get_quality(size_t fid)
  *   - Vector2d smoothing_position(size_t vid) const
  *   - void set_smoothing_position(size_t vid, const Vector2d& p)
- *       writes the working position and its exact/rational copy together
+ *       writes the working position; the vertex is rounded, so that is also its exact one
  *   - m_envelope, used for both the surface pull energy and containment
  */
 template <class Mesh>
@@ -398,7 +424,7 @@ bool smooth_vertex_2d(
     auto& VA = m.m_vertex_attribute;
     auto& FA = m.m_face_attribute;
 
-    const std::vector<size_t>& locs = m.get_one_ring_fids_for_vertex(t);
+    const auto& locs = m.get_one_ring_fids_for_vertex(t);
     assert(!locs.empty());
 
     double max_quality = 0.;
@@ -438,25 +464,6 @@ bool smooth_vertex_2d(
         assembles.push_back(T);
     }
 
-    if (!solver) {
-        solver = create_basic_solver();
-    }
-
-    const double amips_w = opts.w_amips > 0 ? opts.s_amips * opts.w_amips : 1.0;
-    auto amips_energy = std::make_shared<AMIPSEnergy2D>(assembles, amips_w);
-    std::shared_ptr<polysolve::nonlinear::Problem> total_energy = amips_energy;
-
-    auto solve = [&]() {
-        VectorXd x = m.smoothing_position(vid);
-        try {
-            solver->minimize(*total_energy, x);
-        } catch (const std::exception&) {
-            // A failed line search is reported by throwing; the position reached is still
-            // the best found, and the checks below decide whether to keep it.
-        }
-        m.set_smoothing_position(vid, Vector2d(x));
-    };
-
     // Neighbours along the incident surface edges, captured before the solve. Only `vid`
     // moves, so their positions are the same either way, but taking them first matches what
     // both applications did and keeps the assert below meaningful.
@@ -474,14 +481,54 @@ bool smooth_vertex_2d(
     const std::shared_ptr<SampleEnvelope> envelope =
         VA[vid].m_is_on_surface ? m.m_envelope : nullptr;
 
+    // As in 3D: minimize wa * AMIPS + we * envelope, weights relative to the options'.
+    const double amips_w = opts.w_amips > 0 ? opts.s_amips * opts.w_amips : 1.0;
+    const double envelope_w = opts.s_envelope * opts.w_envelope;
+    std::shared_ptr<AMIPSEnergy2D> amips_energy;
+    std::shared_ptr<ExactDistanceEnergy2D> envelope_energy;
+    auto solve = [&](const double wa, const double we) {
+        if (opts.solver == SmoothVertexOptions::Solver::FixedNewton) {
+            const VertexObjective<2> obj(assembles, wa * amips_w, envelope.get(), we * envelope_w);
+            Vector2d x = m.smoothing_position(vid);
+            fixed_newton_minimize(obj, x);
+            m.set_smoothing_position(vid, x);
+            return;
+        }
+
+        if (!solver) {
+            solver = create_basic_solver();
+        }
+        if (!amips_energy) {
+            amips_energy = std::make_shared<AMIPSEnergy2D>(assembles, amips_w);
+        }
+        std::shared_ptr<polysolve::nonlinear::Problem> total_energy = amips_energy;
+        if (we > 0 || wa != 1) {
+            if (!envelope_energy) {
+                envelope_energy = std::make_shared<ExactDistanceEnergy2D>(envelope, envelope_w);
+            }
+            auto sum = std::make_shared<EnergySum>();
+            if (wa > 0) sum->add_energy(amips_energy, wa);
+            if (we > 0) sum->add_energy(envelope_energy, we);
+            total_energy = sum;
+        }
+
+        VectorXd x = m.smoothing_position(vid);
+        try {
+            solver->minimize(*total_energy, x);
+        } catch (const std::exception&) {
+            // A failed line search is reported by throwing; the position reached is still
+            // the best found, and the checks below decide whether to keep it.
+        }
+        m.set_smoothing_position(vid, Vector2d(x));
+    };
+
     if (envelope && opts.smoothing_mode == SmoothVertexOptions::SmoothingMode::Projected) {
         const Vector2d x_orig = m.smoothing_position(vid);
-        total_energy = amips_energy;
-        solve();
+        solve(1, 0);
         const Vector2d x_new = m.smoothing_position(vid);
 
-        // set_smoothing_position keeps the rational position in step, which the exact
-        // is_inverted below depends on.
+        // Only rounded vertices are smoothed, so the position set here is the exact one the
+        // is_inverted below reads.
         const auto worst_at = [&](const Vector2d& p) {
             m.set_smoothing_position(vid, p);
             double mq = 0.;
@@ -547,24 +594,14 @@ bool smooth_vertex_2d(
             return false;
         }
     } else if (envelope) {
-        auto envelope_energy =
-            std::make_shared<ExactDistanceEnergy2D>(envelope, opts.s_envelope * opts.w_envelope);
-
         if (opts.two_stage) {
-            auto warmup = std::make_shared<EnergySum>();
-            if (opts.w_amips > 0) warmup->add_energy(amips_energy, 1. / opts.w_amips);
-            if (opts.w_envelope > 0) warmup->add_energy(envelope_energy, 1. / opts.w_envelope);
-            total_energy = warmup;
-            solve();
+            solve(
+                opts.w_amips > 0 ? 1. / opts.w_amips : 0.,
+                opts.w_envelope > 0 ? 1. / opts.w_envelope : 0.);
         }
-
-        auto weighted = std::make_shared<EnergySum>();
-        if (opts.w_amips > 0) weighted->add_energy(amips_energy);
-        if (opts.w_envelope > 0) weighted->add_energy(envelope_energy);
-        total_energy = weighted;
-        solve();
+        solve(opts.w_amips > 0 ? 1. : 0., opts.w_envelope > 0 ? 1. : 0.);
     } else {
-        solve();
+        solve(1, 0);
     }
 
     // Per-vertex positional constraint, on top of the envelope. A mesh uses this to pin a
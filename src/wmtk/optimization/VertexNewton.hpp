@@ -0,0 +1,236 @@
+#pragma once
+
+#include <wmtk/Types.hpp>
+#include <wmtk/envelope/Envelope.hpp>
+#include <wmtk/utils/AMIPSBatch.h>
+#include <wmtk/utils/orient.hpp>
+
+#include <Eigen/Cholesky>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace wmtk::optimization {
+
+/**
+ * @brief The smoothing objective of one vertex, AMIPS plus the exact envelope distance, in
+ * fixed-size Eigen types.
+ *
+ * The same energy the polysolve path assembles from AMIPSEnergy2D/3D, ExactDistanceEnergy2D/3D
+ * and EnergySum, without the problem objects around it: those hand a 2- or 3-variable problem
+ * through dynamically sized vectors and matrices and a virtual call per term, and for a single
+ * vertex that bookkeeping costs more than the AMIPS evaluations it wraps.
+ *
+ * The cells are held by reference, not copied; they must outlive the objective. Each cell has
+ * the moving vertex first, exactly as AMIPSEnergy expects them.
+ */
+template <int N>
+class VertexObjective
+{
+    static_assert(N == 2 || N == 3, "a vertex objective is 2D or 3D");
+
+public:
+    using Vec = Eigen::Matrix<double, N, 1>;
+    using Mat = Eigen::Matrix<double, N, N>;
+    using Cell = std::array<double, N*(N + 1)>;
+
+    /// `envelope` may be null, or its weight 0, for a vertex with no envelope term.
+    VertexObjective(
+        const std::vector<Cell>& cells,
+        const double amips_weight,
+        const SampleEnvelope* envelope = nullptr,
+        const double envelope_weight = 0)
+        : m_cells(cells)
+        , m_amips_weight(amips_weight)
+        , m_envelope(envelope_weight > 0 ? envelope : nullptr)
+        , m_envelope_weight(envelope_weight)
+    {}
+
+    double value(const Vec& x) const
+    {
+        double res = 0;
+        if (m_amips_weight > 0) {
+            res = m_amips_weight * amips_one_ring(m_cells, x, nullptr, nullptr);
+        }
+        if (m_envelope) {
+            res += m_envelope_weight * m_envelope->squared_distance(x);
+        }
+        return res;
+    }
+
+    /// Gradient and Hessian together: the envelope term gets both from one feature query.
+    void derivatives(const Vec& x, Vec& g, Mat& H) const
+    {
+        g.setZero();
+        H.setZero();
+        if (m_amips_weight > 0) {
+            amips_one_ring(m_cells, x, &g, &H);
+            g *= m_amips_weight;
+            H *= m_amips_weight;
+        }
+        if (m_envelope) {
+            envelope_derivatives(x, g, H);
+        }
+    }
+
+    /// The pole guard of AMIPSEnergy::is_step_valid: no step may invert an incident cell.
+    bool is_step_valid(const Vec& x) const
+    {
+        for (const Cell& c : m_cells) {
+            if (!cell_is_positive(x, c)) return false;
+        }
+        return true;
+    }
+
+private:
+    static double amips_one_ring(
+        const std::vector<std::array<double, 12>>& cells,
+        const Vector3d& x,
+        Vector3d* g,
+        Matrix3d* H)
+    {
+        return AMIPS_one_ring(cells, x, g, H);
+    }
+    static double amips_one_ring(
+        const std::vector<std::array<double, 6>>& cells,
+        const Vector2d& x,
+        Vector2d* g,
+        Matrix2d* H)
+    {
+        return AMIPS2D_one_ring(cells, x, g, H);
+    }
+
+    static bool cell_is_positive(const Vector3d& x, const std::array<double, 12>& c)
+    {
+        return utils::orient3d(
+            x,
+            Vector3d(c[3], c[4], c[5]),
+            Vector3d(c[6], c[7], c[8]),
+            Vector3d(c[9], c[10], c[11]));
+    }
+    static bool cell_is_positive(const Vector2d& x, const std::array<double, 6>& c)
+    {
+        return utils::orient2d(x, Vector2d(c[2], c[3]), Vector2d(c[4], c[5]));
+    }
+
+    // Same Hessians as ExactDistanceEnergy2D/3D, see there for the case analysis.
+    void envelope_derivatives(const Vector3d& x, Vector3d& g, Matrix3d& H) const
+    {
+        Vector3d n, dir;
+        int dim = -1;
+        long long feature_id = -1;
+        m_envelope->nearest_point_feature(x, n, dim, dir, feature_id);
+        const double w2 = 2.0 * m_envelope_weight;
+        g += w2 * (x - n);
+        if (dim == 2) {
+            H += w2 * (dir * dir.transpose());
+        } else if (dim == 1) {
+            H += w2 * (Matrix3d::Identity() - dir * dir.transpose());
+        } else {
+            H += w2 * Matrix3d::Identity();
+        }
+    }
+    void envelope_derivatives(const Vector2d& x, Vector2d& g, Matrix2d& H) const
+    {
+        Vector2d n, seg_normal;
+        bool on_corner = false;
+        int feature_id = -1;
+        m_envelope->nearest_point_feature(x, n, on_corner, seg_normal, feature_id);
+        const double w2 = 2.0 * m_envelope_weight;
+        g += w2 * (x - n);
+        if (on_corner) {
+            H += w2 * Matrix2d::Identity();
+        } else {
+            H += w2 * (seg_normal * seg_normal.transpose());
+        }
+    }
+
+    const std::vector<Cell>& m_cells;
+    double m_amips_weight;
+    const SampleEnvelope* m_envelope;
+    double m_envelope_weight;
+};
+
+/**
+ * @brief Stopping and line-search parameters of fixed_newton_minimize.
+ *
+ * The defaults are those of create_basic_solver (10 iterations, DenseNewton's gradient and
+ * Armijo tolerances), so that switching the solver changes the cost of a smoothing pass and
+ * not where it puts the vertices.
+ */
+struct NewtonOptions
+{
+    int max_iterations = 10;
+    double grad_norm_tol = 1e-8;
+    double armijo_c = 1e-4;
+    double step_ratio = 0.5;
+    double min_step = 1e-10;
+};
+
+/**
+ * @brief Damped Newton on a VertexObjective, entirely on the stack.
+ *
+ * Follows polysolve's DenseNewton: an LDLT solve of the N x N system, falling back to a
+ * regularized Hessian and then to steepest descent when the Newton direction is not a descent
+ * direction, and a backtracking Armijo line search that also refuses any step the objective
+ * reports as invalid (an inverted cell) or that yields a non-finite energy. A failed line
+ * search stops the iteration, as it does in polysolve, and `x` keeps the last accepted point.
+ *
+ * @return the number of accepted steps.
+ */
+template <int N>
+int fixed_newton_minimize(
+    const VertexObjective<N>& obj,
+    typename VertexObjective<N>::Vec& x,
+    const NewtonOptions& opts = {})
+{
+    using Vec = typename VertexObjective<N>::Vec;
+    using Mat = typename VertexObjective<N>::Mat;
+
+    double f = obj.value(x);
+    if (!std::isfinite(f)) return 0;
+
+    Vec g;
+    Mat H;
+    int it = 0;
+    for (; it < opts.max_iterations; ++it) {
+        obj.derivatives(x, g, H);
+        if (!g.allFinite() || g.norm() <= opts.grad_norm_tol) break;
+
+        Vec dir;
+        bool descent = false;
+        Eigen::LDLT<Mat> ldlt(H);
+        if (ldlt.info() == Eigen::Success) {
+            dir = -ldlt.solve(g);
+            descent = dir.allFinite() && dir.dot(g) < 0;
+        }
+        // Indefinite or singular: shift the spectrum until the step descends.
+        for (double reg = 1e-8; !descent && reg <= 1e8; reg *= 10) {
+            ldlt.compute(H + reg * Mat::Identity());
+            if (ldlt.info() != Eigen::Success) continue;
+            dir = -ldlt.solve(g);
+            descent = dir.allFinite() && dir.dot(g) < 0;
+        }
+        if (!descent) dir = -g;
+
+        const double slope = dir.dot(g);
+        bool stepped = false;
+        for (double t = 1; t >= opts.min_step; t *= opts.step_ratio) {
+            const Vec x1 = x + t * dir;
+            if (!obj.is_step_valid(x1)) continue;
+            const double f1 = obj.value(x1);
+            if (std::isfinite(f1) && f1 <= f + opts.armijo_c * t * slope) {
+                x = x1;
+                f = f1;
+                stepped = true;
+                break;
+            }
+        }
+        if (!stepped) break;
+    }
+    return it;
+}
+
+} // namespace wmtk::optimization
@@ -18,6 +18,9 @@
 //    safe).
 //  * enumerable_thread_specific is lock-free on the hot path: each thread keeps a
 //    small thread_local list of (instance-id -> value) slots.
+//  * task_group and parallel_for run on one process-wide thread_pool instead of
+//    creating threads per call; a parallel_for issued from inside a pool task runs
+//    inline.
 
 #include "collector.hpp"
 #include "concurrent_map.hpp"
@@ -28,5 +31,7 @@
 #include "range.hpp"
 #include "serial_priority_queue.hpp"
 #include "spin_mutex.hpp"
+#include "stealable_priority_queue.hpp"
 #include "task_group.hpp"
+#include "thread_pool.hpp"
 #include "vertex_mutex.hpp"
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <wmtk/threading/dary_heap.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace wmtk::threading {
+
+// ---------------------------------------------------------------------------
+// bucket_priority_queue: a max-priority queue that only orders by a quantized priority.
+//
+// Priorities are cut into buckets of relative width 2^-bits -- `bits` leading mantissa bits of
+// the double, so a bucket is [x, x * (1 + 2^-bits)) at every scale and of either sign -- and
+// pop returns some element of the highest non-empty bucket: the one pushed last. Pushing is a
+// lookup among the non-empty buckets (a handful: an edge-length pass spans a few octaves) and
+// an append; popping is a pop_back. Neither moves an element more than once.
+//
+// The price is the order. Within a bucket it is LIFO, so the queue is only right to within a
+// bucket's width, and the tie-breaks that make a heap's order total (op, then the Tuple) are
+// not applied at all. That is fine for a pass that processes "longest first" as a heuristic --
+// edge split and collapse -- and wrong for one whose result depends on the exact order. Still
+// deterministic: the same pushes give the same pops.
+//
+// `KeyOf(const T&)` returns a heap_key, of which only the priority is used, so the same KeyOf
+// serves keyed_dary_heap. Not synchronized.
+// ---------------------------------------------------------------------------
+template <typename T, typename KeyOf>
+class bucket_priority_queue
+{
+    struct Bucket
+    {
+        int64_t id;
+        std::vector<T> items;
+    };
+
+    // Non-empty buckets, ascending, so the top is at the back.
+    std::vector<Bucket> m_buckets;
+    // Storage of emptied buckets, so that a bucket coming and going does not reallocate.
+    std::vector<std::vector<T>> m_spare;
+    size_t m_size = 0;
+    int m_shift = 52 - 4;
+    KeyOf m_key_of;
+
+    /// Monotone in the priority: the bit pattern made to order like the double, then truncated.
+    int64_t bucket_of(const double p) const
+    {
+        int64_t bits;
+        std::memcpy(&bits, &p, sizeof(bits));
+        // Negative doubles order backwards in their bit pattern; flip their magnitude bits.
+        bits ^= (bits >> 63) & INT64_MAX;
+        return bits >> m_shift; // arithmetic shift: floor, so still monotone
+    }
+
+public:
+    bucket_priority_queue() = default;
+
+    /// Leading mantissa bits a bucket is cut at, 0..52. Only while empty.
+    void set_bits(const int bits) { m_shift = 52 - std::clamp(bits, 0, 52); }
+
+    void push(T v)
+    {
+        const int64_t id = bucket_of(m_key_of(v).priority);
+        if (m_buckets.empty() || m_buckets.back().id < id) {
+            m_buckets.push_back(Bucket{id, take_spare()});
+            m_buckets.back().items.push_back(std::move(v));
+        } else if (m_buckets.back().id == id) {
+            m_buckets.back().items.push_back(std::move(v));
+        } else {
+            auto it = std::lower_bound(
+                m_buckets.begin(),
+                m_buckets.end(),
+                id,
+                [](const Bucket& b, const int64_t i) { return b.id < i; });
+            if (it == m_buckets.end() || it->id != id) {
+                it = m_buckets.insert(it, Bucket{id, take_spare()});
+            }
+            it->items.push_back(std::move(v));
+        }
+        ++m_size;
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        push(T(std::forward<Args>(args)...));
+    }
+
+    const T& top() const { return m_buckets.back().items.back(); }
+
+    void pop()
+    {
+        auto& items = m_buckets.back().items;
+        items.pop_back();
+        --m_size;
+        if (items.empty()) {
+            m_spare.push_back(std::move(items));
+            m_buckets.pop_back();
+        }
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+private:
+    std::vector<T> take_spare()
+    {
+        if (m_spare.empty()) return {};
+        std::vector<T> v = std::move(m_spare.back());
+        m_spare.pop_back();
+        return v;
+    }
+};
+
+} // namespace wmtk::threading
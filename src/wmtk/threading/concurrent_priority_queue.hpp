@@ -2,24 +2,33 @@
 
 #include <mutex>
 #include <queue>
+#include <utility>
+#include <vector>
 
 namespace wmtk::threading {
 // ---------------------------------------------------------------------------
 // concurrent_priority_queue: replaces tbb::concurrent_priority_queue.
 // Max-heap by default, matching TBB. std::priority_queue + mutex.
 // Non-movable (holds a mutex); constructed in place inside std::vector(count).
+// `Heap` is the container underneath; see stealable_priority_queue.
 // ---------------------------------------------------------------------------
-template <typename T, typename Compare = std::less<T>>
+template <
+    typename T,
+    typename Compare = std::less<T>,
+    typename Heap = std::priority_queue<T, std::vector<T>, Compare>>
 class concurrent_priority_queue
 {
     mutable std::mutex m_mutex;
-    std::priority_queue<T, std::vector<T>, Compare> m_queue;
+    Heap m_queue;
 
 public:
     concurrent_priority_queue() = default;
     concurrent_priority_queue(const concurrent_priority_queue&) = delete;
     concurrent_priority_queue& operator=(const concurrent_priority_queue&) = delete;
 
+    /// The heap itself, to configure it. Unsynchronized: before any other thread can see it.
+    Heap& heap() { return m_queue; }
+
     bool try_pop(T& out)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace wmtk::threading {
+
+/// The leading part of an element's order, kept in the heap itself. See keyed_dary_heap.
+struct heap_key
+{
+    double priority;
+    uint32_t tag;
+
+    bool operator<(const heap_key& o) const
+    {
+        return priority < o.priority || (!(o.priority < priority) && tag < o.tag);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// keyed_dary_heap: a max-heap with std::priority_queue's interface and pop order, laid out for
+// the cache.
+//
+// The scheduler's queue elements are (priority, op, Tuple, retries) -- 48 bytes with a TetMesh
+// Tuple -- and a binary heap moves a whole one per level on every sift. Here the heap holds
+// only a 16-byte node, the element's (priority, tag) key and the index of a slot holding the
+// element itself, and the elements stay put in the slot array until popped. Four children per
+// node halves the depth against a binary heap, and the four children of a node are adjacent,
+// one cache line, so the extra compares per level are compares on data already loaded.
+//
+// `KeyOf(const T&)` must return a heap_key consistent with Compare: key(a) < key(b) implies
+// Compare(a, b). Elements with equal keys are ordered by Compare on the elements themselves, so
+// for a strict total order -- which the scheduler's elements have, the Tuple breaking every
+// tie -- the pop sequence is exactly std::priority_queue's.
+//
+// Not synchronized; the wrappers in this directory add that.
+// ---------------------------------------------------------------------------
+template <typename T, typename KeyOf, typename Compare = std::less<T>, size_t Arity = 4>
+class keyed_dary_heap
+{
+    static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+    // The key as two integers: the priority's bit pattern made to order like the double (see
+    // ordered_bits), and the tag. Integer compares are what keep the sifts branch-light.
+    struct Node
+    {
+        uint64_t priority;
+        uint32_t tag;
+        uint32_t slot;
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<T> m_slots;
+    std::vector<uint32_t> m_free; // slots whose element has been popped
+    KeyOf m_key_of;
+    Compare m_less;
+
+    static uint64_t ordered_bits(double p)
+    {
+        p += 0.; // -0 to +0: the two compare equal as doubles and have to here as well
+        uint64_t bits;
+        std::memcpy(&bits, &p, sizeof(bits));
+        // Flip every bit of a negative double and only the sign bit of a positive one: the
+        // unsigned order is then the double order.
+        return bits ^ (uint64_t(int64_t(bits) >> 63) | (uint64_t(1) << 63));
+    }
+
+    bool less(const Node& a, const Node& b) const
+    {
+        if (a.priority != b.priority) return a.priority < b.priority;
+        if (a.tag != b.tag) return a.tag < b.tag;
+        return m_less(m_slots[a.slot], m_slots[b.slot]);
+    }
+
+    uint32_t store(T&& v)
+    {
+        if (m_free.empty()) {
+            m_slots.push_back(std::move(v));
+            return uint32_t(m_slots.size() - 1);
+        }
+        const uint32_t s = m_free.back();
+        m_free.pop_back();
+        m_slots[s] = std::move(v);
+        return s;
+    }
+
+    void sift_up(size_t i, const Node n)
+    {
+        while (i > 0) {
+            const size_t parent = (i - 1) / Arity;
+            if (!less(m_nodes[parent], n)) break;
+            m_nodes[i] = m_nodes[parent];
+            i = parent;
+        }
+        m_nodes[i] = n;
+    }
+
+    /// Remove the root: walk the hole down along the larger children to a leaf, then put the
+    /// last node there and sift it up. The last node almost always belongs near the bottom, so
+    /// this saves the compare against it at every level that a plain sift-down makes.
+    void pop_root()
+    {
+        const Node last = m_nodes.back();
+        m_nodes.pop_back();
+        const size_t size = m_nodes.size();
+        if (size == 0) return;
+        size_t i = 0;
+        for (;;) {
+            const size_t first = Arity * i + 1;
+            if (first >= size) break;
+            const size_t end = first + Arity < size ? first + Arity : size;
+            size_t best = first;
+            for (size_t c = first + 1; c < end; ++c) {
+                if (less(m_nodes[best], m_nodes[c])) best = c;
+            }
+            m_nodes[i] = m_nodes[best];
+            i = best;
+        }
+        sift_up(i, last);
+    }
+
+public:
+    keyed_dary_heap() = default;
+
+    void push(T v)
+    {
+        const heap_key key = m_key_of(v);
+        const Node n{ordered_bits(key.priority), key.tag, store(std::move(v))};
+        m_nodes.push_back(n);
+        sift_up(m_nodes.size() - 1, n);
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        push(T(std::forward<Args>(args)...));
+    }
+
+    const T& top() const { return m_slots[m_nodes.front().slot]; }
+
+    void pop()
+    {
+        m_free.push_back(m_nodes.front().slot);
+        pop_root();
+        if (m_nodes.empty()) {
+            // Nothing refers to a slot any more; start the slot array over rather than let it
+            // keep the high-water mark's worth of free list.
+            m_slots.clear();
+            m_free.clear();
+        }
+    }
+
+    size_t size() const { return m_nodes.size(); }
+    bool empty() const { return m_nodes.empty(); }
+};
+
+} // namespace wmtk::threading
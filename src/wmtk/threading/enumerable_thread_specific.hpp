@@ -2,7 +2,11 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -18,8 +22,14 @@ inline std::atomic<std::uint64_t>& ets_id_counter()
 
 // ---------------------------------------------------------------------------
 // enumerable_thread_specific: replaces tbb::enumerable_thread_specific.
-// Only `.local()` (and construction with an optional initial value) is used.
-// Lock-free lookup: each thread owns a thread_local vector of slots.
+// `.local()`, construction with an optional initial value, and iteration over every
+// thread's value. Lock-free lookup: each thread owns a thread_local vector of slots.
+//
+// The values belong to the instance, not to the threads: the threads are the
+// thread_pool's and live as long as the process, so a value that died with its
+// thread would outlive every mesh that created it. A slot holds a pointer to the
+// value plus a weak token of its instance; slots of destroyed instances are swept
+// from a thread's list the next time that thread creates a slot.
 // ---------------------------------------------------------------------------
 template <typename T>
 class enumerable_thread_specific
@@ -27,7 +37,8 @@ class enumerable_thread_specific
     struct Slot
     {
         std::uint64_t id;
-        std::unique_ptr<T> value;
+        T* value;
+        std::weak_ptr<void> alive;
     };
 
     static std::vector<Slot>& thread_slots()
@@ -38,6 +49,9 @@ class enumerable_thread_specific
 
     std::uint64_t m_id = detail::ets_id_counter().fetch_add(1, std::memory_order_relaxed);
     std::function<T()> m_factory;
+    std::shared_ptr<void> m_alive = std::make_shared<char>(0);
+    std::mutex m_values_mutex;
+    std::deque<T> m_values; // one per thread that has called local(); deque keeps them in place
 
 public:
     enumerable_thread_specific()
@@ -56,19 +70,6 @@ public:
     enumerable_thread_specific(enumerable_thread_specific&&) = delete;
     enumerable_thread_specific& operator=(enumerable_thread_specific&&) = delete;
 
-    ~enumerable_thread_specific()
-    {
-        // Clear this (usually the main) thread's slot for this instance. Worker
-        // threads are ephemeral in this shim, so their slots die with them.
-        auto& slots = thread_slots();
-        slots.erase(
-            std::remove_if(
-                slots.begin(),
-                slots.end(),
-                [this](const Slot& s) { return s.id == m_id; }),
-            slots.end());
-    }
-
     T& local()
     {
         auto& slots = thread_slots();
@@ -77,10 +78,28 @@ public:
                 return *s.value;
             }
         }
-        // No slot for this thread yet, create one.
-        slots.push_back(Slot{m_id, std::make_unique<T>(m_factory())});
-        return *slots.back().value;
+        // No slot for this thread yet, create one -- and drop those of dead instances while
+        // we are here, which is rare enough that the scan costs nothing.
+        slots.erase(
+            std::remove_if(
+                slots.begin(),
+                slots.end(),
+                [](const Slot& s) { return s.alive.expired(); }),
+            slots.end());
+        T* value;
+        {
+            std::lock_guard<std::mutex> lock(m_values_mutex);
+            value = &m_values.emplace_back(m_factory());
+        }
+        slots.push_back(Slot{m_id, value, m_alive});
+        return *value;
     }
+
+    // Every value created so far, one per thread that has called local(). As with tbb's,
+    // iterating is only safe while no thread can be creating its value.
+    using iterator = typename std::deque<T>::iterator;
+    iterator begin() { return m_values.begin(); }
+    iterator end() { return m_values.end(); }
 };
 
-} // namespace wmtk::threading
\ No newline at end of file
+} // namespace wmtk::threading
@@ -1,9 +1,20 @@
 #include "parallel_for.hpp"
 
+#include "task_group.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
 #include <thread>
 
 namespace wmtk::threading {
 
+std::size_t resolve_num_threads(int num_threads)
+{
+    return num_threads >= 0 ? static_cast<std::size_t>(num_threads)
+                            : std::thread::hardware_concurrency();
+}
+
 void parallel_for(
     const range& range,
     std::function<void(const threading::range&)>&& func,
@@ -15,50 +26,94 @@ void parallel_for(
 
     const std::size_t total = range.size();
 
-    const unsigned hw = std::thread::hardware_concurrency();
-    int requested = num_threads;
-    std::size_t nthreads = requested >= 0 ? static_cast<std::size_t>(requested) : hw;
-    nthreads = std::min<std::size_t>(nthreads, total);
-    if (nthreads <= 1) {
+    const std::size_t grain = range.grainsize();
+    const std::size_t n_chunks = grain > 0 ? (total + grain - 1) / grain : total;
+    const std::size_t nthreads = std::min(resolve_num_threads(num_threads), n_chunks);
+    // Already on one of the pool's threads -- inside a task, or a chunk of an enclosing
+    // parallel_for -- so every worker may be busy with the enclosing loop. Queueing more would
+    // only oversubscribe; run the whole range here.
+    if (nthreads <= 1 || thread_pool::in_task()) {
         func(range);
         return;
     }
 
+    const size_t begin = range.begin();
+
+    if (grain > 0) {
+        // Dynamic: every thread, the caller included, claims the next `grain` elements until
+        // none are left. One fetch_add per chunk, so a grainsize of a few hundred makes the
+        // counter free.
+        std::atomic<std::size_t> next(0);
+        const auto drain = [&]() {
+            for (;;) {
+                const std::size_t cb = next.fetch_add(grain, std::memory_order_relaxed);
+                if (cb >= total) {
+                    return;
+                }
+                const std::size_t ce = std::min(total, cb + grain);
+                func(threading::range(begin + cb, begin + ce, grain));
+            }
+        };
+        std::exception_ptr eptr;
+        {
+            task_group tg;
+            for (std::size_t t = 0; t + 1 < nthreads; ++t) {
+                tg.run(drain);
+            }
+            try {
+                thread_pool::task_scope scope;
+                drain();
+            } catch (...) {
+                eptr = std::current_exception();
+                next.store(total); // the others stop at their next chunk
+            }
+            try {
+                tg.wait();
+            } catch (...) {
+                if (!eptr) {
+                    eptr = std::current_exception();
+                }
+            }
+        }
+        if (eptr) {
+            std::rethrow_exception(eptr);
+        }
+        return;
+    }
+
     const std::size_t chunk = (total + nthreads - 1) / nthreads;
 
+    // Chunks go to the shared pool; the last one runs here. The caller counts as one of the
+    // threads, so the pool only needs nthreads - 1 workers for the chunks to run at once.
     std::exception_ptr eptr;
-    std::mutex eptr_mutex;
-    auto run = [&](size_t cb, size_t ce) {
+    {
+        task_group tg;
+        std::size_t offset = 0;
+        for (std::size_t t = 0; t < nthreads && offset < total; ++t) {
+            const std::size_t cb = offset;
+            const std::size_t ce = std::min(total, offset + chunk);
+            offset = ce;
+            const size_t rb = begin + static_cast<size_t>(cb);
+            const size_t re = begin + static_cast<size_t>(ce);
+            if (t + 1 == nthreads || offset >= total) {
+                // run the last chunk on the calling thread
+                try {
+                    thread_pool::task_scope scope;
+                    func(threading::range(rb, re));
+                } catch (...) {
+                    eptr = std::current_exception();
+                }
+            } else {
+                tg.run([&func, rb, re]() { func(threading::range(rb, re)); });
+            }
+        }
         try {
-            func(threading::range(cb, ce));
+            tg.wait();
         } catch (...) {
-            std::lock_guard<std::mutex> lock(eptr_mutex);
             if (!eptr) {
                 eptr = std::current_exception();
             }
         }
-    };
-
-    const size_t begin = range.begin();
-
-    std::vector<std::thread> workers;
-    workers.reserve(nthreads - 1);
-    std::size_t offset = 0;
-    for (std::size_t t = 0; t < nthreads && offset < total; ++t) {
-        const std::size_t cb = offset;
-        const std::size_t ce = std::min(total, offset + chunk);
-        offset = ce;
-        const size_t rb = begin + static_cast<size_t>(cb);
-        const size_t re = begin + static_cast<size_t>(ce);
-        if (t + 1 == nthreads || offset >= total) {
-            // run the last chunk on the calling thread
-            run(rb, re);
-        } else {
-            workers.emplace_back([&run, rb, re]() { run(rb, re); });
-        }
-    }
-    for (auto& w : workers) {
-        w.join();
     }
 
     if (eptr) {
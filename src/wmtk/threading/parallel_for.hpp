@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <exception>
 #include <functional>
+#include <iterator>
 #include <mutex>
+#include <vector>
 
 #include "range.hpp"
 
@@ -12,10 +16,134 @@ namespace wmtk::threading {
 // parallel_for: replaces tbb::parallel_for.
 // The thread count is an explicit argument: `num_threads >= 0` runs on that many
 // threads, anything else (`num_threads` is negative) falls back to hardware_concurrency().
+//
+// How the range is split depends on its grainsize. Without one (the default), it is
+// cut into one equal chunk per thread and `func` is called once per thread. With
+// one, the threads instead claim chunks of `grainsize` elements from a shared
+// counter until the range is used up, so a thread that drew cheap elements goes
+// back for more instead of idling while another works through expensive ones.
+// Give loops with uneven per-element cost -- BVH queries, loops that skip removed
+// cells -- a grainsize of a few hundred elements; leave it off uniform loops, where
+// a static split has nothing to lose.
 // ---------------------------------------------------------------------------
 void parallel_for(
     const range& range,
     std::function<void(const threading::range&)>&& func,
     int num_threads = -1);
 
-} // namespace wmtk::threading
\ No newline at end of file
+/// The number of threads parallel_for would use for @p num_threads, before capping it by the
+/// size of the range.
+std::size_t resolve_num_threads(int num_threads);
+
+// ---------------------------------------------------------------------------
+// parallel_reduce: replaces tbb::parallel_reduce.
+//
+// `func(subrange, identity)` reduces one chunk; `reduction(a, b)` combines two partial
+// results. The chunks are those parallel_for would make, and the partial results are
+// combined left to right in range order whatever order the chunks finished in, so the
+// result depends on the thread count and grainsize but never on timing. `reduction`
+// therefore need only be associative, not commutative.
+// ---------------------------------------------------------------------------
+template <typename T, typename Func, typename Reduction>
+T parallel_reduce(
+    const range& range,
+    const T& identity,
+    Func&& func,
+    Reduction&& reduction,
+    int num_threads = -1)
+{
+    if (range.empty()) {
+        return identity;
+    }
+    const std::size_t total = range.size();
+    std::size_t grain = range.grainsize();
+    if (grain == 0) {
+        const std::size_t nthreads = std::max<std::size_t>(1, resolve_num_threads(num_threads));
+        grain = (total + nthreads - 1) / nthreads;
+    }
+    const std::size_t n_chunks = (total + grain - 1) / grain;
+    std::vector<T> partial(n_chunks, identity);
+    // One index per chunk; dynamic when the caller asked for a grainsize, static otherwise.
+    parallel_for(
+        threading::range(0, n_chunks, range.grainsize() > 0 ? 1 : 0),
+        [&](const threading::range& chunks) {
+            for (std::size_t c = chunks.begin(); c < chunks.end(); ++c) {
+                const std::size_t b = range.begin() + c * grain;
+                const std::size_t e = std::min(range.end(), b + grain);
+                partial[c] = func(threading::range(b, e), identity);
+            }
+        },
+        num_threads);
+
+    T result = std::move(partial[0]);
+    for (std::size_t c = 1; c < n_chunks; ++c) {
+        result = reduction(std::move(result), std::move(partial[c]));
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// parallel_sort: replaces tbb::parallel_sort.
+//
+// Sorts one block per thread, then merges neighbouring blocks pairwise, each level of
+// merges in parallel. Like std::sort it is not stable: equal elements may come out in
+// a different order than std::sort would put them, so compare on a key that is unique
+// (a cell id, say) wherever the output order matters. Small inputs are sorted serially.
+// ---------------------------------------------------------------------------
+template <typename RandomIt, typename Compare>
+void parallel_sort(RandomIt first, RandomIt last, Compare comp, int num_threads = -1)
+{
+    constexpr std::size_t serial_cutoff = 1 << 14;
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    // No block smaller than a quarter of the cutoff: below that, the merges cost more than the
+    // parallel sort saves.
+    const std::size_t nthreads =
+        std::min(resolve_num_threads(num_threads), n / (serial_cutoff / 4));
+    if (n < serial_cutoff || nthreads <= 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    // Block boundaries; block i is [bounds[i], bounds[i + 1]).
+    std::vector<std::size_t> bounds(nthreads + 1);
+    for (std::size_t i = 0; i <= nthreads; ++i) {
+        bounds[i] = n * i / nthreads;
+    }
+    parallel_for(
+        threading::range(0, nthreads),
+        [&](const threading::range& r) {
+            for (std::size_t i = r.begin(); i < r.end(); ++i) {
+                std::sort(first + bounds[i], first + bounds[i + 1], comp);
+            }
+        },
+        int(nthreads));
+
+    for (std::size_t width = 1; width < nthreads; width *= 2) {
+        const std::size_t n_merges = (nthreads + 2 * width - 1) / (2 * width);
+        parallel_for(
+            threading::range(0, n_merges),
+            [&](const threading::range& r) {
+                for (std::size_t k = r.begin(); k < r.end(); ++k) {
+                    const std::size_t lo = 2 * width * k;
+                    const std::size_t mid = std::min(lo + width, nthreads);
+                    const std::size_t hi = std::min(lo + 2 * width, nthreads);
+                    if (mid < hi) {
+                        std::inplace_merge(
+                            first + bounds[lo],
+                            first + bounds[mid],
+                            first + bounds[hi],
+                            comp);
+                    }
+                }
+            },
+            int(n_merges));
+    }
+}
+
+template <typename RandomIt>
+void parallel_sort(RandomIt first, RandomIt last, int num_threads = -1)
+{
+    parallel_sort(first, last, std::less<>(), num_threads);
+}
+
+} // namespace wmtk::threading
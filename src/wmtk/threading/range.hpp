@@ -6,20 +6,27 @@ namespace wmtk::threading {
 
 // ---------------------------------------------------------------------------
 // range: replaces tbb::range.
+//
+// A grainsize of 0, the default, leaves the split to parallel_for: one equal chunk
+// per thread. A positive grainsize asks for chunks of that many elements handed out
+// dynamically, for loops whose per-element cost varies -- see parallel_for.
 // ---------------------------------------------------------------------------
 class range
 {
     size_t m_begin, m_end;
+    size_t m_grainsize;
 
 public:
-    range(size_t begin, size_t end, std::size_t /*grainsize*/ = 1)
+    range(size_t begin, size_t end, std::size_t grainsize = 0)
         : m_begin(begin)
         , m_end(end)
+        , m_grainsize(grainsize)
     {}
     size_t begin() const { return m_begin; }
     size_t end() const { return m_end; }
+    std::size_t grainsize() const { return m_grainsize; }
     bool empty() const { return !(m_begin < m_end); }
     std::size_t size() const { return static_cast<std::size_t>(m_end - m_begin); }
 };
 
-} // namespace wmtk::threading
\ No newline at end of file
+} // namespace wmtk::threading
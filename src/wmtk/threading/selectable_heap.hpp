@@ -0,0 +1,100 @@
+#pragma once
+
+#include <wmtk/threading/bucket_priority_queue.hpp>
+#include <wmtk/threading/dary_heap.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace wmtk::threading {
+
+/// Which priority queue a scheduler pass keeps its elements in. See ExecutePass::queue_kind.
+enum class QueueKind {
+    kBinaryHeap, ///< std::priority_queue
+    kDaryHeap, ///< keyed_dary_heap: the same order, fewer bytes moved
+    kBucketed, ///< bucket_priority_queue: order only to within a bucket
+};
+
+// ---------------------------------------------------------------------------
+// selectable_heap: one of the heaps above, picked at run time.
+//
+// The queue wrappers (stealable_priority_queue, concurrent_priority_queue) take their heap as a
+// template parameter, and the scheduler hands them this one so that the choice can be made per
+// pass without compiling the pass once per heap. The switch on every call is the same branch
+// every time within a pass, so it predicts perfectly; the two heaps not chosen stay empty and
+// cost three pointers each.
+// ---------------------------------------------------------------------------
+template <typename T, typename KeyOf, typename Compare = std::less<T>>
+class selectable_heap
+{
+    QueueKind m_kind = QueueKind::kBinaryHeap;
+    std::priority_queue<T, std::vector<T>, Compare> m_binary;
+    keyed_dary_heap<T, KeyOf, Compare> m_dary;
+    bucket_priority_queue<T, KeyOf> m_bucketed;
+
+public:
+    /// Choose the heap, and for kBucketed its resolution. Only while empty.
+    void configure(const QueueKind kind, const int bucket_bits)
+    {
+        m_kind = kind;
+        m_bucketed.set_bits(bucket_bits);
+    }
+    QueueKind kind() const { return m_kind; }
+
+    void push(const T& v)
+    {
+        switch (m_kind) {
+        case QueueKind::kDaryHeap: m_dary.push(v); break;
+        case QueueKind::kBucketed: m_bucketed.push(v); break;
+        case QueueKind::kBinaryHeap:
+        default: m_binary.push(v); break;
+        }
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        switch (m_kind) {
+        case QueueKind::kDaryHeap: m_dary.emplace(std::forward<Args>(args)...); break;
+        case QueueKind::kBucketed: m_bucketed.emplace(std::forward<Args>(args)...); break;
+        case QueueKind::kBinaryHeap:
+        default: m_binary.emplace(std::forward<Args>(args)...); break;
+        }
+    }
+
+    const T& top() const
+    {
+        switch (m_kind) {
+        case QueueKind::kDaryHeap: return m_dary.top();
+        case QueueKind::kBucketed: return m_bucketed.top();
+        case QueueKind::kBinaryHeap:
+        default: return m_binary.top();
+        }
+    }
+
+    void pop()
+    {
+        switch (m_kind) {
+        case QueueKind::kDaryHeap: m_dary.pop(); break;
+        case QueueKind::kBucketed: m_bucketed.pop(); break;
+        case QueueKind::kBinaryHeap:
+        default: m_binary.pop(); break;
+        }
+    }
+
+    size_t size() const
+    {
+        switch (m_kind) {
+        case QueueKind::kDaryHeap: return m_dary.size();
+        case QueueKind::kBucketed: return m_bucketed.size();
+        case QueueKind::kBinaryHeap:
+        default: return m_binary.size();
+        }
+    }
+    bool empty() const { return size() == 0; }
+};
+
+} // namespace wmtk::threading
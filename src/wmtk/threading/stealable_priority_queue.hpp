@@ -0,0 +1,122 @@
+#pragma once
+
+#include <wmtk/threading/spin_mutex.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace wmtk::threading {
+// ---------------------------------------------------------------------------
+// stealable_priority_queue: a per-task queue that other tasks may take work from.
+//
+// It is a serial_priority_queue until `set_shared(true)` is called, and then every
+// access goes through a spin_mutex. The scheduler only shares the per-task queues
+// when work stealing is on; without it they stay strictly thread-private and pay
+// nothing, which is the reason serial_priority_queue exists in the first place.
+// With stealing on, the owner's lock is almost always uncontended -- a thief only
+// touches a queue once its own has run dry -- so it is one CAS per access.
+//
+// `try_steal` takes from the top, i.e. the highest-priority elements. Those are
+// the ones the owner would run next, so moving them to an idle task is what
+// shortens the owner's tail; taking the lowest-priority ones would leave the
+// critical path exactly where it was.
+//
+// `Heap` is the container underneath, anything with std::priority_queue's push/emplace/top/pop/
+// size/empty; the scheduler uses selectable_heap.
+// ---------------------------------------------------------------------------
+template <
+    typename T,
+    typename Compare = std::less<T>,
+    typename Heap = std::priority_queue<T, std::vector<T>, Compare>>
+class stealable_priority_queue
+{
+    Heap m_queue;
+    mutable spin_mutex m_mutex;
+    bool m_shared = false;
+
+    struct Guard
+    {
+        spin_mutex* m;
+        explicit Guard(spin_mutex* m_)
+            : m(m_)
+        {
+            if (m) m->lock();
+        }
+        ~Guard()
+        {
+            if (m) m->unlock();
+        }
+    };
+    Guard guard() const { return Guard(m_shared ? &m_mutex : nullptr); }
+
+public:
+    stealable_priority_queue() = default;
+    stealable_priority_queue(const stealable_priority_queue&) = delete;
+    stealable_priority_queue& operator=(const stealable_priority_queue&) = delete;
+
+    /// Must be called before any other thread can see the queue.
+    void set_shared(bool shared) { m_shared = shared; }
+    /// The heap itself, to configure it. Unsynchronized: before any other thread can see it.
+    Heap& heap() { return m_queue; }
+
+    bool try_pop(T& out)
+    {
+        const auto g = guard();
+        if (m_queue.empty()) {
+            return false;
+        }
+        out = m_queue.top();
+        m_queue.pop();
+        return true;
+    }
+
+    void push(const T& v)
+    {
+        const auto g = guard();
+        m_queue.push(v);
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        const auto g = guard();
+        m_queue.emplace(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Move up to @p max_count of the highest-priority elements into @p out.
+     *
+     * Never takes more than half of what is queued (rounded down), so a victim is not robbed of
+     * the work it is about to do and two idle tasks cannot bounce a single element between
+     * them. A queue holding fewer than two elements is not worth stealing from.
+     *
+     * @return the number of elements appended to @p out.
+     */
+    size_t try_steal(std::vector<T>& out, size_t max_count)
+    {
+        const auto g = guard();
+        size_t n = std::min(max_count, m_queue.size() / 2);
+        for (size_t i = 0; i < n; ++i) {
+            out.push_back(m_queue.top());
+            m_queue.pop();
+        }
+        return n;
+    }
+
+    std::size_t size() const
+    {
+        const auto g = guard();
+        return m_queue.size();
+    }
+    bool empty() const
+    {
+        const auto g = guard();
+        return m_queue.empty();
+    }
+};
+
+} // namespace wmtk::threading
@@ -1,20 +1,49 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <exception>
 #include <mutex>
-#include <thread>
-#include <vector>
+
+#include "thread_pool.hpp"
 
 namespace wmtk::threading {
 
 // ---------------------------------------------------------------------------
-// task_group: replaces tbb::task_group. Each run() spawns a thread; wait() joins.
+// task_group: replaces tbb::task_group. run() queues onto the shared thread_pool;
+// wait() blocks until every task run so far has finished.
+//
+// Every task still gets a thread of its own: run() grows the pool to the number
+// of this group's unfinished tasks, which is what spawning a thread per run() used
+// to guarantee. The ExecutePass tasks rely on that only for speed, not progress --
+// none of them ever waits on another.
+//
+// wait() runs queued tasks, this group's or anyone's, instead of only sleeping, so
+// a task that waits on a group of its own does not take a worker out of the pool.
 // ---------------------------------------------------------------------------
 class task_group
 {
-    std::vector<std::thread> m_threads;
     std::exception_ptr m_eptr;
-    std::mutex m_eptr_mutex;
+    std::mutex m_mutex;
+    std::condition_variable m_done;
+    std::size_t m_pending = 0;
+
+    void finish_all() noexcept
+    {
+        auto& pool = thread_pool::instance();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_pending > 0) {
+            lock.unlock();
+            const bool ran = pool.try_run_one();
+            lock.lock();
+            if (!ran && m_pending > 0) {
+                // Timed, because the task that would wake us may be sitting in the queue
+                // behind a worker that is itself waiting here.
+                m_done.wait_for(lock, std::chrono::milliseconds(1));
+            }
+        }
+    }
 
 public:
     task_group() = default;
@@ -24,26 +53,32 @@ public:
     template <typename F>
     void run(F&& f)
     {
-        m_threads.emplace_back([this, f = std::forward<F>(f)]() mutable {
+        std::size_t pending;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            pending = ++m_pending;
+        }
+        auto& pool = thread_pool::instance();
+        pool.reserve(pending);
+        pool.submit([this, f = std::forward<F>(f)]() mutable {
             try {
                 f();
             } catch (...) {
-                std::lock_guard<std::mutex> lock(m_eptr_mutex);
+                std::lock_guard<std::mutex> lock(m_mutex);
                 if (!m_eptr) {
                     m_eptr = std::current_exception();
                 }
             }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0) {
+                m_done.notify_all();
+            }
         });
     }
 
     void wait()
     {
-        for (auto& t : m_threads) {
-            if (t.joinable()) {
-                t.join();
-            }
-        }
-        m_threads.clear();
+        finish_all();
         if (m_eptr) {
             std::exception_ptr e = m_eptr;
             m_eptr = nullptr;
@@ -51,14 +86,7 @@ public:
         }
     }
 
-    ~task_group()
-    {
-        for (auto& t : m_threads) {
-            if (t.joinable()) {
-                t.join();
-            }
-        }
-    }
+    ~task_group() { finish_all(); }
 };
 
-} // namespace wmtk::threading
\ No newline at end of file
+} // namespace wmtk::threading
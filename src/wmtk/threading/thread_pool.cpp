@@ -0,0 +1,102 @@
+#include "thread_pool.hpp"
+
+namespace wmtk::threading {
+
+namespace {
+// Depth rather than a flag: a task_group waited on inside a task runs other tasks in turn.
+thread_local int task_depth = 0;
+} // namespace
+
+thread_pool& thread_pool::instance()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+void thread_pool::reserve(std::size_t n)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    while (m_workers.size() < n) {
+        m_workers.emplace_back([this] { worker_loop(); });
+    }
+}
+
+std::size_t thread_pool::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_workers.size();
+}
+
+void thread_pool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_cv.notify_one();
+}
+
+bool thread_pool::try_run_one()
+{
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_tasks.empty()) {
+            return false;
+        }
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+    }
+    // Tasks are wrapped by the shims and never throw; the wrappers carry exceptions back to
+    // whoever waits on them.
+    task_scope scope;
+    task();
+    return true;
+}
+
+bool thread_pool::in_task()
+{
+    return task_depth > 0;
+}
+
+thread_pool::task_scope::task_scope()
+{
+    ++task_depth;
+}
+
+thread_pool::task_scope::~task_scope()
+{
+    --task_depth;
+}
+
+void thread_pool::worker_loop()
+{
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+            if (m_tasks.empty()) {
+                return; // stopping, and nothing left to run
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task_scope scope;
+        task();
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& w : m_workers) {
+        w.join();
+    }
+}
+
+} // namespace wmtk::threading
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wmtk::threading {
+
+// ---------------------------------------------------------------------------
+// thread_pool: the process-wide workers behind task_group and parallel_for.
+//
+// Both shims used to create their threads on every call -- a pass, a collect, a
+// winding-number sweep, a for_each_vertex -- and mesh_improvement makes dozens of
+// those per iteration. Creation is tens of microseconds per thread, which is the
+// whole budget of a small pass on a small mesh. The pool is created on first use,
+// grows to the largest concurrency anyone has asked for (NUM_THREADS, in practice)
+// and never shrinks; its workers are joined when the process exits.
+//
+// There is one FIFO queue under one mutex. The shims submit a handful of coarse
+// tasks per call, not one per element, so the queue is never the bottleneck.
+//
+// Nested parallelism: a thread that is running a pool task is already one of the
+// NUM_THREADS, so a parallel_for it starts runs inline instead of queueing more
+// work -- see `in_task`. A task_group waited on from a task does not block a
+// worker either: `wait` runs queued tasks while it waits.
+// ---------------------------------------------------------------------------
+class thread_pool
+{
+public:
+    /// The pool. Created, without workers, on first call.
+    static thread_pool& instance();
+
+    /// Make sure at least @p n workers exist. Never shrinks the pool.
+    void reserve(std::size_t n);
+    std::size_t size() const;
+
+    void submit(std::function<void()> task);
+    /// Run one queued task on the calling thread. False if the queue was empty.
+    bool try_run_one();
+
+    /// Whether the calling thread is currently inside a pool task, on a worker or helping.
+    static bool in_task();
+
+    /// Marks the calling thread as inside a task for its lifetime. The pool does this around
+    /// every task it runs; parallel_for also does it around the chunk it keeps for itself.
+    struct task_scope
+    {
+        task_scope();
+        ~task_scope();
+        task_scope(const task_scope&) = delete;
+        task_scope& operator=(const task_scope&) = delete;
+    };
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool();
+
+private:
+    thread_pool() = default;
+    void worker_loop();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::function<void()>> m_tasks;
+    std::vector<std::thread> m_workers;
+    bool m_stop = false;
+};
+
+} // namespace wmtk::threading
@@ -0,0 +1,248 @@
+#include "AMIPSBatch.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Compile each block kernel for several x86 ISAs and let the loader pick one (GCC/Clang
+// function multiversioning, resolved through an ifunc, hence ELF only). The kernels are plain
+// loops over a block; what changes between the clones is only the vector width the compiler
+// gets to use for them.
+#if defined(__x86_64__) && defined(__ELF__) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(WMTK_AMIPS_NO_MULTIVERSION)
+#define WMTK_AMIPS_MULTIVERSION __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define WMTK_AMIPS_MULTIVERSION
+#endif
+
+namespace wmtk {
+
+namespace {
+
+/// Elements per block. Large enough to fill a 512-bit register several times over, small
+/// enough that a block of results stays in L1.
+constexpr size_t kBlock = 16;
+
+/**
+ * A block of tets as the three edge vectors from the first vertex, one array per coordinate:
+ * e[3 * i + c][l] is coordinate c of v_{i+1} - v_0 in lane l.
+ *
+ * With those, and M = (R^T R)^-1 = 2 I - 1/2 11^T for a regular reference R of unit edge
+ * (det R = 1/sqrt(2)):
+ *   N = tr(D M D^T) = 1.5 sum |e_i|^2 - sum_{i<j} e_i . e_j,   E = N / cbrt(2 d^2),  d = det D.
+ * As functions of the first vertex x (e_i = v_i - x), N has gradient -(e_1 + e_2 + e_3) and
+ * Hessian 3 I, and d is affine with gradient -(e_2 x e_3 + e_3 x e_1 + e_1 x e_2).
+ */
+struct TetBlock
+{
+    double e[9][kBlock];
+};
+
+struct TetResult
+{
+    double E[kBlock];
+    double g[3][kBlock];
+    double h[6][kBlock]; // xx, yy, zz, xy, xz, yz
+};
+
+/// `order`: 0 energies only, 1 adds gradients, 2 adds Hessians.
+WMTK_AMIPS_MULTIVERSION void
+tet_block(const TetBlock& b, const size_t n, const int order, TetResult& r)
+{
+    double N[kBlock], d[kBlock], s[kBlock];
+    for (size_t l = 0; l < n; ++l) {
+        const double ax = b.e[0][l], ay = b.e[1][l], az = b.e[2][l];
+        const double bx = b.e[3][l], by = b.e[4][l], bz = b.e[5][l];
+        const double cx = b.e[6][l], cy = b.e[7][l], cz = b.e[8][l];
+        const double aa = ax * ax + ay * ay + az * az;
+        const double bb = bx * bx + by * by + bz * bz;
+        const double cc = cx * cx + cy * cy + cz * cz;
+        const double ab = ax * bx + ay * by + az * bz;
+        const double ac = ax * cx + ay * cy + az * cz;
+        const double bc = bx * cx + by * cy + bz * cz;
+        N[l] = 1.5 * (aa + bb + cc) - (ab + ac + bc);
+        d[l] = ax * (by * cz - bz * cy) - ay * (bx * cz - bz * cx) + az * (bx * cy - by * cx);
+    }
+    // cbrt has no vector form without fast-math; keeping it in its own loop keeps it from
+    // scalarizing the two around it.
+    for (size_t l = 0; l < n; ++l) {
+        s[l] = 1.0 / std::cbrt(2.0 * d[l] * d[l]);
+    }
+    for (size_t l = 0; l < n; ++l) {
+        r.E[l] = N[l] * s[l];
+    }
+    if (order < 1) return;
+
+    for (size_t l = 0; l < n; ++l) {
+        const double ax = b.e[0][l], ay = b.e[1][l], az = b.e[2][l];
+        const double bx = b.e[3][l], by = b.e[4][l], bz = b.e[5][l];
+        const double cx = b.e[6][l], cy = b.e[7][l], cz = b.e[8][l];
+        const double gNx = -(ax + bx + cx), gNy = -(ay + by + cy), gNz = -(az + bz + cz);
+        const double gdx = -((by * cz - bz * cy) + (cy * az - cz * ay) + (ay * bz - az * by));
+        const double gdy = -((bz * cx - bx * cz) + (cz * ax - cx * az) + (az * bx - ax * bz));
+        const double gdz = -((bx * cy - by * cx) + (cx * ay - cy * ax) + (ax * by - ay * bx));
+        const double a = (2.0 / 3.0) / d[l];
+        const double aN = a * N[l];
+        r.g[0][l] = s[l] * (gNx - aN * gdx);
+        r.g[1][l] = s[l] * (gNy - aN * gdy);
+        r.g[2][l] = s[l] * (gNz - aN * gdz);
+        if (order < 2) continue;
+        const double c = (10.0 / 9.0) * N[l] / (d[l] * d[l]);
+        r.h[0][l] = s[l] * (3.0 - 2 * a * gNx * gdx + c * gdx * gdx);
+        r.h[1][l] = s[l] * (3.0 - 2 * a * gNy * gdy + c * gdy * gdy);
+        r.h[2][l] = s[l] * (3.0 - 2 * a * gNz * gdz + c * gdz * gdz);
+        r.h[3][l] = s[l] * (-a * (gNx * gdy + gdx * gNy) + c * gdx * gdy);
+        r.h[4][l] = s[l] * (-a * (gNx * gdz + gdx * gNz) + c * gdx * gdz);
+        r.h[5][l] = s[l] * (-a * (gNy * gdz + gdy * gNz) + c * gdy * gdz);
+    }
+}
+
+/**
+ * The 2D analogue, e[2 * i + c][l] for the two edge vectors. With the equilateral reference
+ * M = 4/3 [[1, -1/2], [-1/2, 1]] and det R = sqrt(3)/2:
+ *   N = 4/3 (|e_1|^2 + |e_2|^2 - e_1 . e_2),   E = (sqrt(3)/2) N / d,
+ * signed like AMIPS2D_energy. N has gradient -4/3 (e_1 + e_2) and Hessian 8/3 I; d is affine.
+ */
+struct TriBlock
+{
+    double e[4][kBlock];
+};
+
+struct TriResult
+{
+    double E[kBlock];
+    double g[2][kBlock];
+    double h[3][kBlock]; // xx, yy, xy
+};
+
+WMTK_AMIPS_MULTIVERSION void
+tri_block(const TriBlock& b, const size_t n, const int order, TriResult& r)
+{
+    constexpr double k = 0.86602540378443864676; // sqrt(3) / 2
+    for (size_t l = 0; l < n; ++l) {
+        const double ax = b.e[0][l], ay = b.e[1][l];
+        const double bx = b.e[2][l], by = b.e[3][l];
+        const double N = (4.0 / 3.0) * (ax * ax + ay * ay + bx * bx + by * by - ax * bx - ay * by);
+        const double inv_d = 1.0 / (ax * by - ay * bx);
+        r.E[l] = k * N * inv_d;
+        if (order < 1) continue;
+        const double gNx = -(4.0 / 3.0) * (ax + bx), gNy = -(4.0 / 3.0) * (ay + by);
+        const double gdx = ay - by, gdy = bx - ax;
+        r.g[0][l] = k * inv_d * (gNx - N * inv_d * gdx);
+        r.g[1][l] = k * inv_d * (gNy - N * inv_d * gdy);
+        if (order < 2) continue;
+        const double c = 2 * N * inv_d;
+        r.h[0][l] = k * inv_d * (8.0 / 3.0 - inv_d * (2 * gNx * gdx - c * gdx * gdx));
+        r.h[1][l] = k * inv_d * (8.0 / 3.0 - inv_d * (2 * gNy * gdy - c * gdy * gdy));
+        r.h[2][l] = k * inv_d * (-inv_d * (gNx * gdy + gdx * gNy - c * gdx * gdy));
+    }
+}
+
+} // namespace
+
+double AMIPS_one_ring(
+    const std::vector<std::array<double, 12>>& cells,
+    const Eigen::Vector3d& x,
+    Eigen::Vector3d* grad,
+    Eigen::Matrix3d* hess)
+{
+    const int order = hess ? 2 : grad ? 1 : 0;
+    double E = 0;
+    double g[3] = {0, 0, 0};
+    double h[6] = {0, 0, 0, 0, 0, 0};
+
+    TetBlock b;
+    TetResult r;
+    for (size_t begin = 0; begin < cells.size(); begin += kBlock) {
+        const size_t n = std::min(kBlock, cells.size() - begin);
+        for (size_t l = 0; l < n; ++l) {
+            const auto& c = cells[begin + l];
+            for (int k = 0; k < 9; ++k) b.e[k][l] = c[3 + k] - x[k % 3];
+        }
+        tet_block(b, n, order, r);
+        for (size_t l = 0; l < n; ++l) E += r.E[l];
+        if (order >= 1) {
+            for (int k = 0; k < 3; ++k)
+                for (size_t l = 0; l < n; ++l) g[k] += r.g[k][l];
+        }
+        if (order >= 2) {
+            for (int k = 0; k < 6; ++k)
+                for (size_t l = 0; l < n; ++l) h[k] += r.h[k][l];
+        }
+    }
+
+    if (grad) *grad = Eigen::Vector3d(g[0], g[1], g[2]);
+    if (hess) {
+        *hess << h[0], h[3], h[4], //
+            h[3], h[1], h[5], //
+            h[4], h[5], h[2];
+    }
+    return E;
+}
+
+double AMIPS2D_one_ring(
+    const std::vector<std::array<double, 6>>& cells,
+    const Eigen::Vector2d& x,
+    Eigen::Vector2d* grad,
+    Eigen::Matrix2d* hess)
+{
+    const int order = hess ? 2 : grad ? 1 : 0;
+    double E = 0;
+    double g[2] = {0, 0};
+    double h[3] = {0, 0, 0};
+
+    TriBlock b;
+    TriResult r;
+    for (size_t begin = 0; begin < cells.size(); begin += kBlock) {
+        const size_t n = std::min(kBlock, cells.size() - begin);
+        for (size_t l = 0; l < n; ++l) {
+            const auto& c = cells[begin + l];
+            for (int k = 0; k < 4; ++k) b.e[k][l] = c[2 + k] - x[k % 2];
+        }
+        tri_block(b, n, order, r);
+        for (size_t l = 0; l < n; ++l) E += r.E[l];
+        if (order >= 1) {
+            for (int k = 0; k < 2; ++k)
+                for (size_t l = 0; l < n; ++l) g[k] += r.g[k][l];
+        }
+        if (order >= 2) {
+            for (int k = 0; k < 3; ++k)
+                for (size_t l = 0; l < n; ++l) h[k] += r.h[k][l];
+        }
+    }
+
+    if (grad) *grad = Eigen::Vector2d(g[0], g[1]);
+    if (hess) *hess << h[0], h[2], h[2], h[1];
+    return E;
+}
+
+void AMIPS_energies(const std::array<double, 12>* T, const size_t n_total, double* out)
+{
+    TetBlock b;
+    TetResult r;
+    for (size_t begin = 0; begin < n_total; begin += kBlock) {
+        const size_t n = std::min(kBlock, n_total - begin);
+        for (size_t l = 0; l < n; ++l) {
+            const auto& c = T[begin + l];
+            for (int k = 0; k < 9; ++k) b.e[k][l] = c[3 + k] - c[k % 3];
+        }
+        tet_block(b, n, 0, r);
+        std::copy(r.E, r.E + n, out + begin);
+    }
+}
+
+void AMIPS2D_energies(const std::array<double, 6>* T, const size_t n_total, double* out)
+{
+    TriBlock b;
+    TriResult r;
+    for (size_t begin = 0; begin < n_total; begin += kBlock) {
+        const size_t n = std::min(kBlock, n_total - begin);
+        for (size_t l = 0; l < n; ++l) {
+            const auto& c = T[begin + l];
+            for (int k = 0; k < 4; ++k) b.e[k][l] = c[2 + k] - c[k % 2];
+        }
+        tri_block(b, n, 0, r);
+        std::copy(r.E, r.E + n, out + begin);
+    }
+}
+
+} // namespace wmtk
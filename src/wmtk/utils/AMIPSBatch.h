@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace wmtk {
+
+/**
+ * Batched AMIPS, for the places that score many elements at once: the one-ring of a vertex
+ * being smoothed, and the candidate tets of a swap or collapse.
+ *
+ * The scalar AMIPS_energy / AMIPS_jacobian / AMIPS_hessian are generated, expanded
+ * polynomials, one call per element and per derivative order. These kernels instead use the
+ * closed form -- for a tet, E = tr(D M D^T) / cbrt(2 det(D)^2) with D the edge vectors from
+ * the first vertex and M the inverse Gram matrix of the regular reference -- and evaluate it
+ * on blocks of elements transposed to structure-of-arrays, so that the per-element arithmetic
+ * is one vectorizable loop over the block. Energy, gradient and Hessian come out of the same
+ * pass. On x86-64 with GCC or Clang the kernels are compiled for AVX-512, AVX2 and the baseline
+ * ISA and the best one is picked at load time; elsewhere the baseline build is the only one.
+ *
+ * Values agree with the scalar functions to rounding (the closed form is evaluated about the
+ * first vertex, exactly as AMIPS_energy translates its input), and degenerate elements
+ * produce the same non-finite results.
+ */
+
+/**
+ * @brief Sum of AMIPS over a vertex's one-ring, with the moving vertex placed at `x`.
+ *
+ * Each cell is laid out as for AMIPSEnergy3D: 12 doubles, the moving vertex first; its
+ * first three entries are ignored and `x` is used instead. `grad` and `hess`, when given,
+ * receive the summed gradient and Hessian with respect to `x`.
+ */
+double AMIPS_one_ring(
+    const std::vector<std::array<double, 12>>& cells,
+    const Eigen::Vector3d& x,
+    Eigen::Vector3d* grad = nullptr,
+    Eigen::Matrix3d* hess = nullptr);
+
+/// 2D counterpart of AMIPS_one_ring, for AMIPS2D over 6-double triangles.
+double AMIPS2D_one_ring(
+    const std::vector<std::array<double, 6>>& cells,
+    const Eigen::Vector2d& x,
+    Eigen::Vector2d* grad = nullptr,
+    Eigen::Matrix2d* hess = nullptr);
+
+/// AMIPS_energy of each of `n` tets, written to `out[0..n)`.
+void AMIPS_energies(const std::array<double, 12>* T, size_t n, double* out);
+
+/// AMIPS2D_energy of each of `n` triangles, written to `out[0..n)`.
+void AMIPS2D_energies(const std::array<double, 6>* T, size_t n, double* out);
+
+} // namespace wmtk
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/RationalArena.hpp>
 #include <wmtk/utils/resolve_path.hpp>
 
 #include <jse/jse.h>
@@ -14,7 +15,8 @@
 namespace wmtk::utils {
 
 /**
- * @brief Verify a driver's json against its spec, inject the defaults, and set up the logger.
+ * @brief Verify a driver's json against its spec, inject the defaults, and set up the logger
+ * and, if `rational_arena` is set, GMP's allocator.
  *
  * The first thing tetwild, triwild and simwild each do, and they did it with 28 of 29
  * identical lines.
@@ -50,6 +52,11 @@ inline std::filesystem::path verify_and_setup_logger(
         }
     }
 
+    // Before the driver starts any threads: GMP's allocation functions are process-wide.
+    if (json_params.value("rational_arena", false)) {
+        enable_rational_arena();
+    }
+
     return root;
 }
 
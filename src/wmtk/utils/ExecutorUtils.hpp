@@ -4,8 +4,12 @@
 
 namespace wmtk {
 
+// Renewal helpers for ExecutePass. Each renews the same operation it was called with, and
+// works for both callback forms: the pairs it returns carry whatever `op` is -- a name for
+// renew_neighbor_tuples, an OpHandle for renew_neighbor_tuples_by_handle.
+
 constexpr auto renewal_edges = [](const auto& m, auto op, const std::vector<TetMesh::Tuple>& newt) {
-    std::vector<std::pair<std::string, TetMesh::Tuple>> op_tups;
+    std::vector<std::pair<decltype(op), TetMesh::Tuple>> op_tups;
     std::vector<TetMesh::Tuple> new_edges;
     for (const TetMesh::Tuple& ti : newt) {
         for (auto j = 0; j < 6; j++) {
@@ -20,7 +24,7 @@ constexpr auto renewal_edges = [](const auto& m, auto op, const std::vector<TetM
 };
 
 constexpr auto renewal_faces = [](const auto& m, auto op, const auto& newtets) {
-    std::vector<std::pair<std::string, wmtk::TetMesh::Tuple>> op_tups;
+    std::vector<std::pair<decltype(op), wmtk::TetMesh::Tuple>> op_tups;
 
     auto new_faces = std::vector<wmtk::TetMesh::Tuple>();
     for (auto ti : newtets) {
@@ -32,7 +36,7 @@ constexpr auto renewal_faces = [](const auto& m, auto op, const auto& newtets) {
 };
 
 constexpr auto renewal_simple = [](const auto& m, auto op, const auto& newts) {
-    std::vector<std::pair<std::string, wmtk::TetMesh::Tuple>> op_tups;
+    std::vector<std::pair<decltype(op), wmtk::TetMesh::Tuple>> op_tups;
     for (auto t : newts) {
         op_tups.emplace_back(op, t);
     }
@@ -4,11 +4,84 @@
 #include <wmtk/threading/collector.hpp>
 
 #include <cstdint>
+#include <optional>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 namespace wmtk {
 
+namespace detail {
+/// A pass's hooks with the dirty-epoch bookkeeping of run_localized_to_convergence added:
+/// the renewed tuples' vertices are stamped with the current round, and failures are recorded.
+/// Everything else is passed through.
+template <class Mesh, class Inner>
+struct LocalizedRetryHooks
+{
+    using Tuple = typename Mesh::Tuple;
+    using OpTuple = typename ExecutePass<Mesh>::OpTuple;
+
+    Inner& inner;
+    std::vector<uint64_t>& vertex_epoch;
+    const uint64_t& round;
+    threading::collector<OpTuple>& failures;
+
+    double priority(const Mesh& m, OpHandle op, const Tuple& t)
+    {
+        return inner.priority(m, op, t);
+    }
+    bool should_renew(double val) { return inner.should_renew(val); }
+    bool lock_vertices(Mesh& m, const Tuple& t, int task_id)
+    {
+        return inner.lock_vertices(m, t, task_id);
+    }
+    bool is_weight_up_to_date(const Mesh& m, const std::tuple<double, OpHandle, Tuple>& ele)
+    {
+        return inner.is_weight_up_to_date(m, ele);
+    }
+    std::optional<std::vector<Tuple>> apply(Mesh& m, OpHandle op, const Tuple& t)
+    {
+        return inner.apply(m, op, t);
+    }
+    bool has_operation(OpHandle op) const { return inner.has_operation(op); }
+    bool dedups_renewals() const { return inner.dedups_renewals(); }
+    uint64_t renew_key(const Mesh& m, OpHandle op, const Tuple& t)
+    {
+        return inner.renew_key(m, op, t);
+    }
+
+    // Keep the driver's renewal (re-enqueue affected tuples within the pass) and additionally
+    // stamp those tuples' vertices with the current round so the between-pass filter can find
+    // the failures adjacent to them.
+    template <class Emit>
+    void renew_neighbor_tuples(
+        const Mesh& m,
+        OpHandle op,
+        const std::vector<Tuple>& newts,
+        Emit&& emit)
+    {
+        inner.renew_neighbor_tuples(m, op, newts, [&](OpHandle o, const Tuple& t) {
+            const size_t a = t.vid(m);
+            const size_t b = t.switch_vertex(m).vid(m);
+            if (a < vertex_epoch.size()) {
+                // this is thread-safe because each vertex is only ever modified by one
+                // operation at a time (the two-ring lock)
+                vertex_epoch[a] = round;
+            }
+            if (b < vertex_epoch.size()) {
+                vertex_epoch[b] = round;
+            }
+            emit(o, t);
+        });
+    }
+    void on_fail(const Mesh& m, OpHandle op, const Tuple& t)
+    {
+        failures.emplace_back(op, t);
+        inner.on_fail(m, op, t);
+    }
+};
+} // namespace detail
+
 /**
  * Run `executor` on `ops` until a pass produces no successful operation, but between
  * passes only re-attempt a failed operation if one of its incident vertices was
@@ -34,6 +107,11 @@ namespace wmtk {
  * "affected" and re-enqueues within a pass -- so this stays consistent with the existing
  * intra-pass renewal logic.
  *
+ * Works in operation handles throughout: the wrapper below sits on every renewal and every
+ * failure, so it should not be copying names. It wraps the pass's hooks rather than the
+ * executor's members, so a driver's string callbacks, its handle callbacks and its pass traits
+ * (see ExecutePass) all get the same treatment, and the executor is left as it was given.
+ *
  * `max_passes` caps the loop; 0 means "until convergence". A cap is worth setting when a
  * retry is expensive relative to what it finds. The dirty-epoch filter only asks whether a
  * failure's neighbourhood MOVED, not whether it moved in a direction that helps, so after a
@@ -42,21 +120,23 @@ namespace wmtk {
  * composite and rolls it back, it is not: measured on tetwild's octocat, passes 2+ of the
  * coarsening loop cost 38.4s to find 27 collapses after pass 1 found 5110 in 135.8s.
  */
-template <class Mesh>
+template <class Mesh, class Traits>
 size_t run_localized_to_convergence(
     Mesh& m,
     ExecutePass<Mesh>& executor,
-    std::vector<std::pair<Op, typename Mesh::Tuple>> ops,
+    Traits& traits,
+    std::vector<typename ExecutePass<Mesh>::OpTuple> ops,
     size_t max_passes = 0)
 {
     using Tuple = typename Mesh::Tuple;
+    using OpTuple = typename ExecutePass<Mesh>::OpTuple;
 
     // vertex_epoch[v] = the last round in which v was in some successful operation's
     // modified region. Capacity is fixed within a phase (storage is preallocated), and
     // any vertex created during the phase (splits) has an id below this capacity.
     std::vector<uint64_t> vertex_epoch(m.vert_capacity(), 0);
     uint64_t round = 0;
-    threading::collector<std::pair<Op, Tuple>> failures;
+    threading::collector<OpTuple> failures;
 
     auto edge_epoch = [&vertex_epoch](const Mesh& m_, const Tuple& t) -> uint64_t {
         const size_t a = t.vid(m_);
@@ -66,36 +146,18 @@ size_t run_localized_to_convergence(
         return std::max(ea, eb);
     };
 
-    // Wrap the driver-provided renewal: keep its behavior (re-enqueue affected tuples
-    // within the pass) and additionally stamp those tuples' vertices with the current
-    // round so the between-pass filter can find the failures adjacent to them.
-    auto driver_renew = executor.renew_neighbor_tuples;
-    executor.renew_neighbor_tuples =
-        [&, driver_renew](const Mesh& m_, Op op, const std::vector<Tuple>& newts) {
-            auto tups = driver_renew(m_, op, newts);
-            for (const auto& [_, t] : tups) {
-                const size_t a = t.vid(m_);
-                const size_t b = t.switch_vertex(m_).vid(m_);
-                if (a < vertex_epoch.size()) {
-                    // this is thread-safe because each vertex is only ever modified by one
-                    // operation at a time (the two-ring lock)
-                    vertex_epoch[a] = round;
-                }
-                if (b < vertex_epoch.size()) {
-                    vertex_epoch[b] = round;
-                }
-            }
-            return tups;
-        };
-    executor.on_fail = [&failures](const Mesh&, Op op, const Tuple& t) {
-        failures.emplace_back(op, t);
-    };
+    auto driver = executor.hooks(traits);
+    detail::LocalizedRetryHooks<Mesh, decltype(driver)> hooks{
+        driver,
+        vertex_epoch,
+        round,
+        failures};
 
     size_t total_success = 0;
     do {
         ++round;
         failures.clear();
-        executor(m, ops);
+        executor(m, ops, hooks);
         total_success += static_cast<size_t>(executor.get_cnt_success());
         ops.clear();
         for (const auto& pr : failures) {
@@ -113,4 +175,39 @@ size_t run_localized_to_convergence(
     return total_success;
 }
 
+/// The same, with every hook taken from the executor's members.
+template <class Mesh>
+size_t run_localized_to_convergence(
+    Mesh& m,
+    ExecutePass<Mesh>& executor,
+    std::vector<typename ExecutePass<Mesh>::OpTuple> ops,
+    size_t max_passes = 0)
+{
+    pass_traits::None none;
+    return run_localized_to_convergence(m, executor, none, std::move(ops), max_passes);
+}
+
+/// The same, for an operation list given by name.
+template <class Mesh>
+size_t run_localized_to_convergence(
+    Mesh& m,
+    ExecutePass<Mesh>& executor,
+    const std::vector<std::pair<Op, typename Mesh::Tuple>>& ops,
+    size_t max_passes = 0)
+{
+    return run_localized_to_convergence(m, executor, executor.to_handles(ops), max_passes);
+}
+
+/// The same, for an operation list given by name and hooks from @p traits.
+template <class Mesh, class Traits>
+size_t run_localized_to_convergence(
+    Mesh& m,
+    ExecutePass<Mesh>& executor,
+    Traits& traits,
+    const std::vector<std::pair<Op, typename Mesh::Tuple>>& ops,
+    size_t max_passes = 0)
+{
+    return run_localized_to_convergence(m, executor, traits, executor.to_handles(ops), max_passes);
+}
+
 } // namespace wmtk
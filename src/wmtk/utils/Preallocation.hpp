@@ -8,10 +8,13 @@ namespace wmtk {
 //
 // The mesh storage (connectivity + attributes) is preallocated to
 // max(floor, ceil(factor * live_count)) at init / consolidation; operations grab
-// fresh slots from that headroom and fail (are retried later) once it is
-// exhausted. The default (see TetMesh/TriMesh) suits the bundled integration
-// tests; set "preallocation_factor" in the component's JSON to tune it per input
-// (e.g. lower for pure-decimation runs, higher for aggressive refinement).
+// fresh slots from that headroom. Once it is exhausted, TriMesh operations fail (and
+// are retried later), while TetMesh grows its storage in place. TetMesh also recycles
+// the slots its operations remove, so there the headroom only has to cover the net
+// growth of a pass, not every slot it touches.
+// The defaults (see TetMesh/TriMesh) suit the bundled integration tests; set
+// "preallocation_factor" in the component's JSON to tune it per input (e.g. lower
+// for pure-decimation runs, higher for aggressive refinement).
 template <class Mesh>
 inline void set_preallocation_factor_from_json(Mesh& mesh, const nlohmann::json& j)
 {
@@ -1,73 +1,164 @@
 #pragma once
 
 #include <gmp.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <utility>
+
+// The inline representation needs 128-bit products to detect overflow exactly. Where the
+// compiler has no __int128 (MSVC) every value is a GMP one, as it always used to be.
+#if defined(__SIZEOF_INT128__) && GMP_LIMB_BITS == 64 && !defined(WMTK_RATIONAL_NO_SMALL)
+#define WMTK_RATIONAL_SMALL 1
+#endif
+
+#ifdef WMTK_RATIONAL_SMALL
+// __extension__ keeps -pedantic quiet about the non-ISO type in every file that includes this.
+__extension__ typedef __int128 wmtk_int128;
+__extension__ typedef unsigned __int128 wmtk_uint128;
+#endif
 
 namespace wmtk {
 
+/**
+ * An exact rational number.
+ *
+ * A value whose numerator and denominator both fit in 63 bits is stored inline, as a reduced
+ * fraction of two int64s; anything larger is a GMP mpq_t. The mesh code's rationals are mostly
+ * doubles and midpoints of doubles, whose denominators are powers of two well within that, and
+ * on those the arithmetic is a few integer instructions with no allocation. An operation whose
+ * result does not fit is redone in GMP, and a GMP result that fits is brought back inline, so
+ * the representation of a value depends on the value alone: equal values compare equal
+ * whichever path produced them, and to_double gives the same double for both. Without
+ * WMTK_RATIONAL_SMALL only zero can be inline (default-constructed or moved-from), so there
+ * equality falls back to comparing the values.
+ */
 class Rational
 {
 public:
-    mpq_t value;
-    void canonicalize() { mpq_canonicalize(value); }
-    int get_sign() const { return mpq_sgn(value); }
+    void canonicalize()
+    {
+        if (m_big) {
+            mpq_canonicalize(m_q);
+            demote();
+        }
+    }
+    int get_sign() const
+    {
+        if (m_big) return mpq_sgn(m_q);
+        return (m_small.num > 0) - (m_small.num < 0);
+    }
     template <typename T>
     void init(const T& v)
     {
-        mpq_set(value, v);
+        make_big();
+        mpq_set(m_q, v);
+        canonicalize();
     }
 
-    void init_from_bin(const std::string& bin) { mpq_set_str(value, bin.c_str(), 2); }
-
-    Rational()
+    void init_from_bin(const std::string& bin)
     {
-        mpq_init(value);
-        mpq_set_d(value, 0);
+        make_big();
+        mpq_set_str(m_q, bin.c_str(), 2);
+        canonicalize();
     }
 
-    Rational(double d)
-    {
-        mpq_init(value);
-        mpq_set_d(value, d);
-        // canonicalize();
-    }
+    Rational() { m_small = {0, 1}; }
+
+    Rational(double d) { set_double(d); }
 
     Rational(const mpq_t& v_)
     {
-        mpq_init(value);
-        mpq_set(value, v_);
-        // canonicalize();
+        m_small = {0, 1};
+        init(v_);
     }
 
     Rational(const Rational& other)
     {
-        mpq_init(value);
-        mpq_set(value, other.value);
+        if (other.m_big) {
+            m_big = true;
+            mpq_init(m_q);
+            mpq_set(m_q, other.m_q);
+        } else {
+            m_small = other.m_small;
+        }
+    }
+
+    // Takes the limbs over rather than copying them; `other` is left holding zero.
+    Rational(Rational&& other) noexcept
+    {
+        // An mpq_t only points at its limbs, so it can be moved bitwise.
+        if (other.m_big) {
+            m_big = true;
+            *m_q = *other.m_q;
+            other.m_big = false;
+            other.m_small = {0, 1};
+        } else {
+            m_small = other.m_small;
+        }
     }
 
+    ~Rational()
+    {
+        if (m_big) mpq_clear(m_q);
+    }
 
-    ~Rational() { mpq_clear(value); }
+    // In place, so a chain like `a * b + c * d` reuses the storage of its temporaries instead of
+    // allocating a fresh one for every intermediate.
+    Rational& operator+=(const Rational& x)
+    {
+        if (!m_big && !x.m_big && small_add(m_small, x.m_small, m_small)) return *this;
+        return big_op(x, mpq_add);
+    }
+    Rational& operator-=(const Rational& x)
+    {
+        if (!m_big && !x.m_big && small_add(m_small, {-x.m_small.num, x.m_small.den}, m_small))
+            return *this;
+        return big_op(x, mpq_sub);
+    }
+    Rational& operator*=(const Rational& x)
+    {
+        if (!m_big && !x.m_big && small_mul(m_small, x.m_small, m_small)) return *this;
+        return big_op(x, mpq_mul);
+    }
+    Rational& operator/=(const Rational& x)
+    {
+        // Division by zero falls through to GMP, which reports it.
+        if (!m_big && !x.m_big && x.m_small.num != 0) {
+            const Small inv = x.m_small.num > 0 ? Small{x.m_small.den, x.m_small.num}
+                                                : Small{-x.m_small.den, -x.m_small.num};
+            if (small_mul(m_small, inv, m_small)) return *this;
+        }
+        return big_op(x, mpq_div);
+    }
 
     friend Rational operator+(const Rational& x, const Rational& y)
     {
-        Rational r_out;
-        mpq_add(r_out.value, x.value, y.value);
+        Rational r_out = x;
+        r_out += y;
         return r_out;
     }
+    friend Rational operator+(Rational&& x, const Rational& y) { return std::move(x += y); }
 
     friend Rational operator-(const Rational& x, const Rational& y)
     {
-        Rational r_out;
-        mpq_sub(r_out.value, x.value, y.value);
+        Rational r_out = x;
+        r_out -= y;
         return r_out;
     }
+    friend Rational operator-(Rational&& x, const Rational& y) { return std::move(x -= y); }
 
 
     friend Rational operator-(const Rational& x)
     {
-        Rational r_out;
-        mpq_neg(r_out.value, x.value);
+        Rational r_out = x;
+        if (r_out.m_big) {
+            mpq_neg(r_out.m_q, r_out.m_q);
+        } else {
+            r_out.m_small.num = -r_out.m_small.num;
+        }
         return r_out;
     }
 
@@ -83,71 +174,114 @@ public:
 
     friend Rational operator*(const Rational& x, const Rational& y)
     {
-        Rational r_out;
-        mpq_mul(r_out.value, x.value, y.value);
+        Rational r_out = x;
+        r_out *= y;
         return r_out;
     }
+    friend Rational operator*(Rational&& x, const Rational& y) { return std::move(x *= y); }
 
     friend Rational operator/(const Rational& x, const Rational& y)
     {
-        Rational r_out;
-        mpq_div(r_out.value, x.value, y.value);
+        Rational r_out = x;
+        r_out /= y;
         return r_out;
     }
 
     Rational& operator=(const Rational& x)
     {
         if (this == &x) return *this;
-        mpq_set(value, x.value);
+        if (x.m_big) {
+            make_big();
+            mpq_set(m_q, x.m_q);
+        } else {
+            set_small(x.m_small);
+        }
         return *this;
     }
 
-    Rational& operator=(const double x)
+    Rational& operator=(Rational&& x) noexcept
     {
-        mpq_set_d(value, x);
-        //            canonicalize();
+        if (this == &x) return *this;
+        if (x.m_big) {
+            if (m_big) {
+                mpq_swap(m_q, x.m_q);
+            } else {
+                const Small mine = m_small;
+                *m_q = *x.m_q;
+                m_big = true;
+                x.m_big = false;
+                x.m_small = mine;
+            }
+        } else {
+            set_small(x.m_small);
+        }
         return *this;
     }
 
-    //> < ==
-    friend bool operator<(const Rational& r, const Rational& r1)
+    Rational& operator=(const double x)
     {
-        return mpq_cmp(r.value, r1.value) < 0;
+        if (m_big) {
+            mpq_clear(m_q);
+            m_big = false;
+        }
+        set_double(x);
+        return *this;
     }
 
-    friend bool operator>(const Rational& r, const Rational& r1)
-    {
-        return mpq_cmp(r.value, r1.value) > 0;
-    }
+    //> < ==
+    friend bool operator<(const Rational& r, const Rational& r1) { return cmp(r, r1) < 0; }
 
-    friend bool operator<=(const Rational& r, const Rational& r1)
-    {
-        return mpq_cmp(r.value, r1.value) <= 0;
-    }
+    friend bool operator>(const Rational& r, const Rational& r1) { return cmp(r, r1) > 0; }
 
-    friend bool operator>=(const Rational& r, const Rational& r1)
-    {
-        return mpq_cmp(r.value, r1.value) >= 0;
-    }
+    friend bool operator<=(const Rational& r, const Rational& r1) { return cmp(r, r1) <= 0; }
+
+    friend bool operator>=(const Rational& r, const Rational& r1) { return cmp(r, r1) >= 0; }
 
     friend bool operator==(const Rational& r, const Rational& r1)
     {
-        return mpq_equal(r.value, r1.value);
+        if (r.m_big != r1.m_big) {
+#ifdef WMTK_RATIONAL_SMALL
+            // Both representations are canonical, and a value that fits inline is never a GMP one.
+            return false;
+#else
+            return cmp(r, r1) == 0;
+#endif
+        }
+        if (r.m_big) return mpq_equal(r.m_q, r1.m_q);
+        return r.m_small.num == r1.m_small.num && r.m_small.den == r1.m_small.den;
     }
 
-    friend bool operator!=(const Rational& r, const Rational& r1)
-    {
-        return !mpq_equal(r.value, r1.value);
-    }
+    friend bool operator!=(const Rational& r, const Rational& r1) { return !(r == r1); }
 
     // to double
-    double to_double() const { return mpq_get_d(value); }
+    double to_double() const
+    {
+        if (!m_big) {
+#ifdef WMTK_RATIONAL_SMALL
+            // One rounding at most, so this is the nearest double: either the division is
+            // exact (a power-of-two denominator, which every double and every midpoint of
+            // doubles has) or both operands convert exactly.
+            const std::uint64_t n = magnitude(m_small.num);
+            const std::uint64_t d = std::uint64_t(m_small.den);
+            constexpr std::uint64_t exact = std::uint64_t(1) << 53;
+            if ((d & (d - 1)) == 0 || (n <= exact && d <= exact)) {
+                return double(m_small.num) / double(m_small.den);
+            }
+#endif
+            const MpqRef q(*this);
+            return mpq_get_d(q.get());
+        }
+        return mpq_get_d(m_q);
+    }
     explicit operator double() const { return to_double(); }
 
     // get str
     std::string get_str()
     {
-        char* s = mpq_get_str(NULL, 10, value);
+        if (!m_big) {
+            return m_small.den == 1 ? get_num_str() : get_num_str() + "/" + get_den_str();
+        }
+        char* s = mpq_get_str(NULL, 10, m_q);
         std::string Str = s;
         free(s);
         return Str;
@@ -156,41 +290,257 @@ public:
     // get num str
     std::string get_num_str() const
     {
-        mpz_t num;
-        mpz_init(num);
-        mpq_get_num(num, value);
-        char* s = mpz_get_str(NULL, 10, num);
+        if (!m_big) return std::to_string(m_small.num);
+        char* s = mpz_get_str(NULL, 10, mpq_numref(m_q));
         std::string Str = s;
         free(s);
-        mpz_clear(num);
         return Str;
     }
 
     // get den str
     std::string get_den_str() const
     {
-        mpz_t den;
-        mpz_init(den);
-        mpq_get_den(den, value);
-        char* s = mpz_get_str(NULL, 10, den);
+        if (!m_big) return std::to_string(m_small.den);
+        char* s = mpz_get_str(NULL, 10, mpq_denref(m_q));
         std::string Str = s;
         free(s);
-        mpz_clear(den);
         return Str;
     }
 
-    friend Rational abs(const Rational& r0)
-    {
-        Rational r;
-        mpq_abs(r.value, r0.value);
-        return r;
-    }
+    friend Rational abs(const Rational& r0) { return r0.get_sign() < 0 ? -r0 : r0; }
 
     //<<
     friend std::ostream& operator<<(std::ostream& os, const Rational& r)
     {
-        os << mpq_get_d(r.value);
+        os << r.to_double();
         return os;
     }
+
+private:
+    // A reduced fraction with 0 < den and |num|, den <= INT64_MAX; zero is 0/1.
+    struct Small
+    {
+        std::int64_t num;
+        std::int64_t den;
+    };
+
+    // GMP's view of a value: the Rational's own mpq_t, or a temporary for an inline one.
+    class MpqRef
+    {
+    public:
+        explicit MpqRef(const Rational& r)
+        {
+            if (r.m_big) {
+                m_ptr = r.m_q;
+            } else {
+                mpq_init(m_tmp);
+                set_mpz(mpq_numref(m_tmp), r.m_small.num);
+                set_mpz(mpq_denref(m_tmp), r.m_small.den);
+                m_ptr = m_tmp;
+                m_owned = true;
+            }
+        }
+        ~MpqRef()
+        {
+            if (m_owned) mpq_clear(m_tmp);
+        }
+        MpqRef(const MpqRef&) = delete;
+        MpqRef& operator=(const MpqRef&) = delete;
+        mpq_srcptr get() const { return m_ptr; }
+
+    private:
+        mpq_t m_tmp;
+        mpq_srcptr m_ptr;
+        bool m_owned = false;
+    };
+
+    static std::uint64_t magnitude(std::int64_t v)
+    {
+        return v < 0 ? std::uint64_t(0) - std::uint64_t(v) : std::uint64_t(v);
+    }
+
+    static void set_mpz(mpz_ptr z, std::int64_t v)
+    {
+        // Not mpz_set_si: long is 32 bits on some platforms.
+        const std::uint64_t m = magnitude(v);
+        mpz_import(z, 1, -1, sizeof(m), 0, 0, &m);
+        if (v < 0) mpz_neg(z, z);
+    }
+
+    void set_small(const Small& s)
+    {
+        if (m_big) {
+            mpq_clear(m_q);
+            m_big = false;
+        }
+        m_small = s;
+    }
+
+    // Switch to the GMP representation, keeping the value.
+    void make_big()
+    {
+        if (m_big) return;
+        const Small s = m_small;
+        mpq_init(m_q);
+        set_mpz(mpq_numref(m_q), s.num);
+        set_mpz(mpq_denref(m_q), s.den);
+        m_big = true;
+    }
+
+    // Back to the inline representation if the (canonical) GMP value fits.
+    void demote()
+    {
+#ifdef WMTK_RATIONAL_SMALL
+        if (!m_big || mpz_sizeinbase(mpq_numref(m_q), 2) > 63 ||
+            mpz_sizeinbase(mpq_denref(m_q), 2) > 63) {
+            return;
+        }
+        const std::int64_t num = std::int64_t(mpz_getlimbn(mpq_numref(m_q), 0));
+        const std::int64_t den = std::int64_t(mpz_getlimbn(mpq_denref(m_q), 0));
+        set_small({mpq_sgn(m_q) < 0 ? -num : num, den});
+#endif
+    }
+
+    Rational& big_op(const Rational& x, void (*op)(mpq_ptr, mpq_srcptr, mpq_srcptr))
+    {
+        if (this == &x) {
+            make_big();
+            op(m_q, m_q, m_q);
+        } else {
+            const MpqRef rx(x);
+            make_big();
+            op(m_q, m_q, rx.get());
+        }
+        demote();
+        return *this;
+    }
+
+    static int cmp(const Rational& a, const Rational& b)
+    {
+#ifdef WMTK_RATIONAL_SMALL
+        if (!a.m_big && !b.m_big) {
+            const wmtk_int128 l = wmtk_int128(a.m_small.num) * b.m_small.den;
+            const wmtk_int128 r = wmtk_int128(b.m_small.num) * a.m_small.den;
+            return (l > r) - (l < r);
+        }
+#endif
+        const MpqRef ra(a), rb(b);
+        return mpq_cmp(ra.get(), rb.get());
+    }
+
+    void set_double(double d)
+    {
+        m_big = false;
+#ifdef WMTK_RATIONAL_SMALL
+        if (d == 0) {
+            m_small = {0, 1};
+            return;
+        }
+        if (std::isfinite(d)) {
+            // d = mant * 2^e exactly, with mant an odd integer of at most 53 bits.
+            int e;
+            const double m = std::frexp(d, &e);
+            std::int64_t mant = std::int64_t(std::ldexp(m, 53));
+            e -= 53;
+            const int tz = __builtin_ctzll(magnitude(mant));
+            mant /= std::int64_t(1) << tz;
+            e += tz;
+            const int bits = 64 - __builtin_clzll(magnitude(mant));
+            if (e >= 0 && bits + e <= 63) {
+                m_small = {mant * (std::int64_t(1) << e), 1};
+                return;
+            }
+            if (e < 0 && e >= -62) {
+                m_small = {mant, std::int64_t(1) << -e};
+                return;
+            }
+        }
+#endif
+        m_big = true;
+        mpq_init(m_q);
+        mpq_set_d(m_q, d);
+    }
+
+#ifdef WMTK_RATIONAL_SMALL
+    static bool fits(wmtk_int128 v) { return v >= -INT64_MAX && v <= INT64_MAX; }
+
+    static std::uint64_t gcd(std::uint64_t a, std::uint64_t b)
+    {
+        if (a == 0) return b;
+        if (b == 0) return a;
+        const int shift = __builtin_ctzll(a | b);
+        a >>= __builtin_ctzll(a);
+        do {
+            b >>= __builtin_ctzll(b);
+            if (a > b) std::swap(a, b);
+            b -= a;
+        } while (b != 0);
+        return a << shift;
+    }
+
+    // Knuth's algorithms (TAOCP 4.5.1): reduced operands need only gcds of 64-bit values for a
+    // reduced result. The results are computed in 128 bits and kept if they fit.
+    static bool small_add(const Small& a, const Small& b, Small& out)
+    {
+        if (a.den == b.den) {
+            const wmtk_int128 n = wmtk_int128(a.num) + b.num;
+            if (n == 0) {
+                out = {0, 1};
+                return true;
+            }
+            const wmtk_uint128 un = n < 0 ? -(wmtk_uint128)n : (wmtk_uint128)n;
+            const std::uint64_t g = gcd(std::uint64_t(un % std::uint64_t(a.den)), a.den);
+            const wmtk_int128 rn = n / g;
+            if (!fits(rn)) return false;
+            out = {std::int64_t(rn), std::int64_t(a.den / std::int64_t(g))};
+            return true;
+        }
+        const std::int64_t g = std::int64_t(gcd(a.den, b.den));
+        if (g == 1) {
+            const wmtk_int128 n = wmtk_int128(a.num) * b.den + wmtk_int128(b.num) * a.den;
+            const wmtk_int128 d = wmtk_int128(a.den) * b.den;
+            if (!fits(n) || !fits(d)) return false;
+            out = {std::int64_t(n), std::int64_t(d)};
+            return true;
+        }
+        const wmtk_int128 t =
+            wmtk_int128(a.num) * (b.den / g) + wmtk_int128(b.num) * (a.den / g);
+        if (t == 0) {
+            out = {0, 1};
+            return true;
+        }
+        const wmtk_uint128 ut = t < 0 ? -(wmtk_uint128)t : (wmtk_uint128)t;
+        const std::int64_t g2 = std::int64_t(gcd(std::uint64_t(ut % std::uint64_t(g)), g));
+        const wmtk_int128 n = t / g2;
+        const wmtk_int128 d = wmtk_int128(a.den / g) * (b.den / g2);
+        if (!fits(n) || !fits(d)) return false;
+        out = {std::int64_t(n), std::int64_t(d)};
+        return true;
+    }
+
+    static bool small_mul(const Small& a, const Small& b, Small& out)
+    {
+        if (a.num == 0 || b.num == 0) {
+            out = {0, 1};
+            return true;
+        }
+        const std::int64_t g1 = std::int64_t(gcd(magnitude(a.num), b.den));
+        const std::int64_t g2 = std::int64_t(gcd(magnitude(b.num), a.den));
+        const wmtk_int128 n = wmtk_int128(a.num / g1) * (b.num / g2);
+        const wmtk_int128 d = wmtk_int128(a.den / g2) * (b.den / g1);
+        if (!fits(n) || !fits(d)) return false;
+        out = {std::int64_t(n), std::int64_t(d)};
+        return true;
+    }
+#else
+    static bool small_add(const Small&, const Small&, Small&) { return false; }
+    static bool small_mul(const Small&, const Small&, Small&) { return false; }
+#endif
+
+    bool m_big = false;
+    union {
+        Small m_small;
+        mpq_t m_q;
+    };
 };
 } // namespace wmtk
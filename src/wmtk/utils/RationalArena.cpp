@@ -0,0 +1,152 @@
+#include <wmtk/utils/RationalArena.hpp>
+
+#include <gmp.h>
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+namespace wmtk::utils {
+
+namespace {
+
+// Blocks of 8, 16, ..., 512 bytes are cached, one free list per size. GMP allocates limbs, so
+// the sizes it asks for are multiples of 8 anyway.
+constexpr size_t kGranularity = 8;
+constexpr size_t kNumClasses = 64;
+// At most 256 blocks of a class, and at most 4 KiB of it: the small classes, which GMP asks
+// for most, keep 256 blocks; the 512-byte one keeps 8. 64 classes then hold at most 256 KiB.
+constexpr size_t kMaxCachedPerClass = 256;
+constexpr size_t kMaxCachedBytesPerClass = 4096;
+
+constexpr size_t max_cached(size_t c)
+{
+    const size_t by_bytes = kMaxCachedBytesPerClass / (kGranularity * (c + 1));
+    return by_bytes < kMaxCachedPerClass ? by_bytes : kMaxCachedPerClass;
+}
+static_assert(max_cached(kNumClasses - 1) >= 1);
+
+bool g_enabled = false;
+void* (*g_prev_alloc)(size_t) = nullptr;
+void* (*g_prev_realloc)(void*, size_t, size_t) = nullptr;
+void (*g_prev_free)(void*, size_t) = nullptr;
+
+// The size class of an n-byte block, or kNumClasses if it is not cached.
+inline size_t size_class(size_t n)
+{
+    if (n == 0 || n % kGranularity != 0 || n > kGranularity * kNumClasses) return kNumClasses;
+    return n / kGranularity - 1;
+}
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+// Set once the thread's cache has been destroyed. GMP may still free during the thread's
+// teardown (a thread_local Rational destroyed after the cache, or static Rationals on the main
+// thread at exit); those blocks then go back to malloc. A bool has no destructor, so it can
+// still be read at that point.
+thread_local bool t_cache_gone = false;
+
+struct Cache
+{
+    std::array<FreeBlock*, kNumClasses> heads{};
+    std::array<size_t, kNumClasses> counts{};
+
+    ~Cache()
+    {
+        for (FreeBlock* head : heads) {
+            while (head) {
+                FreeBlock* next = head->next;
+                std::free(head);
+                head = next;
+            }
+        }
+        t_cache_gone = true;
+    }
+};
+
+inline Cache& cache()
+{
+    thread_local Cache c;
+    return c;
+}
+
+void* checked_malloc(size_t n)
+{
+    void* p = std::malloc(n);
+    // GMP has no way of reporting an allocation failure either: its own default aborts.
+    if (!p) std::abort();
+    return p;
+}
+
+void* arena_alloc(size_t n)
+{
+    const size_t c = size_class(n);
+    if (c < kNumClasses && !t_cache_gone) {
+        Cache& cc = cache();
+        if (FreeBlock* b = cc.heads[c]) {
+            cc.heads[c] = b->next;
+            --cc.counts[c];
+            return b;
+        }
+    }
+    return checked_malloc(n);
+}
+
+void arena_free(void* p, size_t n)
+{
+    if (!p) return;
+    const size_t c = size_class(n);
+    if (c < kNumClasses && !t_cache_gone) {
+        Cache& cc = cache();
+        if (cc.counts[c] < max_cached(c)) {
+            FreeBlock* b = static_cast<FreeBlock*>(p);
+            b->next = cc.heads[c];
+            cc.heads[c] = b;
+            ++cc.counts[c];
+            return;
+        }
+    }
+    std::free(p);
+}
+
+void* arena_realloc(void* p, size_t old_n, size_t new_n)
+{
+    const size_t old_c = size_class(old_n);
+    const size_t new_c = size_class(new_n);
+    if (old_c < kNumClasses && old_c == new_c) return p;
+    if (old_c == kNumClasses && new_c == kNumClasses) {
+        void* q = std::realloc(p, new_n);
+        if (!q) std::abort();
+        return q;
+    }
+    void* q = arena_alloc(new_n);
+    std::memcpy(q, p, old_n < new_n ? old_n : new_n);
+    arena_free(p, old_n);
+    return q;
+}
+
+} // namespace
+
+void enable_rational_arena(const bool on)
+{
+    if (on == g_enabled) return;
+    if (on) {
+        mp_get_memory_functions(&g_prev_alloc, &g_prev_realloc, &g_prev_free);
+        mp_set_memory_functions(arena_alloc, arena_realloc, arena_free);
+    } else {
+        // The blocks still cached stay with their threads until those exit; they are plain
+        // malloc blocks, so nothing refers to the functions being removed.
+        mp_set_memory_functions(g_prev_alloc, g_prev_realloc, g_prev_free);
+    }
+    g_enabled = on;
+}
+
+bool rational_arena_enabled()
+{
+    return g_enabled;
+}
+
+} // namespace wmtk::utils
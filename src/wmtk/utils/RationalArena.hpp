@@ -0,0 +1,33 @@
+#pragma once
+
+namespace wmtk::utils {
+
+/**
+ * @brief Route GMP's allocations through per-thread caches of recently freed blocks.
+ *
+ * Every Rational temporary allocates its numerator and denominator limbs and frees them again a
+ * few instructions later, so the exact paths -- inversion checks on vertices that are not
+ * rounded, the rational branches of the insertion -- spend much of their time in malloc and
+ * free, and with many threads in the allocator's locks. GMP has exactly one hook for this,
+ * mp_set_memory_functions, and it is process-wide; the functions installed here therefore keep
+ * one cache per thread, so that the common case takes no lock at all.
+ *
+ * Only small blocks are cached, those of up to 64 limbs, which covers the coordinates and
+ * determinants the mesh code works with; anything larger goes straight to malloc. Every block,
+ * cached or not, comes from malloc, so a block may be freed by a thread other than the one that
+ * allocated it (it then joins that thread's cache), blocks allocated before enabling may be
+ * freed after, and the other way round. This relies on the functions replaced being
+ * malloc-compatible, as GMP's defaults are.
+ *
+ * A thread's cache holds at most 256 KiB and is released when the thread exits.
+ *
+ * Call it while no other thread is using GMP: GMP reads the functions on every allocation
+ * without synchronisation. The drivers do so right after reading their json, when
+ * `rational_arena` is set.
+ */
+void enable_rational_arena(bool on = true);
+
+/// Whether the functions installed by enable_rational_arena are GMP's current ones.
+bool rational_arena_enabled();
+
+} // namespace wmtk::utils
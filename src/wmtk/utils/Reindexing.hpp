@@ -0,0 +1,100 @@
+#pragma once
+
+#include <wmtk/threading/parallel_for.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace wmtk {
+
+// The id maps consolidate_mesh renumbers a mesh with. `old_to_new[i]` is the new id of slot i,
+// or size_t(-1) if the slot is dropped; `new_to_old` is its inverse over the kept slots.
+
+/**
+ * Number the slots of [0, n) for which `keep(i)` holds consecutively, in increasing order.
+ *
+ * A parallel prefix sum: each block of slots is counted, the counts are summed into block
+ * offsets, and each block is then numbered from its offset. `keep` is called twice per slot.
+ */
+template <typename Keep>
+void compact_ids(
+    size_t n,
+    Keep&& keep,
+    int num_threads,
+    std::vector<size_t>& old_to_new,
+    std::vector<size_t>& new_to_old)
+{
+    constexpr size_t block = 4096;
+    const size_t n_blocks = (n + block - 1) / block;
+    std::vector<size_t> offset(n_blocks + 1, 0);
+    threading::parallel_for(
+        threading::range(0, n_blocks, 1),
+        [&](const threading::range& r) {
+            for (size_t b = r.begin(); b < r.end(); ++b) {
+                size_t cnt = 0;
+                for (size_t i = b * block; i < std::min(n, (b + 1) * block); ++i) {
+                    if (keep(i)) ++cnt;
+                }
+                offset[b + 1] = cnt;
+            }
+        },
+        num_threads);
+    std::partial_sum(offset.begin(), offset.end(), offset.begin());
+
+    old_to_new.resize(n);
+    new_to_old.resize(offset.back());
+    threading::parallel_for(
+        threading::range(0, n_blocks, 1),
+        [&](const threading::range& r) {
+            for (size_t b = r.begin(); b < r.end(); ++b) {
+                size_t k = offset[b];
+                for (size_t i = b * block; i < std::min(n, (b + 1) * block); ++i) {
+                    if (keep(i)) {
+                        old_to_new[i] = k;
+                        new_to_old[k++] = i;
+                    } else {
+                        old_to_new[i] = size_t(-1);
+                    }
+                }
+            }
+        },
+        num_threads);
+}
+
+/**
+ * Renumber the kept slots in increasing order of `key(old id)`, ties broken by old id, so the
+ * result does not depend on the thread count. Both maps are rewritten.
+ */
+template <typename Key>
+void sort_ids_by_key(
+    Key&& key,
+    int num_threads,
+    std::vector<size_t>& old_to_new,
+    std::vector<size_t>& new_to_old)
+{
+    std::vector<std::pair<uint64_t, size_t>> order(new_to_old.size());
+    threading::parallel_for(
+        threading::range(0, order.size()),
+        [&](const threading::range& r) {
+            for (size_t k = r.begin(); k < r.end(); ++k) {
+                order[k] = {key(new_to_old[k]), new_to_old[k]};
+            }
+        },
+        num_threads);
+    threading::parallel_sort(order.begin(), order.end(), num_threads);
+    threading::parallel_for(
+        threading::range(0, order.size()),
+        [&](const threading::range& r) {
+            for (size_t k = r.begin(); k < r.end(); ++k) {
+                new_to_old[k] = order[k].second;
+                old_to_new[order[k].second] = k;
+            }
+        },
+        num_threads);
+}
+
+} // namespace wmtk
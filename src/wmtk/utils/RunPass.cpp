@@ -65,14 +65,45 @@ void run_pass_impl(
 
     const bool parallel = m.NUM_THREADS > 0;
 
-    ExecutePass<Mesh> executor(parallel ? ExecutionPolicy::kPartition : ExecutionPolicy::kSeq);
+    ExecutionPolicy policy = ExecutionPolicy::kSeq;
+    if (parallel) {
+        const std::string& scheduler = m.m_params.scheduler;
+        if (scheduler == "partition") {
+            policy = ExecutionPolicy::kPartition;
+        } else if (scheduler == "color") {
+            // Uses the same locker below, but only to read off each operation's footprint.
+            policy = ExecutionPolicy::kColor;
+        } else {
+            log_and_throw_error(
+                "Unknown scheduler '{}'; expected 'partition' or 'color'",
+                scheduler);
+        }
+    }
+
+    ExecutePass<Mesh> executor(policy);
     executor.num_threads = m.NUM_THREADS;
+    executor.work_stealing = m.m_params.work_stealing;
+    // "bucket" is for the passes that opt into it (use_approximate_queue); everything else keeps
+    // its exact order.
+    const std::string& queue = m.m_params.scheduler_queue;
+    if (queue == "dary" || queue == "bucket") {
+        executor.queue_kind = threading::QueueKind::kDaryHeap;
+    } else if (queue != "binary") {
+        log_and_throw_error(
+            "Unknown scheduler_queue '{}'; expected 'binary', 'dary' or 'bucket'",
+            queue);
+    }
     if (parallel) {
         // Serial leaves `lock_vertices` at its default (always succeeds): there is nothing to
         // lock against, and claiming the ring would only add work.
         executor.lock_vertices = make_locker<Mesh>(lock, ring);
     }
 
+    // The envelope counts its queries itself (atomically, so every worker can), and the
+    // pass's share is the difference across the body.
+    const SampleEnvelope::QueryStats env_before =
+        m.m_envelope ? m.m_envelope->query_stats() : SampleEnvelope::QueryStats();
+
     body(executor, m);
 
     if (!label.empty()) {
@@ -81,6 +112,12 @@ void run_pass_impl(
             label,
             parallel ? "parallel" : "serial",
             timer.getElapsedTimeInSec());
+        if (m.m_envelope) {
+            logger().info(
+                "{} envelope: {}",
+                label,
+                (m.m_envelope->query_stats() - env_before).to_string());
+        }
     }
 }
 
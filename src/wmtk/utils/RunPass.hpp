@@ -55,7 +55,10 @@ constexpr int default_ring(PassLock lock)
  *
  * @p body receives the executor to configure and the mesh to run it on, and is responsible for
  * actually executing (`executor(m, ops)` or `run_localized_to_convergence(m, executor, ops)`) --
- * drivers differ in which, and in what they do with the result.
+ * drivers differ in which, and in what they do with the result. Either also takes the pass's
+ * hooks as a traits object (`executor(m, ops, traits)`), which is how the hot drivers get them
+ * inlined into the scheduler's loop; the lock installed here is then the one hook still called
+ * through a std::function, which costs nothing next to the atomics it takes.
  *
  * @p label is used as "<label> time parallel: ...". Pass an empty label to log nothing.
  *
@@ -98,4 +101,19 @@ inline void run_pass(
     run_pass(m, lock, default_ring(lock), label, body);
 }
 
+/**
+ * @brief Let a pass whose order is only a heuristic use the bucketed queue, if
+ * OptimizerParameters::scheduler_queue asks for it. Call from the body of `run_pass`.
+ *
+ * run_pass itself maps "bucket" to the exact-order d-ary heap, because most passes cannot tell
+ * it is safe; edge split and collapse can, and say so through this.
+ */
+template <class Mesh>
+void use_approximate_queue(ExecutePass<Mesh>& executor, const Mesh& m)
+{
+    if (m.m_params.scheduler_queue == "bucket") {
+        executor.queue_kind = threading::QueueKind::kBucketed;
+    }
+}
+
 } // namespace wmtk
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace wmtk {
+
+namespace detail {
+// Elements per chunk for T: about 64 KiB worth, at least 256, a power of two.
+template <typename T>
+constexpr std::size_t segmented_vector_chunk_bits()
+{
+    std::size_t bits = 8;
+    while ((std::size_t(2) << bits) * sizeof(T) <= (std::size_t(1) << 16)) ++bits;
+    return bits;
+}
+} // namespace detail
+
+/**
+ * A vector stored as fixed-size chunks, so that it can grow while other threads are reading
+ * and writing its elements.
+ *
+ * A std::vector reallocates when it grows, which moves every element; that is why the mesh
+ * storage used to be sized once, at init and consolidation, and why operations failed once that
+ * headroom was used up. Here growing only allocates new chunks: an element never moves while it
+ * is in the vector, so references to it stay valid, and grow_to_at_least may run concurrently
+ * with accesses to the elements already there. Element i lives at chunk i >> ChunkBits, so an
+ * access costs one more dependent load than a std::vector's.
+ *
+ * The chunk table is an array of chunk pointers behind an atomic pointer. Growing it copies it;
+ * the old copy stays allocated until the vector is cleared or destroyed, so a reader that loaded
+ * it before the copy can still use it. Growth takes a mutex, which only threads that grow the
+ * vector contend for, and at most once per chunk.
+ *
+ * Everything except grow_to_at_least, size and element access is single-threaded, like
+ * std::vector. Elements past size() are value-initialised: a chunk is allocated that way, and
+ * shrinking resets the elements it drops, so a vector that grows again gets fresh elements.
+ */
+template <typename T, std::size_t ChunkBits = detail::segmented_vector_chunk_bits<T>()>
+class SegmentedVector
+{
+    static constexpr std::size_t chunk_size = std::size_t(1) << ChunkBits;
+    static constexpr std::size_t chunk_mask = chunk_size - 1;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    template <bool Const>
+    class Iterator
+    {
+        using Owner = std::conditional_t<Const, const SegmentedVector, SegmentedVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        Iterator() = default;
+        Iterator(Owner* v, size_type i)
+            : m_v(v)
+            , m_i(i)
+        {}
+        operator Iterator<true>() const { return {m_v, m_i}; }
+
+        reference operator*() const { return (*m_v)[m_i]; }
+        pointer operator->() const { return &(*m_v)[m_i]; }
+        reference operator[](difference_type d) const { return (*m_v)[m_i + d]; }
+
+        Iterator& operator++()
+        {
+            ++m_i;
+            return *this;
+        }
+        Iterator operator++(int) { return {m_v, m_i++}; }
+        Iterator& operator--()
+        {
+            --m_i;
+            return *this;
+        }
+        Iterator operator--(int) { return {m_v, m_i--}; }
+        Iterator& operator+=(difference_type d)
+        {
+            m_i += d;
+            return *this;
+        }
+        Iterator& operator-=(difference_type d)
+        {
+            m_i -= d;
+            return *this;
+        }
+        friend Iterator operator+(Iterator it, difference_type d) { return it += d; }
+        friend Iterator operator+(difference_type d, Iterator it) { return it += d; }
+        friend Iterator operator-(Iterator it, difference_type d) { return it -= d; }
+        friend difference_type operator-(const Iterator& a, const Iterator& b)
+        {
+            return difference_type(a.m_i) - difference_type(b.m_i);
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_i == b.m_i; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.m_i != b.m_i; }
+        friend bool operator<(const Iterator& a, const Iterator& b) { return a.m_i < b.m_i; }
+        friend bool operator>(const Iterator& a, const Iterator& b) { return a.m_i > b.m_i; }
+        friend bool operator<=(const Iterator& a, const Iterator& b) { return a.m_i <= b.m_i; }
+        friend bool operator>=(const Iterator& a, const Iterator& b) { return a.m_i >= b.m_i; }
+
+    private:
+        Owner* m_v = nullptr;
+        size_type m_i = 0;
+    };
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    SegmentedVector() = default;
+    explicit SegmentedVector(size_type n) { resize(n); }
+    SegmentedVector(size_type n, const T& value) { assign(n, value); }
+    SegmentedVector(const SegmentedVector& o) { *this = o; }
+    SegmentedVector(SegmentedVector&& o) noexcept { swap(o); }
+    ~SegmentedVector() { release(); }
+
+    SegmentedVector& operator=(const SegmentedVector& o)
+    {
+        if (this == &o) return *this;
+        clear();
+        resize(o.size());
+        for (size_type i = 0; i < o.size(); ++i) (*this)[i] = o[i];
+        return *this;
+    }
+    SegmentedVector& operator=(SegmentedVector&& o) noexcept
+    {
+        if (this != &o) {
+            clear();
+            swap(o);
+        }
+        return *this;
+    }
+
+    T& operator[](size_type i)
+    {
+        assert(i < m_n_chunks.load(std::memory_order_relaxed) * chunk_size);
+        return m_table.load(std::memory_order_acquire)[i >> ChunkBits][i & chunk_mask];
+    }
+    const T& operator[](size_type i) const
+    {
+        assert(i < m_n_chunks.load(std::memory_order_relaxed) * chunk_size);
+        return m_table.load(std::memory_order_acquire)[i >> ChunkBits][i & chunk_mask];
+    }
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, size()}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size()}; }
+
+    size_type size() const { return m_size.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+    /// The number of elements the allocated chunks hold.
+    size_type capacity() const { return m_n_chunks.load(std::memory_order_acquire) * chunk_size; }
+
+    /**
+     * Make size() at least @p n, allocating chunks as needed; it is rounded up to a whole number
+     * of chunks, so that the threads appending one slot at a time do not all take the lock.
+     * Thread-safe, also against concurrent element access; the elements added are
+     * value-initialised.
+     */
+    void grow_to_at_least(size_type n)
+    {
+        if (size() >= n) return;
+        std::lock_guard<std::mutex> lock(m_grow_mutex);
+        if (size() >= n) return;
+        const size_type chunks = (n + chunk_mask) >> ChunkBits;
+        allocate_chunks(chunks);
+        m_size.store(chunks * chunk_size, std::memory_order_release);
+    }
+
+    /// As std::vector::resize, but single-threaded.
+    void resize(size_type n)
+    {
+        const size_type old = size();
+        if (n < old) {
+            for (size_type i = n; i < old; ++i) (*this)[i] = T();
+        } else {
+            allocate_chunks((n + chunk_mask) >> ChunkBits);
+        }
+        m_size.store(n, std::memory_order_release);
+    }
+    void resize(size_type n, const T& value)
+    {
+        const size_type old = size();
+        resize(n);
+        for (size_type i = old; i < n; ++i) (*this)[i] = value;
+    }
+    void assign(size_type n, const T& value)
+    {
+        clear();
+        resize(n, value);
+    }
+
+    /// Free every chunk, as well as the chunk tables retired by growth.
+    void clear() { release(); }
+
+    void swap(SegmentedVector& o) noexcept
+    {
+        // Not thread-safe, so neither vector can be growing: the lock is not needed.
+        T** table = m_table.load(std::memory_order_relaxed);
+        m_table.store(o.m_table.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        o.m_table.store(table, std::memory_order_relaxed);
+        size_type n = m_size.load(std::memory_order_relaxed);
+        m_size.store(o.m_size.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        o.m_size.store(n, std::memory_order_relaxed);
+        n = m_n_chunks.load(std::memory_order_relaxed);
+        m_n_chunks.store(o.m_n_chunks.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        o.m_n_chunks.store(n, std::memory_order_relaxed);
+        std::swap(m_table_capacity, o.m_table_capacity);
+        m_tables.swap(o.m_tables);
+    }
+
+private:
+    // Allocate chunks until there are @p chunks of them, growing the table as needed. Called
+    // single-threaded or under m_grow_mutex.
+    void allocate_chunks(size_type chunks)
+    {
+        size_type have = m_n_chunks.load(std::memory_order_relaxed);
+        if (chunks <= have) return;
+        T** table = m_table.load(std::memory_order_relaxed);
+        if (chunks > m_table_capacity) {
+            const size_type cap = std::max(chunks, 2 * m_table_capacity);
+            std::unique_ptr<T*[]> grown(new T*[cap]());
+            std::copy(table, table + have, grown.get());
+            table = grown.get();
+            m_tables.push_back(std::move(grown));
+            m_table_capacity = cap;
+            m_table.store(table, std::memory_order_release);
+        }
+        for (; have < chunks; ++have) {
+            table[have] = new T[chunk_size]();
+        }
+        m_n_chunks.store(chunks, std::memory_order_release);
+    }
+
+    void release()
+    {
+        T** table = m_table.load(std::memory_order_relaxed);
+        const size_type n = m_n_chunks.load(std::memory_order_relaxed);
+        for (size_type c = 0; c < n; ++c) delete[] table[c];
+        m_tables.clear();
+        m_table.store(nullptr, std::memory_order_relaxed);
+        m_table_capacity = 0;
+        m_n_chunks.store(0, std::memory_order_relaxed);
+        m_size.store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic<T**> m_table{nullptr};
+    std::atomic<size_type> m_size{0};
+    std::atomic<size_type> m_n_chunks{0};
+    size_type m_table_capacity = 0;
+    // Every table allocated, the current one last; a reader may still hold an older one.
+    std::vector<std::unique_ptr<T*[]>> m_tables;
+    std::mutex m_grow_mutex;
+};
+
+} // namespace wmtk
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <wmtk/simplex/Simplex.hpp>
+#include <wmtk/threading/parallel_for.hpp>
 
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <functional>
 #include <queue>
 #include <unordered_set>
 #include <utility>
@@ -31,11 +33,21 @@ using WorstCell = std::pair<double, size_t>;
  * @brief The `num_worst` valid cells with the highest quality, among those whose energy
  * reaches `filter_energy`.
  *
+ * "Highest" orders (quality, cell id) pairs, so among equal qualities the higher cell id is
+ * kept. That makes the selection a function of the mesh alone: it is the same for every
+ * thread count and chunking. (The serial loop this replaced broke exact ties by visiting
+ * order instead, which no parallel split can reproduce.)
+ *
+ * The scan is a parallel reduction: each chunk keeps its own `num_worst` best in a heap, and
+ * the chunks' lists are merged. Chunks are handed out dynamically, since removed cells are
+ * skipped almost for free and removed ids cluster where the mesh was last coarsened.
+ *
  * @param n_cells        cell capacity (ids 0..n_cells-1 are probed)
- * @param is_valid       `bool(size_t cid)` -- whether the cell is live
- * @param energy         `double(size_t cid)` -- energy of a cell
+ * @param is_valid       `bool(size_t cid)` -- whether the cell is live; called concurrently
+ * @param energy         `double(size_t cid)` -- energy of a cell; called concurrently
  * @param filter_energy  cells below this energy are never refined
  * @param num_worst      how many to keep; <= 0 keeps every cell above filter_energy
+ * @param num_threads    as for threading::parallel_for
  *
  * @return the selected cells sorted ascending by quality (so back() is the worst).
  */
@@ -45,38 +57,60 @@ std::vector<WorstCell> select_worst_cells(
     IsValid is_valid,
     Energy energy,
     double filter_energy,
-    int num_worst)
+    int num_worst,
+    int num_threads = 1)
 {
-    // `worst` is kept sorted ascending by quality, size <= num_worst (front = smallest kept).
-    std::vector<WorstCell> worst;
-    if (num_worst > 0) {
-        worst.reserve(num_worst);
-    }
-
-    for (size_t cid = 0; cid < n_cells; ++cid) {
-        if (!is_valid(cid)) {
-            continue;
-        }
-        const double q = energy(cid);
-        if (q < filter_energy) {
-            continue;
+    const bool bounded = num_worst > 0;
+    const size_t k = bounded ? static_cast<size_t>(num_worst) : 0;
+    // Keep the k largest pairs of `worst`, unordered.
+    const auto truncate = [k, bounded](std::vector<WorstCell>& worst) {
+        if (bounded && worst.size() > k) {
+            std::nth_element(
+                worst.begin(),
+                worst.begin() + k,
+                worst.end(),
+                std::greater<WorstCell>());
+            worst.resize(k);
         }
-        if (num_worst > 0) {
-            if (static_cast<int>(worst.size()) < num_worst) {
-                worst.emplace_back(q, cid);
-                std::sort(worst.begin(), worst.end());
-            } else if (q > worst.front().first) {
-                worst.front() = {q, cid};
-                std::sort(worst.begin(), worst.end());
+    };
+
+    std::vector<WorstCell> worst = threading::parallel_reduce(
+        threading::range(0, n_cells, 4096),
+        std::vector<WorstCell>(),
+        [&](const threading::range& r, std::vector<WorstCell> out) {
+            // A min-heap of the best k so far: its top is the one to evict.
+            std::priority_queue<WorstCell, std::vector<WorstCell>, std::greater<WorstCell>>
+                heap;
+            for (size_t cid = r.begin(); cid < r.end(); ++cid) {
+                if (!is_valid(cid)) {
+                    continue;
+                }
+                const double q = energy(cid);
+                if (q < filter_energy) {
+                    continue;
+                }
+                if (!bounded) {
+                    out.emplace_back(q, cid);
+                } else if (heap.size() < k) {
+                    heap.emplace(q, cid);
+                } else if (WorstCell(q, cid) > heap.top()) {
+                    heap.pop();
+                    heap.emplace(q, cid);
+                }
             }
-        } else {
-            worst.emplace_back(q, cid);
-        }
-    }
+            for (; !heap.empty(); heap.pop()) {
+                out.push_back(heap.top());
+            }
+            return out;
+        },
+        [&](std::vector<WorstCell> a, std::vector<WorstCell> b) {
+            a.insert(a.end(), b.begin(), b.end());
+            truncate(a);
+            return a;
+        },
+        num_threads);
 
-    if (num_worst <= 0) {
-        std::sort(worst.begin(), worst.end());
-    }
+    threading::parallel_sort(worst.begin(), worst.end(), num_threads);
     return worst;
 }
 
@@ -0,0 +1,92 @@
+#include "SmallVector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <new>
+
+namespace wmtk::detail {
+
+namespace {
+
+// Block sizes 2^0 .. 2^(n_classes - 1) bytes; anything larger bypasses the lists.
+constexpr std::size_t n_classes = 24;
+// Per thread and size class. A collapse frees and a split allocates a handful of stars, so a
+// few hundred blocks absorb the churn without holding on to a pass's peak.
+constexpr std::size_t max_cached = 256;
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+struct FreeLists
+{
+    std::array<FreeBlock*, n_classes> head{};
+    std::array<std::size_t, n_classes> count{};
+    bool* destroyed;
+
+    explicit FreeLists(bool* d)
+        : destroyed(d)
+    {}
+    ~FreeLists()
+    {
+        for (FreeBlock* b : head) {
+            while (b) {
+                FreeBlock* next = b->next;
+                ::operator delete(b);
+                b = next;
+            }
+        }
+        *destroyed = true;
+    }
+};
+
+// Null once the thread's lists are gone: a mesh destroyed after them, during thread or
+// process exit, frees straight to the system allocator.
+FreeLists* free_lists()
+{
+    thread_local bool destroyed = false;
+    if (destroyed) return nullptr;
+    thread_local FreeLists lists(&destroyed);
+    return &lists;
+}
+
+// The smallest class that holds @p bytes, or -1 if none does. SmallVector asks for powers of
+// two, which fill their class exactly.
+int size_class(std::size_t bytes)
+{
+    int c = 0;
+    while ((std::size_t(1) << c) < std::max(bytes, sizeof(FreeBlock))) ++c;
+    return c < int(n_classes) ? c : -1;
+}
+
+} // namespace
+
+void* small_vector_allocate(std::size_t bytes)
+{
+    const int c = size_class(bytes);
+    FreeLists* lists = c >= 0 ? free_lists() : nullptr;
+    if (lists && lists->head[c]) {
+        FreeBlock* b = lists->head[c];
+        lists->head[c] = b->next;
+        --lists->count[c];
+        return b;
+    }
+    return ::operator new(c >= 0 ? std::size_t(1) << c : bytes);
+}
+
+void small_vector_deallocate(void* p, std::size_t bytes)
+{
+    const int c = size_class(bytes);
+    FreeLists* lists = c >= 0 ? free_lists() : nullptr;
+    if (lists && lists->count[c] < max_cached) {
+        FreeBlock* b = static_cast<FreeBlock*>(p);
+        b->next = lists->head[c];
+        lists->head[c] = b;
+        ++lists->count[c];
+        return;
+    }
+    ::operator delete(p);
+}
+
+} // namespace wmtk::detail
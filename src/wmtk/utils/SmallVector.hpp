@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace wmtk {
+
+namespace detail {
+// Overflow blocks for SmallVector, recycled through per-thread free lists, one list per
+// power-of-two block size. Blocks freed on a thread go to that thread's lists, whichever
+// thread allocated them; each list keeps a bounded number of blocks and returns the rest to
+// the system allocator, as does a thread when it exits.
+void* small_vector_allocate(std::size_t bytes);
+void small_vector_deallocate(void* p, std::size_t bytes);
+} // namespace detail
+
+/**
+ * A vector of trivially copyable elements that holds up to N of them inline, in the object
+ * itself, and moves to a heap block when it grows past that.
+ *
+ * Used for the vertex stars of TetMesh and TriMesh (m_conn_tets, m_conn_tris): with N at the
+ * typical valence, most stars never allocate, a ring walk reads the vertex record and the ids
+ * from the same cache lines, and the stars that do overflow get their blocks from
+ * detail::small_vector_allocate rather than malloc. Heap capacities are powers of two, so the
+ * blocks of one size are interchangeable between stars.
+ *
+ * The interface is the subset of std::vector the mesh code uses. Iterators are pointers, and
+ * like std::vector's they are invalidated by any operation that may grow the vector.
+ */
+template <typename T, std::size_t N>
+class SmallVector
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector moves its elements with memcpy");
+    static_assert(N > 0);
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+    SmallVector(std::initializer_list<T> l) { assign(l.begin(), l.end()); }
+    template <typename It, typename = typename std::iterator_traits<It>::iterator_category>
+    SmallVector(It first, It last)
+    {
+        assign(first, last);
+    }
+    explicit SmallVector(const std::vector<T>& v) { assign(v.begin(), v.end()); }
+    SmallVector(const SmallVector& o) { assign(o.begin(), o.end()); }
+    SmallVector(SmallVector&& o) noexcept { steal(o); }
+    ~SmallVector() { release(); }
+
+    SmallVector& operator=(const SmallVector& o)
+    {
+        if (this != &o) assign(o.begin(), o.end());
+        return *this;
+    }
+    SmallVector& operator=(SmallVector&& o) noexcept
+    {
+        if (this != &o) {
+            release();
+            steal(o);
+        }
+        return *this;
+    }
+    SmallVector& operator=(std::initializer_list<T> l)
+    {
+        assign(l.begin(), l.end());
+        return *this;
+    }
+
+    template <typename It>
+    void assign(It first, It last)
+    {
+        const size_type n = static_cast<size_type>(std::distance(first, last));
+        m_size = 0;
+        reserve(n);
+        std::copy(first, last, data());
+        m_size = static_cast<std::uint32_t>(n);
+    }
+
+    T* data() { return is_inline() ? m_inline : m_heap; }
+    const T* data() const { return is_inline() ? m_inline : m_heap; }
+    iterator begin() { return data(); }
+    iterator end() { return data() + m_size; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + m_size; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_type size() const { return m_size; }
+    size_type capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+    static constexpr size_type inline_capacity() { return N; }
+
+    T& operator[](size_type i)
+    {
+        assert(i < m_size);
+        return data()[i];
+    }
+    const T& operator[](size_type i) const
+    {
+        assert(i < m_size);
+        return data()[i];
+    }
+    T& front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+    T& back() { return (*this)[m_size - 1]; }
+    const T& back() const { return (*this)[m_size - 1]; }
+
+    void reserve(size_type n)
+    {
+        if (n > m_capacity) grow(n);
+    }
+    void clear() { m_size = 0; }
+    void resize(size_type n, const T& value = T())
+    {
+        reserve(n);
+        std::fill(data() + std::min<size_type>(m_size, n), data() + n, value);
+        m_size = static_cast<std::uint32_t>(n);
+    }
+
+    void push_back(const T& value)
+    {
+        if (m_size == m_capacity) {
+            const T copy = value; // may alias the storage grow() is about to free
+            grow(m_size + 1);
+            data()[m_size++] = copy;
+        } else {
+            data()[m_size++] = value;
+        }
+    }
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        push_back(T(std::forward<Args>(args)...));
+        return back();
+    }
+    void pop_back()
+    {
+        assert(m_size > 0);
+        --m_size;
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        const size_type i = static_cast<size_type>(pos - begin());
+        assert(i <= m_size);
+        const T copy = value;
+        reserve(m_size + 1);
+        T* d = data();
+        std::memmove(d + i + 1, d + i, (m_size - i) * sizeof(T));
+        d[i] = copy;
+        ++m_size;
+        return d + i;
+    }
+    template <typename It, typename = typename std::iterator_traits<It>::iterator_category>
+    iterator insert(const_iterator pos, It first, It last)
+    {
+        const size_type i = static_cast<size_type>(pos - begin());
+        assert(i <= m_size);
+        const size_type n = static_cast<size_type>(std::distance(first, last));
+        if (n == 0) return begin() + i;
+        // Copy first: the range may live in this vector.
+        const std::vector<T> items(first, last);
+        reserve(m_size + n);
+        T* d = data();
+        std::memmove(d + i + n, d + i, (m_size - i) * sizeof(T));
+        std::copy(items.begin(), items.end(), d + i);
+        m_size += static_cast<std::uint32_t>(n);
+        return d + i;
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        T* d = data();
+        const size_type i = static_cast<size_type>(first - d);
+        const size_type j = static_cast<size_type>(last - d);
+        assert(i <= j && j <= m_size);
+        std::memmove(d + i, d + j, (m_size - j) * sizeof(T));
+        m_size -= static_cast<std::uint32_t>(j - i);
+        return d + i;
+    }
+
+    /// Release a heap block the elements would now fit without, as std::vector::shrink_to_fit.
+    void shrink_to_fit()
+    {
+        if (is_inline() || m_size > N) return;
+        T* heap = m_heap;
+        const size_type cap = m_capacity;
+        std::memcpy(m_inline, heap, m_size * sizeof(T));
+        m_capacity = N;
+        detail::small_vector_deallocate(heap, cap * sizeof(T));
+    }
+
+    friend bool operator==(const SmallVector& a, const SmallVector& b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend bool operator!=(const SmallVector& a, const SmallVector& b) { return !(a == b); }
+    friend bool operator<(const SmallVector& a, const SmallVector& b)
+    {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend bool operator==(const SmallVector& a, const std::vector<T>& b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend bool operator==(const std::vector<T>& a, const SmallVector& b) { return b == a; }
+    friend bool operator!=(const SmallVector& a, const std::vector<T>& b) { return !(a == b); }
+    friend bool operator!=(const std::vector<T>& a, const SmallVector& b) { return !(b == a); }
+
+private:
+    bool is_inline() const { return m_capacity == N; }
+
+    void grow(size_type n)
+    {
+        size_type cap = 1;
+        while (cap < n || cap <= m_capacity) cap *= 2;
+        T* heap = static_cast<T*>(detail::small_vector_allocate(cap * sizeof(T)));
+        std::memcpy(heap, data(), m_size * sizeof(T));
+        release();
+        m_heap = heap;
+        m_capacity = static_cast<std::uint32_t>(cap);
+    }
+
+    void release()
+    {
+        if (!is_inline()) {
+            detail::small_vector_deallocate(m_heap, m_capacity * sizeof(T));
+            m_capacity = N;
+        }
+    }
+
+    // Leaves o empty and inline; expects this to hold no heap block.
+    void steal(SmallVector& o)
+    {
+        m_size = o.m_size;
+        if (o.is_inline()) {
+            std::memcpy(m_inline, o.m_inline, m_size * sizeof(T));
+            m_capacity = N;
+        } else {
+            m_heap = o.m_heap;
+            m_capacity = o.m_capacity;
+            o.m_capacity = N;
+        }
+        o.m_size = 0;
+    }
+
+    std::uint32_t m_size = 0;
+    std::uint32_t m_capacity = N;
+    union
+    {
+        T m_inline[N];
+        T* m_heap;
+    };
+};
+
+} // namespace wmtk
@@ -8,6 +8,9 @@ void unique_edge_tuples(const TetMesh& m, std::vector<TetMesh::Tuple>& edges)
 {
     std::vector<size_t> edge_ids;
     for (const TetMesh::Tuple& e : edges) {
+        // A stale tuple names no edge: its tet slot may since have been recycled for a tet
+        // that does not have that edge at all.
+        if (!e.is_valid(m)) continue;
         edge_ids.push_back(e.eid(m));
     }
     std::sort(edge_ids.begin(), edge_ids.end());
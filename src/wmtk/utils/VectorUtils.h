@@ -5,13 +5,61 @@
 #include <iostream>
 #include <map>
 #include <set>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include "wmtk/utils/Logger.hpp"
 
 namespace wmtk {
 
+// The element to look for is taken as the container's own type, not deduced from the argument,
+// so a size_t id can be looked up in a star of index_t (see Types.hpp) without a cast. The
+// helpers below take any contiguous container with the std::vector interface, which the
+// vertex stars (SmallVector) are.
 template <class T>
-inline std::vector<T> set_intersection(const std::vector<T>& v1, const std::vector<T>& v2)
+struct type_identity
+{
+    using type = T;
+};
+template <class T>
+using type_identity_t = typename type_identity<T>::type;
+
+/**
+ * Copy ids between the storage type (index_t) and size_t. When the two are the same type, as in
+ * the default build, the array is returned as is and an rvalue vector is moved, not copied.
+ */
+template <class To, class From, size_t N>
+inline std::array<To, N> array_cast(const std::array<From, N>& a)
+{
+    if constexpr (std::is_same_v<To, From>) {
+        return a;
+    } else {
+        std::array<To, N> out;
+        for (size_t i = 0; i < N; ++i) {
+            out[i] = static_cast<To>(a[i]);
+        }
+        return out;
+    }
+}
+
+template <class To, class From>
+inline std::vector<To> vector_cast(std::vector<From>&& v)
+{
+    if constexpr (std::is_same_v<To, From>) {
+        return std::move(v);
+    } else {
+        return std::vector<To>(v.begin(), v.end());
+    }
+}
+
+template <class To, class V>
+inline std::vector<To> vector_cast(const V& v)
+{
+    return std::vector<To>(v.begin(), v.end());
+}
+
+template <class V1, class V2>
+inline std::vector<typename V1::value_type> set_intersection(const V1& v1, const V2& v2)
 {
     if (v1.size() > 1) {
         assert(std::is_sorted(v1.begin(), v1.end()));
@@ -20,14 +68,14 @@ inline std::vector<T> set_intersection(const std::vector<T>& v1, const std::vect
         assert(std::is_sorted(v2.begin(), v2.end()));
     }
 
-    std::vector<T> v;
+    std::vector<typename V1::value_type> v;
     v.reserve(std::min(v1.size(), v2.size()));
     std::set_intersection(v1.begin(), v1.end(), v2.begin(), v2.end(), std::back_inserter(v));
     return v;
 }
 
-template <class T>
-inline void vector_unique(std::vector<T>& v)
+template <class V>
+inline void vector_unique(V& v)
 {
     if (v.size() > 1) {
         std::sort(v.begin(), v.end());
@@ -35,8 +83,8 @@ inline void vector_unique(std::vector<T>& v)
     }
 }
 
-template <class T, typename Comp, typename Equal>
-inline void vector_unique(std::vector<T>& v, Comp comp, Equal equal)
+template <class V, typename Comp, typename Equal>
+inline void vector_unique(V& v, Comp comp, Equal equal)
 {
     if (v.size() > 1) {
         std::sort(v.begin(), v.end(), comp);
@@ -51,16 +99,16 @@ inline void vector_print(std::vector<T>& v)
     wmtk::logger().info("vector {}", v);
 }
 
-template <class T>
-inline void vector_sort(std::vector<T>& v)
+template <class V>
+inline void vector_sort(V& v)
 {
     if (v.size() > 1) {
         std::sort(v.begin(), v.end());
     }
 }
 
-template <class T>
-inline bool vector_erase(std::vector<T>& v, const T& t)
+template <class V>
+inline bool vector_erase(V& v, const typename V::value_type& t)
 {
     auto it = std::find(v.begin(), v.end(), t);
     if (it == v.end()) return false;
@@ -68,16 +116,16 @@ inline bool vector_erase(std::vector<T>& v, const T& t)
     return true;
 }
 
-template <class T>
-inline bool vector_contains(const std::vector<T>& v, const T& t)
+template <class V>
+inline bool vector_contains(const V& v, const typename V::value_type& t)
 {
     auto it = std::find(v.begin(), v.end(), t);
     if (it == v.end()) return false;
     return true;
 }
 
-template <typename T>
-inline bool set_erase(std::vector<T>& v, const T& t)
+template <typename V>
+inline bool set_erase(V& v, const typename V::value_type& t)
 {
     assert(std::is_sorted(v.begin(), v.end()));
     auto it = std::lower_bound(v.begin(), v.end(), t);
@@ -86,8 +134,8 @@ inline bool set_erase(std::vector<T>& v, const T& t)
     return true;
 }
 
-template <typename T>
-inline bool set_insert(std::vector<T>& vec, const T& val)
+template <typename V>
+inline bool set_insert(V& vec, const typename V::value_type& val)
 {
     assert(std::is_sorted(vec.begin(), vec.end()));
     auto it = std::lower_bound(vec.begin(), vec.end(), val);
@@ -118,7 +166,10 @@ void set_union_inplace(std::vector<T>& vec, const std::vector<T>& vec2)
 }
 
 template <typename T, size_t N>
-inline void array_replace_inline(std::array<T, N>& arr, const T& v0, const T& v1)
+inline void array_replace_inline(
+    std::array<T, N>& arr,
+    const type_identity_t<T>& v0,
+    const type_identity_t<T>& v1)
 {
     for (auto j = 0; j < N; j++) {
         if (arr[j] == v0) {
@@ -129,7 +180,10 @@ inline void array_replace_inline(std::array<T, N>& arr, const T& v0, const T& v1
 }
 
 template <typename T, size_t N>
-inline std::array<T, N> array_replace(const std::array<T, N>& arr, const T& v0, const T& v1)
+inline std::array<T, N> array_replace(
+    const std::array<T, N>& arr,
+    const type_identity_t<T>& v0,
+    const type_identity_t<T>& v1)
 {
     std::array<T, N> out = arr;
     array_replace_inline(out, v0, v1);
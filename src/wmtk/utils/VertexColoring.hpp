@@ -0,0 +1,74 @@
+#pragma once
+
+#include <wmtk/threading/parallel_for.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace wmtk::utils {
+
+/**
+ * @brief Greedy distance-1 coloring of a vertex set: no two vertices of one class are
+ * neighbours.
+ *
+ * With `neighbors` returning a vertex's one-ring, two vertices of a class share no cell, so an
+ * operation that moves one vertex and writes only the cells around it -- smoothing -- can run
+ * on a whole class at once without touching anything a classmate reads or writes. That is the
+ * guarantee ExecutionPolicy::kColor builds per round from lock footprints; smoothing changes no
+ * connectivity, so here it is built once and reused for as many passes as the caller likes.
+ *
+ * The neighbour lists are gathered in parallel (that is where the time goes: one one-ring
+ * query per vertex) and the coloring itself is a serial sweep over them in the order of
+ * @p vids, so the classes depend on that order and never on the thread count. Vertices outside
+ * @p vids are never colored and never constrain anything: they are not going to move.
+ *
+ * @param n_verts an upper bound on every vertex id involved, usually vert_capacity()
+ * @param vids the vertices to color
+ * @param neighbors `void(size_t vid, std::vector<size_t>& out)` -- fills @p out with the
+ *   vertex's neighbours; duplicates and the vertex itself are allowed
+ * @return the color classes in color order, each in the order of @p vids
+ */
+template <class Neighbors>
+std::vector<std::vector<size_t>> color_vertices(
+    const size_t n_verts,
+    const std::vector<size_t>& vids,
+    Neighbors&& neighbors,
+    const int num_threads)
+{
+    std::vector<std::vector<size_t>> adj(vids.size());
+    threading::parallel_for(
+        threading::range(0, vids.size()),
+        [&](const threading::range& r) {
+            for (size_t i = r.begin(); i < r.end(); ++i) {
+                neighbors(vids[i], adj[i]);
+            }
+        },
+        num_threads);
+
+    // The lowest color no already-colored neighbour carries. `mark[c] == i + 1` means color c
+    // is taken for vertex i; stamping instead of clearing keeps the sweep linear.
+    std::vector<int> color(n_verts, -1);
+    std::vector<size_t> mark;
+    std::vector<std::vector<size_t>> classes;
+    for (size_t i = 0; i < vids.size(); ++i) {
+        for (const size_t w : adj[i]) {
+            const int c = color[w];
+            if (c >= 0) {
+                mark[c] = i + 1;
+            }
+        }
+        int c = 0;
+        while (size_t(c) < mark.size() && mark[c] == i + 1) {
+            ++c;
+        }
+        if (size_t(c) == mark.size()) {
+            mark.push_back(0);
+            classes.emplace_back();
+        }
+        color[vids[i]] = c;
+        classes[c].push_back(vids[i]);
+    }
+    return classes;
+}
+
+} // namespace wmtk::utils
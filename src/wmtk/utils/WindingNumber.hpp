@@ -109,9 +109,12 @@ inline void winding_number(
     hier.grow();
 
     // hier.winding_number(p) is const and used by igl the same way from parallel_for,
-    // so concurrent queries against the shared hierarchy are safe.
+    // so concurrent queries against the shared hierarchy are safe. The cost of a query is
+    // how deep it has to descend: points near the surface open far more of the hierarchy
+    // than points far from it, and tet barycenters cluster near the surface in space but
+    // not in id order, so the range is handed out in small chunks rather than split evenly.
     threading::parallel_for(
-        threading::range(0, static_cast<size_t>(O.rows())),
+        threading::range(0, static_cast<size_t>(O.rows()), 256),
         [&](const threading::range& r) {
             for (int o = r.begin(); o < r.end(); ++o) {
                 W(o) = hier.winding_number(O.row(o));
@@ -1,11 +1,187 @@
 #include "orient.hpp"
 
+#include <wmtk/threading/enumerable_thread_specific.hpp>
 #include <wmtk/utils/Rational.hpp>
 #include <wmtk/utils/predicates.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
 namespace wmtk::utils {
 
+namespace {
+
+// A closed interval of doubles. Every operation rounds to nearest and then moves each bound
+// one ulp outwards, which covers the rounding error (at most half an ulp) without having to
+// switch the FPU's rounding mode.
+struct Interval
+{
+    double lo;
+    double hi;
+};
+
+// std::nextafter, minus the handling of infinities and NaN the filter never lets in; the libm
+// call was most of the filter's cost.
+inline double up(double x)
+{
+    if (x == 0) return std::numeric_limits<double>::denorm_min();
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(x));
+    bits += x > 0 ? 1 : -1;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+inline double down(double x)
+{
+    return -up(-x);
+}
+
+// The enclosure of a coordinate known only to within one ulp of q.
+inline Interval around(double q)
+{
+    return {down(q), up(q)};
+}
+
+inline Interval operator+(const Interval& a, const Interval& b)
+{
+    return {down(a.lo + b.lo), up(a.hi + b.hi)};
+}
+inline Interval operator-(const Interval& a, const Interval& b)
+{
+    return {down(a.lo - b.hi), up(a.hi - b.lo)};
+}
+inline Interval operator*(const Interval& a, const Interval& b)
+{
+    const double p0 = a.lo * b.lo;
+    const double p1 = a.lo * b.hi;
+    const double p2 = a.hi * b.lo;
+    const double p3 = a.hi * b.hi;
+    return {down(std::min({p0, p1, p2, p3})), up(std::max({p0, p1, p2, p3}))};
+}
+
+inline int sign(const Interval& x)
+{
+    return x.lo > 0 ? 1 : (x.hi < 0 ? -1 : 0);
+}
+
+// Beyond this the products could overflow, or a NaN slip through min/max; such inputs are
+// left to the exact evaluation. Nothing the mesh code builds comes anywhere near it.
+constexpr double kMaxFiltered = 1e100;
+
+template <int N>
+inline bool filterable(const Eigen::Matrix<double, N, 1>& q)
+{
+    for (int i = 0; i < N; ++i) {
+        if (!(std::abs(q[i]) < kMaxFiltered)) return false;
+    }
+    return true;
+}
+
+struct FilterCounts
+{
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+threading::enumerable_thread_specific<FilterCounts>& filter_counts()
+{
+    static threading::enumerable_thread_specific<FilterCounts> counts;
+    return counts;
+}
+
+} // namespace
+
+int orient3d_interval_sign(
+    const Vector3d& q0,
+    const Vector3d& q1,
+    const Vector3d& q2,
+    const Vector3d& q3)
+{
+    if (!filterable(q0) || !filterable(q1) || !filterable(q2) || !filterable(q3)) return 0;
+
+    // The same expression as orient3d_exact below, term for term.
+    Interval a[3], b[3], d[3];
+    for (int k = 0; k < 3; ++k) {
+        const Interval o = around(q0[k]);
+        a[k] = around(q1[k]) - o;
+        b[k] = around(q2[k]) - o;
+        d[k] = around(q3[k]) - o;
+    }
+    const Interval nx = a[1] * b[2] - a[2] * b[1];
+    const Interval ny = a[2] * b[0] - a[0] * b[2];
+    const Interval nz = a[0] * b[1] - a[1] * b[0];
+    return sign(nx * d[0] + ny * d[1] + nz * d[2]);
+}
+
+int orient2d_interval_sign(const Vector2d& q0, const Vector2d& q1, const Vector2d& q2)
+{
+    if (!filterable(q0) || !filterable(q1) || !filterable(q2)) return 0;
+
+    const Interval ax = around(q1[0]) - around(q0[0]);
+    const Interval ay = around(q1[1]) - around(q0[1]);
+    const Interval bx = around(q2[0]) - around(q0[0]);
+    const Interval by = around(q2[1]) - around(q0[1]);
+    return sign(ax * by - ay * bx);
+}
+
+void count_orient_filter(const bool hit)
+{
+    FilterCounts& c = filter_counts().local();
+    if (hit) {
+        ++c.hits;
+    } else {
+        ++c.misses;
+    }
+}
+
+OrientFilterStats orient_filter_stats()
+{
+    OrientFilterStats stats;
+    for (const FilterCounts& c : filter_counts()) {
+        stats.hits += c.hits;
+        stats.misses += c.misses;
+    }
+    return stats;
+}
+
+void reset_orient_filter_stats()
+{
+    for (FilterCounts& c : filter_counts()) {
+        c = FilterCounts();
+    }
+}
+
 bool orient3d(const Vector3r& p0, const Vector3r& p1, const Vector3r& p2, const Vector3r& p3)
+{
+    const int s = orient3d_interval_sign(
+        Vector3d(p0[0].to_double(), p0[1].to_double(), p0[2].to_double()),
+        Vector3d(p1[0].to_double(), p1[1].to_double(), p1[2].to_double()),
+        Vector3d(p2[0].to_double(), p2[1].to_double(), p2[2].to_double()),
+        Vector3d(p3[0].to_double(), p3[1].to_double(), p3[2].to_double()));
+    count_orient_filter(s != 0);
+    if (s != 0) return s > 0;
+    return orient3d_exact(p0, p1, p2, p3);
+}
+
+bool orient2d(const Vector2r& p0, const Vector2r& p1, const Vector2r& p2)
+{
+    const int s = orient2d_interval_sign(
+        Vector2d(p0[0].to_double(), p0[1].to_double()),
+        Vector2d(p1[0].to_double(), p1[1].to_double()),
+        Vector2d(p2[0].to_double(), p2[1].to_double()));
+    count_orient_filter(s != 0);
+    if (s != 0) return s > 0;
+    return orient2d_exact(p0, p1, p2);
+}
+
+bool orient3d_exact(
+    const Vector3r& p0,
+    const Vector3r& p1,
+    const Vector3r& p2,
+    const Vector3r& p3)
 {
     const Vector3r a(p1 - p0);
     const Vector3r b(p2 - p0);
@@ -52,12 +228,12 @@ bool orient3d(const Vector3d& p0, const Vector3d& p1, const Vector3d& p2, const
     return false;
 }
 
-bool orient2d(const Vector2r& p0, const Vector2r& p1, const Vector2r& p2)
+bool orient2d_exact(const Vector2r& p0, const Vector2r& p1, const Vector2r& p2)
 {
-    Eigen::Matrix2<Rational> M;
-    M.row(0) = p1 - p0;
-    M.row(1) = p2 - p0;
-    const Rational det = M(0, 0) * M(1, 1) - M(0, 1) * M(1, 0);
+    const Vector2r a = p1 - p0;
+    const Vector2r b = p2 - p0;
+    // The products are temporaries, so the subtraction reuses the first one's storage.
+    const Rational det = a[0] * b[1] - a[1] * b[0];
     // logger().info("{}", det.to_double());
     return det.get_sign() == 1;
 }
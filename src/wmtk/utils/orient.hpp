@@ -2,8 +2,16 @@
 
 #include <wmtk/Types.hpp>
 
+#include <cstddef>
+
 namespace wmtk::utils {
 
+/**
+ * Exact orientation of rational points, filtered: the sign is first evaluated in interval
+ * arithmetic on double enclosures of the coordinates, and the rational determinant is only
+ * computed when that interval contains zero. Nearly every tet the mesh code asks about is
+ * far from flat, so the filter decides nearly every call.
+ */
 bool orient3d(const Vector3r& p0, const Vector3r& p1, const Vector3r& p2, const Vector3r& p3);
 
 bool orient3d(const Vector3d& p0, const Vector3d& p1, const Vector3d& p2, const Vector3d& p3);
@@ -12,4 +20,51 @@ bool orient2d(const Vector2r& p0, const Vector2r& p1, const Vector2r& p2);
 
 bool orient2d(const Vector2d& p0, const Vector2d& p1, const Vector2d& p2);
 
-} // namespace wmtk::utils
\ No newline at end of file
+/// The rational determinant alone, without the filter.
+bool orient3d_exact(
+    const Vector3r& p0,
+    const Vector3r& p1,
+    const Vector3r& p2,
+    const Vector3r& p3);
+
+bool orient2d_exact(const Vector2r& p0, const Vector2r& p1, const Vector2r& p2);
+
+/**
+ * The interval filter on its own, for callers that already hold double approximations of
+ * their rational points -- the optimizer meshes keep `m_posf == to_double(exact)` for every
+ * vertex, which saves converting the rationals again, and building the rational positions of
+ * the rounded ones at all. Such a caller runs the filter, counts it with count_orient_filter,
+ * and only calls orient3d_exact on a miss.
+ *
+ * Each coordinate of each q_i is taken to be within one ulp of the exact one, which holds for
+ * Rational::to_double (nearest or truncated, depending on the representation) and trivially
+ * for exact doubles. Returns +1 or -1 for the sign of the same determinant as the rational
+ * orient3d / orient2d above, or 0 if the filter cannot decide and the caller has to evaluate it
+ * exactly.
+ */
+int orient3d_interval_sign(
+    const Vector3d& q0,
+    const Vector3d& q1,
+    const Vector3d& q2,
+    const Vector3d& q3);
+
+int orient2d_interval_sign(const Vector2d& q0, const Vector2d& q1, const Vector2d& q2);
+
+/**
+ * How often the interval filter decided a rational orientation (hits) and how often it had to
+ * fall back to GMP (misses), summed over every thread. Counted per thread without
+ * synchronisation, so read or reset them between passes, not while predicates run.
+ */
+struct OrientFilterStats
+{
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+OrientFilterStats orient_filter_stats();
+void reset_orient_filter_stats();
+
+/// Count one decision of the filter; for the callers of orient*_interval_sign.
+void count_orient_filter(bool hit);
+
+} // namespace wmtk::utils
@@ -3,16 +3,14 @@
 #include <wmtk/utils/Morton.h>
 #include <wmtk/threading/parallel_for.hpp>
 
-void wmtk::partition_vertex_morton(
+std::vector<uint64_t> wmtk::morton_codes(
     size_t vert_size,
     const std::function<Eigen::Vector3d(size_t)>& pos,
-    int num_partition,
-    std::vector<size_t>& result)
+    int num_threads)
 {
-    result.clear();
-    result.resize(vert_size);
-    if (vert_size == 0 || num_partition <= 0) {
-        return; // V.front() below would be out of bounds
+    std::vector<uint64_t> codes(vert_size);
+    if (vert_size == 0) {
+        return codes; // V.front() below would be out of bounds
     }
 
     std::vector<Eigen::Vector3d> V_v(vert_size);
@@ -24,18 +22,8 @@ void wmtk::partition_vertex_morton(
                 V_v[i] = pos(i);
             }
         },
-        num_partition);
-
+        num_threads);
 
-    struct sortstruct
-    {
-        size_t order;
-        Resorting::MortonCode64 morton;
-    };
-
-    std::vector<sortstruct> list_v;
-    list_v.resize(V_v.size());
-    // std::vector<sortstruct> list;
     const int multi = 1000;
     // since the morton code requires a correct scale of input vertices,
     //  we need to scale the vertices if their coordinates are out of range
@@ -61,7 +49,7 @@ void wmtk::partition_vertex_morton(
                 V[i] = V[i] - center;
             }
         },
-        num_partition);
+        num_threads);
 
     Eigen::Vector3d scale_point =
         vmax - center; // after placing box at origin, vmax and vmin are symetric.
@@ -79,21 +67,50 @@ void wmtk::partition_vertex_morton(
                     V[i] = V[i] / scale;
                 }
             },
-            num_partition);
+            num_threads);
     }
 
     threading::parallel_for(
         threading::range(0, V.size()),
         [&](const threading::range& r) {
             for (size_t i = r.begin(); i < r.end(); i++) {
-                list_v[i].morton = Resorting::MortonCode64(
+                codes[i] = uint64_t(Resorting::MortonCode64(
                     int(V[i][0] * multi),
                     int(V[i][1] * multi),
-                    int(V[i][2] * multi));
-                list_v[i].order = i;
+                    int(V[i][2] * multi)));
             }
         },
-        num_partition);
+        num_threads);
+
+    return codes;
+}
+
+void wmtk::partition_vertex_morton(
+    size_t vert_size,
+    const std::function<Eigen::Vector3d(size_t)>& pos,
+    int num_partition,
+    std::vector<size_t>& result)
+{
+    result.clear();
+    result.resize(vert_size);
+    if (vert_size == 0 || num_partition <= 0) {
+        return;
+    }
+
+    const std::vector<uint64_t> codes = morton_codes(vert_size, pos, num_partition);
+
+    struct sortstruct
+    {
+        size_t order;
+        uint64_t morton;
+    };
+
+    std::vector<sortstruct> list_v;
+    list_v.resize(vert_size);
+    for (size_t i = 0; i < vert_size; i++) {
+        list_v[i].morton = codes[i];
+        list_v[i].order = i;
+    }
 
     const auto morton_compare = [](const sortstruct& a, const sortstruct& b) {
         return (a.morton < b.morton);
@@ -3,11 +3,26 @@
 #include <Eigen/Core>
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <vector>
 
 namespace wmtk {
 
+/**
+ * @brief The 64-bit Morton code of each vertex, after centering the positions on their bounding
+ * box (and scaling them down if it is large). Sorting vertices by code orders them along a
+ * space-filling curve.
+ *
+ * @param vert_size   number of vertices (ids 0..vert_size-1)
+ * @param pos         position of vertex i
+ * @param num_threads thread count, as for threading::parallel_for
+ */
+std::vector<uint64_t> morton_codes(
+    size_t vert_size,
+    const std::function<Eigen::Vector3d(size_t)>& pos,
+    int num_threads);
+
 /**
  * @brief Assign each vertex a partition id by sorting the vertices along a Morton curve
  * and cutting the resulting order into `num_partition` equal runs.
@@ -0,0 +1,190 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <igl/Timer.h>
+#include <wmtk/Types.hpp>
+#include <wmtk/utils/AMIPS.h>
+#include <wmtk/utils/AMIPS2D.h>
+#include <wmtk/utils/AMIPSBatch.h>
+#include <wmtk/utils/Logger.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace wmtk;
+
+namespace {
+// A one-ring of `n` random cells around `x`, offset far from the origin so that the closed
+// form is also exercised where the generated expressions need their translation.
+std::vector<std::array<double, 12>>
+random_ring_3d(std::mt19937& rng, const size_t n, const Vector3d& offset)
+{
+    std::uniform_real_distribution<double> U(-1, 1);
+    std::vector<std::array<double, 12>> cells(n);
+    for (auto& c : cells) {
+        for (int k = 0; k < 12; ++k) c[k] = U(rng) + offset[k % 3];
+    }
+    return cells;
+}
+
+std::vector<std::array<double, 6>> random_ring_2d(std::mt19937& rng, const size_t n)
+{
+    std::uniform_real_distribution<double> U(-1, 1);
+    std::vector<std::array<double, 6>> cells(n);
+    for (auto& c : cells) {
+        for (double& v : c) v = U(rng);
+    }
+    return cells;
+}
+
+double rel(const double a, const double b)
+{
+    return std::abs(a - b) / std::max(1.0, std::abs(b));
+}
+} // namespace
+
+TEST_CASE("amips_batch_matches_scalar_3d", "[energies][amips]")
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> U(-0.1, 0.1);
+    for (const Vector3d offset : {Vector3d(0, 0, 0), Vector3d(100, 50, -20)}) {
+        // Sizes on both sides of the block width.
+        for (const size_t n : {1, 5, 16, 17, 40}) {
+            const auto cells = random_ring_3d(rng, n, offset);
+            const Vector3d x = offset + Vector3d(U(rng), U(rng), U(rng));
+
+            double E = 0;
+            Vector3d G = Vector3d::Zero();
+            Matrix3d H = Matrix3d::Zero();
+            for (auto c : cells) {
+                c[0] = x[0];
+                c[1] = x[1];
+                c[2] = x[2];
+                E += AMIPS_energy(c);
+                Vector3d g;
+                AMIPS_jacobian(c, g);
+                G += g;
+                Matrix3d h;
+                AMIPS_hessian(c, h);
+                H += h;
+            }
+
+            Vector3d Gb;
+            Matrix3d Hb;
+            const double Eb = AMIPS_one_ring(cells, x, &Gb, &Hb);
+            CHECK(rel(Eb, E) < 1e-9);
+            CHECK((Gb - G).norm() / std::max(1.0, G.norm()) < 1e-9);
+            CHECK((Hb - H).norm() / std::max(1.0, H.norm()) < 1e-9);
+            CHECK(AMIPS_one_ring(cells, x) == Eb);
+
+            std::vector<double> e(n);
+            AMIPS_energies(cells.data(), n, e.data());
+            for (size_t i = 0; i < n; ++i) {
+                CHECK(rel(e[i], AMIPS_energy(cells[i])) < 1e-9);
+            }
+        }
+    }
+
+    // A flat tet has no AMIPS; both must say so.
+    const std::array<double, 12> flat = {{0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0}};
+    double e;
+    AMIPS_energies(&flat, 1, &e);
+    CHECK_FALSE(std::isfinite(e));
+    CHECK_FALSE(std::isfinite(AMIPS_energy(flat)));
+}
+
+TEST_CASE("amips_batch_matches_scalar_2d", "[energies][amips]")
+{
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> U(-1, 1);
+    for (const size_t n : {1, 6, 16, 33}) {
+        const auto cells = random_ring_2d(rng, n);
+        const Vector2d x(U(rng), U(rng));
+
+        double E = 0;
+        Vector2d G = Vector2d::Zero();
+        Matrix2d H = Matrix2d::Zero();
+        for (auto c : cells) {
+            c[0] = x[0];
+            c[1] = x[1];
+            E += AMIPS2D_energy(c);
+            Vector2d g;
+            AMIPS2D_jacobian(c, g);
+            G += g;
+            Matrix2d h;
+            AMIPS2D_hessian(c, h);
+            H += h;
+        }
+
+        Vector2d Gb;
+        Matrix2d Hb;
+        const double Eb = AMIPS2D_one_ring(cells, x, &Gb, &Hb);
+        CHECK(rel(Eb, E) < 1e-8);
+        CHECK((Gb - G).norm() / std::max(1.0, G.norm()) < 1e-8);
+        CHECK((Hb - H).norm() / std::max(1.0, H.norm()) < 1e-8);
+
+        std::vector<double> e(n);
+        AMIPS2D_energies(cells.data(), n, e.data());
+        for (size_t i = 0; i < n; ++i) {
+            CHECK(rel(e[i], AMIPS2D_energy(cells[i])) < 1e-8);
+        }
+    }
+
+    // The equilateral triangle is the optimum, AMIPS2D = 2.
+    const std::array<double, 6> eq = {{0, 0, 1, 0, 0.5, std::sqrt(3.) / 2}};
+    double e;
+    AMIPS2D_energies(&eq, 1, &e);
+    CHECK(std::abs(e - 2) < 1e-12);
+}
+
+TEST_CASE("amips_batch_performance", "[energies][amips][.]")
+{
+    // What one Newton iteration of smoothing asks for: energy, gradient and Hessian over a
+    // one-ring of typical size.
+    std::mt19937 rng(7);
+    const auto ring = random_ring_3d(rng, 24, Vector3d::Zero());
+    const Vector3d x(0.1, 0.2, 0.3);
+    const int reps = 200000;
+    igl::Timer timer;
+
+    double acc_scalar = 0;
+    timer.start();
+    for (int rep = 0; rep < reps; ++rep) {
+        double E = 0;
+        Vector3d G = Vector3d::Zero();
+        Matrix3d H = Matrix3d::Zero();
+        for (auto c : ring) {
+            c[0] = x[0];
+            c[1] = x[1];
+            c[2] = x[2];
+            E += AMIPS_energy(c);
+            Vector3d g;
+            AMIPS_jacobian(c, g);
+            G += g;
+            Matrix3d h;
+            AMIPS_hessian(c, h);
+            H += h;
+        }
+        acc_scalar += E + G[0] + H(0, 0);
+    }
+    timer.stop();
+    const double t_scalar = timer.getElapsedTimeInMilliSec();
+
+    double acc_batch = 0;
+    timer.start();
+    for (int rep = 0; rep < reps; ++rep) {
+        Vector3d G;
+        Matrix3d H;
+        acc_batch += AMIPS_one_ring(ring, x, &G, &H) + G[0] + H(0, 0);
+    }
+    timer.stop();
+    const double t_batch = timer.getElapsedTimeInMilliSec();
+
+    CHECK(rel(acc_batch, acc_scalar) < 1e-9);
+    logger().info(
+        "AMIPS one-ring (24 tets) x {}: scalar {} ms, batched {} ms; speedup {}",
+        reps,
+        t_scalar,
+        t_batch,
+        t_scalar / t_batch);
+}
@@ -29,6 +29,7 @@
 #include <wmtk/envelope/Envelope.hpp>
 
 #include <cmath>
+#include <random>
 
 using namespace wmtk;
 
@@ -52,6 +53,31 @@ void init_axis_2d(SampleEnvelope& env, double length, double eps)
     env.init(V, E, eps);
 }
 
+/// Height of a gently curved patch over the unit square, so that queries drift from one input
+/// facet to the next.
+double patch_height(double x, double y)
+{
+    return 0.05 * std::sin(4 * x) * std::cos(3 * y);
+}
+
+/// That patch, triangulated on an n x n grid.
+void curved_patch(int n, std::vector<Eigen::Vector3d>& V, std::vector<Eigen::Vector3i>& F)
+{
+    for (int j = 0; j <= n; ++j) {
+        for (int i = 0; i <= n; ++i) {
+            const double x = double(i) / n, y = double(j) / n;
+            V.emplace_back(x, y, patch_height(x, y));
+        }
+    }
+    for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < n; ++i) {
+            const int v = j * (n + 1) + i;
+            F.emplace_back(v, v + 1, v + n + 1);
+            F.emplace_back(v + 1, v + n + 2, v + n + 1);
+        }
+    }
+}
+
 } // namespace
 
 TEST_CASE("exact and sampled 3D segment envelopes agree away from the boundary", "[envelope]")
@@ -300,3 +326,144 @@ TEST_CASE("envelope_budget", "[envelope]")
         CHECK(optimization_envelope_eps(eps, 0.999999 * eps, true, true) > 0);
     }
 }
+
+// The batched triangle query: the same answers as one query per triangle, and most samples
+// answered without a BVH search.
+TEST_CASE("batched triangle queries agree with single ones", "[envelope]")
+{
+    std::vector<Eigen::Vector3d> V;
+    std::vector<Eigen::Vector3i> F;
+    curved_patch(20, V, F);
+    SampleEnvelope env;
+    env.init(V, F, 0.01);
+
+    // Fans of small triangles around a centre, the way an operation's ring looks, lifted off
+    // the surface by up to about eps so that some fans are inside and some are not.
+    const double pi = std::acos(-1.);
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> U(0.2, 0.8), lift(-0.012, 0.012);
+    size_t n_inside = 0, n_outside = 0;
+    for (int rep = 0; rep < 200; ++rep) {
+        const double cx = U(rng), cy = U(rng);
+        const Eigen::Vector3d c(cx, cy, patch_height(cx, cy) + lift(rng));
+        std::vector<std::array<Eigen::Vector3d, 3>> fan;
+        Eigen::Vector3d prev;
+        for (int k = 0; k <= 6; ++k) {
+            const double a = 2 * pi * k / 6;
+            const double x = cx + 0.04 * std::cos(a), y = cy + 0.04 * std::sin(a);
+            const Eigen::Vector3d p(x, y, patch_height(x, y) + lift(rng) / 4);
+            if (k > 0) {
+                fan.push_back({{c, prev, p}});
+            }
+            prev = p;
+        }
+
+        // The reference asks the BVH for every sample's nearest facet, as the envelope did
+        // before it had a facet cache, so neither the cache nor its distance kernel is on it.
+        size_t expected = fan.size();
+        for (size_t t = 0; t < fan.size() && expected == fan.size(); ++t) {
+            std::vector<Eigen::Vector3d> ps;
+            sampleTriangle(fan[t], ps, env.sampling_dist);
+            for (const Eigen::Vector3d& p : ps) {
+                if (env.squared_distance(p) > env.eps2) {
+                    expected = t;
+                    break;
+                }
+            }
+        }
+        CHECK(env.is_outside(fan[0]) == (expected == 0));
+        CHECK(env.first_outside(fan.data(), fan.size()) == expected);
+        CHECK(env.any_outside(fan) == (expected < fan.size()));
+        (expected < fan.size() ? n_outside : n_inside)++;
+    }
+    // Both answers were exercised.
+    CHECK(n_inside > 10);
+    CHECK(n_outside > 10);
+
+    // On the surface itself every fan is inside, and consecutive samples keep landing near
+    // facets already found: far fewer BVH searches than samples.
+    env.reset_query_stats();
+    std::vector<std::array<Eigen::Vector3d, 3>> on_surface;
+    for (size_t f = 0; f < F.size(); f += 7) {
+        on_surface.push_back({{V[F[f][0]], V[F[f][1]], V[F[f][2]]}});
+    }
+    CHECK_FALSE(env.any_outside(on_surface));
+    const SampleEnvelope::QueryStats stats = env.query_stats();
+    CHECK(stats.triangles == on_surface.size());
+    CHECK(stats.samples >= 3 * on_surface.size());
+    CHECK(stats.bvh_queries < stats.samples / 2);
+
+    // The counters are per envelope, and a fresh init starts them over.
+    env.init(V, F, 0.01);
+    CHECK(env.query_stats().samples == 0);
+}
+
+TEST_CASE("the distance grid answers like the BVH it stands in front of", "[envelope]")
+{
+    std::vector<Eigen::Vector3d> V;
+    std::vector<Eigen::Vector3i> F;
+    curved_patch(20, V, F);
+    const double eps = 0.02;
+    SampleEnvelope plain, gridded;
+    gridded.use_distance_grid = true;
+    plain.init(V, F, eps);
+    gridded.init(V, F, eps);
+    REQUIRE_FALSE(gridded.distance_grid().empty());
+    REQUIRE(plain.distance_grid().empty());
+
+    // The stored bounds are upper bounds on the true distance, everywhere.
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<double> U(0, 1), lift(-1.5 * eps, 1.5 * eps);
+    size_t n_bounded = 0;
+    for (int rep = 0; rep < 20000; ++rep) {
+        const double x = U(rng), y = U(rng);
+        const Eigen::Vector3d p(x, y, patch_height(x, y) + lift(rng));
+        const double b = gridded.distance_grid().bound(p);
+        if (std::isfinite(b)) {
+            CHECK(b * b >= plain.squared_distance(p));
+            ++n_bounded;
+        }
+    }
+    CHECK(n_bounded > 1000);
+
+    // And no query answers differently: points, segments and triangles straddling the
+    // boundary of the envelope.
+    const double pi = std::acos(-1.);
+    size_t n_inside = 0, n_outside = 0;
+    for (int rep = 0; rep < 300; ++rep) {
+        const double cx = 0.1 + 0.8 * U(rng), cy = 0.1 + 0.8 * U(rng);
+        const Eigen::Vector3d c(cx, cy, patch_height(cx, cy) + lift(rng) / 2);
+        CHECK(gridded.is_outside(c) == plain.is_outside(c));
+
+        const double a = 2 * pi * U(rng);
+        const double x = cx + 0.05 * std::cos(a), y = cy + 0.05 * std::sin(a);
+        const Eigen::Vector3d p(x, y, patch_height(x, y) + lift(rng) / 2);
+        const std::array<Eigen::Vector3d, 2> seg = {{c, p}};
+        CHECK(gridded.is_outside(seg) == plain.is_outside(seg));
+
+        const double x2 = cx + 0.05 * std::cos(a + 1), y2 = cy + 0.05 * std::sin(a + 1);
+        const Eigen::Vector3d q(x2, y2, patch_height(x2, y2) + lift(rng) / 2);
+        const std::array<Eigen::Vector3d, 3> tri = {{c, p, q}};
+        const bool out = plain.is_outside(tri);
+        CHECK(gridded.is_outside(tri) == out);
+        (out ? n_outside : n_inside)++;
+    }
+    CHECK(n_inside > 10);
+    CHECK(n_outside > 10);
+
+    // On the surface the grid takes most samples; switched off, it takes none.
+    std::vector<std::array<Eigen::Vector3d, 3>> on_surface;
+    for (size_t f = 0; f < F.size(); f += 7) {
+        on_surface.push_back({{V[F[f][0]], V[F[f][1]], V[F[f][2]]}});
+    }
+    gridded.reset_query_stats();
+    CHECK_FALSE(gridded.any_outside(on_surface));
+    const SampleEnvelope::QueryStats stats = gridded.query_stats();
+    CHECK(stats.grid_hits > stats.samples / 2);
+    CHECK(stats.grid_hits + stats.cache_hits + stats.bvh_queries <= stats.samples);
+
+    gridded.use_distance_grid = false;
+    gridded.reset_query_stats();
+    CHECK_FALSE(gridded.any_outside(on_surface));
+    CHECK(gridded.query_stats().grid_hits == 0);
+}
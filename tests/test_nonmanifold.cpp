@@ -129,7 +129,7 @@ size_t brute_force_edge_valence(const TriMesh& m, const Tuple& t)
 /// Number of edge-connected components of the fan of `vid`, computed from scratch.
 size_t brute_force_vertex_components(const TriMesh& m, size_t vid)
 {
-    const std::vector<size_t>& fan = m.get_one_ring_fids_for_vertex(vid);
+    const auto& fan = m.get_one_ring_fids_for_vertex(vid);
     if (fan.empty()) {
         return 0;
     }
@@ -4,6 +4,8 @@
 #include <wmtk/utils/Logger.hpp>
 #include <wmtk/utils/examples/TetMesh_examples.hpp>
 
+#include <string>
+
 using namespace wmtk;
 
 struct VertexAttributes
@@ -173,7 +175,8 @@ TEST_CASE("tet_mesh_swap", "[tuple_operation]")
         REQUIRE(mesh.get_tets().size() == 3);
     }
 
-    REQUIRE(mesh.tet_capacity() == 4);
+    // The 2-3 swap takes the slot the 3-2 swap freed rather than a fresh one.
+    REQUIRE(mesh.tet_capacity() == 3);
     mesh.consolidate_mesh();
     REQUIRE(mesh.tet_capacity() == 3);
 }
@@ -211,6 +214,72 @@ TEST_CASE("rollback_operation", "[tuple_operation]")
     }
 }
 
+TEST_CASE("attribute_rollback", "[tuple_operation]")
+{
+    AttributeCollection<std::vector<int>> attrs;
+    attrs.resize(200);
+    for (int i = 0; i < 200; ++i) attrs[i] = {i};
+
+    // An element written several times goes back to its value from before the first write.
+    attrs.begin_protect();
+    attrs[3].push_back(1);
+    attrs[3].push_back(2);
+    attrs[5] = {};
+    attrs.rollback();
+    CHECK(attrs[3] == std::vector<int>{3});
+    CHECK(attrs[5] == std::vector<int>{5});
+
+    // Past the elements the log checks for repeats, as well.
+    attrs.begin_protect();
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 200; ++i) attrs[i].push_back(-1);
+    }
+    attrs.rollback();
+    for (int i = 0; i < 200; ++i) REQUIRE(attrs[i] == std::vector<int>{i});
+
+    // A committed operation keeps its writes, and the next one starts from an empty log.
+    attrs.begin_protect();
+    attrs[7].push_back(7);
+    attrs.end_protect();
+    attrs.begin_protect();
+    attrs[8].clear();
+    attrs.rollback();
+    CHECK(attrs[7] == std::vector<int>{7, 7});
+    CHECK(attrs[8] == std::vector<int>{8});
+}
+
+TEST_CASE("sparse_attribute_rollback", "[tuple_operation]")
+{
+    SparseAttributeCollection<std::string> attrs;
+    attrs.set(3, "three");
+    attrs.set(500, "five hundred");
+    CHECK(attrs.size() == 2);
+    CHECK_FALSE(attrs.find(4));
+
+    // Inserting, overwriting and erasing are all undone, newest first.
+    attrs.begin_protect();
+    attrs.set(4, "four");
+    attrs.set(3, "drei");
+    attrs.set(3, "tres");
+    attrs.erase(500);
+    attrs.rollback();
+    CHECK_FALSE(attrs.contains(4));
+    CHECK(attrs.find(3) == "three");
+    CHECK(attrs.find(500) == "five hundred");
+
+    attrs.begin_protect();
+    attrs.move(3, 4);
+    attrs.end_protect();
+    CHECK_FALSE(attrs.contains(3));
+    CHECK(attrs.find(4) == "three");
+
+    // Consolidation renumbers the entries it keeps and drops the rest: 500 -> 0, 4 is dropped.
+    attrs.gather({500, 7}, 1, 2, 1);
+    CHECK(attrs.size() == 1);
+    CHECK(attrs.find(0) == "five hundred");
+    CHECK_FALSE(attrs.contains(1));
+}
+
 TEST_CASE("forbidden-face-swap", "[tuple_operation]")
 {
     /// https://i.imgur.com/aVCsOvf.png and 0,2,3 should not be swapped.
@@ -428,10 +497,10 @@ TEST_CASE("tet_tet_split", "[TetMesh][tuple_operation]")
         CHECK(m.oriented_tet_vids(1) == std::array<size_t, 4>{0, 4, 2, 3});
         CHECK(m.oriented_tet_vids(2) == std::array<size_t, 4>{0, 1, 4, 3});
         CHECK(m.oriented_tet_vids(3) == std::array<size_t, 4>{0, 1, 2, 4});
-        CHECK(m.get_one_ring_tids_for_vertex(0) == std::vector<size_t>{1, 2, 3});
-        CHECK(m.get_one_ring_tids_for_vertex(1) == std::vector<size_t>{0, 2, 3});
-        CHECK(m.get_one_ring_tids_for_vertex(2) == std::vector<size_t>{0, 1, 3});
-        CHECK(m.get_one_ring_tids_for_vertex(3) == std::vector<size_t>{0, 1, 2});
+        CHECK(m.get_one_ring_tids_for_vertex(0) == std::vector<wmtk::index_t>{1, 2, 3});
+        CHECK(m.get_one_ring_tids_for_vertex(1) == std::vector<wmtk::index_t>{0, 2, 3});
+        CHECK(m.get_one_ring_tids_for_vertex(2) == std::vector<wmtk::index_t>{0, 1, 3});
+        CHECK(m.get_one_ring_tids_for_vertex(3) == std::vector<wmtk::index_t>{0, 1, 2});
     }
     SECTION("single_tet_not_ccw")
     {
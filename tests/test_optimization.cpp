@@ -8,8 +8,10 @@
 #include <wmtk/optimization/AMIPSEnergy.hpp>
 #include <wmtk/optimization/EnergySum.hpp>
 #include <wmtk/optimization/EnvelopeEnergy.hpp>
+#include <wmtk/optimization/VertexNewton.hpp>
 #include <wmtk/optimization/solver.hpp>
 #include <wmtk/utils/examples/TriMesh_examples.hpp>
+#include <wmtk/utils/orient.hpp>
 
 using namespace wmtk;
 
@@ -311,3 +313,183 @@ TEST_CASE("exact_distance_energy_3d", "[energies]")
         CHECK((H - 2 * w * MatrixXd::Identity(3, 3)).norm() <= 1e-9);
     }
 }
+
+TEST_CASE("fixed_newton_matches_polysolve", "[energies]")
+{
+    // The fixed-size kernel must land where polysolve's DenseNewton does on the same
+    // objective: AMIPS over a vertex star plus the exact distance to an input that pulls the
+    // vertex off the star's optimum, so both terms are active at the minimum.
+    auto linear_solver_params = optimization::basic_linear_solver_params;
+    auto nonlinear_solver_params = optimization::basic_nonlinear_solver_params;
+    nonlinear_solver_params["max_iterations"] = 100;
+    auto solver = polysolve::nonlinear::Solver::create(
+        nonlinear_solver_params,
+        linear_solver_params,
+        1,
+        opt_logger());
+    optimization::deactivate_opt_logger();
+    optimization::NewtonOptions newton_opts;
+    newton_opts.max_iterations = 100;
+
+    SECTION("3D: octahedron star, planar input")
+    {
+        const Vector3d p0(0.2, -0.1, 0.15);
+        const std::array<Vector3d, 6> ring = {
+            {Vector3d(1, 0, 0),
+             Vector3d(-1, 0, 0),
+             Vector3d(0, 1, 0),
+             Vector3d(0, -1, 0),
+             Vector3d(0, 0, 1),
+             Vector3d(0, 0, -1)}};
+        std::vector<std::array<double, 12>> cells;
+        for (int a : {0, 1}) {
+            for (int b : {2, 3}) {
+                for (int c : {4, 5}) {
+                    Vector3d q1 = ring[a], q2 = ring[b];
+                    const Vector3d q3 = ring[c];
+                    if (!utils::orient3d(p0, q1, q2, q3)) std::swap(q1, q2);
+                    cells.push_back(
+                        {{p0[0], p0[1], p0[2], q1[0], q1[1], q1[2], q2[0], q2[1], q2[2],
+                          q3[0], q3[1], q3[2]}});
+                }
+            }
+        }
+
+        auto env = std::make_shared<SampleEnvelope>(false);
+        const std::vector<Eigen::Vector3d> V = {
+            Eigen::Vector3d(-5, -5, 0.3),
+            Eigen::Vector3d(5, -5, 0.3),
+            Eigen::Vector3d(0, 5, 0.3)};
+        const std::vector<Eigen::Vector3i> F = {Eigen::Vector3i(0, 1, 2)};
+        env->init(V, F, 0.1);
+        const double wa = 0.5, we = 20;
+
+        auto amips = std::make_shared<optimization::AMIPSEnergy3D>(cells, wa);
+        auto dist = std::make_shared<optimization::ExactDistanceEnergy3D>(env, we);
+        optimization::EnergySum sum;
+        sum.add_energy(amips);
+        sum.add_energy(dist);
+        VectorXd x_poly = p0;
+        CHECK_NOTHROW(solver->minimize(sum, x_poly));
+
+        const optimization::VertexObjective<3> obj(cells, wa, env.get(), we);
+        Vector3d x_fixed = p0;
+        optimization::fixed_newton_minimize(obj, x_fixed, newton_opts);
+
+        CHECK((x_fixed - Vector3d(x_poly)).norm() <= 1e-6);
+        CHECK(std::abs(obj.value(x_fixed) - sum.value(x_poly)) <= 1e-8 * sum.value(x_poly));
+        CHECK(x_fixed[2] > 0.01); // pulled off the star's own optimum at the origin
+        CHECK(x_fixed[2] < 0.3);
+    }
+
+    SECTION("3D: surface vertex held inside the envelope")
+    {
+        // The smoothing case proper: the vertex starts on the input, its four equatorial
+        // neighbours lie on it too, and the lopsided poles put the star's own optimum at
+        // z ~= 0.19, outside the envelope. The distance term has to hold it inside.
+        const Vector3d p0(0.2, -0.1, 0);
+        const std::array<Vector3d, 6> ring = {
+            {Vector3d(1, 0, 0),
+             Vector3d(-1, 0, 0),
+             Vector3d(0, 1, 0),
+             Vector3d(0, -1, 0),
+             Vector3d(0, 0, 1.5),
+             Vector3d(0, 0, -0.7)}};
+        std::vector<std::array<double, 12>> cells;
+        for (int a : {0, 1}) {
+            for (int b : {2, 3}) {
+                for (int c : {4, 5}) {
+                    Vector3d q1 = ring[a], q2 = ring[b];
+                    const Vector3d q3 = ring[c];
+                    if (!utils::orient3d(p0, q1, q2, q3)) std::swap(q1, q2);
+                    cells.push_back(
+                        {{p0[0], p0[1], p0[2], q1[0], q1[1], q1[2], q2[0], q2[1], q2[2],
+                          q3[0], q3[1], q3[2]}});
+                }
+            }
+        }
+
+        auto env = std::make_shared<SampleEnvelope>(false);
+        const std::vector<Eigen::Vector3d> V = {
+            Eigen::Vector3d(-5, -5, 0),
+            Eigen::Vector3d(5, -5, 0),
+            Eigen::Vector3d(0, 5, 0)};
+        const std::vector<Eigen::Vector3i> F = {Eigen::Vector3i(0, 1, 2)};
+        env->init(V, F, 0.1);
+        REQUIRE_FALSE(env->is_outside(p0));
+        const double wa = 0.5, we = 100;
+
+        auto amips = std::make_shared<optimization::AMIPSEnergy3D>(cells, wa);
+        auto dist = std::make_shared<optimization::ExactDistanceEnergy3D>(env, we);
+        optimization::EnergySum sum;
+        sum.add_energy(amips);
+        sum.add_energy(dist);
+        VectorXd x_poly = p0;
+        CHECK_NOTHROW(solver->minimize(sum, x_poly));
+
+        const optimization::VertexObjective<3> obj(cells, wa, env.get(), we);
+        Vector3d x_fixed = p0;
+        optimization::fixed_newton_minimize(obj, x_fixed, newton_opts);
+
+        CHECK((x_fixed - Vector3d(x_poly)).norm() <= 1e-6);
+        CHECK(std::abs(obj.value(x_fixed) - sum.value(x_poly)) <= 1e-8 * sum.value(x_poly));
+        CHECK_FALSE(env->is_outside(Vector3d(x_poly)));
+        CHECK_FALSE(env->is_outside(x_fixed));
+        CHECK(x_fixed[2] > 0.005); // both terms active: neither snapped nor left at the optimum
+
+        // Without the distance term the same star leaves the envelope.
+        const optimization::VertexObjective<3> amips_only(cells, wa);
+        Vector3d x_free = p0;
+        optimization::fixed_newton_minimize(amips_only, x_free, newton_opts);
+        CHECK(env->is_outside(x_free));
+    }
+
+    SECTION("2D: hexagon fan, polyline input")
+    {
+        const Vector2d p0(0.3, -0.2);
+        std::vector<std::array<double, 6>> cells;
+        for (int i = 0; i < 6; ++i) {
+            const double a0 = i * M_PI / 3, a1 = (i + 1) * M_PI / 3;
+            cells.push_back(
+                {{p0[0], p0[1], std::cos(a0), std::sin(a0), std::cos(a1), std::sin(a1)}});
+        }
+
+        auto env = std::make_shared<SampleEnvelope>(false);
+        const std::vector<Eigen::Vector2d> V = {Eigen::Vector2d(-5, 0.2), Eigen::Vector2d(5, 0.2)};
+        const std::vector<Eigen::Vector2i> E = {Eigen::Vector2i(0, 1)};
+        env->init(V, E, 0.1);
+        const double wa = 0.5, we = 20;
+
+        auto amips = std::make_shared<optimization::AMIPSEnergy2D>(cells, wa);
+        auto dist = std::make_shared<optimization::ExactDistanceEnergy2D>(env, we);
+        optimization::EnergySum sum;
+        sum.add_energy(amips);
+        sum.add_energy(dist);
+        VectorXd x_poly = p0;
+        CHECK_NOTHROW(solver->minimize(sum, x_poly));
+
+        const optimization::VertexObjective<2> obj(cells, wa, env.get(), we);
+        Vector2d x_fixed = p0;
+        optimization::fixed_newton_minimize(obj, x_fixed, newton_opts);
+
+        CHECK((x_fixed - Vector2d(x_poly)).norm() <= 1e-6);
+        CHECK(std::abs(obj.value(x_fixed) - sum.value(x_poly)) <= 1e-8 * sum.value(x_poly));
+        CHECK(x_fixed[1] > 0.01);
+        CHECK(x_fixed[1] < 0.2);
+    }
+
+    SECTION("AMIPS alone: no step may invert a cell")
+    {
+        // Start next to the pole of a single tet; the line search has to stay on its side.
+        const Vector3d p0(0.25, 0.25, 1e-2);
+        const std::vector<std::array<double, 12>> cells = {
+            {{p0[0], p0[1], p0[2], 0, 0, 0, 0, 1, 0, 1, 0, 0}}};
+        const optimization::VertexObjective<3> obj(cells, 1);
+        Vector3d x = p0;
+        const int steps = optimization::fixed_newton_minimize(obj, x, newton_opts);
+        CHECK(steps > 0);
+        CHECK(obj.is_step_valid(x));
+        CHECK(obj.value(x) < obj.value(p0));
+        CHECK(x[2] > p0[2]);
+    }
+}
@@ -1,8 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <wmtk/Types.hpp>
+#include <wmtk/utils/Rational.hpp>
 #include <wmtk/utils/orient.hpp>
 
+#include <random>
+
 using namespace wmtk;
 
 TEST_CASE("orient2d_double", "[orient][utils]")
@@ -89,4 +92,52 @@ TEST_CASE("orient3d_rational", "[orient][utils]")
         const Vector3r p3(0.5, 0.5, -1e-12);
         CHECK_FALSE(utils::orient3d(p0, p1, p2, p3));
     }
-}
\ No newline at end of file
+}
+TEST_CASE("orient_rational_filter", "[orient][utils]")
+{
+    // Coordinates that are not doubles, on and very near the plane z = x / 3 + y / 7, so that
+    // the filter decides the generic tets and has to give way to GMP on the others.
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    auto on_plane = [&](const Rational& offset) {
+        const Rational x = Rational(dist(rng)) / Rational(3);
+        const Rational y = Rational(dist(rng)) / Rational(7);
+        return Vector3r(x, y, x / Rational(3) + y / Rational(7) + offset);
+    };
+    const Rational tiny = Rational(1) / Rational(3e30);
+
+    utils::reset_orient_filter_stats();
+    for (int i = 0; i < 300; ++i) {
+        const Rational offset = i % 3 == 0 ? Rational(0) : (i % 3 == 1 ? tiny : -tiny);
+        const Vector3r p0 = on_plane(0);
+        const Vector3r p1 = on_plane(0);
+        const Vector3r p2 = on_plane(0);
+        const Vector3r near = on_plane(offset);
+        const Vector3r far = on_plane(Rational(dist(rng)));
+        REQUIRE(utils::orient3d(p0, p1, p2, near) == utils::orient3d_exact(p0, p1, p2, near));
+        REQUIRE(utils::orient3d(p0, p1, p2, far) == utils::orient3d_exact(p0, p1, p2, far));
+
+        const Vector2r q0(p0[0], p0[1]);
+        const Vector2r q1(p1[0], p1[1]);
+        const Vector2r q2(q0 + (q1 - q0) * Rational(dist(rng)) + Vector2r(offset, 0));
+        REQUIRE(utils::orient2d(q0, q1, q2) == utils::orient2d_exact(q0, q1, q2));
+    }
+    const utils::OrientFilterStats stats = utils::orient_filter_stats();
+    CHECK(stats.hits + stats.misses == 900);
+    // Every far tet is decided by the filter, no near one can be.
+    CHECK(stats.hits >= 300);
+    CHECK(stats.misses >= 300);
+
+    // A double that is the coordinate itself is within an ulp of it too.
+    CHECK(utils::orient3d_interval_sign(
+              Vector3d(0, 0, 0),
+              Vector3d(1, 0, 0),
+              Vector3d(0, 1, 0),
+              Vector3d(0, 0, 1)) == 1);
+    CHECK(utils::orient3d_interval_sign(
+              Vector3d(0, 0, 0),
+              Vector3d(1, 0, 0),
+              Vector3d(0, 1, 0),
+              Vector3d(1, 1, 0)) == 0);
+    CHECK(utils::orient2d_interval_sign(Vector2d(0, 0), Vector2d(1, 0), Vector2d(0, -1)) == -1);
+}
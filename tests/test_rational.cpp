@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <wmtk/utils/Rational.hpp>
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace wmtk;
+
+namespace {
+// The reference: the same value in a bare mpq_t.
+struct Mpq
+{
+    mpq_t v;
+    Mpq() { mpq_init(v); }
+    Mpq(const Mpq& o)
+    {
+        mpq_init(v);
+        mpq_set(v, o.v);
+    }
+    Mpq& operator=(const Mpq& o)
+    {
+        mpq_set(v, o.v);
+        return *this;
+    }
+    ~Mpq() { mpq_clear(v); }
+    std::string str() const
+    {
+        char* s = mpq_get_str(NULL, 10, v);
+        std::string out = s;
+        free(s);
+        return out;
+    }
+};
+} // namespace
+
+TEST_CASE("rational_matches_gmp", "[rational][utils]")
+{
+    // Values that stay inline, values that overflow it and values that come back: small
+    // integers, dyadic fractions, full doubles and the extremes of the double range.
+    std::mt19937_64 rng(13);
+    std::vector<Rational> r;
+    std::vector<Mpq> q;
+    const auto push = [&](double d) {
+        r.emplace_back(d);
+        q.emplace_back();
+        mpq_set_d(q.back().v, d);
+    };
+    for (int i = 0; i < 40; ++i) {
+        push(std::uniform_real_distribution<double>(-10, 10)(rng));
+        push(double(int(rng() % 100)) - 50);
+        push(std::ldexp(double(rng() % 1000), -int(rng() % 80)));
+    }
+    push(0);
+    push(1e300);
+    push(-1e-300);
+
+    for (int it = 0; it < 20000; ++it) {
+        const size_t i = rng() % r.size();
+        const size_t j = rng() % r.size();
+        Rational x;
+        Mpq y;
+        switch (rng() % 4) {
+        case 0:
+            x = r[i] + r[j];
+            mpq_add(y.v, q[i].v, q[j].v);
+            break;
+        case 1:
+            x = r[i] - r[j];
+            mpq_sub(y.v, q[i].v, q[j].v);
+            break;
+        case 2:
+            x = r[i] * r[j];
+            mpq_mul(y.v, q[i].v, q[j].v);
+            break;
+        default:
+            if (mpq_sgn(q[j].v) == 0) continue;
+            x = r[i] / r[j];
+            mpq_div(y.v, q[i].v, q[j].v);
+        }
+        REQUIRE(x.get_str() == y.str());
+        REQUIRE(x.get_sign() == mpq_sgn(y.v));
+        REQUIRE((r[i] < r[j]) == (mpq_cmp(q[i].v, q[j].v) < 0));
+        REQUIRE((r[i] == r[j]) == (mpq_equal(q[i].v, q[j].v) != 0));
+        const double d = mpq_get_d(y.v);
+        if (std::isfinite(d)) {
+            REQUIRE(std::abs(x.to_double() - d) <= std::abs(d) * 0x1p-52);
+        }
+
+        // Keep the operands from growing without bound.
+        if (mpz_sizeinbase(mpq_numref(y.v), 2) < 1000 &&
+            mpz_sizeinbase(mpq_denref(y.v), 2) < 1000) {
+            const size_t k = rng() % r.size();
+            r[k] = std::move(x);
+            q[k] = y;
+        }
+    }
+}
+
+TEST_CASE("rational_aliasing_and_conversions", "[rational][utils]")
+{
+    Rational a(0.1);
+    a -= a;
+    CHECK(a == Rational(0));
+    CHECK(a.get_sign() == 0);
+
+    Rational b(3);
+    b *= b;
+    CHECK(b == Rational(9));
+    b /= b;
+    CHECK(b == Rational(1));
+
+    // A value that only fits in GMP, and one that comes back from it.
+    const Rational big = Rational(std::ldexp(1., 70)) + Rational(1);
+    CHECK(big.get_num_str() == "1180591620717411303425");
+    CHECK((big - Rational(std::ldexp(1., 70))).get_str() == "1");
+    CHECK(Rational(-0.75).get_str() == "-3/4");
+    CHECK(Rational(-0.75).get_den_str() == "4");
+
+    Rational moved = std::move(a);
+    CHECK(moved == Rational(0));
+    Rational c;
+    c.init_from_bin("-110/100");
+    CHECK(c == Rational(-1.5));
+    CHECK(c.to_double() == -1.5);
+}
+
+TEST_CASE("rational_equality_across_representations", "[rational][utils]")
+{
+    // Zero can be inline (default-constructed, moved-from) or GMP (from mpq_t, and from every
+    // operation when WMTK_RATIONAL_SMALL is off); either way the values must compare equal.
+    Mpq zero;
+    const Rational from_mpq(zero.v);
+    const Rational def;
+    CHECK(def == Rational(0.0));
+    CHECK(def == from_mpq);
+    CHECK(from_mpq == def);
+    CHECK(def == Rational(1.0) - Rational(1.0));
+    CHECK_FALSE(def != Rational(0.0));
+    CHECK(def != Rational(0.5));
+
+    Rational moved_from(std::ldexp(1., 90));
+    Rational taker = std::move(moved_from);
+    CHECK(moved_from == Rational(0.0));
+    CHECK(taker == Rational(std::ldexp(1., 90)));
+}
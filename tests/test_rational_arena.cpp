@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <igl/Timer.h>
+#include <wmtk/Types.hpp>
+#include <wmtk/threading/parallel_for.hpp>
+#include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/Rational.hpp>
+#include <wmtk/utils/RationalArena.hpp>
+#include <wmtk/utils/orient.hpp>
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace wmtk;
+
+namespace {
+// Points with coordinates that are not dyadic, so that they are not representable as doubles
+// and the exact predicates have real work to do.
+std::vector<Vector3r> thirds_and_sevenths(size_t n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<Vector3r> p(n);
+    for (Vector3r& x : p) {
+        for (int k = 0; k < 3; ++k) {
+            x[k] = Rational(dist(rng)) / Rational(k == 1 ? 7 : 3);
+        }
+    }
+    return p;
+}
+
+std::vector<bool> orientations(const std::vector<Vector3r>& p)
+{
+    std::vector<bool> out(p.size() - 3);
+    for (size_t i = 0; i + 3 < p.size(); ++i) {
+        out[i] = utils::orient3d_exact(p[i], p[i + 1], p[i + 2], p[i + 3]);
+    }
+    return out;
+}
+} // namespace
+
+TEST_CASE("rational_arena", "[rational][utils]")
+{
+    REQUIRE_FALSE(utils::rational_arena_enabled());
+
+    const std::vector<Vector3r> p = thirds_and_sevenths(200, 5);
+    const std::vector<bool> expected = orientations(p);
+    const Rational a = p[0][0] * p[1][1] - p[2][2] / p[3][0];
+
+    utils::enable_rational_arena();
+    CHECK(utils::rational_arena_enabled());
+    {
+        CHECK(orientations(p) == expected);
+        CHECK(p[0][0] * p[1][1] - p[2][2] / p[3][0] == a);
+
+        // Blocks allocated before enabling are freed through the arena, and the other way round.
+        std::vector<Vector3r> q = thirds_and_sevenths(200, 5);
+        CHECK(orientations(q) == expected);
+
+        // Rationals created on one thread and destroyed on another.
+        std::vector<std::unique_ptr<Rational>> made(1000);
+        threading::parallel_for(
+            threading::range(0, made.size()),
+            [&](const threading::range& r) {
+                for (size_t i = r.begin(); i < r.end(); ++i) {
+                    made[i] = std::make_unique<Rational>(p[i % p.size()][0] / Rational(11));
+                }
+            },
+            4);
+        std::atomic<size_t> wrong{0};
+        threading::parallel_for(
+            threading::range(0, made.size()),
+            [&](const threading::range& r) {
+                for (size_t i = made.size() - r.end(); i < made.size() - r.begin(); ++i) {
+                    if (*made[i] * Rational(11) != p[i % p.size()][0]) ++wrong;
+                    made[i].reset();
+                }
+            },
+            4);
+        CHECK(wrong == 0);
+    }
+    utils::enable_rational_arena(false);
+    CHECK_FALSE(utils::rational_arena_enabled());
+    CHECK(orientations(p) == expected);
+}
+
+TEST_CASE("rational_arena_performance", "[rational][utils][.]")
+{
+    const std::vector<Vector3r> p = thirds_and_sevenths(20000, 7);
+    igl::Timer timer;
+
+    auto run = [&](int num_threads) {
+        std::atomic<size_t> positive{0};
+        timer.start();
+        for (int rep = 0; rep < 5; ++rep) {
+            threading::parallel_for(
+                threading::range(0, p.size() - 3),
+                [&](const threading::range& r) {
+                    size_t n = 0;
+                    for (size_t i = r.begin(); i < r.end(); ++i) {
+                        n += utils::orient3d_exact(p[i], p[i + 1], p[i + 2], p[i + 3]);
+                    }
+                    positive += n;
+                },
+                num_threads);
+        }
+        timer.stop();
+        return std::make_pair(timer.getElapsedTimeInMilliSec(), size_t(positive));
+    };
+
+    for (const int num_threads : {1, 4, 8, 16}) {
+        const auto [t_malloc, n_malloc] = run(num_threads);
+        utils::enable_rational_arena();
+        const auto [t_arena, n_arena] = run(num_threads);
+        utils::enable_rational_arena(false);
+        CHECK(n_malloc == n_arena);
+        logger().info(
+            "exact orient3d, {} threads: malloc {} ms, arena {} ms; speedup {}",
+            num_threads,
+            t_malloc,
+            t_arena,
+            t_malloc / t_arena);
+    }
+}
@@ -1,11 +1,28 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <wmtk/ExecutionScheduler.hpp>
 #include <wmtk/TetMesh.h>
 #include <wmtk/TriMesh.h>
+#include <wmtk/TriOptimizerMesh.h>
+#include <wmtk/utils/LocalizedRetry.hpp>
+#include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/VertexColoring.hpp>
+#include <wmtk/utils/getRSS.h>
+
+#include <igl/Timer.h>
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
+#include <string>
+#include <thread>
 #include <vector>
 
 using namespace wmtk;
@@ -50,12 +67,180 @@ std::set<size_t> reference_ball(const TriMesh& m, const std::vector<size_t>& see
     return ball;
 }
 
+/// An n x n x n block of cubes, each cut into the six Kuhn tets around its main diagonal.
+void make_tet_grid(TetMesh& m, const size_t n)
+{
+    const auto vid = [n](size_t i, size_t j, size_t k) { return (i * (n + 1) + j) * (n + 1) + k; };
+    const size_t paths[6][2] = {{1, 3}, {1, 5}, {2, 3}, {2, 6}, {4, 5}, {4, 6}};
+    std::vector<std::array<size_t, 4>> tets;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            for (size_t k = 0; k < n; ++k) {
+                size_t c[8];
+                for (size_t b = 0; b < 8; ++b) {
+                    c[b] = vid(i + (b & 1), j + ((b >> 1) & 1), k + ((b >> 2) & 1));
+                }
+                for (const auto& p : paths) {
+                    tets.push_back({{c[0], c[p[0]], c[p[1]], c[7]}});
+                }
+            }
+        }
+    }
+    m.init((n + 1) * (n + 1) * (n + 1), tets);
+}
+
+/// ExecutePass asks the mesh for a partition even when the policy never uses one.
+struct PartitionedTetMesh : TetMesh
+{
+    size_t get_partition_id(const Tuple&) const { return 0; }
+};
+
+struct PartitionedTriMesh : TriMesh
+{
+    size_t get_partition_id(const Tuple&) const { return 0; }
+};
+
+/// A tet grid cut into `parts` slabs along its first axis, for the kPartition scheduler.
+struct SlabTetMesh : TetMesh
+{
+    size_t n = 0;
+    size_t parts = 1;
+    size_t get_partition_id(const Tuple& t) const
+    {
+        return t.vid(*this) / ((n + 1) * (n + 1)) * parts / (n + 1);
+    }
+};
+
+/// A tet mesh whose partition is deliberately lopsided: all but the last tenth of the
+/// vertices in partition 0, the rest spread over partitions 1 to 3.
+struct UnbalancedTetMesh : TetMesh
+{
+    size_t n_vertices = 0;
+    size_t get_partition_id(const Tuple& t) const
+    {
+        const size_t v = t.vid(*this);
+        return v < n_vertices * 9 / 10 ? 0 : 1 + v % 3;
+    }
+};
+
 std::set<size_t> locked_set(TriMesh& m)
 {
     const auto& stack = m.mutex_release_stack.local();
     return std::set<size_t>(stack.begin(), stack.end());
 }
 
+/// What the "mark" operation of the scheduler tests saw: where it ran, and how often a pass
+/// reported a failure.
+struct MarkLog
+{
+    std::vector<size_t> marked;
+    size_t n_fail = 0;
+};
+
+/// Records where it ran and succeeds, except every third time, so that failures happen too.
+std::optional<std::vector<TetMesh::Tuple>>
+mark_tuple(MarkLog& log, const TetMesh& m, const TetMesh::Tuple& t)
+{
+    log.marked.push_back(t.vid(m));
+    if (log.marked.size() % 3 == 0) {
+        return {};
+    }
+    return std::vector<TetMesh::Tuple>();
+}
+
+double split_mark_priority(const TetMesh& m, const bool is_mark, const TetMesh::Tuple& t)
+{
+    return is_mark ? 0. : double(t.vid(m) + t.switch_vertex(m).vid(m));
+}
+
+/// Every hook of the split-and-mark pass, as traits.
+struct SplitMarkTraits
+{
+    OpHandle mark;
+    MarkLog& log;
+
+    double priority(const PartitionedTetMesh& m, OpHandle op, const TetMesh::Tuple& t) const
+    {
+        return split_mark_priority(m, op == mark, t);
+    }
+    template <class Emit>
+    void renew_neighbor_tuples(
+        const PartitionedTetMesh&,
+        OpHandle op,
+        const std::vector<TetMesh::Tuple>& tets,
+        Emit&& emit) const
+    {
+        if (op != mark) {
+            for (const auto& t : tets) {
+                emit(mark, t);
+            }
+        }
+    }
+    bool is_weight_up_to_date(
+        const PartitionedTetMesh& m,
+        const std::tuple<double, OpHandle, TetMesh::Tuple>& ele) const
+    {
+        return std::get<2>(ele).is_valid(m);
+    }
+    std::optional<std::vector<TetMesh::Tuple>>
+    apply(PartitionedTetMesh& m, OpHandle op, const TetMesh::Tuple& t) const
+    {
+        if (op == mark) {
+            return mark_tuple(log, m, t);
+        }
+        std::vector<TetMesh::Tuple> ret;
+        if (m.split_edge(t, ret)) {
+            return ret;
+        }
+        return {};
+    }
+    void on_fail(const PartitionedTetMesh&, OpHandle, const TetMesh::Tuple&) const
+    {
+        ++log.n_fail;
+    }
+};
+
+/// Only the priority, so that everything else falls back to the executor's members.
+struct PriorityOnlyTraits
+{
+    OpHandle mark;
+
+    double priority(const PartitionedTetMesh& m, OpHandle op, const TetMesh::Tuple& t) const
+    {
+        return split_mark_priority(m, op == mark, t);
+    }
+};
+
+/// The benchmark's do-nothing operation, with the same hooks as members would have.
+struct TouchTraits
+{
+    size_t& touched;
+
+    double priority(const PartitionedTetMesh& m, OpHandle, const TetMesh::Tuple& t) const
+    {
+        return double(t.vid(m));
+    }
+    template <class Emit>
+    void renew_neighbor_tuples(
+        const PartitionedTetMesh&,
+        OpHandle,
+        const std::vector<TetMesh::Tuple>&,
+        Emit&&) const
+    {}
+    bool is_weight_up_to_date(
+        const PartitionedTetMesh&,
+        const std::tuple<double, OpHandle, TetMesh::Tuple>&) const
+    {
+        return true;
+    }
+    std::optional<std::vector<TetMesh::Tuple>>
+    apply(PartitionedTetMesh&, OpHandle, const TetMesh::Tuple&) const
+    {
+        ++touched;
+        return std::vector<TetMesh::Tuple>();
+    }
+};
+
 } // namespace
 
 TEST_CASE("ring_lock_claims_the_whole_ball", "[threading][lock]")
@@ -205,3 +390,806 @@ TEST_CASE("tet_ring_lock_claims_the_whole_ball", "[threading][lock]")
     REQUIRE(std::set<size_t>(stack.begin(), stack.end()) == std::set<size_t>{0, 1, 2, 3});
     m.release_vertex_mutex_in_stack();
 }
+
+TEST_CASE("color_scheduler_runs_without_lock_failures", "[threading][lock][scheduler]")
+{
+    PartitionedTetMesh m;
+    make_tet_grid(m, 8);
+    std::vector<std::pair<Op, TetMesh::Tuple>> ops;
+    for (const auto& e : m.get_edges()) {
+        ops.emplace_back("edge_split", e);
+    }
+
+    ExecutePass<PartitionedTetMesh> executor(ExecutionPolicy::kColor);
+    executor.num_threads = 4;
+    executor.lock_vertices = [](PartitionedTetMesh& m, const TetMesh::Tuple& e, int task_id) {
+        return m.try_set_edge_mutex_two_ring(e, task_id);
+    };
+    executor(m, ops);
+
+    REQUIRE(m.check_mesh_connectivity_validity());
+    REQUIRE(executor.get_cnt_success() > 0);
+    REQUIRE(executor.stats().lock_failures == 0);
+    REQUIRE(executor.stats().final_queue_size == 0);
+    REQUIRE(executor.stats().unknown_footprint == 0);
+    // Two-ring footprints overlap heavily on a grid this small, so there must be several
+    // classes, but each still has to hold several splits on average.
+    REQUIRE(executor.stats().color_classes > 1);
+    REQUIRE(executor.stats().color_classes < size_t(executor.get_cnt_success()));
+    // Footprints are taken by locking and must all have been given back.
+    REQUIRE(m.mutex_release_stack.local().empty());
+}
+
+TEST_CASE("color_scheduler_without_a_locker_is_serial", "[threading][lock][scheduler]")
+{
+    // With lock_vertices left at its default there is no footprint to color by, so every
+    // operation runs serially -- in the same order, and so to the same mesh, as kSeq.
+    const auto run = [](ExecutionPolicy policy) {
+        auto m = std::make_unique<PartitionedTetMesh>();
+        make_tet_grid(*m, 3);
+        std::vector<std::pair<Op, TetMesh::Tuple>> ops;
+        for (const auto& e : m->get_edges()) {
+            ops.emplace_back("edge_split", e);
+        }
+        ExecutePass<PartitionedTetMesh> executor(policy);
+        executor.num_threads = 4;
+        executor(*m, ops);
+        REQUIRE(m->check_mesh_connectivity_validity());
+        return std::make_pair(executor.get_cnt_success(), m->get_tets().size());
+    };
+    REQUIRE(run(ExecutionPolicy::kColor) == run(ExecutionPolicy::kSeq));
+}
+
+TEST_CASE("operation_handles_are_stable_and_named", "[scheduler]")
+{
+    ExecutePass<PartitionedTetMesh> executor(ExecutionPolicy::kSeq);
+    const OpHandle split = executor.operation("edge_split");
+    REQUIRE(split.valid());
+    REQUIRE(executor.operation("edge_split") == split);
+    REQUIRE(executor.find_operation("edge_split") == split);
+    REQUIRE(executor.operation_name(split) == "edge_split");
+
+    const OpHandle mark = executor.register_operation(
+        "mark",
+        [](PartitionedTetMesh&,
+           const TetMesh::Tuple&) -> std::optional<std::vector<TetMesh::Tuple>> {
+            return std::vector<TetMesh::Tuple>();
+        });
+    REQUIRE(mark != split);
+    REQUIRE(executor.operation_name(mark) == "mark");
+    REQUIRE(executor.edit_operation_maps.count("mark") == 1);
+    REQUIRE_FALSE(OpHandle().valid());
+
+    REQUIRE_THROWS(executor.find_operation("no_such_operation"));
+    // A name handed out but never given an operation fails once a pass tries to run it.
+    PartitionedTetMesh m;
+    make_tet_grid(m, 1);
+    const OpHandle missing = executor.operation("no_such_operation");
+    REQUIRE_THROWS(executor(m, {{missing, m.get_edges().front()}}));
+}
+
+TEST_CASE("handle_callbacks_run_the_same_pass_as_string_callbacks", "[threading][scheduler]")
+{
+    // Every split renews the edges of its new tets as a "mark" operation, which only records
+    // where it ran. Driven through names or through handles, the pass has to do the same work
+    // in the same order.
+    struct Result
+    {
+        int success;
+        size_t n_tets;
+        std::vector<size_t> marked;
+        size_t n_fail;
+        bool operator==(const Result& o) const
+        {
+            return success == o.success && n_tets == o.n_tets && marked == o.marked &&
+                   n_fail == o.n_fail;
+        }
+    };
+    const auto run = [](const bool by_handle) {
+        auto m = std::make_unique<PartitionedTetMesh>();
+        make_tet_grid(*m, 3);
+        ExecutePass<PartitionedTetMesh> executor(ExecutionPolicy::kSeq);
+        Result r{0, 0, {}, 0};
+        const OpHandle mark = executor.register_operation(
+            "mark",
+            [&r](PartitionedTetMesh& m, const TetMesh::Tuple& t)
+                -> std::optional<std::vector<TetMesh::Tuple>> {
+                r.marked.push_back(t.vid(m));
+                // Fail every third mark so that on_fail is exercised as well.
+                if (r.marked.size() % 3 == 0) {
+                    return {};
+                }
+                return std::vector<TetMesh::Tuple>();
+            });
+        std::vector<std::pair<Op, TetMesh::Tuple>> ops;
+        for (const auto& e : m->get_edges()) {
+            ops.emplace_back("edge_split", e);
+        }
+        const auto priority = [](const TetMesh& m, const bool is_mark, const TetMesh::Tuple& t) {
+            return is_mark ? 0. : double(t.vid(m) + t.switch_vertex(m).vid(m));
+        };
+        if (by_handle) {
+            executor.priority_by_handle = [&](const PartitionedTetMesh& m,
+                                              OpHandle op,
+                                              const TetMesh::Tuple& t) {
+                return priority(m, op == mark, t);
+            };
+            executor.renew_neighbor_tuples_by_handle =
+                [mark](const PartitionedTetMesh& m, OpHandle op, const auto& tets) {
+                    std::vector<std::pair<OpHandle, TetMesh::Tuple>> out;
+                    if (op != mark) {
+                        for (const auto& t : tets) {
+                            out.emplace_back(mark, t);
+                        }
+                    }
+                    return out;
+                };
+            executor.is_weight_up_to_date_by_handle = [](const PartitionedTetMesh& m,
+                                                         const auto& ele) {
+                return std::get<2>(ele).is_valid(m);
+            };
+            executor.on_fail_by_handle = [&r](const PartitionedTetMesh&, OpHandle, const auto&) {
+                ++r.n_fail;
+            };
+            executor(*m, executor.to_handles(ops));
+        } else {
+            executor.priority = [&](const PartitionedTetMesh& m, Op op, const TetMesh::Tuple& t) {
+                return priority(m, op == "mark", t);
+            };
+            executor.renew_neighbor_tuples =
+                [](const PartitionedTetMesh& m, Op op, const auto& tets) {
+                    std::vector<std::pair<Op, TetMesh::Tuple>> out;
+                    if (op != "mark") {
+                        for (const auto& t : tets) {
+                            out.emplace_back("mark", t);
+                        }
+                    }
+                    return out;
+                };
+            executor.is_weight_up_to_date = [](const PartitionedTetMesh& m, const auto& ele) {
+                return std::get<2>(ele).is_valid(m);
+            };
+            executor.on_fail = [&r](const PartitionedTetMesh&, Op, const auto&) { ++r.n_fail; };
+            executor(*m, ops);
+        }
+        REQUIRE(m->check_mesh_connectivity_validity());
+        r.success = executor.get_cnt_success();
+        r.n_tets = m->get_tets().size();
+        return r;
+    };
+    const Result by_name = run(false);
+    REQUIRE(by_name.n_fail > 0);
+    REQUIRE(by_name.marked.size() > by_name.n_fail);
+    REQUIRE(run(true) == by_name);
+}
+
+TEST_CASE("pass_traits_run_the_same_pass_as_member_callbacks", "[threading][scheduler]")
+{
+    // The split-and-mark pass of the test above, with its hooks as members, as traits, and as
+    // traits that provide only the priority. All three must do the same work in the same
+    // order, in a single pass and under run_localized_to_convergence.
+    enum class Hooks { kMembers, kTraits, kPartial };
+    struct Result
+    {
+        size_t success;
+        size_t n_tets;
+        std::vector<size_t> marked;
+        size_t n_fail;
+        bool operator==(const Result& o) const
+        {
+            return success == o.success && n_tets == o.n_tets && marked == o.marked &&
+                   n_fail == o.n_fail;
+        }
+    };
+    const auto run = [](const Hooks hooks, const bool localized) {
+        auto m = std::make_unique<PartitionedTetMesh>();
+        make_tet_grid(*m, 3);
+        ExecutePass<PartitionedTetMesh> executor(ExecutionPolicy::kSeq);
+        MarkLog log;
+        const OpHandle mark = executor.register_operation(
+            "mark",
+            [&log](PartitionedTetMesh& m, const TetMesh::Tuple& t) {
+                return mark_tuple(log, m, t);
+            });
+        std::vector<std::pair<Op, TetMesh::Tuple>> ops;
+        for (const auto& e : m->get_edges()) {
+            ops.emplace_back("edge_split", e);
+        }
+        // Always installed, so that whatever the traits leave out has something to fall back to.
+        executor.priority_by_handle =
+            [mark](const PartitionedTetMesh& m, OpHandle op, const TetMesh::Tuple& t) {
+                return split_mark_priority(m, op == mark, t);
+            };
+        executor.renew_neighbor_tuples_by_handle =
+            [mark](const PartitionedTetMesh&, OpHandle op, const auto& tets) {
+                std::vector<std::pair<OpHandle, TetMesh::Tuple>> out;
+                if (op != mark) {
+                    for (const auto& t : tets) {
+                        out.emplace_back(mark, t);
+                    }
+                }
+                return out;
+            };
+        executor.on_fail_by_handle = [&log](const PartitionedTetMesh&, OpHandle, const auto&) {
+            ++log.n_fail;
+        };
+
+        const auto go = [&](auto& traits) {
+            if (localized) {
+                return run_localized_to_convergence(*m, executor, traits, ops);
+            }
+            executor(*m, executor.to_handles(ops), traits);
+            return size_t(executor.get_cnt_success());
+        };
+        Result r{0, 0, {}, 0};
+        if (hooks == Hooks::kMembers) {
+            pass_traits::None none;
+            r.success = go(none);
+        } else if (hooks == Hooks::kTraits) {
+            SplitMarkTraits traits{mark, log};
+            r.success = go(traits);
+        } else {
+            PriorityOnlyTraits traits{mark};
+            r.success = go(traits);
+        }
+        REQUIRE(m->check_mesh_connectivity_validity());
+        r.n_tets = m->get_tets().size();
+        r.marked = log.marked;
+        r.n_fail = log.n_fail;
+        return r;
+    };
+    for (const bool localized : {false, true}) {
+        const Result members = run(Hooks::kMembers, localized);
+        REQUIRE(members.n_fail > 0);
+        REQUIRE(members.marked.size() > members.n_fail);
+        REQUIRE(run(Hooks::kTraits, localized) == members);
+        REQUIRE(run(Hooks::kPartial, localized) == members);
+    }
+}
+
+TEST_CASE("pass_traits_dispatch_performance", "[threading][scheduler][.]")
+{
+    // Per-element cost of the scheduler itself: an operation that does nothing, driven once
+    // through the std::function members and once through traits. What is left is the queue,
+    // the validity checks and the hook dispatch. The passes are kept small enough for the heap
+    // to stay in cache, so that the queue does not drown out the rest; a real pass's queue is
+    // larger, but so is the work per element.
+    PartitionedTetMesh m;
+    make_tet_grid(m, 6);
+    std::vector<std::pair<Op, TetMesh::Tuple>> ops;
+    for (const auto& e : m.get_edges()) {
+        ops.emplace_back("touch", e);
+    }
+    const int n_passes = 500;
+
+    ExecutePass<PartitionedTetMesh> executor(ExecutionPolicy::kSeq);
+    size_t touched = 0;
+    executor.register_operation(
+        "touch",
+        [&touched](PartitionedTetMesh&, const TetMesh::Tuple&)
+            -> std::optional<std::vector<TetMesh::Tuple>> {
+            ++touched;
+            return std::vector<TetMesh::Tuple>();
+        });
+    executor.priority_by_handle = [](const PartitionedTetMesh& m, OpHandle, const auto& t) {
+        return double(t.vid(m));
+    };
+    executor.renew_neighbor_tuples_by_handle =
+        [](const PartitionedTetMesh&, OpHandle, const auto&) {
+            return std::vector<std::pair<OpHandle, TetMesh::Tuple>>();
+        };
+    executor.is_weight_up_to_date_by_handle = [](const PartitionedTetMesh&, const auto&) {
+        return true;
+    };
+    TouchTraits traits{touched};
+    const auto handles = executor.to_handles(ops);
+
+    igl::Timer timer;
+    const auto best_of = [&](const auto& run_pass) {
+        double best = std::numeric_limits<double>::max();
+        for (int k = 0; k < 5; ++k) {
+            touched = 0;
+            timer.start();
+            for (int pass = 0; pass < n_passes; ++pass) {
+                run_pass();
+            }
+            timer.stop();
+            best = std::min(best, timer.getElapsedTimeInSec());
+            CHECK(touched == n_passes * ops.size());
+        }
+        return 1e9 * best / (n_passes * ops.size());
+    };
+    // The pass's own log line would dominate the measurement.
+    const auto level = logger().level();
+    logger().set_level(spdlog::level::warn);
+    const double ns_members = best_of([&] { executor(m, handles); });
+    const double ns_traits = best_of([&] { executor(m, handles, traits); });
+    logger().set_level(level);
+    logger().info(
+        "scheduler overhead, {} passes of {} elements: members {:.1f} ns, traits {:.1f} ns per "
+        "element; speedup {:.2f}",
+        n_passes,
+        ops.size(),
+        ns_members,
+        ns_traits,
+        ns_members / ns_traits);
+}
+
+TEST_CASE("compact_indices_split_pass_performance", "[threading][scheduler][.]")
+{
+    // Time and memory of one edge-split pass over a grid. The numbers are only meaningful next
+    // to those of a build with WMTK_COMPACT_INDICES switched the other way, so the index width
+    // is logged with them. Run on its own, so that the peak belongs to this pass alone.
+    const size_t rss_start = getCurrentRSS();
+    igl::Timer timer;
+    timer.start();
+    PartitionedTetMesh m;
+    make_tet_grid(m, 24);
+    std::vector<std::pair<Op, TetMesh::Tuple>> ops;
+    for (const auto& e : m.get_edges()) {
+        ops.emplace_back("edge_split", e);
+    }
+    timer.stop();
+    const double ms_init = timer.getElapsedTimeInMilliSec();
+    const size_t rss_init = getCurrentRSS();
+
+    ExecutePass<PartitionedTetMesh> executor(ExecutionPolicy::kSeq);
+    timer.start();
+    executor(m, ops);
+    timer.stop();
+    const double ms_pass = timer.getElapsedTimeInMilliSec();
+    const size_t rss_pass = getCurrentRSS();
+
+    REQUIRE(executor.get_cnt_success() > 0);
+    REQUIRE(m.check_mesh_connectivity_validity());
+
+    const double mib = 1024. * 1024.;
+    logger().info(
+        "index_t {} B, Tuple {} B: init {:.0f} ms, +{:.1f} MiB; {} splits to {} tets in {:.0f} ms, "
+        "+{:.1f} MiB; peak {:.1f} MiB",
+        sizeof(index_t),
+        sizeof(TetMesh::Tuple),
+        ms_init,
+        (rss_init - rss_start) / mib,
+        executor.get_cnt_success(),
+        m.tet_size(),
+        ms_pass,
+        (rss_pass - rss_init) / mib,
+        getPeakRSS() / mib);
+}
+
+TEST_CASE("queue_kinds_run_the_same_pass", "[threading][scheduler]")
+{
+    // The d-ary heap pops in exactly the binary heap's order, so the split-and-mark pass has to
+    // come out identical. The bucketed queue does not promise that, only a valid pass.
+    struct Result
+    {
+        size_t success;
+        size_t n_tets;
+        std::vector<size_t> marked;
+        size_t n_fail;
+        bool operator==(const Result& o) const
+        {
+            return success == o.success && n_tets == o.n_tets && marked == o.marked &&
+                   n_fail == o.n_fail;
+        }
+    };
+    const auto run = [](const threading::QueueKind kind) {
+        auto m = std::make_unique<PartitionedTetMesh>();
+        make_tet_grid(*m, 3);
+        ExecutePass<PartitionedTetMesh> executor(ExecutionPolicy::kSeq);
+        executor.queue_kind = kind;
+        MarkLog log;
+        const OpHandle mark = executor.register_operation(
+            "mark",
+            [&log](PartitionedTetMesh& m, const TetMesh::Tuple& t) {
+                return mark_tuple(log, m, t);
+            });
+        SplitMarkTraits traits{mark, log};
+        std::vector<std::pair<Op, TetMesh::Tuple>> ops;
+        for (const auto& e : m->get_edges()) {
+            ops.emplace_back("edge_split", e);
+        }
+        executor(*m, executor.to_handles(ops), traits);
+        REQUIRE(m->check_mesh_connectivity_validity());
+        return Result{
+            size_t(executor.get_cnt_success()),
+            m->get_tets().size(),
+            log.marked,
+            log.n_fail};
+    };
+    const Result binary = run(threading::QueueKind::kBinaryHeap);
+    REQUIRE(binary.n_fail > 0);
+    REQUIRE(run(threading::QueueKind::kDaryHeap) == binary);
+    const Result bucketed = run(threading::QueueKind::kBucketed);
+    CHECK(bucketed.success > 0);
+    CHECK(bucketed.n_tets > binary.n_tets / 2);
+}
+
+TEST_CASE("overflow_reruns_in_parallel_on_the_shifted_partition", "[threading][scheduler]")
+{
+    // Every edge across a slab boundary loses its first lock attempt, as it would to the task on
+    // the other side, and so overflows the first round. The second round puts each boundary in
+    // one task, where the retry succeeds, and leaves nothing for the serial drain. Where each
+    // retry ran is recorded: task (p + q) mod T in the second round, task 0 in the serial drain.
+    const auto run = [](const size_t tail_min, const bool shifted) {
+        SlabTetMesh m;
+        m.n = 7;
+        m.parts = 4;
+        make_tet_grid(m, m.n);
+        const auto key = [&m](const TetMesh::Tuple& e) {
+            const size_t a = e.vid(m), b = e.switch_vertex(m).vid(m);
+            // Not std::minmax, whose pair would refer to a and b.
+            return std::make_pair(std::min(a, b), std::max(a, b));
+        };
+        std::mutex mutex;
+        std::set<std::pair<size_t, size_t>> attempted;
+        std::map<std::pair<size_t, size_t>, size_t> runs;
+        // The task each retry ran on, and the task it should have run on.
+        std::map<std::pair<size_t, size_t>, std::pair<int, int>> rerun_on;
+
+        ExecutePass<SlabTetMesh> executor(ExecutionPolicy::kPartition);
+        executor.num_threads = 4;
+        executor.max_retry_limit = 1;
+        executor.parallel_tail_min = tail_min;
+        executor.lock_vertices = [&](SlabTetMesh& m, const TetMesh::Tuple& e, int task_id) {
+            if (m.get_partition_id(e) == m.get_partition_id(e.switch_vertex(m))) {
+                return true;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (attempted.insert(key(e)).second) {
+                return false;
+            }
+            const size_t p = m.get_partition_id(e);
+            const size_t q = m.get_partition_id(e.switch_vertex(m));
+            rerun_on[key(e)] = {task_id, shifted ? int((p + q) % executor.num_threads) : 0};
+            return true;
+        };
+        executor.register_operation("touch", [&](SlabTetMesh&, const TetMesh::Tuple& e) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++runs[key(e)];
+            return std::optional<std::vector<TetMesh::Tuple>>(std::vector<TetMesh::Tuple>());
+        });
+        std::vector<std::pair<Op, TetMesh::Tuple>> ops;
+        for (const auto& e : m.get_edges()) {
+            ops.emplace_back("touch", e);
+        }
+        executor(m, ops);
+
+        REQUIRE(runs.size() == ops.size());
+        for (const auto& [e, count] : runs) {
+            REQUIRE(count == 1);
+        }
+        const auto& stats = executor.stats();
+        REQUIRE(attempted.size() > 0);
+        REQUIRE(stats.first_round_size == ops.size());
+        REQUIRE(stats.overflowed == attempted.size());
+        REQUIRE(stats.final_queue_size == attempted.size());
+        REQUIRE(rerun_on.size() == attempted.size());
+        for (const auto& [e, tasks] : rerun_on) {
+            REQUIRE(tasks.first == tasks.second);
+        }
+        return stats;
+    };
+
+    const auto shifted = run(0, true);
+    CHECK(shifted.tail_round_size == shifted.final_queue_size);
+    CHECK(shifted.serial_tail_size == 0);
+
+    const auto serial = run(std::numeric_limits<size_t>::max(), false);
+    CHECK(serial.tail_round_size == 0);
+    CHECK(serial.serial_tail_size == serial.final_queue_size);
+}
+
+TEST_CASE("work_stealing_runs_an_unbalanced_pass", "[threading][scheduler]")
+{
+    // Nearly every vertex in partition 0, so without stealing task 0 does almost the whole
+    // pass while the other three sit idle. With it they take work from task 0; every operation
+    // still runs exactly once and the outcome is the same.
+    struct Result
+    {
+        size_t success;
+        size_t steals;
+        size_t run_elsewhere;
+    };
+    const auto run = [](const bool stealing) {
+        UnbalancedTetMesh m;
+        make_tet_grid(m, 5);
+        m.n_vertices = m.vert_capacity();
+        const auto key = [&m](const TetMesh::Tuple& e) {
+            const size_t a = e.vid(m), b = e.switch_vertex(m).vid(m);
+            return std::make_pair(std::min(a, b), std::max(a, b));
+        };
+        std::mutex mutex;
+        std::map<std::pair<size_t, size_t>, size_t> runs;
+        size_t run_elsewhere = 0;
+
+        ExecutePass<UnbalancedTetMesh> executor(ExecutionPolicy::kPartition);
+        executor.num_threads = 4;
+        executor.work_stealing = stealing;
+        executor.steal_batch = 4;
+        // Only the ring claim sees which task runs an operation.
+        executor.lock_vertices = [&](UnbalancedTetMesh& m, const TetMesh::Tuple& e, int task_id) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (size_t(task_id) != m.get_partition_id(e)) {
+                ++run_elsewhere;
+            }
+            return true;
+        };
+        executor.register_operation("touch", [&](UnbalancedTetMesh&, const TetMesh::Tuple& e) {
+            // Long enough that task 0 still has a queue when the others run dry.
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+            std::lock_guard<std::mutex> lock(mutex);
+            ++runs[key(e)];
+            return std::optional<std::vector<TetMesh::Tuple>>(std::vector<TetMesh::Tuple>());
+        });
+        std::vector<std::pair<Op, TetMesh::Tuple>> ops;
+        for (const auto& e : m.get_edges()) {
+            ops.emplace_back("touch", e);
+        }
+        executor(m, ops);
+
+        REQUIRE(m.check_mesh_connectivity_validity());
+        REQUIRE(runs.size() == ops.size());
+        for (const auto& [e, count] : runs) {
+            REQUIRE(count == 1);
+        }
+        return Result{
+            size_t(executor.get_cnt_success()),
+            executor.stats().steals,
+            run_elsewhere};
+    };
+
+    const Result plain = run(false);
+    CHECK(plain.steals == 0);
+    CHECK(plain.run_elsewhere == 0);
+    const Result stolen = run(true);
+    CHECK(stolen.success == plain.success);
+    CHECK(stolen.steals > 0);
+    CHECK(stolen.run_elsewhere > 0);
+}
+
+TEST_CASE("renew_key_queues_each_renewal_once", "[threading][scheduler]")
+{
+    // Each split renews the three edges of each of its new triangles, as triwild's does, so
+    // every spoke is renewed twice, as a "mark" operation that only records where it ran.
+    // Keyed by the undirected edge, each is queued once per split: the splits are the same,
+    // and the marks are the same minus repeats.
+    struct Result
+    {
+        size_t n_tris;
+        std::vector<std::pair<size_t, size_t>> marked;
+        size_t duplicates;
+    };
+    const auto edge_of = [](const TriMesh& m, const TriMesh::Tuple& t) {
+        const size_t a = t.vid(m);
+        const size_t b = t.switch_vertex(m).vid(m);
+        return std::make_pair(std::min(a, b), std::max(a, b));
+    };
+    const auto run = [&](const bool keyed) {
+        auto m = std::make_unique<PartitionedTriMesh>();
+        make_grid(*m, 4, 4);
+        ExecutePass<PartitionedTriMesh> executor(ExecutionPolicy::kSeq);
+        Result r{0, {}, 0};
+        const OpHandle split = executor.operation("edge_split");
+        const OpHandle mark = executor.register_operation(
+            "mark",
+            [&](PartitionedTriMesh& m, const TriMesh::Tuple& t) {
+                r.marked.push_back(edge_of(m, t));
+                return std::optional<std::vector<TriMesh::Tuple>>(std::vector<TriMesh::Tuple>());
+            });
+        // Distinct per edge, so that the two copies of a renewal are popped back to back.
+        executor.priority_by_handle = [&](const PartitionedTriMesh& m, OpHandle op, const auto& t) {
+            const auto [a, b] = edge_of(m, t);
+            return double(a * 1000 + b) + (op == split ? 1e7 : 0.);
+        };
+        executor.renew_neighbor_tuples_by_handle =
+            [&](const PartitionedTriMesh& m, OpHandle op, const auto& tris) {
+                std::vector<std::pair<OpHandle, TriMesh::Tuple>> out;
+                if (op == split) {
+                    for (const auto& t : tris) {
+                        out.emplace_back(mark, t);
+                        out.emplace_back(mark, t.switch_edge(m));
+                        out.emplace_back(mark, t.switch_vertex(m).switch_edge(m));
+                    }
+                }
+                return out;
+            };
+        if (keyed) {
+            executor.renew_key_by_handle =
+                [&](const PartitionedTriMesh& m, OpHandle, const TriMesh::Tuple& t) {
+                    const auto [a, b] = edge_of(m, t);
+                    return (uint64_t(a) << 32) | b;
+                };
+        }
+        std::vector<std::pair<OpHandle, TriMesh::Tuple>> ops;
+        for (const auto& e : m->get_edges()) {
+            ops.emplace_back(split, e);
+        }
+        executor(*m, ops);
+        REQUIRE(m->check_mesh_connectivity_validity());
+        r.n_tris = m->get_faces().size();
+        r.duplicates = executor.stats().renew_duplicates;
+        return r;
+    };
+    const Result plain = run(false);
+    const Result keyed = run(true);
+    CHECK(plain.duplicates == 0);
+    REQUIRE(keyed.duplicates > 0);
+    CHECK(keyed.n_tris == plain.n_tris);
+    // Every mark the keyed pass ran, the plain one ran in the same order; what the plain one
+    // ran in addition are repeats of the mark just before. (A later split renewing an edge
+    // again is not a duplicate to the key, so the keyed pass keeps some repeats too.)
+    REQUIRE(keyed.marked.size() < plain.marked.size());
+    size_t j = 0;
+    for (size_t i = 0; i < plain.marked.size(); ++i) {
+        if (j < keyed.marked.size() && plain.marked[i] == keyed.marked[j]) {
+            ++j;
+        } else {
+            REQUIRE(i > 0);
+            REQUIRE(plain.marked[i] == plain.marked[i - 1]);
+        }
+    }
+    CHECK(j == keyed.marked.size());
+}
+
+TEST_CASE("scheduler_queue_performance", "[threading][scheduler][.]")
+{
+    // Per-element cost of a pass whose operation does nothing, so that the queue is most of
+    // what is measured, for each queue kind and a range of queue sizes. The priority is a
+    // vertex id, so ties are common and the tie-break on the Tuple is exercised as it is by a
+    // real pass over a regular mesh.
+    const auto level = logger().level();
+    logger().set_level(spdlog::level::warn);
+    for (const int n : {6, 12, 24}) {
+        PartitionedTetMesh m;
+        make_tet_grid(m, n);
+        ExecutePass<PartitionedTetMesh> executor(ExecutionPolicy::kSeq);
+        size_t touched = 0;
+        TouchTraits traits{touched};
+        std::vector<std::pair<Op, TetMesh::Tuple>> ops;
+        for (const auto& e : m.get_edges()) {
+            ops.emplace_back("touch", e);
+        }
+        executor.operation("touch");
+        const auto handles = executor.to_handles(ops);
+        // About a million elements per measurement, whatever the pass size.
+        const size_t n_passes = std::max<size_t>(1, (size_t(1) << 20) / ops.size());
+
+        igl::Timer timer;
+        double ns[3];
+        for (const auto kind :
+             {threading::QueueKind::kBinaryHeap,
+              threading::QueueKind::kDaryHeap,
+              threading::QueueKind::kBucketed}) {
+            executor.queue_kind = kind;
+            double best = std::numeric_limits<double>::max();
+            for (int k = 0; k < 5; ++k) {
+                touched = 0;
+                timer.start();
+                for (size_t pass = 0; pass < n_passes; ++pass) {
+                    executor(m, handles, traits);
+                }
+                timer.stop();
+                best = std::min(best, timer.getElapsedTimeInSec());
+                CHECK(touched == n_passes * ops.size());
+            }
+            ns[int(kind)] = 1e9 * best / (n_passes * ops.size());
+        }
+        logger().set_level(level);
+        logger().info(
+            "queue, {} elements: binary {:.1f} ns, d-ary {:.1f} ns, bucketed {:.1f} ns per element",
+            ops.size(),
+            ns[0],
+            ns[1],
+            ns[2]);
+        logger().set_level(spdlog::level::warn);
+    }
+    logger().set_level(level);
+}
+
+TEST_CASE("vertex_coloring_separates_every_cell", "[threading][scheduler]")
+{
+    // What the colored smoothing engine relies on: every vertex in exactly one class, and no
+    // two vertices of a class in one tet.
+    TetMesh m;
+    make_tet_grid(m, 5);
+    std::vector<size_t> vids;
+    for (const auto& v : m.get_vertices()) {
+        vids.push_back(v.vid(m));
+    }
+    const auto neighbors = [&m](const size_t v, std::vector<size_t>& out) {
+        out = m.get_one_ring_vids_for_vertex(v);
+    };
+    const auto classes = utils::color_vertices(m.vert_capacity(), vids, neighbors, 4);
+
+    std::vector<int> color(m.vert_capacity(), -1);
+    size_t n_colored = 0;
+    for (size_t c = 0; c < classes.size(); ++c) {
+        REQUIRE_FALSE(classes[c].empty());
+        for (const size_t v : classes[c]) {
+            REQUIRE(color[v] == -1);
+            color[v] = int(c);
+            ++n_colored;
+        }
+    }
+    REQUIRE(n_colored == vids.size());
+    for (const auto& t : m.get_tets()) {
+        const auto vs = m.oriented_tet_vids(t);
+        for (int i = 0; i < 4; ++i) {
+            for (int j = i + 1; j < 4; ++j) {
+                REQUIRE(color[vs[i]] != color[vs[j]]);
+            }
+        }
+    }
+    // Greedy stays well within degree + 1 colors, and does not depend on the thread count.
+    REQUIRE(classes.size() < 16);
+    REQUIRE(utils::color_vertices(m.vert_capacity(), vids, neighbors, 1) == classes);
+}
+
+namespace {
+/// The smallest TriOptimizerMesh: no envelope, no sizing, and an invariant that can be told to
+/// refuse everything.
+class RejectingTriMesh : public TriOptimizerMesh
+{
+public:
+    explicit RejectingTriMesh(OptimizerParameters& params)
+        : TriOptimizerMesh(params)
+    {}
+
+    bool reject = false;
+    std::atomic<size_t> invariant_calls{0};
+
+    bool invariants(const std::vector<Tuple>&) override
+    {
+        ++invariant_calls;
+        return !reject;
+    }
+    bool smoothing_position_is_allowed(size_t, const Vector2d&) const override { return true; }
+
+protected:
+    size_t refine_sizing_around_worst(double) override { return 0; }
+    void write_smoothing_debug_output(const std::string&) const override {}
+};
+} // namespace
+
+TEST_CASE("colored_smoothing_honours_invariants", "[threading][scheduler]")
+{
+    // Every smoothing engine must consult invariants() after the move, as
+    // TriMesh::smooth_vertex does, and undo the move when it refuses.
+    for (const std::string engine : {"pass", "colored"}) {
+        for (const bool reject : {false, true}) {
+            OptimizerParameters params;
+            params.smoothing_engine = engine;
+            params.smoothing_solver = "newton";
+            RejectingTriMesh m(params);
+            make_grid(m, 2, 2);
+            m.m_vertex_attribute.resize(9);
+            m.m_edge_attribute.resize(8 * 3);
+            m.m_face_attribute.resize(8);
+            for (size_t v = 0; v < 9; ++v) {
+                m.m_vertex_attribute[v] = TriOptimizerMesh::VertexAttributes(
+                    Vector2d(double(v % 3), double(v / 3)));
+                // Pin the boundary, so only the centre can move.
+                if (v != 4) m.m_vertex_attribute[v].on_bbox_faces = {0};
+            }
+            const Vector2d start(1.3, 0.8);
+            m.m_vertex_attribute[4].m_posf = start;
+            for (size_t f = 0; f < 8; ++f) {
+                m.m_face_attribute[f].m_quality = m.get_quality(f);
+            }
+            // Face 1 is (1, 4, 3), in the centre's one-ring.
+            const double quality_before = m.m_face_attribute[1].m_quality;
+
+            m.reject = reject;
+            m.smooth_all_vertices();
+            CHECK(m.invariant_calls > 0);
+            if (reject) {
+                CHECK(m.m_vertex_attribute[4].m_posf == start);
+                CHECK(m.m_face_attribute[1].m_quality == quality_before);
+            } else {
+                CHECK(m.m_vertex_attribute[4].m_posf != start);
+            }
+        }
+    }
+}
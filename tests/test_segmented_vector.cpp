@@ -0,0 +1,138 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <wmtk/TetMesh.h>
+#include <wmtk/threading/parallel_for.hpp>
+#include <wmtk/utils/SegmentedVector.hpp>
+#include <wmtk/utils/examples/TetMesh_examples.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace wmtk;
+using namespace wmtk::utils::examples::tet;
+
+TEST_CASE("segmented_vector", "[segmented_vector]")
+{
+    // Small chunks, so that every test crosses many chunk boundaries.
+    using Vec = SegmentedVector<std::uint64_t, 4>;
+
+    std::mt19937 rng(11);
+    Vec v;
+    std::vector<std::uint64_t> ref;
+    for (int step = 0; step < 2000; ++step) {
+        switch (rng() % 4) {
+        case 0:
+        case 1: {
+            const size_t n = ref.size() + rng() % 40;
+            v.resize(n);
+            ref.resize(n);
+            break;
+        }
+        case 2: {
+            // Shrinking must leave fresh elements behind for the next growth.
+            const size_t n = ref.empty() ? 0 : rng() % ref.size();
+            v.resize(n);
+            ref.resize(n);
+            break;
+        }
+        case 3:
+            for (size_t i = 0; i < ref.size(); ++i) {
+                const std::uint64_t x = rng();
+                v[i] = x;
+                ref[i] = x;
+            }
+            break;
+        }
+        REQUIRE(v.size() == ref.size());
+        REQUIRE(std::equal(v.begin(), v.end(), ref.begin(), ref.end()));
+    }
+
+    // grow_to_at_least rounds up to whole chunks and never shrinks.
+    Vec g;
+    g.grow_to_at_least(17);
+    CHECK(g.size() == 32);
+    g.grow_to_at_least(3);
+    CHECK(g.size() == 32);
+
+    Vec copy = v;
+    CHECK(std::equal(copy.begin(), copy.end(), v.begin(), v.end()));
+    Vec moved = std::move(copy);
+    CHECK(copy.empty());
+    CHECK(std::equal(moved.begin(), moved.end(), v.begin(), v.end()));
+
+    Vec filled(37, 5);
+    CHECK(std::count(filled.begin(), filled.end(), 5u) == 37);
+    std::sort(filled.begin(), filled.end());
+}
+
+TEST_CASE("segmented_vector_concurrent_growth", "[segmented_vector]")
+{
+    using Vec = SegmentedVector<std::uint64_t, 6>;
+    Vec v;
+    v.resize(64);
+    std::iota(v.begin(), v.end(), 0);
+    std::uint64_t* const first = &v[0];
+
+    // Every thread claims slots past the end, grows the vector to hold them and writes them,
+    // while the others read and write their own elements; no element may move.
+    std::atomic<size_t> next{64};
+    std::atomic<bool> moved{false};
+    const size_t n = 1 << 16;
+    threading::parallel_for(
+        threading::range(0, 16),
+        [&](const threading::range& r) {
+            for (size_t t = r.begin(); t < r.end(); ++t) {
+                for (;;) {
+                    const size_t i = next.fetch_add(1);
+                    if (i >= n) break;
+                    v.grow_to_at_least(i + 1);
+                    v[i] = i;
+                    if (v[i % 64] != i % 64) moved = true;
+                }
+            }
+        },
+        8);
+    CHECK_FALSE(moved);
+    REQUIRE(v.size() >= n);
+    CHECK(&v[0] == first);
+    for (size_t i = 0; i < n; ++i) REQUIRE(v[i] == i);
+}
+
+TEST_CASE("tet_storage_grows_past_preallocation", "[segmented_vector][TetMesh]")
+{
+    class MeshWithAttributes : public TetMesh
+    {
+    public:
+        AttributeCollection<double> m_vertex_attribute;
+        AttributeCollection<double> m_tet_attribute;
+        MeshWithAttributes()
+        {
+            p_vertex_attrs = &m_vertex_attribute;
+            p_tet_attrs = &m_tet_attribute;
+        }
+    };
+
+    MeshWithAttributes mesh;
+    mesh.set_preallocation_factor(1.0);
+    mesh.init(six_cycle_tets().T);
+
+    // Split until the mesh holds many times what the 64-slot floor of the reservation does.
+    // None of those splits may fail for want of slots.
+    std::vector<TetMesh::Tuple> dummy;
+    for (int round = 0; round < 50 && mesh.tet_capacity() < 1000; ++round) {
+        for (const auto& e : mesh.get_edges()) {
+            if (e.is_valid(mesh)) REQUIRE(mesh.split_edge(e, dummy));
+        }
+    }
+    CHECK(mesh.tet_capacity() >= 1000);
+    REQUIRE(mesh.check_mesh_connectivity_validity());
+    CHECK(mesh.m_vertex_attribute.size() >= mesh.vert_capacity());
+    CHECK(mesh.m_tet_attribute.size() >= mesh.tet_capacity());
+
+    mesh.consolidate_mesh();
+    REQUIRE(mesh.check_mesh_connectivity_validity());
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <wmtk/utils/SmallVector.hpp>
+#include <wmtk/utils/VectorUtils.h>
+#include <wmtk/threading/parallel_for.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace wmtk;
+
+TEST_CASE("small_vector", "[small_vector]")
+{
+    using Vec = SmallVector<std::uint32_t, 4>;
+
+    // Every operation against std::vector, across the inline/heap boundary in both directions.
+    std::mt19937 rng(7);
+    Vec v;
+    std::vector<std::uint32_t> ref;
+    for (int step = 0; step < 5000; ++step) {
+        const std::uint32_t x = rng() % 64;
+        switch (rng() % 7) {
+        case 0:
+        case 1:
+            v.push_back(x);
+            ref.push_back(x);
+            break;
+        case 2:
+            if (!ref.empty()) {
+                const size_t i = rng() % ref.size();
+                v.erase(v.begin() + i);
+                ref.erase(ref.begin() + i);
+            }
+            break;
+        case 3: {
+            const size_t i = ref.empty() ? 0 : rng() % (ref.size() + 1);
+            v.insert(v.begin() + i, x);
+            ref.insert(ref.begin() + i, x);
+            break;
+        }
+        case 4:
+            // A range out of the vector itself.
+            v.insert(v.end(), v.begin(), v.begin() + std::min<size_t>(v.size(), 3));
+            ref.insert(ref.end(), ref.begin(), ref.begin() + std::min<size_t>(ref.size(), 3));
+            break;
+        case 5:
+            vector_unique(v);
+            vector_unique(ref);
+            break;
+        case 6:
+            if (ref.size() > 20) {
+                v.resize(2);
+                ref.resize(2);
+                v.shrink_to_fit();
+                CHECK(v.capacity() == Vec::inline_capacity());
+            }
+            break;
+        }
+        REQUIRE(v == ref);
+    }
+
+    Vec copy = v;
+    CHECK(copy == v);
+    Vec moved = std::move(copy);
+    CHECK(moved == v);
+    CHECK(copy.empty());
+    moved = Vec{1, 2, 3};
+    CHECK(moved == std::vector<std::uint32_t>{1, 2, 3});
+    CHECK(moved.capacity() == Vec::inline_capacity());
+
+    const Vec a{1, 3, 5, 7, 9, 11};
+    const std::vector<std::uint32_t> b{3, 4, 5, 9};
+    CHECK(set_intersection(a, b) == std::vector<std::uint32_t>{3, 5, 9});
+}
+
+TEST_CASE("small_vector_threads", "[small_vector][threading]")
+{
+    // Heap blocks freed on another thread than they came from go to that thread's lists.
+    using Vec = SmallVector<std::size_t, 2>;
+    std::vector<Vec> stars(1000);
+    threading::parallel_for(threading::range(0, stars.size()), [&](const threading::range& r) {
+        for (size_t i = r.begin(); i < r.end(); ++i) {
+            for (size_t j = 0; j < i % 40; ++j) stars[i].push_back(j);
+        }
+    });
+    std::vector<char> ok(stars.size(), 0); // Catch2 assertions are not thread-safe
+    threading::parallel_for(threading::range(0, stars.size()), [&](const threading::range& r) {
+        for (size_t i = r.begin(); i < r.end(); ++i) {
+            const size_t k = stars.size() - 1 - i;
+            std::vector<size_t> ref(k % 40);
+            std::iota(ref.begin(), ref.end(), 0);
+            ok[k] = stars[k] == ref;
+            stars[k] = Vec();
+        }
+    });
+    CHECK(std::count(ok.begin(), ok.end(), 1) == ok.size());
+}
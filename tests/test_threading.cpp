@@ -2,16 +2,28 @@
 
 #include <igl/Timer.h>
 #include <wmtk/TetMesh.h>
+#include <algorithm>
 #include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <random>
 #include <stdexcept>
 #include <thread>
+#include <tuple>
 #include <wmtk/Types.hpp>
 #include <wmtk/threading/collector.hpp>
 #include <wmtk/threading/enumerable_thread_specific.hpp>
 #include <wmtk/threading/indexed_collector.hpp>
 #include <wmtk/threading/parallel_for.hpp>
+#include <wmtk/threading/selectable_heap.hpp>
 #include <wmtk/threading/spin_mutex.hpp>
+#include <wmtk/threading/stealable_priority_queue.hpp>
 #include <wmtk/threading/task_group.hpp>
+#include <wmtk/threading/thread_pool.hpp>
 #include <wmtk/utils/Logger.hpp>
 
 using namespace wmtk;
@@ -66,6 +78,100 @@ TEST_CASE("parallel_for", "[threading]")
     }
 }
 
+TEST_CASE("parallel_for_grainsize", "[threading]")
+{
+    // With a grainsize every chunk is at most that long and the range is covered exactly once.
+    std::vector<std::atomic<int>> hits(1003);
+    std::atomic<int> oversized(0);
+    threading::parallel_for(
+        threading::range(0, hits.size(), 10),
+        [&](const threading::range& r) {
+            if (r.size() > 10) oversized++;
+            for (size_t i = r.begin(); i < r.end(); ++i) {
+                hits[i]++;
+            }
+        },
+        4);
+    REQUIRE(oversized.load() == 0);
+    for (const auto& h : hits) {
+        REQUIRE(h.load() == 1);
+    }
+
+    REQUIRE_THROWS_AS(
+        threading::parallel_for(
+            threading::range(0, 100, 1),
+            [](const threading::range& r) {
+                if (r.begin() == 50) {
+                    throw std::runtime_error("parallel_for failure");
+                }
+            },
+            4),
+        std::runtime_error);
+}
+
+TEST_CASE("parallel_reduce", "[threading]")
+{
+    const auto sum = [](size_t grain, int num_threads) {
+        return threading::parallel_reduce(
+            threading::range(0, 10000, grain),
+            size_t(0),
+            [](const threading::range& r, size_t acc) {
+                for (size_t i = r.begin(); i < r.end(); ++i) {
+                    acc += i;
+                }
+                return acc;
+            },
+            [](size_t a, size_t b) { return a + b; },
+            num_threads);
+    };
+    REQUIRE(sum(0, 1) == 49995000);
+    REQUIRE(sum(0, 4) == 49995000);
+    REQUIRE(sum(7, 4) == 49995000);
+    REQUIRE(threading::parallel_reduce(
+                threading::range(3, 3),
+                -1,
+                [](const threading::range&, int) { return 0; },
+                [](int a, int b) { return a + b; }) == -1);
+
+    // Partial results are combined in range order: concatenation is not commutative.
+    const auto ids = threading::parallel_reduce(
+        threading::range(0, 500, 3),
+        std::vector<size_t>(),
+        [](const threading::range& r, std::vector<size_t> v) {
+            for (size_t i = r.begin(); i < r.end(); ++i) {
+                v.push_back(i);
+            }
+            return v;
+        },
+        [](std::vector<size_t> a, const std::vector<size_t>& b) {
+            a.insert(a.end(), b.begin(), b.end());
+            return a;
+        },
+        4);
+    REQUIRE(ids.size() == 500);
+    REQUIRE(std::is_sorted(ids.begin(), ids.end()));
+}
+
+TEST_CASE("parallel_sort", "[threading]")
+{
+    std::vector<uint64_t> v(100000);
+    uint64_t x = 88172645463325252ull;
+    for (auto& e : v) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17; // xorshift
+        e = x % 5000; // plenty of duplicates
+    }
+    auto expected = v;
+    std::sort(expected.begin(), expected.end());
+
+    auto a = v;
+    threading::parallel_sort(a.begin(), a.end(), 5);
+    REQUIRE(a == expected);
+
+    auto b = v;
+    threading::parallel_sort(b.begin(), b.end(), std::greater<uint64_t>(), 3);
+    REQUIRE(std::equal(b.begin(), b.end(), expected.rbegin()));
+}
+
 TEST_CASE("parallel_for_performance", "[threading][.]")
 {
     /**
@@ -225,6 +331,94 @@ TEST_CASE("enumerable_thread_specific", "[threading]")
     CHECK(total_sum == (N * (N - 1)) / 2);
 }
 
+TEST_CASE("enumerable_thread_specific_outlives_no_thread", "[threading]")
+{
+    // Pool workers persist, so a value must be destroyed with its instance, not its thread.
+    const auto counter = std::make_shared<int>(0);
+    for (int round = 0; round < 3; ++round) {
+        threading::enumerable_thread_specific<std::shared_ptr<int>> ets(counter);
+        std::atomic<int> wrong(0);
+        threading::parallel_for(
+            threading::range(0, 64),
+            [&](const threading::range&) {
+                if (ets.local() != counter) wrong++;
+            },
+            4);
+        REQUIRE(wrong.load() == 0);
+        REQUIRE(counter.use_count() > 2);
+    }
+    REQUIRE(counter.use_count() == 1);
+}
+
+TEST_CASE("thread_pool", "[threading]")
+{
+    SECTION("workers persist across calls")
+    {
+        threading::parallel_for(threading::range(0, 8), [](const threading::range&) {}, 4);
+        const size_t workers = threading::thread_pool::instance().size();
+        REQUIRE(workers >= 3);
+        for (int i = 0; i < 10; ++i) {
+            threading::parallel_for(threading::range(0, 8), [](const threading::range&) {}, 4);
+        }
+        REQUIRE(threading::thread_pool::instance().size() == workers);
+    }
+
+    SECTION("task_group tasks run concurrently")
+    {
+        // Each task waits for all the others to start: this only finishes if every task has a
+        // thread of its own, which is what a thread per run() used to guarantee.
+        constexpr int n = 6;
+        std::atomic<int> started(0);
+        threading::task_group tg;
+        for (int i = 0; i < n; ++i) {
+            tg.run([&] {
+                started.fetch_add(1);
+                while (started.load() < n) {
+                    std::this_thread::yield();
+                }
+            });
+        }
+        tg.wait();
+        REQUIRE(started.load() == n);
+    }
+
+    SECTION("task_group rethrows")
+    {
+        threading::task_group tg;
+        tg.run([] { throw std::runtime_error("task failure"); });
+        tg.run([] {});
+        REQUIRE_THROWS_AS(tg.wait(), std::runtime_error);
+    }
+
+    SECTION("nested parallel_for runs inline")
+    {
+        std::atomic<size_t> inner_chunks(0);
+        std::atomic<size_t> sum(0);
+        std::atomic<int> outside(0);
+        threading::parallel_for(
+            threading::range(0, 4),
+            [&](const threading::range& outer) {
+                if (!threading::thread_pool::in_task()) outside++;
+                for (size_t i = outer.begin(); i < outer.end(); ++i) {
+                    threading::parallel_for(
+                        threading::range(0, 100),
+                        [&](const threading::range& r) {
+                            inner_chunks.fetch_add(1);
+                            for (size_t j = r.begin(); j < r.end(); ++j) {
+                                sum.fetch_add(j);
+                            }
+                        },
+                        8);
+                }
+            },
+            4);
+        REQUIRE(outside.load() == 0);
+        REQUIRE(inner_chunks.load() == 4);
+        REQUIRE(sum.load() == 4 * 4950);
+        REQUIRE_FALSE(threading::thread_pool::in_task());
+    }
+}
+
 TEST_CASE("spin_mutex", "[threading]")
 {
     SECTION("mutual exclusion")
@@ -264,6 +458,178 @@ TEST_CASE("spin_mutex", "[threading]")
     }
 }
 
+TEST_CASE("stealable_priority_queue", "[threading]")
+{
+    threading::stealable_priority_queue<int> q;
+    q.set_shared(true);
+    for (int i = 0; i < 10; ++i) {
+        q.push(i);
+    }
+
+    SECTION("steals from the top, at most half")
+    {
+        std::vector<int> loot;
+        CHECK(q.try_steal(loot, 100) == 5);
+        CHECK(loot == std::vector<int>{9, 8, 7, 6, 5});
+        CHECK(q.size() == 5);
+
+        int top = -1;
+        REQUIRE(q.try_pop(top));
+        CHECK(top == 4);
+    }
+
+    SECTION("respects the batch bound and leaves a single element alone")
+    {
+        std::vector<int> loot;
+        CHECK(q.try_steal(loot, 3) == 3);
+        CHECK(q.size() == 7);
+        int out;
+        while (q.size() > 1) {
+            q.try_pop(out);
+        }
+        loot.clear();
+        CHECK(q.try_steal(loot, 3) == 0);
+        CHECK(loot.empty());
+    }
+
+    SECTION("concurrent owner and thieves lose nothing")
+    {
+        constexpr int kItems = 20000;
+        threading::stealable_priority_queue<int> shared;
+        shared.set_shared(true);
+        for (int i = 0; i < kItems; ++i) {
+            shared.push(i);
+        }
+        std::atomic<size_t> taken{0};
+        threading::task_group tg;
+        tg.run([&]() {
+            int v;
+            while (shared.try_pop(v)) {
+                taken.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        for (int t = 0; t < 3; ++t) {
+            tg.run([&]() {
+                std::vector<int> loot;
+                while (!shared.empty()) {
+                    loot.clear();
+                    taken.fetch_add(shared.try_steal(loot, 16), std::memory_order_relaxed);
+                }
+            });
+        }
+        tg.wait();
+        int v;
+        while (shared.try_pop(v)) {
+            taken.fetch_add(1, std::memory_order_relaxed);
+        }
+        CHECK(taken.load() == size_t(kItems));
+    }
+}
+
+namespace {
+// The scheduler's element shape, with an int standing in for the Tuple.
+using QueueElem = std::tuple<double, uint32_t, int>;
+struct QueueElemKey
+{
+    threading::heap_key operator()(const QueueElem& e) const
+    {
+        return {std::get<0>(e), std::get<1>(e)};
+    }
+};
+} // namespace
+
+TEST_CASE("dary_heap_pops_in_priority_queue_order", "[threading]")
+{
+    // Few distinct priorities and ops, so that most of the order is decided by the tie-break on
+    // the element itself, which the d-ary heap only reaches through its side array.
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> prio(-8, 8), op(0, 2), payload(0, 1 << 20);
+    std::priority_queue<QueueElem> reference;
+    threading::keyed_dary_heap<QueueElem, QueueElemKey> heap;
+    // Interleave pushes and pops, as a pass does with its renewals.
+    for (int round = 0; round < 200; ++round) {
+        for (int i = 0; i < 50; ++i) {
+            const QueueElem e(0.5 * prio(rng), uint32_t(op(rng)), payload(rng));
+            reference.push(e);
+            heap.push(e);
+        }
+        for (int i = 0; i < 30; ++i) {
+            REQUIRE(heap.top() == reference.top());
+            reference.pop();
+            heap.pop();
+        }
+    }
+    while (!reference.empty()) {
+        REQUIRE(heap.size() == reference.size());
+        REQUIRE(heap.top() == reference.top());
+        reference.pop();
+        heap.pop();
+    }
+    CHECK(heap.empty());
+}
+
+TEST_CASE("bucket_priority_queue_orders_to_within_a_bucket", "[threading]")
+{
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> mantissa(1, 2);
+    std::uniform_int_distribution<int> exponent(-20, 20), sign(0, 3);
+    const int bits = 3;
+    threading::bucket_priority_queue<QueueElem, QueueElemKey> q;
+    q.set_bits(bits);
+    std::vector<QueueElem> pushed;
+    for (int i = 0; i < 5000; ++i) {
+        // Mostly positive, some negative and some zero: every sign has to order correctly.
+        double p = std::ldexp(mantissa(rng), exponent(rng));
+        if (sign(rng) == 0) p = -p;
+        if (i % 97 == 0) p = 0;
+        pushed.emplace_back(p, 0, i);
+        q.push(pushed.back());
+    }
+    CHECK(q.size() == pushed.size());
+
+    // Never out of order by more than a bucket: relative 2^-bits, and exact across zero.
+    std::vector<int> seen(pushed.size(), 0);
+    double prev = std::numeric_limits<double>::infinity();
+    while (!q.empty()) {
+        const QueueElem e = q.top();
+        q.pop();
+        const double p = std::get<0>(e);
+        const double slack = std::abs(p) * std::ldexp(1., -bits);
+        CHECK(p <= prev + slack);
+        CHECK((p > 0) <= (prev > 0));
+        prev = std::min(prev, p);
+        ++seen[std::get<2>(e)];
+    }
+    CHECK(std::all_of(seen.begin(), seen.end(), [](int n) { return n == 1; }));
+}
+
+TEST_CASE("stealable_priority_queue_over_a_selectable_heap", "[threading]")
+{
+    using Queue = threading::stealable_priority_queue<
+        QueueElem,
+        std::less<QueueElem>,
+        threading::selectable_heap<QueueElem, QueueElemKey>>;
+    for (const auto kind : {threading::QueueKind::kBinaryHeap, threading::QueueKind::kDaryHeap}) {
+        Queue q;
+        q.heap().configure(kind, 4);
+        q.set_shared(true);
+        for (int i = 0; i < 10; ++i) {
+            q.emplace(double(i % 5), uint32_t(i % 2), i);
+        }
+        std::vector<QueueElem> loot;
+        CHECK(q.try_steal(loot, 3) == 3);
+        CHECK(
+            loot == std::vector<QueueElem>{
+                        QueueElem(4., 1, 9),
+                        QueueElem(4., 0, 4),
+                        QueueElem(3., 1, 3)});
+        QueueElem top;
+        REQUIRE(q.try_pop(top));
+        CHECK(top == QueueElem(3., 0, 8));
+        CHECK(q.size() == 6);
+    }
+}
+
 TEST_CASE("vertex_mutex_owner_integrity", "[threading]")
 {
     // The invariant the two-ring walks rely on: while a thread holds a vertex, that vertex's
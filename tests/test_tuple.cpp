@@ -4,6 +4,8 @@
 #include <wmtk/TetMesh.h>
 #include <wmtk/utils/examples/TetMesh_examples.hpp>
 
+#include <algorithm>
+
 using namespace wmtk;
 using namespace wmtk::utils::examples::tet;
 
@@ -120,6 +122,246 @@ TEST_CASE("switch_tet", "[test_tuple][TetMesh]")
     REQUIRE(tid1 == tid2);
 }
 
+TEST_CASE("switch_tet_face_adjacency", "[test_tuple][TetMesh]")
+{
+    using Tuple = TetMesh::Tuple;
+
+    // Operations that can be told to fail after the connectivity update, to exercise rollback.
+    class FlakyMesh : public TetMesh
+    {
+    public:
+        bool fail = false;
+        bool split_edge_after(const Tuple&) override { return !fail; }
+        bool collapse_edge_after(const Tuple&) override { return !fail; }
+        bool swap_edge_after(const Tuple&) override { return !fail; }
+        bool swap_face_after(const Tuple&) override { return !fail; }
+    };
+
+    // The table must give the same answer as the star search, tuple for tuple.
+    const auto check_against_search = [](const TetMesh& m) {
+        for (const Tuple& t : m.get_faces()) {
+            const auto t_opp_slow = t.switch_tetrahedron_slow(m);
+            const auto t_opp = t.switch_tetrahedron(m);
+            REQUIRE(t_opp_slow.has_value() == t_opp.has_value());
+            if (t_opp) {
+                CHECK(t_opp_slow.value() == t_opp.value());
+            }
+        }
+    };
+
+    TetMeshVT VT = six_cycle_tets();
+    FlakyMesh mesh;
+    mesh.init(VT.T);
+    REQUIRE_FALSE(mesh.has_face_adjacency());
+    mesh.enable_face_adjacency(true);
+    REQUIRE(mesh.has_face_adjacency());
+    check_against_search(mesh);
+
+    std::vector<Tuple> dummy;
+    for (const Tuple& e : mesh.get_edges()) {
+        if (e.is_valid(mesh)) mesh.split_edge(e, dummy);
+    }
+    REQUIRE(mesh.has_face_adjacency());
+    check_against_search(mesh);
+
+    mesh.fail = true;
+    for (const Tuple& e : mesh.get_edges()) {
+        REQUIRE_FALSE(mesh.split_edge(e, dummy));
+        REQUIRE_FALSE(mesh.collapse_edge(e, dummy));
+        REQUIRE_FALSE(mesh.swap_edge(e, dummy));
+    }
+    for (const Tuple& f : mesh.get_faces()) {
+        REQUIRE_FALSE(mesh.swap_face(f, dummy));
+    }
+    mesh.fail = false;
+    check_against_search(mesh);
+
+    for (const Tuple& f : mesh.get_faces()) {
+        if (f.is_valid(mesh)) mesh.swap_face(f, dummy);
+    }
+    check_against_search(mesh);
+    // Collapse the edges a split just made, the one pattern a bare TetMesh always accepts.
+    for (const Tuple& e : mesh.get_edges()) {
+        std::vector<Tuple> new_edges;
+        if (e.is_valid(mesh) && mesh.split_edge(e, new_edges)) {
+            mesh.collapse_edge(new_edges[1], dummy);
+        }
+    }
+    REQUIRE(mesh.check_mesh_connectivity_validity());
+    check_against_search(mesh);
+
+    mesh.consolidate_mesh();
+    REQUIRE(mesh.has_face_adjacency());
+    check_against_search(mesh);
+
+    // A face split edits connectivity directly: the table goes stale and the search answers
+    // until consolidate_mesh rebuilds it.
+    REQUIRE(mesh.split_face(mesh.get_faces().front(), dummy));
+    REQUIRE_FALSE(mesh.has_face_adjacency());
+    check_against_search(mesh);
+    mesh.consolidate_mesh();
+    REQUIRE(mesh.has_face_adjacency());
+    check_against_search(mesh);
+}
+
+TEST_CASE("slot_recycling", "[test_tuple][TetMesh]")
+{
+    using Tuple = TetMesh::Tuple;
+
+    // Remembers where the last split put its new vertex.
+    class SplitMesh : public TetMesh
+    {
+    public:
+        Tuple last_split;
+        bool split_edge_after(const Tuple& t) override
+        {
+            last_split = t;
+            return true;
+        }
+    };
+
+    TetMeshVT VT = six_cycle_tets();
+    SplitMesh mesh;
+    mesh.init(VT.T);
+
+    // A split followed by the collapse that undoes it leaves the live counts unchanged, so once
+    // the first round has taken its slots every later round must run on recycled ones. The
+    // split returns an edge from an old vertex to the new one; collapse it from the new end.
+    const auto split_collapse_round = [&]() {
+        std::vector<Tuple> dummy;
+        for (const Tuple& e : mesh.get_edges()) {
+            if (e.is_valid(mesh) && mesh.split_edge(e, dummy)) {
+                REQUIRE(mesh.collapse_edge(mesh.switch_vertex(mesh.last_split), dummy));
+            }
+        }
+    };
+    split_collapse_round();
+    const size_t vert_capacity = mesh.vert_capacity();
+    const size_t tet_capacity = mesh.tet_capacity();
+    for (int i = 0; i < 5; i++) split_collapse_round();
+    CHECK(mesh.vert_capacity() == vert_capacity);
+    CHECK(mesh.tet_capacity() == tet_capacity);
+    REQUIRE(mesh.check_mesh_connectivity_validity());
+
+    // Tuples taken before a round name slots it removed and refilled; the hash bump keeps them
+    // from passing for the tets that now live there.
+    const auto stale = mesh.get_tets();
+    split_collapse_round();
+    for (const Tuple& t : stale) {
+        CHECK_FALSE(t.is_valid(mesh));
+    }
+}
+
+TEST_CASE("tuple_compact_layout", "[test_tuple][TetMesh]")
+{
+    // Queues and tuple vectors hold millions of these; keep an eye on the size.
+    STATIC_REQUIRE(sizeof(TetMesh::Tuple) <= 2 * sizeof(index_t) + 8);
+    STATIC_REQUIRE(sizeof(TetMesh::TetrahedronConnectivity::m_indices) == 4 * sizeof(index_t));
+
+    TetMesh m;
+    m.init(5, {{{0, 1, 2, 3}}, {{0, 1, 2, 4}}});
+    CHECK_FALSE(TetMesh::Tuple().is_valid(m));
+    // The narrowed local ids must survive every switch.
+    for (const auto& e : m.get_edges()) {
+        const auto f = e.switch_face(m);
+        CHECK(f.eid(m) == e.eid(m));
+        CHECK(f.switch_face(m).fid(m) == e.fid(m));
+        CHECK(e.switch_vertex(m).switch_vertex(m).vid(m) == e.vid(m));
+    }
+}
+
+TEST_CASE("consolidate_mesh_reorder", "[test_tuple][TetMesh]")
+{
+    using Tuple = TetMesh::Tuple;
+
+    // Each vertex carries its pre-consolidation id, and each tet the ids of its vertices, so
+    // that connectivity and attributes can be checked to have moved together.
+    class LabelledMesh : public TetMesh
+    {
+    public:
+        AttributeCollection<size_t> m_vertex_label;
+        AttributeCollection<std::array<size_t, 4>> m_tet_label;
+        LabelledMesh()
+        {
+            p_vertex_attrs = &m_vertex_label;
+            p_tet_attrs = &m_tet_label;
+        }
+        void label()
+        {
+            for (size_t v = 0; v < vert_capacity(); ++v) m_vertex_label[v] = v;
+            for (size_t t = 0; t < tet_capacity(); ++t) {
+                if (!tuple_from_tet(t).is_valid(*this)) continue;
+                m_tet_label[t] = oriented_tet_vids(t);
+            }
+        }
+        void check_labels()
+        {
+            for (const Tuple& t : get_tets()) {
+                std::array<size_t, 4> vs = oriented_tet_vids(t);
+                for (size_t& v : vs) v = m_vertex_label[v];
+                CHECK(vs == m_tet_label[t.tid(*this)]);
+            }
+        }
+    };
+
+    TetMeshVT VT = six_cycle_tets();
+    LabelledMesh mesh;
+    mesh.init(VT.T);
+    mesh.enable_face_adjacency(true);
+    std::vector<Tuple> dummy;
+    for (const Tuple& e : mesh.get_edges()) {
+        std::vector<Tuple> new_edges;
+        if (e.is_valid(mesh) && mesh.split_edge(e, new_edges)) {
+            mesh.collapse_edge(new_edges[1], dummy);
+        }
+    }
+    for (const Tuple& e : mesh.get_edges()) {
+        if (e.is_valid(mesh)) mesh.split_edge(e, dummy);
+    }
+    const size_t n_verts = mesh.get_vertices().size();
+    const size_t n_tets = mesh.get_tets().size();
+
+    // Plain compaction keeps the relative order.
+    mesh.label();
+    mesh.consolidate_mesh();
+    REQUIRE(mesh.check_mesh_connectivity_validity());
+    REQUIRE(mesh.get_vertices().size() == n_verts);
+    for (size_t v = 1; v < n_verts; ++v) {
+        CHECK(mesh.m_vertex_label[v - 1] < mesh.m_vertex_label[v]);
+    }
+    mesh.check_labels();
+
+    // Reversed keys reverse the vertex order; tets follow their lowest vertex.
+    mesh.label();
+    std::vector<uint64_t> keys(mesh.vert_capacity());
+    for (size_t v = 0; v < keys.size(); ++v) keys[v] = keys.size() - v;
+    mesh.consolidate_mesh(keys);
+    REQUIRE(mesh.check_mesh_connectivity_validity());
+    REQUIRE(mesh.get_vertices().size() == n_verts);
+    REQUIRE(mesh.get_tets().size() == n_tets);
+    for (size_t v = 0; v < n_verts; ++v) {
+        CHECK(mesh.m_vertex_label[v] == n_verts - 1 - v);
+        const auto& star = mesh.get_one_ring_tids_for_vertex(v);
+        CHECK(std::is_sorted(star.begin(), star.end()));
+    }
+    size_t prev_min = 0;
+    for (size_t t = 0; t < n_tets; ++t) {
+        const auto vs = mesh.oriented_tet_vids(t);
+        const size_t min_v = *std::min_element(vs.begin(), vs.end());
+        CHECK(prev_min <= min_v);
+        prev_min = min_v;
+    }
+    mesh.check_labels();
+
+    REQUIRE(mesh.has_face_adjacency());
+    for (const Tuple& f : mesh.get_faces()) {
+        const auto t_opp_slow = f.switch_tetrahedron_slow(mesh);
+        const auto t_opp = f.switch_tetrahedron(mesh);
+        REQUIRE(t_opp_slow.has_value() == t_opp.has_value());
+        if (t_opp) CHECK(t_opp_slow.value() == t_opp.value());
+    }
+}
+
 TEST_CASE("tuple_from_face_vids", "[test_tuple][TetMesh]")
 {
     TetMesh m;